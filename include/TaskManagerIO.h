@@ -49,21 +49,38 @@ public:
 extern TaskManager taskManager; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
 #else
-// Simple TaskManager implementation for non-test builds
-class TaskManager {
+#include <cooperative_scheduler.h>
+
+/**
+ * The firmware's scheduler: a CooperativeScheduler on millis(), timing runs with micros(), with the TaskManagerIO calls
+ * the firmware uses. Tasks skip periods they miss, so a slow loop never replays stale control steps.
+ */
+class TaskManager : public CooperativeScheduler {
 public:
-  void runLoop() {}
-  void cancelTask(taskid_t taskId) {}
+  TaskManager();
 
-  static taskid_t scheduleFixedRate(uint32_t rate, void (*callback)()) {
-    static taskid_t nextId = 1;
-    return nextId++;
-  }
+  /**
+   * Stops a task.
+   * @param taskId The task to stop.
+   */
+  void cancelTask(taskid_t taskId) { cancel(taskId); }
 
-  static taskid_t scheduleFixedRate(uint32_t initialDelay, uint32_t rate, void (*callback)()) {
-    static taskid_t nextId = DEFAULT_TASK_RATE_MS;
-    return nextId++;
-  }
+  /**
+   * Schedules a task on the global task manager, first one period from now.
+   * @param rate Time between runs in milliseconds.
+   * @param callback The work to run.
+   * @return The task ID, or CooperativeScheduler::INVALID_TASK if every slot is taken.
+   */
+  static taskid_t scheduleFixedRate(uint32_t rate, void (*callback)());
+
+  /**
+   * Schedules a task on the global task manager, first after an initial delay.
+   * @param initialDelay Time from now to the first run in milliseconds.
+   * @param rate Time between runs in milliseconds.
+   * @param callback The work to run.
+   * @return The task ID, or CooperativeScheduler::INVALID_TASK if every slot is taken.
+   */
+  static taskid_t scheduleFixedRate(uint32_t initialDelay, uint32_t rate, void (*callback)());
 };
 
 extern TaskManager taskManager; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
@@ -0,0 +1,144 @@
+#ifndef BLOCK_STORE_H
+#define BLOCK_STORE_H
+
+#include "hardware_interfaces.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Keeps a fixed number of values across power cycles, as one checksummed block.
+ *
+ * The values live in memory and go to the storage as a single block guarded by a magic number and an FNV-1a
+ * checksum, so a missing, foreign or torn block is rejected as a whole. Each slot is either empty or holds a value,
+ * and saving an unchanged block writes nothing, so the storage only wears when a value actually changes.
+ *
+ * @tparam Value The stored value; must be trivially copyable and comparable with ==.
+ * @tparam Key The slot index type, such as an enum of the things that have values.
+ * @tparam SlotCount The number of slots, at most 8.
+ * @tparam Magic Identifies the block; use a different one for each store, and bump it whenever Value changes.
+ */
+template <typename Value, typename Key, uint8_t SlotCount, uint32_t Magic> class BlockStore {
+  static_assert(SlotCount <= 8, "BlockStore keeps its valid slots in one byte");
+
+private:
+  static constexpr uint32_t FNV_OFFSET_BASIS = 2166136261UL;
+  static constexpr uint32_t FNV_PRIME = 16777619UL;
+
+  /**
+   * The block as written to the storage.
+   */
+  struct Image {
+    uint32_t magic;         /**< Identifies the block and its layout. */
+    uint8_t validMask;      /**< Bit i set if slot i holds a value. */
+    Value slots[SlotCount]; /**< Value of each slot. */
+    uint32_t checksum;      /**< FNV-1a hash of every byte before this field. */
+  };
+
+  IBlockStorage &storage; /**< Non-volatile storage for the block. */
+  Image image;            /**< Values in memory. */
+  bool dirty{false};      /**< Whether the values changed since the last load or save. */
+
+  /**
+   * Computes the checksum of a block.
+   * @param block The block to hash.
+   * @return The FNV-1a hash of every byte before the checksum field.
+   */
+  static uint32_t checksumOf(const Image &block) {
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&block);
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < offsetof(Image, checksum); i++) {
+      hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+  }
+
+public:
+  /** Identifies the block. */
+  static const uint32_t MAGIC = Magic;
+
+  /**
+   * Constructor for the BlockStore class. Starts with every slot empty.
+   * @param storage Non-volatile storage for the block.
+   */
+  explicit BlockStore(IBlockStorage &storage) : storage(storage) {
+    // Cleared bytewise so that the padding, which the checksum covers, is deterministic
+    memset(&image, 0, sizeof(image));
+    image.magic = MAGIC;
+  }
+
+  /**
+   * Reads the values from the storage. A block that fails validation leaves every slot empty.
+   * @return True if a valid block was read, false otherwise.
+   */
+  bool load() {
+    Image block;
+    if (!storage.read(reinterpret_cast<uint8_t *>(&block), sizeof(block))) {
+      return false;
+    }
+    if (block.magic != MAGIC || block.checksum != checksumOf(block)) {
+      return false;
+    }
+    image = block;
+    dirty = false;
+    return true;
+  }
+
+  /**
+   * Writes the values to the storage, if they changed since the last load or save.
+   * @return True if the storage holds the current values, false if writing failed.
+   */
+  bool save() {
+    if (!dirty) {
+      return true;
+    }
+    image.checksum = checksumOf(image);
+    if (!storage.write(reinterpret_cast<const uint8_t *>(&image), sizeof(image))) {
+      return false;
+    }
+    dirty = false;
+    return true;
+  }
+
+  /**
+   * Returns the value stored in a slot.
+   * @param slot The slot.
+   * @param value Receives the value, if there is one.
+   * @return True if the slot holds a value, false otherwise.
+   */
+  bool get(Key slot, Value &value) const {
+    uint8_t index = static_cast<uint8_t>(slot);
+    if (index >= SlotCount || (image.validMask & (1U << index)) == 0) {
+      return false;
+    }
+    value = image.slots[index];
+    return true;
+  }
+
+  /**
+   * Stores a value in memory, to be written by the next save(). Storing the value a slot already holds does not
+   * mark the store as changed.
+   * @param slot The slot.
+   * @param value The value to store.
+   */
+  void set(Key slot, const Value &value) {
+    uint8_t index = static_cast<uint8_t>(slot);
+    if (index >= SlotCount) {
+      return;
+    }
+    Value &stored = image.slots[index];
+    bool valid = (image.validMask & (1U << index)) != 0;
+    if (valid && stored == value) {
+      return;
+    }
+    stored = value;
+    image.validMask |= static_cast<uint8_t>(1U << index);
+    dirty = true;
+  }
+};
+
+template <typename Value, typename Key, uint8_t SlotCount, uint32_t Magic>
+const uint32_t BlockStore<Value, Key, SlotCount, Magic>::MAGIC;
+
+#endif // BLOCK_STORE_H
@@ -0,0 +1,14 @@
+#ifndef CALIBRATION_STORE_H
+#define CALIBRATION_STORE_H
+
+#include "block_store.h"
+#include "constants.h"
+#include "scale.h"
+
+/**
+ * Keeps the offset and calibration factor of every scale across power cycles, one slot per scale in
+ * SCALE_COLLECTION_STATES order. Restoring at boot is then one read and a copy, with no HX711 conversions to wait for.
+ */
+using CalibrationStore = BlockStore<ScaleCalibration, uint8_t, CALIBRATION_STORE_SLOTS, 0x43414C31>; // "CAL1"
+
+#endif // CALIBRATION_STORE_H
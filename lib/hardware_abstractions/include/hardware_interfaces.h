@@ -38,6 +38,7 @@ class HX711;
 #else
 // For test/native builds, we use our mock implementations
 #include <Arduino.h>
+#include <MockSensors.h>
 
 // Define File class for test/native builds
 #ifndef File_defined
@@ -125,6 +126,12 @@ public:
     return (mockWeight + (counter % 3) * 0.01) / scaleCalibration;
   }
 
+  long read() { return static_cast<long>(mockWeight * scaleCalibration); }
+
+  long get_offset() { return 0; }
+
+  float get_scale() { return scaleCalibration; }
+
   // Method to set mock weight for testing
   void set_mock_weight(float weight) { mockWeight = weight; }
 };
@@ -183,6 +190,12 @@ public:
    * @return true if data available, false otherwise
    */
   virtual bool available() = 0;
+
+  /**
+   * @brief Read one byte of serial input.
+   * @return The byte, or -1 if none is available
+   */
+  virtual int read() = 0;
 };
 
 /**
@@ -256,16 +269,24 @@ public:
 
   /**
    * @brief Tare the scale (set current reading as zero).
+   *
+   * Every conversion takes about 100 ms at 10 SPS and this call waits for all of them, so keep
+   * the count low outside of startup.
+   *
    * @param times - Number of readings to average for tare
    */
-  virtual void tare(uint8_t times = 10) = 0;
+  virtual void tare(uint8_t times = 1) = 0;
 
   /**
    * @brief Get weight reading in calibrated units.
+   *
+   * Defaults to a single conversion, which does not wait once is_ready() returns true. Averaging
+   * belongs in the caller's software filters rather than in repeated blocking reads.
+   *
    * @param times - Number of readings to average
    * @return Weight reading
    */
-  virtual float get_units(uint8_t times = 10) = 0;
+  virtual float get_units(uint8_t times = 1) = 0;
 
   /**
    * @brief Power down the scale to save power.
@@ -276,6 +297,161 @@ public:
    * @brief Power up the scale.
    */
   virtual void power_up() = 0;
+
+  /**
+   * @brief Check whether power_down() actually powers this scale down.
+   * @return true by default; false for a scale whose power_down() does nothing
+   */
+  virtual bool can_power_down() { return true; }
+
+  /**
+   * @brief Read one raw conversion, without averaging, offset or calibration.
+   *
+   * Only call once is_ready() returns true; otherwise the read waits for the next conversion.
+   *
+   * @return Raw 24-bit count, sign-extended
+   */
+  virtual long read() { return 0; }
+
+  /**
+   * @brief Clock out a conversion that is already waiting, for use in the data-ready interrupt.
+   *
+   * Unlike read(), never waits for the scale and never changes the interrupt mask. Only call once is_ready() returns
+   * true. The default reads through read(), for interfaces whose read() does neither.
+   *
+   * @return Raw 24-bit count, sign-extended
+   */
+  virtual long readReadyConversion() { return read(); }
+
+  /**
+   * @brief Clock out a conversion that is already waiting, for a scale that is polled rather than interrupt-driven.
+   *
+   * Never waits for the scale, but masks interrupts while the clock is high: another scale's data-ready handler
+   * could otherwise stretch a pulse past 60 µs and power the HX711 down mid-read. Only call once is_ready() returns
+   * true, and never from an interrupt handler. The default reads through readReadyConversion().
+   *
+   * @return Raw 24-bit count, sign-extended
+   */
+  virtual long readPolledConversion() { return readReadyConversion(); }
+
+  /**
+   * @brief Get the raw count that corresponds to zero weight, as set by tare().
+   * @return Tare offset in raw counts
+   */
+  virtual long get_offset() { return 0; }
+
+  /**
+   * @brief Set the raw count that corresponds to zero weight, for a tare computed by the caller.
+   * @param offset - Tare offset in raw counts
+   */
+  virtual void set_offset(long /*offset*/) {}
+
+  /**
+   * @brief Get the scale calibration factor.
+   * @return Raw counts per unit of weight
+   */
+  virtual float get_scale() { return 1.0F; }
+
+  /**
+   * @brief Call a handler on the falling edge of DOUT, which signals that a conversion is ready.
+   *
+   * The default implementation reports that no interrupt is available, so the scale is polled instead.
+   *
+   * @param handler - Interrupt handler
+   * @return true if the handler was attached, false if DOUT cannot raise interrupts
+   */
+  virtual bool attachDataReadyInterrupt(void (* /*handler*/)()) { return false; }
+
+  /**
+   * @brief Stop calling the data-ready handler.
+   */
+  virtual void detachDataReadyInterrupt() {}
+};
+
+/**
+ * @brief Interface for the pins of a bank of HX711 modules sharing one clock line.
+ *
+ * Channel i of the bank maps to bit i of the returned masks. Keeping the pin access behind this
+ * interface lets the bank's read protocol be tested without hardware.
+ */
+class IHX711BankPort {
+public:
+  /** Virtual destructor for proper cleanup */
+  virtual ~IHX711BankPort() = default;
+
+  /**
+   * @brief Configure the shared clock pin and the data pins.
+   * @param clockPin - Shared PD_SCK pin
+   * @param dataPins - DOUT pin of each channel
+   * @param channelCount - Number of channels
+   */
+  virtual void begin(int clockPin, const int *dataPins, uint8_t channelCount) = 0;
+
+  /**
+   * @brief Sample every DOUT line at once.
+   * @return Bit i set if DOUT of channel i is high
+   */
+  virtual uint8_t readDataPins() = 0;
+
+  /**
+   * @brief Pulse the shared clock once and sample every DOUT line while it is high.
+   * @return Bit i set if channel i shifted out a one
+   */
+  virtual uint8_t pulseClock() = 0;
+
+  /**
+   * @brief Drive the shared clock line. Holding it high for over 60 µs powers the whole bank down.
+   * @param high - true to drive the clock high, false to drive it low
+   */
+  virtual void setClock(bool high) = 0;
+};
+
+/**
+ * @brief Interface for non-volatile storage that keeps one block of bytes, such as the scale calibrations.
+ *
+ * A block store hands over its whole block at once, so an implementation only has to keep one blob
+ * across power cycles.
+ */
+class IBlockStorage {
+public:
+  /** Virtual destructor for proper cleanup */
+  virtual ~IBlockStorage() = default;
+
+  /**
+   * @brief Read the stored block.
+   * @param data - Buffer to fill
+   * @param size - Number of bytes to read
+   * @return true if a block of exactly size bytes was read, false otherwise
+   */
+  virtual bool read(uint8_t *data, size_t size) = 0;
+
+  /**
+   * @brief Replace the stored block.
+   * @param data - Bytes to store
+   * @param size - Number of bytes to store
+   * @return true if the whole block was written, false otherwise
+   */
+  virtual bool write(const uint8_t *data, size_t size) = 0;
+};
+
+/**
+ * @brief Interface for the text file that holds the distillation recipe.
+ *
+ * The recipe is written by hand on a computer, so it is read as text of whatever length the
+ * file has, up to the caller's buffer.
+ */
+class IRecipeStorage {
+public:
+  /** Virtual destructor for proper cleanup */
+  virtual ~IRecipeStorage() = default;
+
+  /**
+   * @brief Read the recipe file.
+   * @param buffer - Buffer to fill; not null-terminated
+   * @param capacity - Size of the buffer
+   * @return Number of bytes read, 0 if there is no file; capacity if the file may not have fit
+   */
+  virtual size_t read(char *buffer, size_t capacity) = 0;
 };
 
 /**
@@ -293,6 +469,7 @@ public:
   size_t print(float val, int format = 2) override;
   size_t println(float val, int format = 2) override;
   bool available() override;
+  int read() override;
 };
 
 /**
@@ -319,27 +496,26 @@ public:
 class HX711ScaleInterface : public IScaleInterface {
 private:
 #if defined(UNIT_TEST) || defined(NATIVE)
-  // For test/native builds, use the mock implementation
+  // For test/native builds, use the mock implementation, which converts the count set for its data pin
   class HX711 {
   private:
-    float mockWeight = 0.0f;
+    int dataPin = 0;
     float scaleCalibration = 1.0f;
+    long offset = 0;
 
   public:
     HX711() {}
-    void begin(int dataPin, int clockPin) {}
+    void begin(int dataPin, int clockPin) { this->dataPin = dataPin; }
     bool isReady() { return true; }
     void set_scale(float scale) { scaleCalibration = scale; }
-    void tare(uint8_t times = 10) { mockWeight = 0.0f; }
+    void tare(uint8_t times = 10) { offset = read(); }
     void powerDown() {}
     void powerUp() {}
-    float get_units(uint8_t times = 10) {
-      // Simulate some variation in readings
-      static int counter = 0;
-      counter++;
-      return (mockWeight + (counter % 3) * 0.01) / scaleCalibration;
-    }
-    void set_mock_weight(float weight) { mockWeight = weight; }
+    float get_units(uint8_t times = 10) { return static_cast<float>(read() - offset) / scaleCalibration; }
+    long read() { return MockSensors::loadCellCounts[dataPin % MockSensors::PIN_COUNT]; }
+    long get_offset() { return offset; }
+    void set_offset(long value) { offset = value; }
+    float get_scale() { return scaleCalibration; }
   };
   HX711 scale; /**< Underlying mock HX711 object */
 #else
@@ -363,20 +539,89 @@ public:
   void begin() override;
   bool is_ready() override;
   void set_scale(float scaleValue) override;
-  void tare(uint8_t times = 10) override;
-  float get_units(uint8_t times = 10) override;
+  void tare(uint8_t times = 1) override;
+  float get_units(uint8_t times = 1) override;
   void power_down() override;
   void power_up() override;
+  long read() override;
+  long readReadyConversion() override;
+  long readPolledConversion() override;
+  long get_offset() override;
+  void set_offset(long offset) override;
+  float get_scale() override;
+  bool attachDataReadyInterrupt(void (*handler)()) override;
+  void detachDataReadyInterrupt() override;
+};
+
+/**
+ * @brief Arduino implementation of the HX711 bank port.
+ *
+ * Samples the data pins through their port input registers, reading each register once per clock
+ * no matter how many data pins share it.
+ */
+class ArduinoHX711BankPort : public IHX711BankPort {
+private:
+#if !defined(UNIT_TEST) && !defined(NATIVE)
+  static const uint8_t MAX_CHANNELS = 8;                 /**< Channels that fit in the returned masks */
+  const volatile uint32_t *registers[MAX_CHANNELS] = {}; /**< Distinct input registers holding the data pins */
+  uint32_t channelMasks[MAX_CHANNELS] = {};              /**< Bit of each channel's pin in its register */
+  uint8_t channelRegisters[MAX_CHANNELS] = {};           /**< Index into registers for each channel */
+  uint8_t registerCount = 0;                             /**< Number of distinct input registers */
+  uint8_t channelCount = 0;                              /**< Number of channels */
 
-#if defined(UNIT_TEST) || defined(NATIVE)
   /**
-   * @brief Set mock weight for testing (only available in test/native builds).
-   *
-   * This method allows test code to set a specific weight value to be
-   * returned by the scale when get_units() is called.
-   *
-   * @param weight - The weight value to simulate
+   * @brief Read each input register once and gather the channel bits.
+   * @return Bit i set if DOUT of channel i is high
    */
-  void set_mock_weight(float weight) { scale.set_mock_weight(weight); }
+  uint8_t sample();
 #endif
-};
\ No newline at end of file
+  int clockPin = -1; /**< Shared PD_SCK pin */
+
+public:
+  void begin(int clockPin, const int *dataPins, uint8_t channelCount) override;
+  uint8_t readDataPins() override;
+  uint8_t pulseClock() override;
+  void setClock(bool high) override;
+};
+
+/**
+ * @brief SD card implementation of the block storage.
+ *
+ * Keeps the block in a file of its own. The SD card must already be initialized, which the
+ * logger does in its begin().
+ */
+class ArduinoBlockStorage : public IBlockStorage {
+private:
+  const char *fileName; /**< 8.3 name of the file that holds the block */
+
+public:
+  /**
+   * @brief Constructor
+   * @param fileName - 8.3 name of the file that holds the block
+   */
+  explicit ArduinoBlockStorage(const char *fileName) : fileName(fileName) {}
+
+  // These implementations are defined in the .cpp file to avoid direct use of SD.h here
+  bool read(uint8_t *data, size_t size) override;
+  bool write(const uint8_t *data, size_t size) override;
+};
+
+/**
+ * @brief SD card implementation of the recipe storage.
+ *
+ * The SD card must already be initialized, which the logger does in its begin().
+ */
+class ArduinoRecipeStorage : public IRecipeStorage {
+private:
+  const char *fileName; /**< 8.3 name of the recipe file */
+
+public:
+  /**
+   * @brief Constructor
+   * @param fileName - 8.3 name of the recipe file
+   */
+  explicit ArduinoRecipeStorage(const char *fileName) : fileName(fileName) {}
+
+  // Defined in the .cpp file to avoid direct use of SD.h here
+  size_t read(char *buffer, size_t capacity) override;
+};
@@ -3,20 +3,23 @@
 
 #ifndef UNIT_TEST
 #include <Arduino.h>
+#ifndef NATIVE
 #include <Wire.h>
 #include <hd44780.h>
 #include <hd44780ioClass/hd44780_I2Cexp.h>
 #endif
+#endif
 
 #include <cstdint>
 
 // Constants
 constexpr uint8_t MULTIPLEXER_ADDRESS = 0x70;
 constexpr uint8_t CHANNEL_SWITCH_DELAY_MS = 100;
+constexpr uint8_t NO_CHANNEL = 0xFF; // Before the multiplexer has been switched
 
 class Lcd {
 private:
-#ifndef UNIT_TEST
+#if !defined(UNIT_TEST) && !defined(NATIVE)
   Hd44780I2Cexp lcd; // LCD object
 #endif
   uint8_t channel; // I2C multiplexer channel
@@ -26,7 +29,12 @@ public:
   // Constructor: stores configuration but doesn't initialize LCD
   Lcd(int lcdCols, int lcdRows, uint8_t channel) : channel(channel), lcdCols(lcdCols), lcdRows(lcdRows) {}
 
-#ifndef UNIT_TEST
+#if defined(NATIVE) && !defined(UNIT_TEST)
+  // Native builds have no display, so the rows go nowhere
+  void init() {}
+  void writeToRow(const String & /*text*/, int /*row*/) {}
+  void clear() {}
+#elif !defined(UNIT_TEST)
   // Initializes the LCD; must be called after I2C is set up
   void init() {
     selectChannel(channel);
@@ -47,12 +55,22 @@ public:
   }
 
 private:
-  // Selects the correct I2C channel on the multiplexer
+  // The multiplexer channel last selected, shared by every display behind it
+  static uint8_t &selectedChannel() {
+    static uint8_t selected = NO_CHANNEL;
+    return selected;
+  }
+
+  // Selects the correct I2C channel on the multiplexer; the settling delay blocks, so it is only paid on a switch
   static void selectChannel(uint8_t channel) {
+    if (selectedChannel() == channel) {
+      return;
+    }
     Wire.beginTransmission(MULTIPLEXER_ADDRESS);
     TwoWire::write(1 << channel);
     TwoWire::endTransmission();
     delay(CHANNEL_SWITCH_DELAY_MS); // Ensure channel switching
+    selectedChannel() = channel;
   }
 #endif
 };
@@ -0,0 +1,156 @@
+#ifndef PARALLEL_HX711_BANK_H
+#define PARALLEL_HX711_BANK_H
+
+#include "constants.h"
+#include "hardware_interfaces.h"
+
+#include <array>
+
+#ifndef UNIT_TEST
+#include "Arduino.h"
+#else
+// The bank's stall timeout comes from millis(); the mock implementation lives in the test files
+#include "mock_arduino.h"
+#endif
+
+/**
+ * A bank of HX711 modules on one shared clock line.
+ *
+ * Each clock pulse samples every data line at once, so one pass of 25 pulses reads a conversion from every
+ * channel: reading the whole bank takes as long as reading a single HX711, however many channels there are.
+ * A pass starts once every active channel has a conversion waiting. A channel that stays silent while the others
+ * are ready is left out of the bank until it has data again, so one missing module cannot stall the rest.
+ */
+class ParallelHX711Bank {
+  static_assert(HX711_BANK_MAX_CHANNELS <= 8, "Channel masks are 8 bits wide");
+
+private:
+  IHX711BankPort &port;                                /**< Pin access for the clock and data lines. */
+  const int clockPin;                                  /**< Shared clock pin. */
+  std::array<int, HX711_BANK_MAX_CHANNELS> dataPins{}; /**< Data pin of each channel. */
+  std::array<long, HX711_BANK_MAX_CHANNELS> latest{};  /**< Latest conversion of each channel. */
+  uint8_t channelCount{0};                             /**< Number of channels added. */
+  uint8_t activeMask{0};                               /**< Channels a pass waits for. */
+  uint8_t freshMask{0};                                /**< Channels with a conversion not yet taken. */
+  bool started{false};                                 /**< Whether begin() has configured the pins. */
+  bool waiting{false};                                 /**< Whether some, but not all, channels are ready. */
+  unsigned long waitStart{0};                          /**< Time the first channel of a pass became ready. */
+  unsigned long passCount{0};                          /**< Number of passes read so far. */
+
+  /**
+   * Clocks one conversion out of every ready channel.
+   * @param readyMask The channels whose conversions are read.
+   */
+  void readPass(uint8_t readyMask);
+
+public:
+  /** Clock pulses per pass: 24 data bits plus one that selects channel A at gain 128 for the next conversion. */
+  static const uint8_t PULSES_PER_PASS = 25;
+
+  /**
+   * Constructor for the ParallelHX711Bank class.
+   * @param port Pin access for the clock and data lines.
+   * @param clockPin The shared clock pin.
+   */
+  ParallelHX711Bank(IHX711BankPort &port, int clockPin);
+
+  /**
+   * Adds a channel to the bank, reconfiguring the pins if the bank has already begun.
+   * @param dataPin The channel's data pin.
+   * @return The channel index, or -1 if the bank is full.
+   */
+  int addChannel(int dataPin);
+
+  /**
+   * Configures the pins. Later calls do nothing, so every channel may call it.
+   */
+  void begin();
+
+  /**
+   * Reads a pass if every active channel has a conversion waiting. Never waits.
+   * @return True if a pass was read, false otherwise.
+   */
+  bool poll();
+
+  /**
+   * Checks whether a channel has a conversion that was not taken yet.
+   * @param channel The channel index.
+   * @return True if a conversion is waiting, false otherwise.
+   */
+  [[nodiscard]] bool hasSample(uint8_t channel) const;
+
+  /**
+   * Takes a channel's latest conversion.
+   * @param channel The channel index.
+   * @return The raw 24-bit count, sign-extended.
+   */
+  long takeSample(uint8_t channel);
+
+  /**
+   * Powers down every module in the bank; the shared clock line makes this all or nothing.
+   */
+  void powerDown();
+
+  /**
+   * Powers the bank back up.
+   */
+  void powerUp();
+
+  /**
+   * Returns the number of passes read.
+   * @return The pass count.
+   */
+  [[nodiscard]] unsigned long getPassCount() const;
+
+  /**
+   * Returns the channels a pass currently waits for.
+   * @return Bit i set if channel i is active.
+   */
+  [[nodiscard]] uint8_t getActiveMask() const;
+};
+
+/**
+ * One channel of a ParallelHX711Bank, presented as a scale.
+ *
+ * Checking readiness polls the bank, so whichever channel is updated first in a tick reads the whole bank and the
+ * others find their conversions waiting. Offset and calibration are applied here, as the HX711 library would.
+ * Powering down is a bank-wide operation, so power_down() and power_up() on a single channel do nothing, and
+ * can_power_down() says so.
+ */
+class HX711BankChannel : public IScaleInterface {
+private:
+  ParallelHX711Bank &bank; /**< The bank the channel belongs to. */
+  const int channel;       /**< Channel index in the bank, or -1 if the bank was full. */
+  long offset{0};          /**< Raw count at zero weight. */
+  float scale{1.0F};       /**< Raw counts per unit of weight. */
+
+  /**
+   * Averages fresh conversions, waiting at most SCALE_CONNECTION_TIMEOUT_MS for them.
+   * @param times The number of conversions to average.
+   * @return The average raw count, or the offset if no conversion arrived.
+   */
+  long readAverage(uint8_t times);
+
+public:
+  /**
+   * Constructor for the HX711BankChannel class.
+   * @param bank The bank the channel belongs to.
+   * @param dataPin The channel's data pin.
+   */
+  HX711BankChannel(ParallelHX711Bank &bank, int dataPin);
+
+  void begin() override;
+  bool is_ready() override;
+  void set_scale(float scaleValue) override;
+  void tare(uint8_t times = 1) override;
+  float get_units(uint8_t times = 1) override;
+  void power_down() override;
+  void power_up() override;
+  bool can_power_down() override;
+  long read() override;
+  long get_offset() override;
+  void set_offset(long offsetValue) override;
+  float get_scale() override;
+};
+
+#endif // PARALLEL_HX711_BANK_H
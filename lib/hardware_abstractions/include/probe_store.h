@@ -0,0 +1,15 @@
+#ifndef PROBE_STORE_H
+#define PROBE_STORE_H
+
+#include "block_store.h"
+#include "constants.h"
+#include "thermometer_bus.h"
+
+/**
+ * Keeps the ROM code of the probe at each position on the still across power cycles, one slot per position from
+ * MASH_TUN_THERMOMETER_PROBE to TOP_THERMOMETER_PROBE. The ROM search lists probes by ROM code, so without it a
+ * replaced or added probe could silently take over another's position.
+ */
+using ProbeStore = BlockStore<ProbeAddress, uint8_t, THERMOMETER_PROBE_POSITIONS, 0x524F4D31>; // "ROM1"
+
+#endif // PROBE_STORE_H
@@ -2,28 +2,171 @@
 #define SCALE_H
 
 #include "constants.h"
+#include "hampel_filter.h"
 #include "hardware_interfaces.h"
 #include "logger.h"
+#include "median_filter.h"
+#include "spsc_queue.h"
 
-#include <algorithm>
-#include <array>
+/**
+ * A raw HX711 conversion and the time it became available.
+ */
+struct ScaleSample {
+  unsigned long timeMs; /**< Time the conversion was read, in milliseconds. */
+  long rawCount;        /**< Raw 24-bit count, before tare offset and calibration. */
+};
+
+/**
+ * A filtered weight reading and the time its conversions were taken, for consumers that need to know how old it is.
+ */
+struct ScaleReading {
+  unsigned long timeMs;   /**< Middle of the span of the conversions averaged into the reading, in milliseconds. */
+  float weight;           /**< Weight in grams. */
+  unsigned long sequence; /**< Number of readings up to and including this one; 0 if there is none yet. */
+};
+
+/**
+ * The conversion from raw HX711 counts to weight, as kept in the calibration store.
+ */
+struct ScaleCalibration {
+  long offset; /**< Raw count at zero weight. */
+  float scale; /**< Raw counts per gram. */
+};
+
+/**
+ * Compares two calibrations, so the calibration store can tell when one changed.
+ * @param a The first calibration.
+ * @param b The second calibration.
+ * @return True if both fields are equal, false otherwise.
+ */
+inline bool operator==(const ScaleCalibration &a, const ScaleCalibration &b) {
+  return a.offset == b.offset && a.scale == b.scale;
+}
+
+/**
+ * Steps of bringing a scale online. Scale::serviceConnection() takes at most one step per call and never waits.
+ */
+enum ScaleConnectionState {
+  SCALE_ONLINE,   /**< Connected and tared. */
+  SCALE_BACKOFF,  /**< Waiting out the retry delay after a failed attempt. */
+  SCALE_PROBING,  /**< Waiting for the HX711 to signal its first conversion. */
+  SCALE_SETTLING, /**< Collecting steady conversions for the zero check or tare. */
+};
 
 /**
  * Class for managing a scale.
+ *
+ * Conversions are collected without waiting on the HX711. Where the data pin can raise interrupts, the falling edge
+ * of DOUT clocks the conversion out in the interrupt handler and queues it; otherwise updateWeight() reads a
+ * conversion only if one is already waiting. Either way, updateWeight() just drains the queue into the median filter,
+ * after a Hampel filter has dropped the spikes that vibration and relay switching put on single conversions.
+ * Connecting is equally non-blocking: a scale that is missing or drops out is brought online step by step through
+ * serviceConnection().
  */
 class Scale {
 private:
-  IScaleInterface *scaleInterface;                   /**< Interface for HX711 operations. */
-  std::array<float, READINGS_ARRAY_SIZE> readings{}; /**< Array to store weight readings. */
-  int index{0};                                      /**< Index for the current reading. */
-  bool connected{false};                             /**< Whether the scale is connected and responding. */
-  const int dataPin;                                 /**< Data pin for HX711. */
-  const int clockPin;                                /**< Clock pin for HX711. */
-  Logger *logger = nullptr;                          /**< Logger for recording events. */
+  IScaleInterface *scaleInterface;                         /**< Interface for HX711 operations. */
+  MedianFilter<float, SCALE_MEDIAN_WINDOW> readings;       /**< Median filter over the latest weight readings. */
+  HampelFilter<SCALE_HAMPEL_WINDOW> outliers;              /**< Drops single-conversion spikes before averaging. */
+  SpscQueue<ScaleSample, SCALE_SAMPLE_QUEUE_SIZE> samples; /**< Conversions waiting to be filtered. */
+  bool connected{false};                                   /**< Whether the scale is connected and responding. */
+  bool acquiring{false};                                   /**< Whether conversions are being collected. */
+  bool missedLastUpdate{false};                            /**< Whether the previous update found no conversion. */
+  bool sleeping{false};                                    /**< Whether the HX711 is powered down. */
+  int interruptSlot{-1};                                   /**< Data-ready handler slot, or -1 if polled. */
+  int8_t loggedAcquisitionMode{-1};                        /**< Mode last logged: 1 interrupt, 0 polled, -1 none. */
+  uint8_t averagingDepth{SCALE_AVERAGING_DEPTH};           /**< Conversions averaged per filtered reading. */
+  uint8_t averageCount{0};                                 /**< Conversions in the current average. */
+  long averageSum{0};                                      /**< Sum of the raw counts in the current average. */
+  unsigned long readingCount{0};                           /**< Readings added to the median filter so far. */
+  unsigned long averageStartTime{0};                       /**< Time of the first conversion in the current average. */
+  unsigned long readingTime{0};                            /**< Acquisition time of the newest reading. */
+  unsigned long lastSampleTime{0}; /**< Time of the newest conversion, or of the start of acquisition. */
+  unsigned long readTimeout{SCALE_READ_TIMEOUT_MS}; /**< Silence allowed before the next conversion is missing. */
+  unsigned long reportedDrops{0};  /**< Dropped conversions already logged. */
+  const int dataPin;               /**< Data pin for HX711. */
+  const int clockPin;              /**< Clock pin for HX711. */
+  Logger *logger = nullptr;        /**< Logger for recording events. */
+
+  ScaleConnectionState connectionState{SCALE_PROBING};        /**< Current step of bringing the scale online. */
+  unsigned long stateStartTime{0};                            /**< Time the current step started. */
+  unsigned long reconnectDelay{SCALE_RECONNECT_MIN_DELAY_MS}; /**< Wait before the next attempt. */
+  long tareSum{0};                                            /**< Sum of the conversions collected for the tare. */
+  long tareMin{0};                                            /**< Smallest conversion collected for the tare. */
+  long tareMax{0};                                            /**< Largest conversion collected for the tare. */
+  uint8_t tareCount{0};                                       /**< Conversions collected for the tare. */
+  bool zeroKnown{false};                                      /**< Whether the offset came from a tare or the store. */
+  bool zeroCheckPending{false};                               /**< Whether settling checks the offset, not tares. */
+  bool wasOnline{false};                                      /**< Whether the zero has been confirmed online. */
+  bool zeroMismatch{false};                                   /**< Whether a reconnect found the zero moved. */
+  float calibrationWeight{0.0F};                              /**< Known weight being calibrated to, or 0. */
+
+  static Scale *volatile interruptScales[SCALE_INTERRUPT_SLOTS];   /**< Scale served by each handler slot. */
+  static void (*const dataReadyHandlers[SCALE_INTERRUPT_SLOTS])(); /**< Handler for each slot. */
+
+  /**
+   * Interrupt handler for one slot. attachInterrupt() takes plain functions, so each slot gets its own.
+   * @tparam Slot The handler slot.
+   */
+  template <int Slot> static void dataReadyHandler() {
+    Scale *scale = interruptScales[Slot];
+    if (scale != nullptr) {
+      scale->onDataReady();
+    }
+  }
+
+  /**
+   * Reads a ready conversion into the queue. Runs in interrupt context.
+   */
+  void onDataReady();
+
+  /**
+   * Reads a ready conversion into the queue, for a scale without an interrupt. Runs in task context.
+   */
+  void pollConversion();
+
+  /**
+   * Starts collecting conversions, by interrupt if the data pin supports it and by polling otherwise.
+   */
+  void startAcquisition();
+
+  /**
+   * Sets the calibration factor from the full, settled median window of a calibration, and ends it. The old factor
+   * is kept if the window measures less than SCALE_CALIBRATION_MIN_LOAD of the known weight.
+   */
+  void finishCalibration();
+
+  /**
+   * Stops collecting conversions and discards any that were not filtered yet.
+   */
+  void stopAcquisition();
+
+  /**
+   * Logs whether conversions arrive by interrupt or by polling, if that changed since it was last logged.
+   */
+  void logAcquisitionMode();
+
+  /**
+   * Moves queued conversions into the median filter.
+   * @return True if at least one conversion was moved, false if the queue was empty.
+   */
+  bool drainSamples();
+
+  /**
+   * Collects conversions until enough of them agree, then checks the known zero against them or tares to them.
+   * @return True if the scale came online, false otherwise.
+   */
+  bool settle();
+
+  /**
+   * Gives up on the current attempt and waits reconnectDelay before the next one.
+   */
+  void scheduleReconnect();
 
 public:
   /**
-   * Constructor for the Scale class.
+   * Constructor for the Scale class. Never waits for the HX711: the scale comes online through serviceConnection(),
+   * so a stored calibration can still be restored before its first zero check.
    * @param scaleInterface Interface for HX711 operations.
    * @param dataPin The data pin for the HX711 module.
    * @param clockPin The clock pin for the HX711 module.
@@ -32,8 +175,16 @@ public:
   Scale(IScaleInterface *scaleInterface, int dataPin, int clockPin, Logger *logger = nullptr);
 
   /**
-   * Updates the weight reading.
-   * @return True if weight was successfully updated, false otherwise.
+   * Destructor for the Scale class. Releases the data-ready interrupt, if any.
+   */
+  ~Scale();
+
+  Scale(const Scale &) = delete;
+  Scale &operator=(const Scale &) = delete;
+
+  /**
+   * Folds the conversions collected since the last call into the weight, without waiting for the HX711.
+   * @return False if the scale is disconnected or stopped delivering conversions, true otherwise.
    */
   bool updateWeight();
 
@@ -49,6 +200,13 @@ public:
    */
   [[nodiscard]] float getLastWeight() const;
 
+  /**
+   * Returns the last weight reading together with the time its conversions were taken. The reading may be several
+   * conversions old by the time it is used, so rate estimates should use this time rather than the time of the call.
+   * @return The last reading, stamped with the middle of the span of its averaged conversions.
+   */
+  [[nodiscard]] ScaleReading getLastReading() const;
+
   /**
    * Checks if the scale is connected and responding.
    * @return True if connected, false otherwise.
@@ -56,10 +214,103 @@ public:
   [[nodiscard]] bool isConnected() const;
 
   /**
-   * Attempts to reconnect to the scale.
-   * @return True if successfully reconnected, false otherwise.
+   * Checks if conversions arrive by interrupt rather than by polling.
+   * @return True if the data-ready interrupt is attached, false otherwise.
+   */
+  [[nodiscard]] bool isInterruptDriven() const;
+
+  /**
+   * Returns how many readings have been added to the median filter, so callers can tell when a new one arrived.
+   * @return The number of readings since construction.
+   */
+  [[nodiscard]] unsigned long getReadingCount() const;
+
+  /**
+   * Returns how many conversions the outlier filter has dropped, for diagnostics.
+   * @return The number of dropped spikes since construction.
+   */
+  [[nodiscard]] unsigned long getRejectedCount() const;
+
+  /**
+   * Powers the HX711 down and stops collecting conversions. The filtered weight is kept.
+   * Does nothing if the interface cannot power down, as for a channel of a parallel bank.
+   */
+  void sleep();
+
+  /**
+   * Powers the HX711 back up. Conversions are collected again from the next update, and the first one is given
+   * SCALE_WAKE_SETTLE_MS on top of the read timeout while the HX711 settles.
+   */
+  void wake();
+
+  /**
+   * Checks if the HX711 is powered down.
+   * @return True if the scale is asleep, false otherwise.
+   */
+  [[nodiscard]] bool isSleeping() const;
+
+  /**
+   * Sets how many conversions are averaged into each reading of the median filter.
+   * Averaging happens as conversions arrive, so a deeper average delays readings but never blocks.
+   * @param depth The number of conversions per reading; 0 is treated as 1.
+   */
+  void setAveragingDepth(uint8_t depth);
+
+  /**
+   * Returns how many conversions are averaged into each reading.
+   * @return The averaging depth.
+   */
+  [[nodiscard]] uint8_t getAveragingDepth() const;
+
+  /**
+   * Advances a disconnected scale towards being online by at most one step, without waiting for the HX711.
+   * Failed attempts are retried after a delay that doubles each time, from SCALE_RECONNECT_MIN_DELAY_MS up to
+   * SCALE_RECONNECT_MAX_DELAY_MS. The zero check or tare uses the scale's own conversions once they hold steady.
+   * @return True if the scale came online during this call, false otherwise.
+   */
+  bool serviceConnection();
+
+  /**
+   * Applies a stored calibration. The stored zero is then confirmed with SCALE_ZERO_CHECK_CONVERSIONS conversions
+   * when the scale first comes online, and replaced by a full tare only if the vessel weight has moved away from it.
+   * Later reconnects keep the zero either way; see hasZeroMismatch().
+   * @param calibration The stored offset and calibration factor.
+   */
+  void restoreCalibration(const ScaleCalibration &calibration);
+
+  /**
+   * Starts calibrating against a known weight placed on the scale. The median window is refilled with readings of
+   * the weight until they settle within SCALE_CALIBRATION_MAX_SPREAD, and the calibration factor is then set so that
+   * their median reads as the known weight. Until then getWeight() only covers the readings taken since the start.
+   * @param knownWeight The weight on the scale in grams, at least SCALE_CALIBRATION_MIN_WEIGHT.
+   * @return True if the calibration started, false if the scale is offline or the weight is too light.
+   */
+  bool startCalibration(float knownWeight);
+
+  /**
+   * Checks whether a calibration is still collecting readings. A scale that goes offline abandons its calibration.
+   * @return True until the calibration factor has been set or abandoned, false otherwise.
+   */
+  [[nodiscard]] bool isCalibrating() const;
+
+  /**
+   * Returns the offset and calibration factor in use, for the calibration store.
+   * @return The current calibration.
+   */
+  [[nodiscard]] ScaleCalibration getCalibration() const;
+
+  /**
+   * Returns the current step of bringing the scale online.
+   * @return SCALE_ONLINE once connected and tared.
+   */
+  [[nodiscard]] ScaleConnectionState getConnectionState() const;
+
+  /**
+   * Tells whether the scale came back from a reconnect away from its zero. The vessel may have been filled by then,
+   * so the zero it had is kept rather than tared to the load.
+   * @return True if the last zero check after a reconnect failed, false otherwise.
    */
-  bool tryReconnect();
+  [[nodiscard]] bool hasZeroMismatch() const;
 };
 
-#endif // SCALE_H
\ No newline at end of file
+#endif // SCALE_H
@@ -2,169 +2,100 @@
 #define THERMOMETER_H
 
 #include "constants.h"
-
-#include <algorithm>
-#include <array>
-#include <memory> // Required for std::shared_ptr
-#if __cplusplus >= 202002L
-#include <ranges>
-#endif
-
-#ifdef UNIT_TEST
-#include <gmock/gmock.h>
-
-// Mock classes for OneWire and DallasTemperature
-class MockOneWire {
-public:
-  MOCK_METHOD(void, begin, (), ());
-  MOCK_METHOD(uint8_t, reset, (), ());
-  MOCK_METHOD(void, select, (const uint8_t *), ());
-  MOCK_METHOD(void, write, (uint8_t), ());
-  MOCK_METHOD(void, write_bytes, (const uint8_t *, uint16_t), ());
-  MOCK_METHOD(uint8_t, read, (), ());
-  MOCK_METHOD(void, read_bytes, (uint8_t *, uint16_t), ());
-};
-
-class MockDallasTemperature {
-public:
-  MOCK_METHOD(void, begin, (), ());
-  MOCK_METHOD(void, requestTemperatures, (), ());
-  MOCK_METHOD(float, getTempCByIndex, (uint8_t), ());
-};
-
-#elif defined(UNIT_TEST)
-// For unit tests, we'll use the mocks defined above
-#elif defined(NATIVE)
-// For native builds, we'll provide a minimal implementation
-class OneWire {
-public:
-  OneWire(int pin) {}
-  void begin() {}
-  uint8_t reset() { return 1; }
-  void select(const uint8_t *addr) {}
-  void write(uint8_t v) {}
-  void write_bytes(const uint8_t *buf, uint16_t count) {}
-  uint8_t read() { return 0; }
-  void read_bytes(uint8_t *buf, uint16_t count) {}
-};
-
-class DallasTemperature {
-public:
-  DallasTemperature(OneWire *wire) {}
-  void begin() {}
-  void requestTemperatures() {}
-  float getTempCByIndex(uint8_t index) { return 20.0f; }
-};
-#else
-// Use angle brackets for library includes - for production build
-#include <DallasTemperature.h>
-#include <OneWire.h>
-#endif
+#include "fixed_point_temperature.h"
+#include "median_filter.h"
+#include "thermometer_bus.h"
+#include "trend_estimator.h"
 
 /**
  * Class for managing a thermometer.
+ *
+ * Each thermometer is one probe on a shared ThermometerBus. The bus starts conversions for all probes at once;
+ * collectTemperature() then reads this probe's scratchpad once the conversion has finished, so the control loop
+ * never waits for the sensor. Readings stay in raw 1/16 °C steps through the median filter and the trend
+ * estimator; the float getters convert only at the display and log edges.
  */
 class Thermometer {
 private:
-#ifdef UNIT_TEST
-  std::shared_ptr<MockOneWire> oneWire;
-  std::shared_ptr<MockDallasTemperature> sensors;
-#else
-  OneWire oneWire;           /**< OneWire object for communication. */
-  DallasTemperature sensors; /**< DallasTemperature object for temperature sensing. */
-#endif
-  std::array<float, READINGS_ARRAY_SIZE> readings{}; /**< Array to store temperature readings. */
-  int index{0};                                      /**< Index for the current reading. */
-  float lastMedian{0.0F};                            /**< Last calculated median temperature. */
-  int readingsCount{0};                              /**< Number of valid temperature readings stored. */
+  ThermometerBus &bus;                /**< Bus the probe is connected to. */
+  uint8_t probe;                      /**< Index of the probe on the bus. */
+  unsigned long collectedSequence{0}; /**< Sequence number of the last conversion collected. */
+  unsigned long readingCount{0};      /**< Number of valid readings stored so far. */
+  unsigned long readingTime{0};       /**< Acquisition time of the newest reading. */
+  MedianFilter<RawTemperature, THERMOMETER_MEDIAN_WINDOW> readings; /**< Median filter over the latest readings. */
+  TrendEstimator<RawTemperature, THERMOMETER_TREND_WINDOW> trend;   /**< Least-squares trend over the readings. */
 
-public:
-#ifdef UNIT_TEST
-  // Constructor for the test environment
-  explicit Thermometer(std::shared_ptr<MockOneWire> ow, std::shared_ptr<MockDallasTemperature> ds)
-    : oneWire(std::move(ow)), sensors(std::move(ds)) {
-    for (float &reading : readings) {
-      reading = 0.0F;
-    }
-  }
+  /**
+   * Stores a new reading in the median filter and the trend estimator.
+   * @param temperature The temperature reading in 1/16 °C steps.
+   * @param timeMs The time the probe sampled the temperature, in milliseconds.
+   */
+  void addReading(RawTemperature temperature, unsigned long timeMs);
 
-  // Method to set lastMedian for testing purposes
-  void setLastMedian(float median) { lastMedian = median; }
-#else
+public:
   /**
    * Constructor for the Thermometer class.
-   * @param pin The pin number for the thermometer sensor.
+   * @param bus The bus the probe is connected to.
+   * @param probe The index of the probe on the bus.
+   */
+  Thermometer(ThermometerBus &bus, uint8_t probe);
+
+  /**
+   * Reads the result of the bus's last conversion into the median filter as soon as this probe has finished.
+   * @return True if a new reading was stored, false if no new valid result was available.
+   */
+  bool collectTemperature();
+
+  /**
+   * Returns the slope of the least-squares line through the trend window.
+   * @return The temperature trend in degrees Celsius per minute.
+   */
+  [[nodiscard]] float getTemperatureSlope() const;
+
+  /**
+   * Returns the variance of the readings around the trend line, a measure of sensor and column noise.
+   * @return The residual variance in squared degrees Celsius.
    */
-  explicit Thermometer(int pin) : oneWire(pin), sensors(&oneWire) {
-    sensors.begin();
-    for (float &reading : readings) {
-      reading = 0.0F;
-    }
-  }
-#endif
+  [[nodiscard]] float getTemperatureNoise() const;
 
   /**
-   * Updates the temperature reading.
+   * Checks whether the temperature is rising faster than a given rate.
+   * The rise only counts once the trend window is full and the slope exceeds the threshold by
+   * TEMPERATURE_TREND_CONFIDENCE_SIGMAS standard errors, so noise alone does not trigger it.
+   * @param slopeThreshold The rate of rise to check against, in degrees Celsius per minute.
+   * @return True if a rise faster than the threshold is detected, false otherwise.
    */
-  void updateTemperature() {
-#ifdef UNIT_TEST
-    sensors->requestTemperatures();
-    // Update the last median before adding the new reading
-    if (readingsCount == READINGS_ARRAY_SIZE) {
-      lastMedian = getTemperature();
-    }
-    readings[index] = sensors->getTempCByIndex(0); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-#else
-    sensors.requestTemperatures();
-    // Update the last median before adding the new reading
-    if (readingsCount == READINGS_ARRAY_SIZE) {
-      lastMedian = getTemperature();
-    }
-    readings[index] = sensors.getTempCByIndex(0); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-#endif
-    index = (index + 1) % READINGS_ARRAY_SIZE;
-    readingsCount =
-        std::min(readingsCount + 1, READINGS_ARRAY_SIZE); // Don't let readingsCount exceed READINGS_ARRAY_SIZE
-  }
+  [[nodiscard]] bool isTemperatureRising(float slopeThreshold) const;
 
   /**
-   * Checks if there is a sudden temperature increase beyond a given threshold.
-   * @param threshold The temperature increase threshold to check against.
-   * @return True if a sudden temperature increase beyond the threshold is detected, false otherwise.
+   * Returns the current temperature in raw steps, for threshold comparisons in the control loop.
+   * @return The median temperature in 1/16 °C steps.
    */
-  [[nodiscard]] bool isSuddenTemperatureIncrease(float threshold) const {
-    if (readingsCount < READINGS_ARRAY_SIZE) {
-      return false; // Not enough readings to calculate the median
-    }
-    float currentMedian = getTemperature();
-    float difference = currentMedian - lastMedian;
-    return difference > threshold + TEMPERATURE_COMPARISON_TOLERANCE;
-  }
+  [[nodiscard]] RawTemperature getRawTemperature() const;
 
   /**
    * Returns the current temperature.
    * @return The current temperature in degrees Celsius.
    */
-  [[nodiscard]] float getTemperature() const {
-    std::array<float, READINGS_ARRAY_SIZE> sortedReadings{};
-#if __cplusplus >= 202002L
-    std::ranges::copy(readings, sortedReadings.begin());
-    std::ranges::sort(sortedReadings);
-#else
-    std::copy(readings.begin(), readings.end(), sortedReadings.begin()); // NOLINT(modernize-use-ranges)
-    std::sort(sortedReadings.begin(), sortedReadings.end());             // NOLINT(modernize-use-ranges)
-#endif
-    return sortedReadings[READINGS_ARRAY_MIDDLE_INDEX]; // return the median
-  }
+  [[nodiscard]] float getTemperature() const;
+
+  /**
+   * Returns the number of valid readings stored so far, so consumers can tell when a new reading arrived.
+   * @return The reading count.
+   */
+  [[nodiscard]] unsigned long getReadingCount() const;
+
+  /**
+   * Returns when the newest reading was acquired, which is when its conversion started rather than when it was read.
+   * @return The acquisition time in milliseconds.
+   */
+  [[nodiscard]] unsigned long getReadingTime() const;
 
   /**
    * Returns the last temperature reading.
    * @return The last temperature reading in degrees Celsius.
    */
-  [[nodiscard]] float getLastTemperature() const {
-    int lastIndex = (index - 1 + READINGS_ARRAY_SIZE) % READINGS_ARRAY_SIZE; // calculate the index of the last reading
-    return readings[lastIndex]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-  }
+  [[nodiscard]] float getLastTemperature() const;
 };
 
 #endif // THERMOMETER_H
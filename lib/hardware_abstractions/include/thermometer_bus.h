@@ -0,0 +1,279 @@
+#ifndef THERMOMETER_BUS_H
+#define THERMOMETER_BUS_H
+
+#include "constants.h"
+#include "fixed_point_temperature.h"
+#include "logger.h"
+
+#include <array>
+#include <cstdint>
+#include <memory> // Required for std::shared_ptr
+
+#ifndef UNIT_TEST
+#include "Arduino.h"
+#else
+// Conversion timing relies on millis(); the mock implementation lives in the test files
+#include "mock_arduino.h"
+#endif
+
+#ifdef UNIT_TEST
+#include <gmock/gmock.h>
+
+// Mock classes for OneWire and DallasTemperature
+class MockOneWire {
+public:
+  MOCK_METHOD(void, begin, (), ());
+  MOCK_METHOD(uint8_t, reset, (), ());
+  MOCK_METHOD(void, select, (const uint8_t *), ());
+  MOCK_METHOD(void, write, (uint8_t), ());
+  MOCK_METHOD(void, write_bytes, (const uint8_t *, uint16_t), ());
+  MOCK_METHOD(uint8_t, read, (), ());
+  MOCK_METHOD(void, read_bytes, (uint8_t *, uint16_t), ());
+};
+
+class MockDallasTemperature {
+public:
+  MOCK_METHOD(void, begin, (), ());
+  MOCK_METHOD(uint8_t, getDeviceCount, (), ());
+  MOCK_METHOD(bool, getAddress, (uint8_t *, uint8_t), ());
+  MOCK_METHOD(uint8_t, getResolution, (const uint8_t *), ());
+  MOCK_METHOD(void, setWaitForConversion, (bool), ());
+  MOCK_METHOD(void, requestTemperatures, (), ());
+  MOCK_METHOD(int32_t, getTemp, (const uint8_t *), ());
+};
+
+constexpr int32_t DEVICE_DISCONNECTED_RAW = -7040;
+#elif defined(NATIVE)
+#include <MockSensors.h>
+
+// For native builds, we'll provide a minimal implementation, with the temperatures set in MockSensors
+class OneWire {
+public:
+  OneWire(int pin) {}
+  void begin() {}
+  uint8_t reset() { return 1; }
+  void select(const uint8_t *addr) {}
+  void write(uint8_t v) {}
+  void write_bytes(const uint8_t *buf, uint16_t count) {}
+  uint8_t read() { return 0; }
+  void read_bytes(uint8_t *buf, uint16_t count) {}
+};
+
+class DallasTemperature {
+public:
+  DallasTemperature(OneWire *wire) {}
+  void begin() {}
+  uint8_t getDeviceCount() { return 4; }
+  bool getAddress(uint8_t *address, uint8_t index) {
+    address[0] = index;
+    return true;
+  }
+  uint8_t getResolution(const uint8_t *address) { return 12; }
+  void setWaitForConversion(bool wait) {}
+  void requestTemperatures() {}
+  int32_t getTemp(const uint8_t *address) {
+    return MockSensors::probeTemperatures[address[0] % MockSensors::PROBE_COUNT];
+  }
+};
+
+constexpr int32_t DEVICE_DISCONNECTED_RAW = -7040;
+#else
+// Use angle brackets for library includes - for production build
+#include <DallasTemperature.h>
+#include <OneWire.h>
+#endif
+
+constexpr uint8_t ONE_WIRE_ADDRESS_SIZE = 8; /**< Size of a 1-Wire ROM code in bytes. */
+constexpr int32_t DALLAS_RAW_PER_STEP = 8;   /**< DallasTemperature reports 1/128 °C, eight per register step. */
+
+constexpr uint8_t DS18B20_WRITE_SCRATCHPAD = 0x4E;     /**< Writes TH, TL and the configuration register. */
+constexpr uint8_t DS18B20_ALARM_HIGH = 0x7D;           /**< TH at +125 °C, so the alarm never trips. */
+constexpr uint8_t DS18B20_ALARM_LOW = 0xC9;            /**< TL at -55 °C, so the alarm never trips. */
+constexpr uint8_t DS18B20_RESOLUTION_SHIFT = 5;        /**< Position of R0 in the configuration register. */
+constexpr uint8_t DS18B20_CONFIG_RESERVED_BITS = 0x1F; /**< Low bits of the configuration register, which read 1. */
+
+/**
+ * ROM code of a probe, which identifies it whatever its place in the ROM search.
+ */
+struct ProbeAddress {
+  std::array<uint8_t, ONE_WIRE_ADDRESS_SIZE> bytes; /**< The ROM code, family byte first. */
+
+  bool operator==(const ProbeAddress &other) const { return bytes == other.bytes; }
+};
+
+/**
+ * Returns the worst-case conversion time of a DS18B20 at the given resolution.
+ * Each bit of resolution below 12 halves the conversion time (750, 375, 188 and 94 ms).
+ * @param resolution The resolution in bits (9-12).
+ * @return The conversion time in milliseconds.
+ */
+constexpr unsigned long ds18b20ConversionTimeMs(uint8_t resolution) {
+  return resolution >= DS18B20_MAX_RESOLUTION_BITS
+             ? DS18B20_CONVERSION_TIME_MS
+             : (DS18B20_CONVERSION_TIME_MS + (1UL << (DS18B20_MAX_RESOLUTION_BITS - resolution)) - 1) >>
+                   (DS18B20_MAX_RESOLUTION_BITS - resolution);
+}
+
+/**
+ * Class for driving every DS18B20 probe on a single multi-drop 1-Wire bus.
+ *
+ * The ROM search runs once in begin() and the address of each probe is cached, so reading a probe never
+ * re-enumerates the bus. A single Skip-ROM convert starts a conversion on every probe at once, and each
+ * scratchpad is then read directly by its cached address.
+ *
+ * The search lists probes in ROM code order, which says nothing about where each probe sits on the still, so
+ * bindProbe() moves each probe to the index of its position by its ROM code.
+ */
+class ThermometerBus {
+private:
+#ifdef UNIT_TEST
+  std::shared_ptr<MockOneWire> oneWire;
+  std::shared_ptr<MockDallasTemperature> sensors;
+#else
+  OneWire oneWire;           /**< OneWire object for communication. */
+  DallasTemperature sensors; /**< DallasTemperature object for temperature sensing. */
+#endif
+  std::array<std::array<uint8_t, ONE_WIRE_ADDRESS_SIZE>, MAX_THERMOMETER_PROBES>
+      addresses{};                                               /**< ROM codes of the probes, by index. */
+  std::array<uint8_t, MAX_THERMOMETER_PROBES> resolutions{};     /**< Current resolution of each probe in bits. */
+  unsigned long cycleTimeMs{DS18B20_CONVERSION_TIME_MS};        /**< Conversion time of the slowest probe. */
+  unsigned long pendingCycleTimeMs{DS18B20_CONVERSION_TIME_MS}; /**< Cycle time of the last conversion started. */
+  uint8_t probeCount{0};                                         /**< Number of probes found by the ROM search. */
+  bool conversionStarted{false};                                 /**< Whether a conversion has ever been started. */
+  unsigned long conversionStartTime{0}; /**< Time at which the last conversion was started. */
+  unsigned long conversionSequence{0}; /**< Incremented on every conversion, lets readers skip stale results. */
+  Logger *logger = nullptr;            /**< Logger for recording events. */
+
+  /**
+   * Recomputes the cycle time from the resolutions of all probes.
+   */
+  void updateCycleTime();
+
+  /**
+   * Writes a resolution to a probe's configuration register, in the scratchpad only.
+   * DallasTemperature::setResolution() also copies the scratchpad to EEPROM and waits 20 ms for the copy, on every
+   * call. The EEPROM keeps the resolution the probe started with, which begin() reads back after a power cycle.
+   * @param probe The index of the probe on the bus.
+   * @param resolution The resolution in bits (9-12).
+   * @return True if a probe answered the reset pulse, false otherwise.
+   */
+  bool writeConfiguration(uint8_t probe, uint8_t resolution);
+
+public:
+#ifdef UNIT_TEST
+  // Constructor for the test environment
+  ThermometerBus(std::shared_ptr<MockOneWire> ow, std::shared_ptr<MockDallasTemperature> ds,
+                 Logger *logger = nullptr);
+#else
+  /**
+   * Constructor for the ThermometerBus class.
+   * @param pin The pin number of the 1-Wire bus.
+   * @param logger Pointer to the logger instance (optional).
+   */
+  explicit ThermometerBus(int pin, Logger *logger = nullptr);
+#endif
+
+  /**
+   * Searches the bus and caches the address of every probe found.
+   * @return The number of probes found.
+   */
+  uint8_t begin();
+
+  /**
+   * Returns the number of probes found by the ROM search.
+   * @return The number of probes on the bus.
+   */
+  [[nodiscard]] uint8_t getProbeCount() const;
+
+  /**
+   * Returns the ROM code of a probe.
+   * @param probe The index of the probe on the bus.
+   * @return The ROM code, or all zeros for an unknown probe.
+   */
+  [[nodiscard]] ProbeAddress getAddress(uint8_t probe) const;
+
+  /**
+   * Moves the probe with a ROM code to an index, swapping it with the probe there. Bind indices in ascending order:
+   * the probes below the index count as bound already and are not searched.
+   * @param probe The index the probe is to have.
+   * @param address The ROM code of the probe.
+   * @return True if the probe is now at the index, false if no unbound probe on the bus has the ROM code.
+   */
+  bool bindProbe(uint8_t probe, const ProbeAddress &address);
+
+  /**
+   * Starts a conversion on every probe with a single Skip-ROM command, without waiting for it to finish.
+   */
+  void requestConversion();
+
+  /**
+   * Checks whether a conversion has been started and is still running.
+   * @return True if a conversion is in progress, false otherwise.
+   */
+  [[nodiscard]] bool isConversionPending() const;
+
+  /**
+   * Checks whether the last conversion has had enough time to finish on every probe.
+   * @return True if all scratchpads hold the results of the last conversion, false otherwise.
+   */
+  [[nodiscard]] bool isConversionComplete() const;
+
+  /**
+   * Checks whether the last conversion has had enough time to finish on one probe.
+   * Low-resolution probes finish first and can be read before the rest of the bus.
+   * @param probe The index of the probe on the bus.
+   * @return True if the probe's scratchpad holds the result of the last conversion, false otherwise.
+   */
+  [[nodiscard]] bool isConversionComplete(uint8_t probe) const;
+
+  /**
+   * Reprograms the resolution in a probe's configuration register, without copying it to EEPROM.
+   * The register is only written between conversions and only when the resolution actually changes.
+   * @param probe The index of the probe on the bus.
+   * @param resolution The new resolution in bits (9-12).
+   * @return True if the probe is now at the requested resolution, false otherwise.
+   */
+  bool setResolution(uint8_t probe, uint8_t resolution);
+
+  /**
+   * Returns the current resolution of a probe.
+   * @param probe The index of the probe on the bus.
+   * @return The resolution in bits, or 0 for an unknown probe.
+   */
+  [[nodiscard]] uint8_t getResolution(uint8_t probe) const;
+
+  /**
+   * Returns the conversion time of a probe at its current resolution.
+   * @param probe The index of the probe on the bus.
+   * @return The conversion time in milliseconds.
+   */
+  [[nodiscard]] unsigned long getConversionTimeMs(uint8_t probe) const;
+
+  /**
+   * Returns the length of one conversion cycle, set by the slowest probe on the bus.
+   * @return The conversion time of the slowest probe in milliseconds.
+   */
+  [[nodiscard]] unsigned long getCycleTimeMs() const;
+
+  /**
+   * Returns the sequence number of the last conversion.
+   * @return The number of conversions started so far.
+   */
+  [[nodiscard]] unsigned long getConversionSequence() const;
+
+  /**
+   * Returns when the last conversion was started. Every probe samples its temperature from then on, so this is the
+   * acquisition time of the results, however late they are read.
+   * @return The start time of the last conversion in milliseconds.
+   */
+  [[nodiscard]] unsigned long getConversionStartTime() const;
+
+  /**
+   * Reads the scratchpad of a probe by its cached address, without any floating-point conversion.
+   * @param probe The index of the probe on the bus.
+   * @return The temperature in 1/16 °C steps, or DISCONNECTED_RAW_TEMPERATURE if the probe could not be read.
+   */
+  RawTemperature readRawTemperature(uint8_t probe);
+};
+
+#endif // THERMOMETER_BUS_H
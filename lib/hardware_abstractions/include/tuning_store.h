@@ -0,0 +1,24 @@
+#ifndef TUNING_STORE_H
+#define TUNING_STORE_H
+
+#include "block_store.h"
+#include "relay_autotuner.h"
+
+/**
+ * Control loops whose gains the tuning store keeps.
+ */
+enum TuningLoop {
+  FLOW_TUNING_LOOP,   /**< Main valve against the measured flow rate. */
+  HEATER_TUNING_LOOP, /**< Heater against the column temperature. */
+  TUNING_LOOP_COUNT,  /**< Number of loops; not a loop. */
+};
+
+/**
+ * Keeps the autotuned PID gains of each control loop across power cycles.
+ *
+ * The gains belong to the still rather than to the firmware, so they sit on the still's own SD card next to the
+ * scale calibrations, in a block of their own.
+ */
+using TuningStore = BlockStore<PidTuning, TuningLoop, TUNING_LOOP_COUNT, 0x50494431>; // "PID1"
+
+#endif // TUNING_STORE_H
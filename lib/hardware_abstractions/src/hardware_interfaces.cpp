@@ -10,6 +10,7 @@
 #include <HX711.h>   // Real HX711.h from library
 #include <SD.h>      // Real SD.h from framework
 #include <SPI.h>     // Real SPI.h from framework
+#include <constants.h>
 
 // ArduinoSerialInterface implementations for production
 void ArduinoSerialInterface::begin(unsigned long baud) { Serial.begin(baud); }
@@ -24,6 +25,8 @@ size_t ArduinoSerialInterface::println(float val, int format) { return Serial.pr
 
 bool ArduinoSerialInterface::available() { return Serial.available() > 0; }
 
+int ArduinoSerialInterface::read() { return Serial.read(); }
+
 // ArduinoSDInterface implementations for production
 bool ArduinoSDInterface::begin(uint8_t csPin) { return SD.begin(csPin); }
 
@@ -33,6 +36,12 @@ bool ArduinoSDInterface::exists(const char *filename) { return SD.exists(filenam
 
 bool ArduinoSDInterface::mkdir(const char *filename) { return SD.mkdir(filename); }
 
+namespace {
+constexpr uint8_t HX711_DATA_BITS = 24;
+constexpr uint8_t HX711_GAIN_128_PULSES = 1;
+constexpr long HX711_SIGN_BIT = 0x800000L;
+} // namespace
+
 // HX711ScaleInterface implementations for production
 HX711ScaleInterface::HX711ScaleInterface(int dout, int sck) : dataPin(dout), clockPin(sck) {
   // Create a new HX711 object
@@ -60,11 +69,172 @@ void HX711ScaleInterface::power_down() { static_cast<HX711 *>(scalePtr)->power_d
 
 void HX711ScaleInterface::power_up() { static_cast<HX711 *>(scalePtr)->power_up(); }
 
+long HX711ScaleInterface::read() { return static_cast<HX711 *>(scalePtr)->read(); }
+
+// Clocks out a waiting conversion. Outside the data-ready interrupt, another scale's handler could fire while the
+// clock is high and hold it there past 60 µs, so each high phase is masked, as HX711::read() did
+static long clockOutConversion(int dataPin, int clockPin, bool maskInterrupts) {
+  long value = 0;
+  for (uint8_t bit = 0; bit < HX711_DATA_BITS; bit++) {
+    if (maskInterrupts) {
+      noInterrupts();
+    }
+    digitalWrite(clockPin, HIGH);
+    delayMicroseconds(1);
+    value = (value << 1) | (digitalRead(dataPin) == HIGH ? 1L : 0L);
+    digitalWrite(clockPin, LOW);
+    if (maskInterrupts) {
+      interrupts();
+    }
+    delayMicroseconds(1);
+  }
+  // The pulses after the data select channel A at gain 128 for the next conversion, as HX711::begin() does
+  for (uint8_t pulse = 0; pulse < HX711_GAIN_128_PULSES; pulse++) {
+    if (maskInterrupts) {
+      noInterrupts();
+    }
+    digitalWrite(clockPin, HIGH);
+    delayMicroseconds(1);
+    digitalWrite(clockPin, LOW);
+    if (maskInterrupts) {
+      interrupts();
+    }
+    delayMicroseconds(1);
+  }
+  return (value ^ HX711_SIGN_BIT) - HX711_SIGN_BIT;
+}
+
+long HX711ScaleInterface::readReadyConversion() {
+  // HX711::read() waits for DOUT and re-enables interrupts when done, so clock the bits out here instead
+  return clockOutConversion(dataPin, clockPin, false);
+}
+
+long HX711ScaleInterface::readPolledConversion() { return clockOutConversion(dataPin, clockPin, true); }
+
+long HX711ScaleInterface::get_offset() { return static_cast<HX711 *>(scalePtr)->get_offset(); }
+
+void HX711ScaleInterface::set_offset(long offset) { static_cast<HX711 *>(scalePtr)->set_offset(offset); }
+
+float HX711ScaleInterface::get_scale() { return static_cast<HX711 *>(scalePtr)->get_scale(); }
+
+// Checks whether a pin is wired to the external interrupt controller
+static bool canInterrupt(int pin) {
+#if defined(ARDUINO_ARCH_SAMD)
+  // digitalPinToInterrupt() is the identity on SAMD, so ask the pin table instead
+  return g_APinDescription[pin].ulExtInt != NOT_AN_INTERRUPT;
+#else
+  return digitalPinToInterrupt(pin) != NOT_AN_INTERRUPT;
+#endif
+}
+
+bool HX711ScaleInterface::attachDataReadyInterrupt(void (*handler)()) {
+  if (!canInterrupt(dataPin)) {
+    return false;
+  }
+  attachInterrupt(digitalPinToInterrupt(dataPin), handler, FALLING);
+  return true;
+}
+
+void HX711ScaleInterface::detachDataReadyInterrupt() {
+  if (canInterrupt(dataPin)) {
+    detachInterrupt(digitalPinToInterrupt(dataPin));
+  }
+}
+
+// ArduinoHX711BankPort implementations for production
+void ArduinoHX711BankPort::begin(int clock, const int *dataPins, uint8_t count) {
+  clockPin = clock;
+  channelCount = count < MAX_CHANNELS ? count : MAX_CHANNELS;
+  registerCount = 0;
+  pinMode(clockPin, OUTPUT);
+  digitalWrite(clockPin, LOW);
+
+  for (uint8_t i = 0; i < channelCount; i++) {
+    pinMode(dataPins[i], INPUT);
+    const volatile uint32_t *inputRegister = portInputRegister(digitalPinToPort(dataPins[i]));
+    uint8_t index = 0;
+    while (index < registerCount && registers[index] != inputRegister) {
+      index++;
+    }
+    if (index == registerCount) {
+      registers[registerCount++] = inputRegister;
+    }
+    channelRegisters[i] = index;
+    channelMasks[i] = digitalPinToBitMask(dataPins[i]);
+  }
+}
+
+uint8_t ArduinoHX711BankPort::sample() {
+  uint32_t values[MAX_CHANNELS];
+  for (uint8_t i = 0; i < registerCount; i++) {
+    values[i] = *registers[i];
+  }
+  uint8_t bits = 0;
+  for (uint8_t i = 0; i < channelCount; i++) {
+    if ((values[channelRegisters[i]] & channelMasks[i]) != 0) {
+      bits |= static_cast<uint8_t>(1U << i);
+    }
+  }
+  return bits;
+}
+
+uint8_t ArduinoHX711BankPort::readDataPins() { return sample(); }
+
+uint8_t ArduinoHX711BankPort::pulseClock() {
+  // An interrupt while the clock is high could stretch the pulse past 60 µs and power the bank down
+  noInterrupts();
+  digitalWrite(clockPin, HIGH);
+  delayMicroseconds(1);
+  uint8_t bits = sample();
+  digitalWrite(clockPin, LOW);
+  interrupts();
+  delayMicroseconds(1);
+  return bits;
+}
+
+void ArduinoHX711BankPort::setClock(bool high) { digitalWrite(clockPin, high ? HIGH : LOW); }
+
+// ArduinoBlockStorage implementations for production
+bool ArduinoBlockStorage::read(uint8_t *data, size_t size) {
+  File file = SD.open(fileName, FILE_READ);
+  if (!file) {
+    return false;
+  }
+  size_t count = file.read(data, size);
+  file.close();
+  return count == size;
+}
+
+bool ArduinoBlockStorage::write(const uint8_t *data, size_t size) {
+  // FILE_WRITE appends to an existing file, so the old block is removed first
+  SD.remove(fileName);
+  File file = SD.open(fileName, FILE_WRITE);
+  if (!file) {
+    return false;
+  }
+  size_t count = file.write(data, size);
+  file.close();
+  return count == size;
+}
+
+// ArduinoRecipeStorage implementation for production
+size_t ArduinoRecipeStorage::read(char *buffer, size_t capacity) {
+  File file = SD.open(fileName, FILE_READ);
+  if (!file) {
+    return 0;
+  }
+  size_t count = file.read(reinterpret_cast<uint8_t *>(buffer), capacity);
+  file.close();
+  return count;
+}
+
 #else
 // For test/native environments, we use mock implementations
 // We include the Arduino mock header for test/native builds
 #include <Arduino.h> // This will be the mock Arduino.h
 
+#include <cstdio>
+
 // ArduinoSerialInterface implementations for test/native
 void ArduinoSerialInterface::begin(unsigned long baud) {
   // In the mock environment, we don't need to do anything real
@@ -72,23 +242,23 @@ void ArduinoSerialInterface::begin(unsigned long baud) {
 }
 
 size_t ArduinoSerialInterface::print(const char *str) {
-  // For mocks, just return the length that would have been printed
-  return strlen(str);
+  // The host's standard output stands in for the serial monitor
+  return static_cast<size_t>(printf("%s", str));
 }
 
 size_t ArduinoSerialInterface::println(const char *str) {
-  // For mocks, return length + 2 for CR+LF
-  return strlen(str) + 2;
+  // As print(), ending the line
+  return static_cast<size_t>(printf("%s\n", str));
 }
 
 size_t ArduinoSerialInterface::print(float val, int format) {
-  // For mocks, return a reasonable size
-  return 10;
+  // Printed with format decimals, as the Arduino core does
+  return static_cast<size_t>(printf("%.*f", format, static_cast<double>(val)));
 }
 
 size_t ArduinoSerialInterface::println(float val, int format) {
-  // For mocks, return a reasonable size + 2 for CR+LF
-  return 12;
+  // As print(float), ending the line
+  return static_cast<size_t>(printf("%.*f\n", format, static_cast<double>(val)));
 }
 
 bool ArduinoSerialInterface::available() {
@@ -96,6 +266,11 @@ bool ArduinoSerialInterface::available() {
   return false;
 }
 
+int ArduinoSerialInterface::read() {
+  // For mocks, there is nothing to read
+  return -1;
+}
+
 // ArduinoSDInterface mock implementations for test/native
 bool ArduinoSDInterface::begin(uint8_t csPin) {
   // Mock always succeeds
@@ -161,6 +336,82 @@ void HX711ScaleInterface::power_up() {
   scale.powerUp();
 }
 
+long HX711ScaleInterface::read() {
+  // Use the mock read method
+  return scale.read();
+}
+
+long HX711ScaleInterface::readReadyConversion() {
+  // The mock read never waits
+  return scale.read();
+}
+
+long HX711ScaleInterface::readPolledConversion() {
+  // The mock read never waits
+  return scale.read();
+}
+
+long HX711ScaleInterface::get_offset() {
+  // Use the mock get_offset method
+  return scale.get_offset();
+}
+
+void HX711ScaleInterface::set_offset(long offset) {
+  // Use the mock set_offset method
+  scale.set_offset(offset);
+}
+
+float HX711ScaleInterface::get_scale() {
+  // Use the mock get_scale method
+  return scale.get_scale();
+}
+
+bool HX711ScaleInterface::attachDataReadyInterrupt(void (* /*handler*/)()) {
+  // There are no interrupts in test/native builds, so the scale is polled
+  return false;
+}
+
+void HX711ScaleInterface::detachDataReadyInterrupt() {
+  // Nothing to detach in test/native builds
+}
+
+// ArduinoHX711BankPort implementations for test/native
+void ArduinoHX711BankPort::begin(int clock, const int * /*dataPins*/, uint8_t /*channelCount*/) {
+  // No pins to configure in test/native builds
+  clockPin = clock;
+}
+
+uint8_t ArduinoHX711BankPort::readDataPins() {
+  // Every DOUT reads low, so the bank always looks ready
+  return 0;
+}
+
+uint8_t ArduinoHX711BankPort::pulseClock() {
+  // Every channel shifts out zeros
+  return 0;
+}
+
+void ArduinoHX711BankPort::setClock(bool /*high*/) {
+  // No clock line in test/native builds
+}
+
+// ArduinoBlockStorage implementations for test/native
+bool ArduinoBlockStorage::read(uint8_t * /*data*/, size_t /*size*/) {
+  // Nothing is stored in test/native builds
+  return false;
+}
+
+bool ArduinoBlockStorage::write(const uint8_t * /*data*/, size_t /*size*/) {
+  // Mock always succeeds
+  return true;
+}
+
+// ArduinoRecipeStorage implementation for test/native
+size_t ArduinoRecipeStorage::read(char * /*buffer*/, size_t /*capacity*/) {
+  // There is no recipe file in test/native builds, so the built-in recipe is used
+  return 0;
+}
+
 // Define the global SD instance for test/native builds
 SDClass SD;
 #endif
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "../include/parallel_hx711_bank.h"
+
+namespace {
+constexpr uint8_t DATA_BITS = 24;
+constexpr long SIGN_BIT = 0x800000L;
+} // namespace
+
+const uint8_t ParallelHX711Bank::PULSES_PER_PASS;
+
+ParallelHX711Bank::ParallelHX711Bank(IHX711BankPort &port, int clockPin) : port(port), clockPin(clockPin) {}
+
+int ParallelHX711Bank::addChannel(int dataPin) {
+  if (channelCount >= HX711_BANK_MAX_CHANNELS) {
+    return -1;
+  }
+  int channel = channelCount;
+  dataPins[channel] = dataPin; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  activeMask |= static_cast<uint8_t>(1U << channel);
+  channelCount++;
+  // Scales begin as they are constructed, so a channel added after begin() needs the pins configured again
+  if (started) {
+    port.begin(clockPin, dataPins.data(), channelCount);
+  }
+  return channel;
+}
+
+void ParallelHX711Bank::begin() {
+  if (started) {
+    return;
+  }
+  port.begin(clockPin, dataPins.data(), channelCount);
+  started = true;
+}
+
+bool ParallelHX711Bank::poll() {
+  if (!started || channelCount == 0) {
+    return false;
+  }
+
+  // A low data line means a conversion is waiting; it stays low until the conversion is clocked out
+  const uint8_t channelMask = static_cast<uint8_t>((1U << channelCount) - 1U);
+  uint8_t readyMask = static_cast<uint8_t>(~port.readDataPins()) & channelMask;
+  if (readyMask == 0) {
+    return false;
+  }
+
+  // Channels left out earlier rejoin as soon as they have data again
+  activeMask |= readyMask;
+  if (readyMask != activeMask) {
+    unsigned long now = millis();
+    if (!waiting) {
+      waiting = true;
+      waitStart = now;
+    }
+    if (now - waitStart <= SCALE_READ_TIMEOUT_MS) {
+      return false;
+    }
+    // The silent channels missed a whole read timeout; stop waiting for them
+    activeMask = readyMask;
+  }
+
+  readPass(readyMask);
+  waiting = false;
+  return true;
+}
+
+void ParallelHX711Bank::readPass(uint8_t readyMask) {
+  // Every channel shifts its bits out on the same pulses, so a pass costs the same for one channel or for six
+  std::array<long, HX711_BANK_MAX_CHANNELS> values{};
+  for (uint8_t bit = 0; bit < DATA_BITS; bit++) {
+    uint8_t levels = port.pulseClock();
+    for (uint8_t i = 0; i < channelCount; i++) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+      values[i] = (values[i] << 1) | static_cast<long>((levels >> i) & 1U);
+    }
+  }
+  for (uint8_t pulse = DATA_BITS; pulse < PULSES_PER_PASS; pulse++) {
+    port.pulseClock();
+  }
+
+  for (uint8_t i = 0; i < channelCount; i++) {
+    if ((readyMask & (1U << i)) != 0) {
+      // Sign-extend the 24-bit two's complement value
+      latest[i] = (values[i] ^ SIGN_BIT) - SIGN_BIT; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+  }
+  freshMask |= readyMask;
+  passCount++;
+}
+
+bool ParallelHX711Bank::hasSample(uint8_t channel) const { return (freshMask & (1U << channel)) != 0; }
+
+long ParallelHX711Bank::takeSample(uint8_t channel) {
+  freshMask &= static_cast<uint8_t>(~(1U << channel));
+  return latest[channel]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+}
+
+void ParallelHX711Bank::powerDown() {
+  // A clock held high powers the modules down; the line is shared, so this is all or nothing
+  port.setClock(false);
+  port.setClock(true);
+}
+
+void ParallelHX711Bank::powerUp() { port.setClock(false); }
+
+unsigned long ParallelHX711Bank::getPassCount() const { return passCount; }
+
+uint8_t ParallelHX711Bank::getActiveMask() const { return activeMask; }
+
+HX711BankChannel::HX711BankChannel(ParallelHX711Bank &bank, int dataPin)
+  : bank(bank), channel(bank.addChannel(dataPin)) {}
+
+void HX711BankChannel::begin() { bank.begin(); }
+
+bool HX711BankChannel::is_ready() {
+  if (channel < 0) {
+    return false;
+  }
+  bank.poll();
+  return bank.hasSample(static_cast<uint8_t>(channel));
+}
+
+void HX711BankChannel::set_scale(float scaleValue) { scale = scaleValue; }
+
+void HX711BankChannel::tare(uint8_t times) { offset = readAverage(times); }
+
+float HX711BankChannel::get_units(uint8_t times) { return static_cast<float>(readAverage(times) - offset) / scale; }
+
+void HX711BankChannel::power_down() {
+  // The clock line is shared, so one channel cannot power down without taking the whole bank with it
+}
+
+void HX711BankChannel::power_up() {
+  // See power_down()
+}
+
+bool HX711BankChannel::can_power_down() { return false; }
+
+long HX711BankChannel::read() { return channel < 0 ? 0 : bank.takeSample(static_cast<uint8_t>(channel)); }
+
+long HX711BankChannel::get_offset() { return offset; }
+
+void HX711BankChannel::set_offset(long offsetValue) { offset = offsetValue; }
+
+float HX711BankChannel::get_scale() { return scale; }
+
+long HX711BankChannel::readAverage(uint8_t times) {
+  // Blocks, like the HX711 library's own averaging, but only taring and get_units() come here
+  long sum = 0;
+  uint8_t count = 0;
+  unsigned long startTime = millis();
+  while (count < times && millis() - startTime <= SCALE_CONNECTION_TIMEOUT_MS) {
+    if (is_ready()) {
+      sum += read();
+      count++;
+    } else {
+      delay(1);
+    }
+  }
+  return count == 0 ? offset : sum / count;
+}
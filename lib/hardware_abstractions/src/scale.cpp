@@ -2,45 +2,153 @@
 
 #include "../../utilities/include/logger.h"
 
+#include <cmath>
+
+Scale *volatile Scale::interruptScales[SCALE_INTERRUPT_SLOTS] = {};
+
+void (*const Scale::dataReadyHandlers[SCALE_INTERRUPT_SLOTS])() = {
+    &Scale::dataReadyHandler<0>, &Scale::dataReadyHandler<1>, &Scale::dataReadyHandler<2>,
+    &Scale::dataReadyHandler<3>, &Scale::dataReadyHandler<4>, &Scale::dataReadyHandler<5>};
+
+static_assert(SCALE_INTERRUPT_SLOTS == 6, "dataReadyHandlers must have one entry per slot");
+
 Scale::Scale(IScaleInterface *scaleInterface, int dataPin, int clockPin, Logger *logger)
-  : scaleInterface(scaleInterface), dataPin(dataPin), clockPin(clockPin), logger(logger) {
+  : scaleInterface(scaleInterface), outliers(SCALE_HAMPEL_THRESHOLD, SCALE_HAMPEL_MIN_DEVIATION), dataPin(dataPin),
+    clockPin(clockPin), logger(logger) {
 
   if (logger) {
     logger->info("Initializing scale on pins %d, %d", dataPin, clockPin);
   }
 
-  // Initialize reading array with zeros
-  for (float &reading : readings) {
-    reading = 0.0F;
+  scaleInterface->begin();
+  scaleInterface->set_scale(SCALE_DEFAULT_CALIBRATION);
+  stateStartTime = millis();
+}
+
+Scale::~Scale() { stopAcquisition(); }
+
+void Scale::onDataReady() {
+  // DOUT also toggles while the bits are clocked out, raising spurious edges; only a low DOUT means new data
+  if (!scaleInterface->is_ready()) {
+    return;
   }
+  ScaleSample sample = {millis(), scaleInterface->readReadyConversion()};
+  samples.push(sample);
+}
 
-  // Try to connect with timeout
-  unsigned long startTime = millis();
-  scaleInterface->begin();
+void Scale::pollConversion() {
+  if (!scaleInterface->is_ready()) {
+    return;
+  }
+  // Other scales' handlers stay enabled here, so the read masks them while the clock is high
+  ScaleSample sample = {millis(), scaleInterface->readPolledConversion()};
+  samples.push(sample);
+}
 
-  // Check if scale responds within timeout
-  connected = false;
-  while (!scaleInterface->is_ready()) {
-    if (millis() - startTime > SCALE_CONNECTION_TIMEOUT_MS) {
-      if (logger) {
-        logger->error("Scale connection timeout on pins %d, %d", dataPin, clockPin);
-      }
+void Scale::startAcquisition() {
+  samples.clear();
+  // The scale may have been tared or left idle since the window was filled, so its old samples no longer compare
+  outliers.clear();
+  averageSum = 0;
+  averageCount = 0;
+  lastSampleTime = millis();
+  missedLastUpdate = false;
+  acquiring = true;
+
+  int slot = 0;
+  while (slot < SCALE_INTERRUPT_SLOTS && interruptScales[slot] != nullptr) {
+    slot++;
+  }
+  if (slot < SCALE_INTERRUPT_SLOTS) {
+    // Claim the slot before attaching, so the first edge already finds this scale
+    interruptScales[slot] = this;
+    if (scaleInterface->attachDataReadyInterrupt(dataReadyHandlers[slot])) {
+      interruptSlot = slot;
+      logAcquisitionMode();
       return;
     }
-    delay(10);
+    interruptScales[slot] = nullptr;
   }
+  logAcquisitionMode();
+}
 
-  // Scale is connected
-  connected = true;
+void Scale::logAcquisitionMode() {
+  // Idle scales restart acquisition on every check, so only a change of mode is worth a line on the SD card
+  int8_t mode = interruptSlot >= 0 ? 1 : 0;
+  if (mode == loggedAcquisitionMode) {
+    return;
+  }
+  loggedAcquisitionMode = mode;
   if (logger) {
-    logger->info("Scale connected successfully on pins %d, %d", dataPin, clockPin);
+    logger->info(mode ? "Scale on pins %d, %d reads by interrupt" : "Scale on pins %d, %d is polled", dataPin,
+                 clockPin);
   }
+}
 
-  // Tare the scale
-  scaleInterface->tare();
-  if (logger) {
-    logger->info("Scale tared on pins %d, %d", dataPin, clockPin);
+void Scale::stopAcquisition() {
+  if (interruptSlot >= 0) {
+    scaleInterface->detachDataReadyInterrupt();
+    interruptScales[interruptSlot] = nullptr;
+    interruptSlot = -1;
+  }
+  acquiring = false;
+  samples.clear();
+}
+
+bool Scale::drainSamples() {
+  long offset = scaleInterface->get_offset();
+  float calibration = scaleInterface->get_scale();
+
+  ScaleSample sample{};
+  bool drained = false;
+  bool filtered = false;
+  while (samples.pop(sample)) {
+    lastSampleTime = sample.timeMs;
+    readTimeout = SCALE_READ_TIMEOUT_MS;
+    drained = true;
+
+    // A spike still proves the HX711 is alive, so it counts as drained, but it never reaches the average
+    float weight = (static_cast<float>(sample.rawCount) - static_cast<float>(offset)) / calibration;
+    if (!outliers.accept(weight)) {
+      if (logger && logger->isLevelEnabled(Logger::DEBUG_LEVEL)) {
+        logger->debug("Scale on pins %d, %d dropped a spike of %.2f", dataPin, clockPin, weight);
+      }
+      continue;
+    }
+
+    // Average groups of conversions in software, as get_units() would, without waiting for any of them
+    if (averageCount == 0) {
+      averageStartTime = sample.timeMs;
+    }
+    averageSum += sample.rawCount;
+    averageCount++;
+    if (averageCount >= averagingDepth) {
+      float mean = static_cast<float>(averageSum) / static_cast<float>(averageCount);
+      readings.add((mean - static_cast<float>(offset)) / calibration);
+      // The mean describes the middle of the averaged span, not the moment the last conversion arrived
+      readingTime = averageStartTime + (sample.timeMs - averageStartTime) / 2;
+      averageSum = 0;
+      averageCount = 0;
+      readingCount++;
+      filtered = true;
+      // A load still swinging or creeping would put its passing median into the factor, so wait for it to settle
+      if (calibrationWeight > 0.0F && readings.isFull() && readings.spread() <= SCALE_CALIBRATION_MAX_SPREAD) {
+        finishCalibration();
+        calibration = scaleInterface->get_scale(); // Any conversions still queued are weighed in the new units
+      }
+    }
+  }
+
+  unsigned long drops = samples.getDroppedCount();
+  if (drops != reportedDrops && logger) {
+    logger->warning("Scale on pins %d, %d dropped %lu conversions", dataPin, clockPin, drops - reportedDrops);
+  }
+  reportedDrops = drops;
+
+  if (filtered && logger && logger->isLevelEnabled(Logger::DEBUG_LEVEL)) {
+    logger->debug("Scale reading: %.2f on pins %d, %d", readings.last(), dataPin, clockPin);
   }
+  return drained;
 }
 
 bool Scale::updateWeight() {
@@ -52,74 +160,262 @@ bool Scale::updateWeight() {
     return false;
   }
 
-  // Wait for scale with timeout
-  unsigned long startTime = millis();
-  while (!scaleInterface->is_ready()) {
-    if (millis() - startTime > SCALE_READ_TIMEOUT_MS) {
-      if (logger) {
-        logger->error("Timeout waiting for scale data on pins %d, %d", dataPin, clockPin);
-      }
-      connected = false; // Mark as disconnected for future calls
-      return false;
-    }
-    delay(10);
+  // A sleeping scale has nothing to collect; its last weight still stands
+  if (sleeping) {
+    return true;
+  }
+
+  // Interrupts are attached here rather than in the constructor, which may run before the board is initialized
+  if (!acquiring) {
+    startAcquisition();
   }
 
-  // Read weight
-  float value = scaleInterface->get_units();
-  readings[index] = value;
-  index = (index + 1) % READINGS_ARRAY_SIZE;
+  // Without an interrupt, take a conversion only if one is already waiting
+  if (interruptSlot < 0) {
+    pollConversion();
+  }
+  if (drainSamples()) {
+    missedLastUpdate = false;
+    return true;
+  }
 
-  if (logger && logger->isLevelEnabled(Logger::DEBUG_LEVEL)) {
-    logger->debug("Scale reading: %.2f on pins %d, %d", value, dataPin, clockPin);
+  // One empty update is normal when ticks outpace conversions, so only a silence spanning two updates counts
+  if (missedLastUpdate && millis() - lastSampleTime > readTimeout) {
+    if (logger) {
+      logger->error("Timeout waiting for scale data on pins %d, %d", dataPin, clockPin);
+    }
+    stopAcquisition();
+    connected = false; // Mark as disconnected for future calls
+    scheduleReconnect();
+    return false;
   }
+  missedLastUpdate = true;
   return true;
 }
 
-float Scale::getWeight() const {
-  std::array<float, READINGS_ARRAY_SIZE> sortedReadings{};
-  std::copy(readings.begin(), readings.end(), sortedReadings.begin());
-  std::sort(sortedReadings.begin(), sortedReadings.end());
-  return sortedReadings[READINGS_ARRAY_MIDDLE_INDEX]; // return the median
+float Scale::getWeight() const { return readings.median(); }
+
+float Scale::getLastWeight() const { return readings.last(); }
+
+ScaleReading Scale::getLastReading() const { return {readingTime, readings.last(), readingCount}; }
+
+bool Scale::isConnected() const { return connected; }
+
+bool Scale::isInterruptDriven() const { return interruptSlot >= 0; }
+
+void Scale::setAveragingDepth(uint8_t depth) {
+  averagingDepth = depth == 0 ? 1 : depth;
+  averageSum = 0;
+  averageCount = 0;
+}
+
+uint8_t Scale::getAveragingDepth() const { return averagingDepth; }
+
+unsigned long Scale::getReadingCount() const { return readingCount; }
+
+unsigned long Scale::getRejectedCount() const { return outliers.getRejectedCount(); }
+
+void Scale::sleep() {
+  // Sleeping a scale that cannot power down would save nothing and only add the settle delay on waking
+  if (sleeping || !scaleInterface->can_power_down()) {
+    return;
+  }
+  // Detach first: powering down raises DOUT, and the edges must not reach the handler
+  stopAcquisition();
+  scaleInterface->power_down();
+  sleeping = true;
 }
 
-float Scale::getLastWeight() const {
-  int lastReadingIndex =
-      (index - 1 + READINGS_ARRAY_SIZE) % READINGS_ARRAY_SIZE; // calculate the index of the last reading
-  return readings[lastReadingIndex];
+void Scale::wake() {
+  if (!sleeping) {
+    return;
+  }
+  scaleInterface->power_up();
+  // The first conversion only comes once the output has settled, so the timeout waits for it
+  readTimeout = SCALE_READ_TIMEOUT_MS + SCALE_WAKE_SETTLE_MS;
+  sleeping = false;
 }
 
-bool Scale::isConnected() const { return connected; }
+bool Scale::isSleeping() const { return sleeping; }
+
+void Scale::restoreCalibration(const ScaleCalibration &calibration) {
+  scaleInterface->set_scale(calibration.scale);
+  scaleInterface->set_offset(calibration.offset);
+  zeroKnown = true;
+  if (logger) {
+    logger->info("Restored calibration of scale on pins %d, %d", dataPin, clockPin);
+  }
+}
 
-bool Scale::tryReconnect() {
-  if (connected)
-    return true; // Already connected
+bool Scale::startCalibration(float knownWeight) {
+  if (!connected || knownWeight < SCALE_CALIBRATION_MIN_WEIGHT) {
+    return false;
+  }
+  // Only readings of the known weight may go into the median the factor is taken from, and placing it is no spike
+  readings.clear();
+  outliers.clear();
+  calibrationWeight = knownWeight;
+  return true;
+}
 
+void Scale::finishCalibration() {
+  float measured = readings.median();
+  // The readings were divided by the old factor, so their raw load is the measured weight times that factor
+  float calibration = scaleInterface->get_scale() * measured / calibrationWeight;
+  // A weight that hardly moves the reading was not placed, or the scale is miswired; keep the old factor
+  bool loaded = std::fabs(measured) >= SCALE_CALIBRATION_MIN_LOAD * calibrationWeight;
+  calibrationWeight = 0.0F;
+  if (!loaded) {
+    if (logger) {
+      logger->error("Scale on pins %d, %d sees too little load to calibrate against", dataPin, clockPin);
+    }
+    return;
+  }
+  scaleInterface->set_scale(calibration);
+  // Readings in the old units no longer compare with new ones
+  readings.clear();
+  outliers.clear();
   if (logger) {
-    logger->info("Attempting to reconnect scale on pins %d, %d", dataPin, clockPin);
+    logger->info("Calibrated scale on pins %d, %d to %.2f counts per gram", dataPin, clockPin, calibration);
   }
+}
 
-  // Try to connect with timeout
-  unsigned long startTime = millis();
-  scaleInterface->begin();
+bool Scale::isCalibrating() const { return calibrationWeight > 0.0F; }
+
+ScaleCalibration Scale::getCalibration() const { return {scaleInterface->get_offset(), scaleInterface->get_scale()}; }
+
+ScaleConnectionState Scale::getConnectionState() const { return connectionState; }
+
+bool Scale::hasZeroMismatch() const { return zeroMismatch; }
+
+bool Scale::serviceConnection() {
+  unsigned long now = millis();
+  switch (connectionState) {
+  case SCALE_ONLINE:
+    return false;
+
+  case SCALE_BACKOFF:
+    if (now - stateStartTime < reconnectDelay) {
+      return false;
+    }
+    if (logger) {
+      logger->info("Attempting to reconnect scale on pins %d, %d", dataPin, clockPin);
+    }
+    // A powered-down HX711 never reports ready, so a sleeping scale is woken before it is probed
+    wake();
+    scaleInterface->begin();
+    connectionState = SCALE_PROBING;
+    stateStartTime = now;
+    // Should this attempt fail too, wait twice as long before the next one
+    reconnectDelay = reconnectDelay > SCALE_RECONNECT_MAX_DELAY_MS / 2 ? SCALE_RECONNECT_MAX_DELAY_MS
+                                                                       : reconnectDelay * 2;
+    return false;
 
-  // Check if scale responds within timeout
-  while (!scaleInterface->is_ready()) {
-    if (millis() - startTime > SCALE_CONNECTION_TIMEOUT_MS) {
+  case SCALE_PROBING:
+    if (scaleInterface->is_ready()) {
+      // Collect the tare conversions through the normal acquisition path, so settling never waits either
+      startAcquisition();
+      tareCount = 0;
+      zeroCheckPending = zeroKnown;
+      connectionState = SCALE_SETTLING;
+      stateStartTime = now;
+    } else if (now - stateStartTime > SCALE_CONNECTION_TIMEOUT_MS) {
       if (logger) {
-        logger->error("Scale reconnection timeout on pins %d, %d", dataPin, clockPin);
+        logger->error("Scale connection timeout on pins %d, %d", dataPin, clockPin);
       }
-      return false;
+      scheduleReconnect();
+    }
+    return false;
+
+  case SCALE_SETTLING:
+    return settle();
+  }
+  return false;
+}
+
+bool Scale::settle() {
+  if (interruptSlot < 0) {
+    pollConversion();
+  }
+
+  ScaleSample sample{};
+  while (samples.pop(sample)) {
+    lastSampleTime = sample.timeMs;
+    if (tareCount == 0) {
+      tareSum = 0;
+      tareMin = sample.rawCount;
+      tareMax = sample.rawCount;
+    }
+    tareSum += sample.rawCount;
+    tareMin = sample.rawCount < tareMin ? sample.rawCount : tareMin;
+    tareMax = sample.rawCount > tareMax ? sample.rawCount : tareMax;
+    tareCount++;
+    if (tareCount < (zeroCheckPending ? SCALE_ZERO_CHECK_CONVERSIONS : SCALE_TARE_CONVERSIONS)) {
+      continue;
+    }
+
+    // A load that is still moving, such as a vessel being set down, would tare to the wrong zero; start over
+    float calibration = std::fabs(scaleInterface->get_scale());
+    float spread = static_cast<float>(tareMax - tareMin) / calibration;
+    if (spread > SCALE_TARE_MAX_SPREAD) {
+      tareCount = 0;
+      continue;
     }
-    delay(10);
+
+    long mean = tareSum / tareCount;
+    if (zeroCheckPending) {
+      // A known zero is kept while the vessel still weighs what it did; otherwise the full tare follows
+      zeroCheckPending = false;
+      float drift = static_cast<float>(mean - scaleInterface->get_offset()) / calibration;
+      zeroMismatch = std::fabs(drift) > SCALE_ZERO_CHECK_TOLERANCE;
+      if (zeroMismatch && wasOnline) {
+        // Mid-run the vessel holds what was collected so far, and taring to it would lose that for good
+        if (logger) {
+          logger->warning("Scale on pins %d, %d is %.1f g off its zero, keeping it", dataPin, clockPin, drift);
+        }
+      } else if (zeroMismatch) {
+        if (logger) {
+          logger->warning("Scale on pins %d, %d is %.1f g off its zero, taring", dataPin, clockPin, drift);
+        }
+        zeroMismatch = false;
+        tareCount = 0;
+        continue;
+      }
+    } else {
+      scaleInterface->set_offset(mean);
+      zeroKnown = true;
+      if (logger) {
+        logger->info("Scale tared on pins %d, %d", dataPin, clockPin);
+      }
+    }
+
+    connected = true;
+    wasOnline = true;
+    connectionState = SCALE_ONLINE;
+    reconnectDelay = SCALE_RECONNECT_MIN_DELAY_MS;
+    missedLastUpdate = false;
+    if (logger) {
+      logger->info("Scale connected successfully on pins %d, %d", dataPin, clockPin);
+    }
+    return true;
   }
 
-  // Scale is connected
-  connected = true;
-  scaleInterface->tare();
+  if (millis() - lastSampleTime > SCALE_READ_TIMEOUT_MS) {
+    if (logger) {
+      logger->error("Scale stopped responding while settling on pins %d, %d", dataPin, clockPin);
+    }
+    stopAcquisition();
+    scheduleReconnect();
+  }
+  return false;
+}
 
+void Scale::scheduleReconnect() {
+  // The readings a calibration has collected so far may not be of the known weight by the time the scale is back
+  calibrationWeight = 0.0F;
+  connectionState = SCALE_BACKOFF;
+  stateStartTime = millis();
   if (logger) {
-    logger->info("Scale reconnected successfully on pins %d, %d", dataPin, clockPin);
+    logger->info("Retrying scale on pins %d, %d in %lu ms", dataPin, clockPin, reconnectDelay);
   }
-  return true;
-}
\ No newline at end of file
+}
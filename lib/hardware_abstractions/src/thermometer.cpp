@@ -1,73 +1,64 @@
 #include "../include/thermometer.h"
 
-#ifdef UNIT_TEST
-// Constructor for the test environment
-Thermometer::Thermometer(std::shared_ptr<MockOneWire> ow, std::shared_ptr<MockDallasTemperature> ds)
-  : oneWire(std::move(ow)), sensors(std::move(ds)) {
-  for (float &reading : readings) {
-    reading = 0.0F;
-  }
-}
-
-// Method to set lastMedian for testing purposes
-void Thermometer::setLastMedian(float median) { lastMedian = median; }
-#else
 // Constructor for the Thermometer class
-Thermometer::Thermometer(int pin) : oneWire(pin), sensors(&oneWire) {
-  sensors.begin();
-  for (float &reading : readings) {
-    reading = 0.0F;
-  }
+Thermometer::Thermometer(ThermometerBus &bus, uint8_t probe) : bus(bus), probe(probe) {}
+
+// Stores a new reading in the median filter and the trend estimator
+void Thermometer::addReading(RawTemperature temperature, unsigned long timeMs) {
+  readings.add(temperature);
+  trend.add(timeMs, temperature);
+  readingTime = timeMs;
+  readingCount++;
 }
-#endif
 
-// Updates the temperature reading
-void Thermometer::updateTemperature() {
-#ifdef UNIT_TEST
-  sensors->requestTemperatures();
-  // Update the last median before adding the new reading
-  if (readingsCount == READINGS_ARRAY_SIZE) {
-    lastMedian = getTemperature();
+// Reads the result of the bus's last completed conversion into the readings buffer
+bool Thermometer::collectTemperature() {
+  if (!bus.isConversionComplete(probe) || bus.getConversionSequence() == collectedSequence) {
+    return false;
   }
-  readings[index] = sensors->getTempCByIndex(0); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-#else
-  sensors.requestTemperatures();
-  // Update the last median before adding the new reading
-  if (readingsCount == READINGS_ARRAY_SIZE) {
-    lastMedian = getTemperature();
+  collectedSequence = bus.getConversionSequence();
+
+  RawTemperature temperature = bus.readRawTemperature(probe);
+  if (temperature == DISCONNECTED_RAW_TEMPERATURE) {
+    return false; // Keep a failed read out of the median
   }
-  readings[index] = sensors.getTempCByIndex(0); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-#endif
-  index = (index + 1) % READINGS_ARRAY_SIZE;
-  readingsCount =
-      std::min(readingsCount + 1, READINGS_ARRAY_SIZE); // Don't let readingsCount exceed READINGS_ARRAY_SIZE
+  // Stamp the reading with the start of its conversion, so a late collection does not bend the trend
+  addReading(temperature, bus.getConversionStartTime());
+  return true;
+}
+
+// Returns the slope of the least-squares line through the trend window
+float Thermometer::getTemperatureSlope() const {
+  return trend.slopePerMinute() / static_cast<float>(RAW_TEMPERATURE_STEPS_PER_C);
+}
+
+// Returns the variance of the readings around the trend line
+float Thermometer::getTemperatureNoise() const {
+  return trend.residualVariance() / static_cast<float>(RAW_TEMPERATURE_STEPS_PER_C * RAW_TEMPERATURE_STEPS_PER_C);
 }
 
-// Checks if there is a sudden temperature increase beyond a given threshold
-bool Thermometer::isSuddenTemperatureIncrease(float threshold) const {
-  if (readingsCount < READINGS_ARRAY_SIZE) {
-    return false; // Not enough readings to calculate the median
+// Checks whether the temperature is rising faster than a given rate
+bool Thermometer::isTemperatureRising(float slopeThreshold) const {
+  if (!trend.isFull()) {
+    return false; // Not enough readings for a trustworthy trend
   }
-  float currentMedian = getTemperature();
-  float difference = currentMedian - lastMedian;
-  return difference > threshold + TEMPERATURE_COMPARISON_TOLERANCE;
+  // Compare in raw steps per minute so the slope is used exactly as the estimator produced it
+  float threshold = slopeThreshold * static_cast<float>(RAW_TEMPERATURE_STEPS_PER_C);
+  float margin = TEMPERATURE_TREND_CONFIDENCE_SIGMAS * trend.slopeStandardError();
+  return trend.slopePerMinute() - margin > threshold;
 }
 
+// Returns the current temperature in raw steps
+RawTemperature Thermometer::getRawTemperature() const { return readings.median(); }
+
 // Returns the current temperature
-float Thermometer::getTemperature() const {
-  std::array<float, READINGS_ARRAY_SIZE> sortedReadings{};
-#if __cplusplus >= 202002L
-  std::ranges::copy(readings, sortedReadings.begin());
-  std::ranges::sort(sortedReadings);
-#else
-  std::copy(readings.begin(), readings.end(), sortedReadings.begin()); // NOLINT(modernize-use-ranges)
-  std::sort(sortedReadings.begin(), sortedReadings.end());             // NOLINT(modernize-use-ranges)
-#endif
-  return sortedReadings[READINGS_ARRAY_MIDDLE_INDEX]; // return the median
-}
+float Thermometer::getTemperature() const { return rawToCelsius(readings.median()); }
+
+// Returns the number of valid readings stored so far
+unsigned long Thermometer::getReadingCount() const { return readingCount; }
+
+// Returns when the newest reading was acquired
+unsigned long Thermometer::getReadingTime() const { return readingTime; }
 
 // Returns the last temperature reading
-float Thermometer::getLastTemperature() const {
-  int lastIndex = (index - 1 + READINGS_ARRAY_SIZE) % READINGS_ARRAY_SIZE; // calculate the index of the last reading
-  return readings[lastIndex]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-}
\ No newline at end of file
+float Thermometer::getLastTemperature() const { return rawToCelsius(readings.last()); }
@@ -0,0 +1,202 @@
+#include "../include/thermometer_bus.h"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef UNIT_TEST
+// Constructor for the test environment
+ThermometerBus::ThermometerBus(std::shared_ptr<MockOneWire> ow, std::shared_ptr<MockDallasTemperature> ds,
+                               Logger *logger)
+  : oneWire(std::move(ow)), sensors(std::move(ds)), logger(logger) {}
+#else
+// Constructor for the ThermometerBus class
+ThermometerBus::ThermometerBus(int pin, Logger *logger) : oneWire(pin), sensors(&oneWire), logger(logger) {}
+#endif
+
+// Searches the bus and caches the address of every probe found
+uint8_t ThermometerBus::begin() {
+#ifdef UNIT_TEST
+  MockDallasTemperature &dallas = *sensors;
+#else
+  DallasTemperature &dallas = sensors;
+#endif
+  dallas.begin();
+  // Return from requestTemperatures() immediately instead of blocking for the conversion time
+  dallas.setWaitForConversion(false);
+
+  uint8_t found = dallas.getDeviceCount();
+  if (found > MAX_THERMOMETER_PROBES) {
+    if (logger) {
+      logger->warning("Found %d probes on the thermometer bus, using the first %d", found, MAX_THERMOMETER_PROBES);
+    }
+    found = MAX_THERMOMETER_PROBES;
+  }
+
+  probeCount = 0;
+  for (uint8_t i = 0; i < found; i++) {
+    std::array<uint8_t, ONE_WIRE_ADDRESS_SIZE> &address = addresses[probeCount];
+    if (!dallas.getAddress(address.data(), i)) {
+      if (logger) {
+        logger->error("Failed to read the address of probe %d on the thermometer bus", i);
+      }
+      continue;
+    }
+    // Probes keep their resolution in EEPROM, so it may differ from the power-on default
+    uint8_t resolution = dallas.getResolution(address.data());
+    if (resolution < DS18B20_MIN_RESOLUTION_BITS || resolution > DS18B20_MAX_RESOLUTION_BITS) {
+      resolution = DS18B20_MAX_RESOLUTION_BITS;
+    }
+    resolutions[probeCount] = resolution;
+    if (logger) {
+      logger->info("Thermometer probe %d: %02X%02X%02X%02X%02X%02X%02X%02X, %d bit", probeCount, address[0],
+                   address[1], address[2], address[3], address[4], address[5], address[6], address[7], resolution);
+    }
+    probeCount++;
+  }
+  updateCycleTime();
+  return probeCount;
+}
+
+// Recomputes the cycle time from the resolutions of all probes
+void ThermometerBus::updateCycleTime() {
+  unsigned long slowest = 0;
+  for (uint8_t i = 0; i < probeCount; i++) {
+    slowest = std::max(slowest, getConversionTimeMs(i));
+  }
+  cycleTimeMs = probeCount > 0 ? slowest : DS18B20_CONVERSION_TIME_MS;
+}
+
+// Returns the number of probes found by the ROM search
+uint8_t ThermometerBus::getProbeCount() const { return probeCount; }
+
+// Returns the ROM code of a probe
+ProbeAddress ThermometerBus::getAddress(uint8_t probe) const {
+  ProbeAddress address{};
+  if (probe < probeCount) {
+    address.bytes = addresses[probe]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  }
+  return address;
+}
+
+// Moves the probe with a ROM code to an index
+bool ThermometerBus::bindProbe(uint8_t probe, const ProbeAddress &address) {
+  uint8_t found = probe;
+  while (found < probeCount && addresses[found] != address.bytes) { // NOLINT
+    found++;
+  }
+  if (found >= probeCount) {
+    return false;
+  }
+  // The resolution belongs to the probe, so it moves along with the address
+  std::swap(addresses[probe], addresses[found]);     // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  std::swap(resolutions[probe], resolutions[found]); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  return true;
+}
+
+// Starts a conversion on every probe with a single Skip-ROM command
+void ThermometerBus::requestConversion() {
+#ifdef UNIT_TEST
+  sensors->requestTemperatures();
+#else
+  sensors.requestTemperatures();
+#endif
+  conversionStartTime = millis();
+  pendingCycleTimeMs = cycleTimeMs;
+  conversionStarted = true;
+  conversionSequence++;
+}
+
+// Checks whether a conversion has been started and is still running
+bool ThermometerBus::isConversionPending() const { return conversionStarted && !isConversionComplete(); }
+
+// Checks whether the last conversion has had enough time to finish on every probe
+bool ThermometerBus::isConversionComplete() const {
+  return conversionStarted && millis() - conversionStartTime >= pendingCycleTimeMs;
+}
+
+// Checks whether the last conversion has had enough time to finish on one probe
+bool ThermometerBus::isConversionComplete(uint8_t probe) const {
+  // A probe raised to a finer resolution after the conversion finished still holds a valid result
+  return conversionStarted &&
+         millis() - conversionStartTime >= std::min(getConversionTimeMs(probe), pendingCycleTimeMs);
+}
+
+// Reprograms the resolution in a probe's configuration register
+bool ThermometerBus::setResolution(uint8_t probe, uint8_t resolution) {
+  if (probe >= probeCount || resolution < DS18B20_MIN_RESOLUTION_BITS || resolution > DS18B20_MAX_RESOLUTION_BITS) {
+    return false;
+  }
+  if (resolutions[probe] == resolution) { // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    return true;
+  }
+  // Writing the configuration register mid-conversion would corrupt the result being converted
+  if (isConversionPending()) {
+    return false;
+  }
+  if (!writeConfiguration(probe, resolution)) {
+    if (logger) {
+      logger->error("Failed to set thermometer probe %d to %d bit", probe, resolution);
+    }
+    return false;
+  }
+  resolutions[probe] = resolution; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  updateCycleTime();
+  return true;
+}
+
+// Writes a resolution to a probe's scratchpad, leaving its EEPROM alone
+bool ThermometerBus::writeConfiguration(uint8_t probe, uint8_t resolution) {
+#ifdef UNIT_TEST
+  MockOneWire &wire = *oneWire;
+#else
+  OneWire &wire = oneWire;
+#endif
+  if (wire.reset() == 0) {
+    return false; // No presence pulse, so nothing on the bus would hear the write
+  }
+  wire.select(addresses[probe].data()); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  wire.write(DS18B20_WRITE_SCRATCHPAD);
+  // The alarm thresholds come first; the firmware never searches for alarms, so they are set out of reach
+  wire.write(DS18B20_ALARM_HIGH);
+  wire.write(DS18B20_ALARM_LOW);
+  wire.write(static_cast<uint8_t>(((resolution - DS18B20_MIN_RESOLUTION_BITS) << DS18B20_RESOLUTION_SHIFT) |
+                                  DS18B20_CONFIG_RESERVED_BITS));
+  return true;
+}
+
+// Returns the current resolution of a probe
+uint8_t ThermometerBus::getResolution(uint8_t probe) const {
+  return probe < probeCount ? resolutions[probe] : 0; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+}
+
+// Returns the conversion time of a probe at its current resolution
+unsigned long ThermometerBus::getConversionTimeMs(uint8_t probe) const {
+  return probe < probeCount ? ds18b20ConversionTimeMs(resolutions[probe]) // NOLINT
+                            : DS18B20_CONVERSION_TIME_MS;
+}
+
+// Returns the length of one conversion cycle
+unsigned long ThermometerBus::getCycleTimeMs() const { return cycleTimeMs; }
+
+// Returns the sequence number of the last conversion
+unsigned long ThermometerBus::getConversionSequence() const { return conversionSequence; }
+
+// Returns when the last conversion was started
+unsigned long ThermometerBus::getConversionStartTime() const { return conversionStartTime; }
+
+// Reads the scratchpad of a probe by its cached address
+RawTemperature ThermometerBus::readRawTemperature(uint8_t probe) {
+  if (probe >= probeCount) {
+    return DISCONNECTED_RAW_TEMPERATURE;
+  }
+#ifdef UNIT_TEST
+  int32_t raw = sensors->getTemp(addresses[probe].data()); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+#else
+  int32_t raw = sensors.getTemp(addresses[probe].data()); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+#endif
+  if (raw <= DEVICE_DISCONNECTED_RAW) {
+    return DISCONNECTED_RAW_TEMPERATURE;
+  }
+  // getTemp() shifts the 16-bit register left by three bits, so this division is exact
+  return static_cast<RawTemperature>(raw / DALLAS_RAW_PER_STEP);
+}
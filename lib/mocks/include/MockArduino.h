@@ -62,29 +62,31 @@ extern SDClass SD;
 #define OCT 8
 #define BIN 2
 
-// Forward declarations
-class HardwareSerial;
-extern HardwareSerial Serial;
+constexpr uint8_t MOCK_PIN_COUNT = 32; // Pins the mock core keeps a level for
 
-// Basic Arduino functions
+// Basic Arduino functions, inline so that every translation unit of a native build shares them
 extern "C" {
-// Time functions
-static unsigned long _mock_millis = 0;
-unsigned long millis() { return _mock_millis; }
-void delay(unsigned long ms) { _mock_millis += ms; }
-
-// Pin I/O functions
-void pinMode(uint8_t pin, uint8_t mode) {}
-void digitalWrite(uint8_t pin, uint8_t val) {}
-int digitalRead(uint8_t pin) { return LOW; }
-int analogRead(uint8_t pin) { return 0; }
-void analogWrite(uint8_t pin, int val) {}
+// Time functions; the time only moves when the native build moves it, so a simulated run takes no real time
+inline unsigned long _mock_millis = 0;
+inline unsigned long millis() { return _mock_millis; }
+inline void delay(unsigned long ms) { _mock_millis += ms; }
+
+// Pin I/O functions; each pin keeps the level last written to it, for the native build to read the outputs back
+inline uint8_t _mock_pin_levels[MOCK_PIN_COUNT] = {};
+inline void pinMode(uint8_t pin, uint8_t mode) {}
+inline void digitalWrite(uint8_t pin, uint8_t val) { _mock_pin_levels[pin % MOCK_PIN_COUNT] = val; }
+inline int digitalRead(uint8_t pin) { return _mock_pin_levels[pin % MOCK_PIN_COUNT]; }
+inline int analogRead(uint8_t pin) { return 0; }
+inline void analogWrite(uint8_t pin, int val) {}
 
 // Advanced time functions
-unsigned long micros() { return _mock_millis * 1000UL; }
-void delayMicroseconds(unsigned int us) { _mock_millis += us / 1000UL; }
+inline unsigned long micros() { return _mock_millis * 1000UL; }
+inline void delayMicroseconds(unsigned int us) { _mock_millis += us / 1000UL; }
 }
 
+// Function to set mock time, as in the unit tests
+inline void setMillis(unsigned long newMillis) { _mock_millis = newMillis; }
+
 // Serial communication
 class Stream {
 public:
@@ -157,23 +159,8 @@ public:
   bool operator!=(const String &rhs) const { return !equals(rhs); }
 };
 
-// Global serial instance
-static HardwareSerial SerialInstance;
-HardwareSerial Serial = SerialInstance;
-
-// Global SD instance
-#ifndef SDClass_defined
-#define SDClass_defined
-class SDClass {
-public:
-  bool begin(uint8_t csPin = 10) { return true; }
-  File open(const char *filename, const char *mode) { return File(); }
-  bool exists(const char *filename) { return true; }
-  bool mkdir(const char *filename) { return true; }
-};
-#endif
-static SDClass SDInstance;
-SDClass SD = SDInstance;
+// Global serial instance; the SD instance is defined with the mock hardware interfaces
+inline HardwareSerial Serial;
 
 #else
 // Minimal Arduino.h for non-test, non-native builds
@@ -0,0 +1,23 @@
+#ifndef MOCK_SENSORS_H
+#define MOCK_SENSORS_H
+
+#include <cstdint>
+
+/**
+ * Readings of the mock sensors in test and native builds.
+ *
+ * The mock HX711 and DS18B20 drivers return these values instead of talking to hardware, so whatever simulates the
+ * still around the firmware sets them, and the firmware reads them through its usual drivers.
+ */
+namespace MockSensors {
+constexpr uint8_t PIN_COUNT = 32;  /**< Data pins a load cell count is kept for. */
+constexpr uint8_t PROBE_COUNT = 8; /**< Probes on the 1-Wire bus a temperature is kept for. */
+
+/** Raw count each HX711 converts, by its data pin. */
+inline long loadCellCounts[PIN_COUNT] = {};
+
+/** Temperature each DS18B20 reports, in DallasTemperature's 1/128 °C, by its index in the ROM search. */
+inline int32_t probeTemperatures[PROBE_COUNT] = {};
+} // namespace MockSensors
+
+#endif // MOCK_SENSORS_H
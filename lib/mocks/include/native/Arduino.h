@@ -0,0 +1,8 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// The Arduino core of native builds, for the sources that include it by its usual name. Only the native environment
+// has this directory on its include path, so the boards still get the real core.
+#include <MockArduino.h>
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,55 @@
+#ifndef CASCADE_CONTROLLER_H
+#define CASCADE_CONTROLLER_H
+
+#include "constants.h"
+#include "control_loop_interfaces.h"
+
+#include <PID_v1.h>
+
+/**
+ * Outer loop of a cascade that sets the heater power from the flow loop's demand.
+ *
+ * The main valve splits the condensate between take-off and reflux, so its duty cycle is roughly the share of the
+ * column's distillate that is taken off. A duty pinned at full means the column cannot keep up with the requested
+ * flow; a low duty means heat is spent on reflux the flow does not need. This loop drives the duty to
+ * 1 / (1 + CASCADE_CAPACITY_MARGIN), so the column makes the requested flow plus a little margin, and the inner flow
+ * loop keeps the fine take-off control. The heater runs in burst fire, so the power can follow in small steps.
+ */
+class CascadeController {
+private:
+  IFlowLoop &flowController;               /**< Inner loop, whose valve duty is measured. */
+  IHeaterPower &heaterController;          /**< Heater whose power is set. */
+  double input{0}, output{0}, setpoint{0}; /**< Variables for PID control. */
+  PID pid;                                 /**< Valve duty to heater power. */
+
+public:
+  /**
+   * Constructor for the CascadeController class. The cascade starts disabled.
+   * @param flowController Inner loop, whose valve duty is measured.
+   * @param heaterController Heater whose power is set.
+   */
+  CascadeController(IFlowLoop &flowController, IHeaterPower &heaterController);
+
+  /**
+   * Hands the heater power to the cascade, starting from the current power. Does nothing if already enabled.
+   */
+  void enable();
+
+  /**
+   * Takes the heater power back from the cascade, leaving it where the cascade last set it.
+   */
+  void disable();
+
+  /**
+   * Sets the heater power from the valve duty, once per CASCADE_PID_SAMPLE_TIME_MS while enabled.
+   */
+  void update();
+
+  /**
+   * Checks whether the cascade sets the heater power.
+   * @return True if the cascade is enabled, false otherwise.
+   */
+  [[nodiscard]] bool isEnabled() const;
+};
+
+#endif // CASCADE_CONTROLLER_H
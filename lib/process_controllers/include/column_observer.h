@@ -0,0 +1,124 @@
+#ifndef COLUMN_OBSERVER_H
+#define COLUMN_OBSERVER_H
+
+#include "constants.h"
+#include "heater_controller.h"
+#include "thermometer_controller.h"
+
+#include <array>
+
+#ifndef UNIT_TEST
+#include "Arduino.h"
+#else
+// The observer's time step comes from millis(); the mock implementation lives in the test files
+#include "mock_arduino.h"
+#endif
+
+/**
+ * State observer for the column temperatures and the vapour rate.
+ *
+ * Each thermometer channel runs a two-state Kalman filter on temperature and rate of change, fed with the latest
+ * unfiltered reading instead of the median, so estimates follow the column without the median's lag of several
+ * samples. Each reading is folded in at the time it was acquired, which can be most of a tick before the update
+ * that sees it, and the estimates are extrapolated from there to the last update with the estimated rate. The
+ * vapour rate is inferred from an energy balance on the boiler: heater power, less the heat going into warming the
+ * mash and the heat lost through the walls, boils off vapour.
+ *
+ * All state lives in fixed-size arrays, and update() does a fixed amount of work per channel, so it runs in
+ * bounded time on every tick.
+ */
+class ColumnObserver {
+private:
+  /**
+   * Kalman filter state for one channel.
+   */
+  struct ChannelEstimate {
+    float temperature{0.0F};           /**< Estimated temperature in degrees Celsius. */
+    float rate{0.0F};                  /**< Estimated rate of change in degrees Celsius per second. */
+    float varianceTemperature{0.0F};   /**< Covariance entry P00. */
+    float covariance{0.0F};            /**< Covariance entries P01 and P10. */
+    float varianceRate{0.0F};          /**< Covariance entry P11. */
+    unsigned long seenReadingCount{0}; /**< Reading count of the thermometer at the last correction. */
+    unsigned long estimateTime{0};     /**< Acquisition time of the last corrected reading in milliseconds. */
+    bool initialized{false};           /**< Whether the first reading has been received. */
+  };
+
+  const ThermometerController &thermometerController;    /**< Source of the temperature readings. */
+  const HeaterController &heaterController;              /**< Source of the heater power. */
+  std::array<ChannelEstimate, CHANNEL_COUNT> channels{}; /**< One filter per thermometer channel. */
+  float vapourRate{0.0F};                                /**< Filtered vapour rate in grams per minute. */
+  unsigned long lastUpdateTime{0};                       /**< Time of the last update in milliseconds. */
+  bool started{false};                                   /**< Whether update() has run before. */
+
+  /**
+   * Propagates one channel's estimate forward in time.
+   * @param channel The channel estimate.
+   * @param dt The time step in seconds.
+   */
+  static void predict(ChannelEstimate &channel, float dt);
+
+  /**
+   * Corrects one channel's estimate with a new reading.
+   * @param channel The channel estimate.
+   * @param measurement The reading in degrees Celsius.
+   */
+  static void correct(ChannelEstimate &channel, float measurement);
+
+  /**
+   * Updates the vapour rate from the boiler energy balance.
+   * @param dt The time step in seconds.
+   */
+  void updateVapourRate(float dt);
+
+public:
+  /**
+   * Constructor for the ColumnObserver class.
+   * @param thermometerController The controller providing the thermometer readings.
+   * @param heaterController The controller providing the heater power.
+   */
+  ColumnObserver(const ThermometerController &thermometerController, const HeaterController &heaterController);
+
+  /**
+   * Folds in any readings that arrived since the last update, each at its acquisition time, and advances the
+   * estimates to the current time.
+   * Call once per tick, after the thermometers have been updated.
+   */
+  void update();
+
+  /**
+   * Checks whether a channel has received its first reading.
+   * @param channel The thermometer channel.
+   * @return True if the channel's estimates are valid, false otherwise.
+   */
+  [[nodiscard]] bool isInitialized(ThermometerChannel channel) const;
+
+  /**
+   * Returns the filtered temperature of a channel, extrapolated from its last reading to the last update.
+   * @param channel The thermometer channel.
+   * @return The estimated temperature in degrees Celsius.
+   */
+  [[nodiscard]] float getTemperature(ThermometerChannel channel) const;
+
+  /**
+   * Returns the filtered temperature of a channel in raw steps, so it can be compared against raw thresholds and
+   * readings in integer arithmetic.
+   * @param channel The thermometer channel.
+   * @return The estimated temperature in 1/16 °C steps, rounded to the nearest step.
+   */
+  [[nodiscard]] RawTemperature getRawTemperature(ThermometerChannel channel) const;
+
+  /**
+   * Returns the estimated rate of change of a channel.
+   * @param channel The thermometer channel.
+   * @return The estimated rate in degrees Celsius per minute.
+   */
+  [[nodiscard]] float getTemperatureRate(ThermometerChannel channel) const;
+
+  /**
+   * Returns the inferred rate at which the boiler produces vapour.
+   * @return The vapour rate in grams per minute.
+   */
+  [[nodiscard]] float getVapourRate() const;
+};
+
+#endif // COLUMN_OBSERVER_H
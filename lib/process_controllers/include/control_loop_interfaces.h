@@ -0,0 +1,94 @@
+#ifndef CONTROL_LOOP_INTERFACES_H
+#define CONTROL_LOOP_INTERFACES_H
+
+#include <distillation_state_manager.h>
+#include <relay_autotuner.h>
+#include <scale.h>
+
+/**
+ * @brief Interface for the flow loop, as seen by the cascade above it.
+ *
+ * Implemented by FlowController, and by mocks in the tests.
+ */
+class IFlowLoop {
+public:
+  /** Virtual destructor for proper cleanup */
+  virtual ~IFlowLoop() = default;
+
+  /**
+   * @brief Returns the duty cycle the main valve was last given.
+   * @return The duty, 0 to 1.
+   */
+  [[nodiscard]] virtual double getValveDuty() const = 0;
+
+  /**
+   * @brief Returns the progress of the latest autotune.
+   * @return The autotune state.
+   */
+  [[nodiscard]] virtual AutotuneState getAutotuneState() const = 0;
+};
+
+/**
+ * @brief Interface for the heater power, as set by the cascade.
+ *
+ * Implemented by HeaterController, and by mocks in the tests.
+ */
+class IHeaterPower {
+public:
+  /** Virtual destructor for proper cleanup */
+  virtual ~IHeaterPower() = default;
+
+  /**
+   * @brief Returns the current power level of the heaters.
+   * @return The current power level (0-6000), the average one in burst-fire mode.
+   */
+  [[nodiscard]] virtual int getPower() const = 0;
+
+  /**
+   * @brief Sets the average power level of the heaters in burst-fire mode.
+   * @param power The power level to set, clamped to 0 to HEATER_POWER_LEVEL_MAX.
+   */
+  virtual void setBurstFirePower(int power) = 0;
+};
+
+/**
+ * @brief Interface for the main valve, as driven by the flow loop.
+ *
+ * Implemented by ValveController, and by mocks in the tests.
+ */
+class IMainValve {
+public:
+  /** Virtual destructor for proper cleanup */
+  virtual ~IMainValve() = default;
+
+  /**
+   * @brief Closes the main valve at once, and keeps it closed.
+   */
+  virtual void closeMainValve() = 0;
+
+  /**
+   * @brief Sets the share of each PWM window the main valve is open, from the next window on.
+   * @param duty The duty cycle, 0 to 1.
+   */
+  virtual void setMainValveDuty(double duty) = 0;
+};
+
+/**
+ * @brief Interface for the scale readings, as measured by the flow loop.
+ *
+ * Implemented by ScaleController, and by fakes in the tests.
+ */
+class IScaleReadings {
+public:
+  /** Virtual destructor for proper cleanup */
+  virtual ~IScaleReadings() = default;
+
+  /**
+   * @brief Returns the newest reading of the scale for the provided state, stamped with its acquisition time.
+   * @param state The distillate state for which to get the reading.
+   * @return The last reading, or a weight of -1 with sequence 0 for a state without a scale.
+   */
+  [[nodiscard]] virtual ScaleReading getLastReading(DistillationState state) const = 0;
+};
+
+#endif // CONTROL_LOOP_INTERFACES_H
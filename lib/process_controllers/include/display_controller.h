@@ -8,26 +8,54 @@
 #include "thermometer_controller.h"
 
 #include <array>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 
 // Time constants
+constexpr unsigned long MS_PER_SECOND = 1000;
 constexpr unsigned long SECONDS_PER_HOUR = 3600;
 constexpr unsigned long SECONDS_PER_MINUTE = 60;
 constexpr int TIME_BUFFER_SIZE = 9; // HH:MM:SS + null terminator
 
+/**
+ * Shows the distillation on the LCD.
+ *
+ * Every write to the LCD goes over I2C through the multiplexer, so the rows last written are kept and a row is only
+ * written again when its text changes. Rows are padded to the width of the display instead of clearing it first, so
+ * a refresh usually costs one row, the elapsed time, rather than a clear and four rows.
+ */
 class DisplayController {
 private:
   Lcd &lcd;
   ThermometerController &thermometerController;
   ScaleController &scaleController;
   FlowController &flowController;
+  std::array<std::array<char, LCD_COLUMNS + 1>, LCD_ROWS> shownRows{}; /**< Text on each row, padded to the width. */
+
+  /**
+   * Writes a row if its text differs from what the row shows.
+   * @param text The text; cut to the width of the display.
+   * @param row The row.
+   */
+  void showRow(const String &text, int row) {
+    std::array<char, LCD_COLUMNS + 1> padded{};
+    snprintf(padded.data(), padded.size(), "%-*s", LCD_COLUMNS, text.c_str());
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+    std::array<char, LCD_COLUMNS + 1> &shown = shownRows[row];
+    if (strcmp(padded.data(), shown.data()) == 0) {
+      return;
+    }
+    lcd.writeToRow(String(padded.data()), row);
+    shown = padded;
+  }
 
   /**
    * Returns the elapsed time since the start of distillation in the format HH:MM:SS.
    */
   static String getElapsedTimeFormatted() {
-    unsigned long elapsedTime = DistillationStateManager::getInstance().getElapsedTime();
+    unsigned long elapsedTime = DistillationStateManager::getInstance().getElapsedTime() / MS_PER_SECOND;
     unsigned long hours = elapsedTime / SECONDS_PER_HOUR;
     unsigned long minutes = (elapsedTime % SECONDS_PER_HOUR) / SECONDS_PER_MINUTE;
     unsigned long seconds = elapsedTime % SECONDS_PER_MINUTE;
@@ -46,11 +74,10 @@ public:
       flowController(flowController) {}
 
   void displayDistillationInfo() {
-    lcd.clear();
-    lcd.writeToRow("Elapsed: " + getElapsedTimeFormatted(), 0);
-    lcd.writeToRow("State: " + String(DistillationStateManager::getInstance().getState()), 1);
-    lcd.writeToRow("Flow: " + String(flowController.getFlowRate(), 0) + "ml/min", 2);
-    lcd.writeToRow(
+    showRow("Elapsed: " + getElapsedTimeFormatted(), 0);
+    showRow("State: " + String(DistillationStateManager::getInstance().getState()), 1);
+    showRow("Flow: " + String(flowController.getFlowRate(), 0) + "ml/min", 2);
+    showRow(
         "Volume: " +
             String(scaleController.getWeight(DistillationStateManager::getInstance().getState()) / ALCOHOL_DENSITY, 1) +
             "ml",
@@ -58,11 +85,10 @@ public:
   }
 
   void displayTemperatureInfo() {
-    lcd.clear();
-    lcd.writeToRow("Top: " + String(thermometerController.getTopTemperature(), 1), 0);
-    lcd.writeToRow("Middle: " + String(thermometerController.getNearTopTemperature(), 1), 1);
-    lcd.writeToRow("Bottom: " + String(thermometerController.getBottomTemperature(), 1), 2);
-    lcd.writeToRow("Mash tun: " + String(thermometerController.getMashTunTemperature(), 1), 3);
+    showRow("Top: " + String(thermometerController.getTopTemperature(), 1), 0);
+    showRow("Middle: " + String(thermometerController.getNearTopTemperature(), 1), 1);
+    showRow("Bottom: " + String(thermometerController.getBottomTemperature(), 1), 2);
+    showRow("Mash tun: " + String(thermometerController.getMashTunTemperature(), 1), 3);
   }
 };
 
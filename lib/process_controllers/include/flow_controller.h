@@ -4,39 +4,84 @@
 #include <PID_v1.h>
 #include <cmath> // For std::abs
 #include <constants.h>
+#include <control_loop_interfaces.h>
 #include <distillation_state_manager.h>
-#include <scale_controller.h>
-#include <valve_controller.h>
+#include <flow_rate_estimator.h>
+#include <relay_autotuner.h>
 
 /**
  * Class for handling flow control.
+ *
+ * The PID compares the requested flow rate with an estimate of the actual one: the mean weight over the last main
+ * valve PWM window against the window before, from the scale readings at the times their conversions were taken.
+ * Readings reach the loop late and at irregular intervals, so stamping them with the control time would make the
+ * measured flow lag and jitter.
+ *
+ * The gains can be measured on the still itself: during an autotune a relay takes the PID's place and drives the main
+ * valve open and closed around the requested rate, on the same timestamped estimates, until the flow settles into a
+ * limit cycle. The PI gains derived from it replace the PID's, and the PID resumes. Until then, or if the experiment
+ * fails, the PID runs on the FLOW_PID_KP, FLOW_PID_KI and FLOW_PID_KD defaults, which are sized so that an error of a
+ * few ml/min moves the duty part of the way rather than saturating it.
  */
-class FlowController {
+class FlowController : public IFlowLoop {
 private:
-  ValveController *valveController;        /**< Pointer to ValveController object for controlling valves. */
-  ScaleController *scaleController;        /**< Pointer to ScaleController object for controlling scales. */
+  IMainValve *valveController;             /**< Main valve the loop drives. */
+  IScaleReadings *scaleController;         /**< Scales the loop measures the flow on. */
   double input{0}, output{0}, setpoint{0}; /**< Variables for PID control. */
   PID pid;                                 /**< PID object for flow control. */
   double flowRate{0};                      /**< Flow rate in ml/min. */
-  unsigned long startTime{0};              /**< Time at the start of the state. */
-  double startVolume{0};                   /**< Alcohol volume at the start of the state. */
+  FlowRateEstimator flowRateEstimator;     /**< Measured flow rate, from timestamped scale readings. */
+  DistillationState estimatedState{OFF};   /**< State whose scale feeds the estimator. */
+  unsigned long measuredTime{0};           /**< Acquisition time of the newest reading in the estimate. */
+  RelayAutotuner autotuner;                /**< Relay experiment that stands in for the PID during an autotune. */
 
   /**
-   * Returns the current volume of alcohol.
+   * Feeds the newest reading of the current fraction's scale to the flow rate estimator.
+   * The estimate restarts when the outlet moves to another scale, which also abandons an autotune.
+   * @return True if the reading was new, false otherwise.
    */
-  [[nodiscard]] double getCurrentVolume() {
-    return scaleController->getWeight(DistillationStateManager::getInstance().getState()) / ALCOHOL_DENSITY;
+  bool updateMeasuredFlowRate() {
+    DistillationState state = DistillationStateManager::getInstance().getState();
+    if (state != estimatedState) {
+      flowRateEstimator.clear();
+      estimatedState = state;
+      cancelAutotune();
+    }
+    ScaleReading reading = scaleController->getLastReading(state);
+    if (!flowRateEstimator.add(reading)) {
+      return false;
+    }
+    measuredTime = reading.timeMs;
+    return true;
+  }
+
+  /**
+   * Feeds a new estimate to the relay and hands control back to the PID once the experiment ends.
+   * A successful experiment replaces the PID gains with the PI gains it measured; a failed one keeps the old gains.
+   */
+  void updateAutotune() {
+    output = autotuner.update(input, measuredTime);
+    AutotuneState state = autotuner.getState();
+    if (state == AUTOTUNE_DONE) {
+      applyTuning(autotuner.getTuning(TUNING_RULE_PI));
+    }
+    if (state != AUTOTUNE_RUNNING) {
+      pid.SetMode(AUTOMATIC);
+    }
   }
 
 public:
   /**
    * Constructor for the FlowController class.
-   * @param valveController Pointer to ValveController object for controlling valves.
-   * @param scaleController Pointer to ScaleController object for controlling scales.
+   * @param valveController Main valve the loop drives, usually the ValveController.
+   * @param scaleController Scales the loop measures the flow on, usually the ScaleController.
    */
-  FlowController(ValveController *valveController, ScaleController *scaleController)
+  FlowController(IMainValve *valveController, IScaleReadings *scaleController)
     : valveController(valveController), scaleController(scaleController),
-      pid(&input, &output, &setpoint, TEST_PID_KP, TEST_PID_KI, TEST_PID_KD, DIRECT) {
+      pid(&input, &output, &setpoint, FLOW_PID_KP, FLOW_PID_KI, FLOW_PID_KD, DIRECT) {
+    pid.SetOutputLimits(FLOW_PID_OUTPUT_MIN, FLOW_PID_OUTPUT_MAX);
+    pid.SetSampleTime(FLOW_PID_SAMPLE_TIME_MS);
+    pid.SetDerivativeFilter(FLOW_PID_DERIVATIVE_FILTER_S);
     pid.SetMode(AUTOMATIC);
     valveController->closeMainValve();
   }
@@ -48,48 +93,124 @@ public:
   [[nodiscard]] double getFlowRate() const { return flowRate; }
 
   /**
-   * Sets and controls the flow rate.
-   *
-   * This method first checks if the new flow rate is different from the current one.
-   * If it is, it updates the flow rate, start volume, and start time.
-   *
-   * If the flow rate is zero, the main valve is closed and the method returns.
+   * Returns the flow rate measured by the scale under the outlet.
+   * @return The estimated flow rate in ml/min, or 0 until enough readings have arrived.
+   */
+  [[nodiscard]] double getMeasuredFlowRate() const { return flowRateEstimator.getFlowRate(); }
+
+  /**
+   * Returns the duty cycle the main valve was last given.
+   * @return The duty, 0 to 1.
+   */
+  [[nodiscard]] double getValveDuty() const override { return output; }
+
+  /**
+   * Starts a relay autotune around the current flow rate, from the newest reading on.
+   * @return True if the autotune started, false if there is no flow rate to tune around or no estimate yet.
+   */
+  bool startAutotune() {
+    if (flowRate == 0 || !flowRateEstimator.isReady()) {
+      return false;
+    }
+    const double bias = (FLOW_PID_OUTPUT_MIN + FLOW_PID_OUTPUT_MAX) / 2;
+    autotuner.start(flowRate, bias, FLOW_PID_OUTPUT_MAX - bias, FLOW_AUTOTUNE_HYSTERESIS, FLOW_AUTOTUNE_TIMEOUT_MS,
+                    measuredTime);
+    pid.SetMode(MANUAL);
+    return true;
+  }
+
+  /**
+   * Abandons a running autotune and hands control back to the PID with its old gains, from the relay's last output.
+   */
+  void cancelAutotune() {
+    if (autotuner.getState() != AUTOTUNE_RUNNING) {
+      return;
+    }
+    autotuner.cancel();
+    pid.SetMode(AUTOMATIC);
+  }
+
+  /**
+   * Returns the progress of the latest autotune.
+   * @return The autotune state.
+   */
+  [[nodiscard]] AutotuneState getAutotuneState() const override { return autotuner.getState(); }
+
+  /**
+   * Returns the gains measured by the latest autotune.
+   * @return The PI gains, all zero unless the autotune is done.
+   */
+  [[nodiscard]] PidTuning getAutotunedTuning() const { return autotuner.getTuning(TUNING_RULE_PI); }
+
+  /**
+   * Returns the gains the PID runs on.
+   * @return The defaults, or the gains last applied.
+   */
+  [[nodiscard]] PidTuning getTuning() const { return {pid.GetKp(), pid.GetKi(), pid.GetKd()}; }
+
+  /**
+   * Replaces the PID gains, such as with gains stored by an earlier autotune.
+   * @param tuning The gains.
+   */
+  void applyTuning(const PidTuning &tuning) { pid.SetTunings(tuning.kp, tuning.ki, tuning.kd); }
+
+  /**
+   * Sets the flow rate the loop controls to, from the next control step on.
    *
-   * If the flow rate is non-zero, the method controls the flow based on the PID output.
+   * A rate that differs from the current one becomes the PID setpoint and abandons a running autotune, since the
+   * relay switches around the old rate.
    *
    * @param newFlowRate The desired flow rate in ml/min.
    */
-  void setAndControlFlowRate(double newFlowRate) {
+  void setFlowRate(double newFlowRate) {
     const double epsilon = 0.001;
 
     // Check if the new flow rate is significantly different from the current one
     if (std::abs(newFlowRate - flowRate) > epsilon) {
       flowRate = newFlowRate;
-      startVolume = getCurrentVolume();
-      startTime = millis();
+      setpoint = flowRate;
+      cancelAutotune(); // The relay switches around the old rate
     }
+  }
 
+  /**
+   * Runs one control step at the current flow rate.
+   *
+   * If the flow rate is zero, the main valve is closed. Otherwise the main valve's duty cycle is set to the PID
+   * output, with the measured flow rate as the PID input; the PID computes once per FLOW_PID_SAMPLE_TIME_MS however
+   * often it is called. During an autotune the relay sets the output instead, once per new reading. Until the estimate
+   * is ready, after startup or a move to another scale, the duty stays where it was. Called from the fast rate group,
+   * so a new reading is acted on within a fast period rather than a control task period.
+   */
+  void controlFlowRate() {
     if (flowRate == 0) {
+      cancelAutotune();
       valveController->closeMainValve();
       return;
     }
 
-    unsigned long currentMillis = millis();
-    double elapsedTimeInMinutes = static_cast<double>(currentMillis - startTime) / MS_TO_MINUTES;
-    double expectedVolume = flowRate * elapsedTimeInMinutes;
-    double currentVolume = getCurrentVolume();
-    input = expectedVolume - (currentVolume - startVolume);
-    PID::Compute();
-
-    double tolerance = TEST_TOLERANCE;
-    if (output > tolerance) {
-      valveController->openMainValve();
-    } else if (output < -tolerance) {
-      valveController->closeMainValve();
+    bool newReading = updateMeasuredFlowRate();
+    input = flowRateEstimator.getFlowRate();
+    if (!flowRateEstimator.isReady()) {
+      // The estimate would still follow the valve's ripple, so neither the PID nor the relay acts on it yet
+    } else if (autotuner.getState() == AUTOTUNE_RUNNING) {
+      if (newReading) {
+        updateAutotune();
+      }
     } else {
-      // If the output is close to 0 (within the tolerance), the valve remains in its current state
-      // You can add additional logic here if you want to handle this situation differently
+      pid.Compute();
     }
+
+    valveController->setMainValveDuty(output);
+  }
+
+  /**
+   * Sets the flow rate and runs one control step at it.
+   * @param newFlowRate The desired flow rate in ml/min.
+   */
+  void setAndControlFlowRate(double newFlowRate) {
+    setFlowRate(newFlowRate);
+    controlFlowRate();
   }
 };
 
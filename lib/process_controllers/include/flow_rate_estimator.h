@@ -0,0 +1,135 @@
+#ifndef FLOW_RATE_ESTIMATOR_H
+#define FLOW_RATE_ESTIMATOR_H
+
+#include <array>
+#include <constants.h>
+#include <cstddef>
+#include <cstdint>
+#include <scale.h>
+
+/**
+ * Estimate of the distillate flow rate from timestamped scale readings: the mean weight over the last main valve PWM
+ * window against the mean over the window before it.
+ *
+ * The valve lets the distillate through in pulses, once per MAIN_VALVE_PWM_WINDOW_MS, so the weight climbs in steps
+ * on top of its trend. Averaged over exactly one window, the steps contribute the same whatever the phase, and the
+ * difference between two consecutive windows' means is the trend alone. Averaging also keeps the noise of single
+ * conversions out: at low flow a window adds little more weight than the HX711's noise on one reading.
+ *
+ * The weight is taken at the time each reading was acquired, not the time it reaches the control loop, so readings
+ * that are several conversions old, or that arrive in bursts, do not distort the rate. Each reading is added once,
+ * recognised by its sequence number, so the estimator can be fed on every control tick whether or not the scale has
+ * produced a new reading. The rate is worked out once per reading added, not on every query.
+ *
+ * Readings less than FLOW_RATE_SLOT_MS apart share a slot that keeps their mean weight and how many they are, so the
+ * slots always reach across both windows, however fast the scale converts.
+ */
+class FlowRateEstimator {
+private:
+  std::array<unsigned long, FLOW_RATE_SLOTS> times{}; /**< Time of each slot's first reading, as a ring buffer. */
+  std::array<float, FLOW_RATE_SLOTS> weights{};       /**< Mean weight of each slot's readings, parallel to times. */
+  std::array<uint16_t, FLOW_RATE_SLOTS> readings{};   /**< Readings in each slot, parallel to times. */
+  std::size_t next{0};                                /**< Index where the next slot is stored. */
+  std::size_t count{0};                               /**< Number of slots held. */
+  unsigned long newestTime{0};                        /**< Acquisition time of the newest reading added. */
+  unsigned long lastSequence{0};                      /**< Sequence number of the newest reading added. */
+  double flowRate{0};                                 /**< Rate over the readings held, or 0 until ready. */
+
+  /**
+   * Returns the buffer index of a slot, counted from the oldest.
+   * @param age 0 for the oldest slot held.
+   * @return The index into times, weights and readings.
+   */
+  [[nodiscard]] std::size_t indexOf(std::size_t age) const {
+    return (next + FLOW_RATE_SLOTS - count + age) % FLOW_RATE_SLOTS;
+  }
+
+  /**
+   * Works out the flow rate from the readings held.
+   * @return The volume gained per minute between the means of the two windows, or 0 until isReady().
+   */
+  [[nodiscard]] double computeFlowRate() const {
+    if (!isReady()) {
+      return 0.0;
+    }
+    // Sums are taken relative to the oldest reading and the newest time, so float weights keep their precision
+    float baseWeight = weights[indexOf(0)];
+    // Index 0 is the older window, 1 the newer. A slot counts once per reading it holds
+    std::array<double, 2> weightSums{};
+    std::array<double, 2> ageSums{};
+    std::array<std::size_t, 2> counts{};
+    for (std::size_t age = 0; age < count; age++) {
+      std::size_t index = indexOf(age);
+      unsigned long slotAge = newestTime - times[index];
+      std::size_t window = slotAge < FLOW_RATE_WINDOW_MS ? 1 : 0;
+      weightSums[window] += static_cast<double>(weights[index] - baseWeight) * readings[index];
+      ageSums[window] += static_cast<double>(slotAge) * readings[index];
+      counts[window] += readings[index];
+    }
+    // Once ready, both windows hold readings. Their mean times stand in for the window length, so irregular reading
+    // intervals do not bias the rate
+    double spanMs = ageSums[0] / static_cast<double>(counts[0]) - ageSums[1] / static_cast<double>(counts[1]);
+    double gained = (weightSums[1] / static_cast<double>(counts[1]) - weightSums[0] / static_cast<double>(counts[0])) /
+                    ALCOHOL_DENSITY;
+    return gained * MS_TO_MINUTES / spanMs;
+  }
+
+public:
+  /**
+   * Adds a scale reading, unless it was already added or the scale has no reading yet. Readings two
+   * FLOW_RATE_WINDOW_MS or more older than it leave the estimate.
+   * @param reading The newest reading of the scale under the outlet.
+   * @return True if the reading was added, false if it was ignored.
+   */
+  bool add(const ScaleReading &reading) {
+    if (reading.sequence == 0 || reading.sequence == lastSequence) {
+      return false;
+    }
+    lastSequence = reading.sequence;
+    newestTime = reading.timeMs;
+    std::size_t newest = indexOf(count - 1);
+    if (count > 0 && reading.timeMs - times[newest] < FLOW_RATE_SLOT_MS && readings[newest] < UINT16_MAX) {
+      readings[newest]++;
+      weights[newest] += (reading.weight - weights[newest]) / static_cast<float>(readings[newest]);
+    } else {
+      times[next] = reading.timeMs;
+      weights[next] = reading.weight;
+      readings[next] = 1;
+      next = (next + 1) % FLOW_RATE_SLOTS;
+      count = count < FLOW_RATE_SLOTS ? count + 1 : count;
+    }
+    while (count > 1 && reading.timeMs - times[indexOf(0)] >= 2 * FLOW_RATE_WINDOW_MS) {
+      count--;
+    }
+    flowRate = computeFlowRate();
+    return true;
+  }
+
+  /**
+   * Returns the estimated flow rate, as of the newest reading added.
+   * @return The volume gained per minute between the means of the two windows, or 0 until isReady().
+   */
+  [[nodiscard]] double getFlowRate() const { return flowRate; }
+
+  /**
+   * Checks whether the readings span both windows. Until they do, a window's mean holds only part of a valve cycle
+   * and the rate would follow the valve's ripple.
+   * @return True once the readings span two windows, short of FLOW_RATE_SPAN_TOLERANCE_MS, false otherwise.
+   */
+  [[nodiscard]] bool isReady() const {
+    return count > 1 && newestTime - times[indexOf(0)] + FLOW_RATE_SPAN_TOLERANCE_MS >= 2 * FLOW_RATE_WINDOW_MS;
+  }
+
+  /**
+   * Removes every reading, for when the outlet moves to another scale.
+   */
+  void clear() {
+    next = 0;
+    count = 0;
+    newestTime = 0;
+    lastSequence = 0;
+    flowRate = 0.0;
+  }
+};
+
+#endif // FLOW_RATE_ESTIMATOR_H
@@ -2,17 +2,42 @@
 #define HEATER_CONTROLLER_H
 
 #include "constants.h"
+#include "control_loop_interfaces.h"
 #include "relay.h"
+#include "time_proportioned_output.h"
 
 #include <array>
 
 /**
  * Class for controlling heaters.
+ *
+ * The three heaters are relay stages of 1, 2 and 3 × HEATER_POWER_LEVEL_1, which add up to any multiple of
+ * HEATER_POWER_LEVEL_1 up to HEATER_POWER_LEVEL_MAX. setPower() switches straight to such a sum. In burst-fire mode
+ * any power in between is delivered on average instead: within each HEATER_BURST_WINDOW_MS window the stages spend a
+ * share of the time at the sum above the requested power and the rest at the sum below it. Adjacent sums always
+ * differ by HEATER_POWER_LEVEL_1, so the share sets the power in steps of a few watts, and a burst cut by the minimum
+ * dwell is made up in later windows. Each relay then switches only a few times per window, well within contact life.
+ *
+ * The energy the stages actually deliver is integrated over time, in either mode.
  */
-class HeaterController {
+class HeaterController : public IHeaterPower {
 private:
   std::array<Relay *, 3> heaters; /**< Array of pointers to Relay objects for controlling the heaters. */
   int power{0};                   /**< Power level of the heaters. */
+  int appliedPower{0};            /**< Sum of the stages that are on. */
+  bool burstFire{false};          /**< Whether update() modulates the stages. */
+  bool windowPending{false};      /**< Whether burst fire has yet to take up its first window. */
+  int burstBase{0};               /**< Lower sum of stages in the current window. */
+  int pendingBase{0};             /**< Lower sum of stages for the requested power, taken up at the next window. */
+  TimeProportionedOutput burst;   /**< Share of each window at burstBase + HEATER_POWER_LEVEL_1. */
+  double deliveredEnergy{0};      /**< Energy delivered up to lastChange, in joules. */
+  unsigned long lastChange{0};    /**< Time the applied power last changed. */
+
+  /**
+   * Switches the heaters to the stages that add up to a power, and books the energy of the previous stages.
+   * @param stagePower The power; the largest sum of stages not above it is applied.
+   */
+  void applyStages(int stagePower);
 
 public:
   /**
@@ -24,16 +49,39 @@ public:
   HeaterController(Relay &relay1, Relay &relay2, Relay &relay3);
 
   /**
-   * Sets the power level of the heaters.
+   * Sets the power level of the heaters, as a sum of stages, and leaves burst-fire mode.
    * @param power The power level to set (0-6000).
    */
   void setPower(int power);
 
+  /**
+   * Sets the average power level of the heaters in burst-fire mode. update() then modulates the stages.
+   * @param power The power level to set, clamped to 0 to HEATER_POWER_LEVEL_MAX.
+   */
+  void setBurstFirePower(int power) override;
+
+  /**
+   * Modulates the stages in burst-fire mode. Call it about once a second, well within HEATER_MIN_DWELL_MS.
+   */
+  void update();
+
   /**
    * Returns the current power level of the heaters.
-   * @return The current power level (0-6000).
+   * @return The current power level (0-6000), the average one in burst-fire mode.
+   */
+  [[nodiscard]] int getPower() const override;
+
+  /**
+   * Returns the power of the stages that are on right now.
+   * @return The applied power in watts.
+   */
+  [[nodiscard]] int getAppliedPower() const;
+
+  /**
+   * Returns the energy the stages have delivered since startup.
+   * @return The delivered energy in joules.
    */
-  [[nodiscard]] int getPower() const;
+  [[nodiscard]] double getDeliveredEnergy() const;
 };
 
 #endif // HEATER_CONTROLLER_H
@@ -1,14 +1,38 @@
 #ifndef SCALE_CONTROLLER_H
 #define SCALE_CONTROLLER_H
 
+#include <array>
+#include <calibration_store.h>
+#include <constants.h>
+#include <control_loop_interfaces.h>
 #include <distillation_state_manager.h>
 #include <logger.h>
 #include <scale.h>
 
+#ifndef UNIT_TEST
+#include "Arduino.h"
+#else
+// The idle check interval comes from millis(); the mock implementation lives in the test files
+#include "mock_arduino.h"
+#endif
+
+constexpr uint8_t SCALE_COUNT = 6; /**< Number of collection vessels, each on its own scale. */
+static_assert(SCALE_COUNT <= CALIBRATION_STORE_SLOTS, "Every scale needs a calibration store slot");
+
+/**
+ * Fraction collected into each scale's vessel, in the order of ScaleController::scales.
+ */
+constexpr DistillationState SCALE_COLLECTION_STATES[SCALE_COUNT] = {EARLY_FORESHOTS, LATE_FORESHOTS, HEADS,
+                                                                    HEARTS,          EARLY_TAILS,    LATE_TAILS};
+
 /**
  * Class for managing scales.
+ *
+ * Only the scale under the fraction being collected changes, so sampling follows the distillation state: that scale
+ * is updated on every call, while the others are powered down and woken once every SCALE_IDLE_CHECK_INTERVAL_MS
+ * for a single reading that keeps their weights and connection status current.
  */
-class ScaleController {
+class ScaleController : public IScaleReadings {
 private:
   Scale &earlyForeshotsScale; /**< Scale for weighing the early foreshots. */
   Scale &lateForeshotsScale;  /**< Scale for weighing the late foreshots. */
@@ -16,6 +40,9 @@ private:
   Scale &heartsScale;         /**< Scale for weighing the hearts. */
   Scale &earlyTailsScale;     /**< Scale for weighing the early tails. */
   Scale &lateTailsScale;      /**< Scale for weighing the late tails. */
+  std::array<Scale *, SCALE_COUNT> scales;                  /**< The scales, in SCALE_COLLECTION_STATES order. */
+  std::array<unsigned long, SCALE_COUNT> lastCheckTime{};   /**< When each idle scale was last woken. */
+  std::array<unsigned long, SCALE_COUNT> checkStartCount{}; /**< Reading count of each scale when it was woken. */
 
 #if !defined(UNIT_TEST) && !defined(NATIVE)
   Logger *logger = nullptr; /**< Logger for recording events. */
@@ -38,7 +65,9 @@ public:
   ScaleController(Scale &earlyForeshotsScale, Scale &lateForeshotsScale, Scale &headsScale, Scale &heartsScale,
                   Scale &earlyTailsScale, Scale &lateTailsScale, Logger *logger = nullptr)
     : earlyForeshotsScale(earlyForeshotsScale), lateForeshotsScale(lateForeshotsScale), headsScale(headsScale),
-      heartsScale(heartsScale), earlyTailsScale(earlyTailsScale), lateTailsScale(lateTailsScale), logger(logger) {}
+      heartsScale(heartsScale), earlyTailsScale(earlyTailsScale), lateTailsScale(lateTailsScale),
+      scales{{&earlyForeshotsScale, &lateForeshotsScale, &headsScale, &heartsScale, &earlyTailsScale, &lateTailsScale}},
+      logger(logger) {}
 #else
   /**
    * Constructor for the ScaleController class.
@@ -53,7 +82,9 @@ public:
   ScaleController(Scale &earlyForeshotsScale, Scale &lateForeshotsScale, Scale &headsScale, Scale &heartsScale,
                   Scale &earlyTailsScale, Scale &lateTailsScale, Logger *logger = nullptr)
     : earlyForeshotsScale(earlyForeshotsScale), lateForeshotsScale(lateForeshotsScale), headsScale(headsScale),
-      heartsScale(heartsScale), earlyTailsScale(earlyTailsScale), lateTailsScale(lateTailsScale), logger(logger) {
+      heartsScale(heartsScale), earlyTailsScale(earlyTailsScale), lateTailsScale(lateTailsScale),
+      scales{{&earlyForeshotsScale, &lateForeshotsScale, &headsScale, &heartsScale, &earlyTailsScale, &lateTailsScale}},
+      logger(logger) {
 
     if (logger) {
       logger->info("ScaleController initialized");
@@ -70,30 +101,48 @@ public:
 #endif
 
   /**
-   * Updates all the scales' weights.
+   * Updates the scales' weights from the conversions collected since the last call.
+   * The scale of the current fraction, and any scale being calibrated, is updated every time; the others sleep
+   * between periodic checks.
+   * Never waits for an HX711, so the cost does not grow with slow or missing scales.
    */
   void updateAllWeights() {
 #if !defined(UNIT_TEST) && !defined(NATIVE)
     if (logger) {
       logger->debug("Updating all scales");
     }
-
-    // Update each scale and log any failures
-    updateAndLogScale(EARLY_FORESHOTS, earlyForeshotsScale);
-    updateAndLogScale(LATE_FORESHOTS, lateForeshotsScale);
-    updateAndLogScale(HEADS, headsScale);
-    updateAndLogScale(HEARTS, heartsScale);
-    updateAndLogScale(EARLY_TAILS, earlyTailsScale);
-    updateAndLogScale(LATE_TAILS, lateTailsScale);
-#else
-    // In test/native environment, just update all scales
-    earlyForeshotsScale.updateWeight();
-    lateForeshotsScale.updateWeight();
-    headsScale.updateWeight();
-    heartsScale.updateWeight();
-    earlyTailsScale.updateWeight();
-    lateTailsScale.updateWeight();
 #endif
+
+    DistillationState state = DistillationStateManager::getInstance().getState();
+    unsigned long now = millis();
+    for (uint8_t i = 0; i < SCALE_COUNT; i++) {
+      Scale &scale = *scales[i];
+      if (!scale.isConnected()) {
+        continue; // Left to serviceConnections() until it is back online
+      }
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+      DistillationState collectionState = SCALE_COLLECTION_STATES[i];
+      if (collectionState == state || scale.isCalibrating()) {
+        scale.wake();
+        updateScale(collectionState, scale);
+        continue;
+      }
+
+      if (scale.isSleeping()) {
+        if (now - lastCheckTime[i] < SCALE_IDLE_CHECK_INTERVAL_MS) {
+          continue;
+        }
+        scale.wake();
+        lastCheckTime[i] = now;
+        checkStartCount[i] = scale.getReadingCount();
+      }
+      updateScale(collectionState, scale);
+
+      // Power down again once the check has its reading, or the scale turned out to be missing
+      if (scale.getReadingCount() != checkStartCount[i] || !scale.isConnected()) {
+        scale.sleep();
+      }
+    }
   }
 
   /**
@@ -126,39 +175,105 @@ public:
   }
 
   /**
-   * Attempts to reconnect all disconnected scales.
-   * @return Number of scales successfully reconnected.
+   * Returns the newest reading of the scale for the provided state, stamped with its acquisition time.
+   * @param state The distillate state for which to get the reading.
+   * @return The last reading, or a weight of -1 with sequence 0 for a state without a scale.
    */
-  int tryReconnectScales() {
-#if !defined(UNIT_TEST) && !defined(NATIVE)
+  [[nodiscard]] ScaleReading getLastReading(DistillationState state) const override {
+    switch (state) {
+    case EARLY_FORESHOTS:
+      return earlyForeshotsScale.getLastReading();
+    case LATE_FORESHOTS:
+      return lateForeshotsScale.getLastReading();
+    case HEADS:
+      return headsScale.getLastReading();
+    case HEARTS:
+      return heartsScale.getLastReading();
+    case EARLY_TAILS:
+      return earlyTailsScale.getLastReading();
+    case LATE_TAILS:
+      return lateTailsScale.getLastReading();
+    default:
+      return {0, -1.0F, 0};
+    }
+  }
+
+  /**
+   * Advances every disconnected scale towards being online by one step. No step waits for an HX711, so this is
+   * cheap enough to call on every tick; each scale paces its own retries.
+   * @return Number of scales that came online during this call.
+   */
+  int serviceConnections() {
     int reconnectedCount = 0;
+    for (Scale *scale : scales) {
+      if (scale->serviceConnection()) {
+        reconnectedCount++;
+      }
+    }
+    return reconnectedCount;
+  }
 
-    if (logger) {
-      logger->info("Attempting to reconnect all disconnected scales");
+  /**
+   * Applies the stored calibrations, one slot per scale in SCALE_COLLECTION_STATES order.
+   * Call before the scales come online, so they confirm their stored zeros instead of taring.
+   * @param store The calibration store, already loaded.
+   * @return Number of scales that had a stored calibration.
+   */
+  int restoreCalibrations(const CalibrationStore &store) {
+    int restoredCount = 0;
+    for (uint8_t i = 0; i < SCALE_COUNT; i++) {
+      ScaleCalibration calibration{};
+      if (store.get(i, calibration)) {
+        scales[i]->restoreCalibration(calibration); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        restoredCount++;
+      }
     }
+    return restoredCount;
+  }
+
+  /**
+   * Starts calibrating one scale against a known weight placed on it. The scale stays awake until it has measured
+   * the weight; save its calibration with recordCalibrations() once isCalibrating() turns false.
+   * @param index The scale, in SCALE_COLLECTION_STATES order.
+   * @param knownWeight The weight on the scale in grams.
+   * @return True if the calibration started, false for an unknown or offline scale or a weight that is too light.
+   */
+  bool startCalibration(uint8_t index, float knownWeight) {
+    return index < SCALE_COUNT &&
+           scales[index]->startCalibration(knownWeight); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  }
 
-    // Try to reconnect each disconnected scale
-    if (!earlyForeshotsScale.isConnected() && earlyForeshotsScale.tryReconnect())
-      reconnectedCount++;
-    if (!lateForeshotsScale.isConnected() && lateForeshotsScale.tryReconnect())
-      reconnectedCount++;
-    if (!headsScale.isConnected() && headsScale.tryReconnect())
-      reconnectedCount++;
-    if (!heartsScale.isConnected() && heartsScale.tryReconnect())
-      reconnectedCount++;
-    if (!earlyTailsScale.isConnected() && earlyTailsScale.tryReconnect())
-      reconnectedCount++;
-    if (!lateTailsScale.isConnected() && lateTailsScale.tryReconnect())
-      reconnectedCount++;
+  /**
+   * Checks whether a scale is still measuring the known weight of a calibration.
+   * @param index The scale, in SCALE_COLLECTION_STATES order.
+   * @return True while the calibration collects readings, false otherwise.
+   */
+  [[nodiscard]] bool isCalibrating(uint8_t index) const {
+    return index < SCALE_COUNT &&
+           scales[index]->isCalibrating(); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  }
 
-    if (logger) {
-      logger->info("Reconnected %d scales", reconnectedCount);
-    }
+  /**
+   * Checks whether a scale is connected.
+   * @param index The scale, in SCALE_COLLECTION_STATES order.
+   * @return True if the scale is online, false otherwise.
+   */
+  [[nodiscard]] bool isConnected(uint8_t index) const {
+    return index < SCALE_COUNT &&
+           scales[index]->isConnected(); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  }
 
-    return reconnectedCount;
-#else
-    return 0;
-#endif
+  /**
+   * Copies the calibrations of the online scales into the store. Unchanged calibrations leave the store clean.
+   * @param store The calibration store.
+   */
+  void recordCalibrations(CalibrationStore &store) const {
+    for (uint8_t i = 0; i < SCALE_COUNT; i++) {
+      const Scale &scale = *scales[i]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+      if (scale.isConnected()) {
+        store.set(i, scale.getCalibration());
+      }
+    }
   }
 
   /**
@@ -182,6 +297,32 @@ public:
     return count;
   }
 
+  /**
+   * Get the number of scales that came back from a reconnect away from their zero.
+   * @return Scales whose readings may be offset by the load they carried when they reconnected.
+   */
+  int getZeroMismatchCount() const {
+    int count = 0;
+    for (const Scale *scale : scales) {
+      if (scale->hasZeroMismatch()) {
+        count++;
+      }
+    }
+    return count;
+  }
+
+  /**
+   * Get the number of conversions the scales' outlier filters have dropped.
+   * @return Dropped spikes across all scales since startup.
+   */
+  unsigned long getRejectedSampleCount() const {
+    unsigned long count = 0;
+    for (const Scale *scale : scales) {
+      count += scale->getRejectedCount();
+    }
+    return count;
+  }
+
   /**
    * Check if a specific scale is connected.
    * @param state The distillation state corresponding to the scale.
@@ -207,6 +348,20 @@ public:
   }
 
 private:
+  /**
+   * Update a scale, logging any failures in production builds.
+   * @param state The distillation state corresponding to the scale.
+   * @param scale The scale to update.
+   */
+  void updateScale(DistillationState state, Scale &scale) {
+#if !defined(UNIT_TEST) && !defined(NATIVE)
+    updateAndLogScale(state, scale);
+#else
+    (void)state;
+    scale.updateWeight();
+#endif
+  }
+
 #if !defined(UNIT_TEST) && !defined(NATIVE)
   /**
    * Update a scale and log any failures.
@@ -1,27 +1,116 @@
 #ifndef THERMOMETER_CONTROLLER_H
 #define THERMOMETER_CONTROLLER_H
 
+#include "distillation_state_manager.h"
 #include "thermometer.h"
+#include "thermometer_bus.h"
+
+#include <array>
+
+/**
+ * Resolution of each probe during one distillation phase, in bits.
+ */
+struct ThermometerResolutions {
+  uint8_t mashTun;
+  uint8_t bottom;
+  uint8_t nearTop;
+  uint8_t top;
+};
+
+/**
+ * Resolution policy, indexed by DistillationState.
+ *
+ * Heat-up only needs to know roughly where the mash is, so every probe runs at 9 bits and the bus cycles every
+ * 94 ms. Once the column stabilizes the column probes move to finer steps, and the near-top probe, which drives
+ * the hearts cut, runs at full 12-bit resolution while hearts are collected. A phase change writes only the
+ * configuration registers that change, in the scratchpad, so it costs a few milliseconds of bus time per probe
+ * rather than the 20 ms EEPROM copy DallasTemperature would add to each.
+ */
+constexpr ThermometerResolutions THERMOMETER_RESOLUTION_POLICY[] = {
+    {9, 9, 9, 9},     // OFF
+    {9, 9, 9, 9},     // HEAT_UP
+    {9, 10, 10, 10},  // STABILIZING
+    {9, 11, 11, 11},  // EARLY_FORESHOTS
+    {9, 11, 11, 11},  // LATE_FORESHOTS
+    {9, 11, 11, 11},  // HEADS
+    {9, 11, 12, 11},  // HEARTS
+    {9, 11, 11, 11},  // EARLY_TAILS
+    {9, 11, 11, 11},  // LATE_TAILS
+    {9, 9, 9, 9},     // FINALIZING
+};
+
+/**
+ * Returns the probe resolutions for a distillation phase.
+ * @param state The distillation phase.
+ * @return The resolution of each probe in bits.
+ */
+constexpr ThermometerResolutions thermometerResolutionsFor(DistillationState state) {
+  return THERMOMETER_RESOLUTION_POLICY[state];
+}
+
+static_assert(sizeof(THERMOMETER_RESOLUTION_POLICY) / sizeof(THERMOMETER_RESOLUTION_POLICY[0]) == FINALIZING + 1,
+              "Every distillation state needs a resolution policy");
+static_assert(thermometerResolutionsFor(HEARTS).nearTop == DS18B20_MAX_RESOLUTION_BITS,
+              "The hearts cut needs the near-top probe at full resolution");
+
+/**
+ * Position of each thermometer in the controller's pipeline, from the mash tun up to the column top.
+ */
+enum ThermometerChannel : uint8_t { MASH_TUN_CHANNEL, BOTTOM_CHANNEL, NEAR_TOP_CHANNEL, TOP_CHANNEL, CHANNEL_COUNT };
 
 class ThermometerController {
 private:
+  ThermometerBus &bus;
   Thermometer &mashTunThermometer;
   Thermometer &bottomThermometer;
   Thermometer &nearTopThermometer;
   Thermometer &topThermometer;
+  std::array<Thermometer *, CHANNEL_COUNT> thermometers; /**< All thermometers, indexed by ThermometerChannel. */
+  bool policyApplied{false};                 /**< Whether the policy of appliedState has been fully applied. */
+  DistillationState appliedState{OFF};       /**< Phase whose resolution policy the probes were last set to. */
+
+  /**
+   * Programs every probe with the resolution the policy sets for a phase.
+   * Must only be called between conversions.
+   * @param state The distillation phase.
+   * @return True if every probe now runs at its policy resolution, false otherwise.
+   */
+  bool applyResolutionPolicy(DistillationState state) {
+    ThermometerResolutions resolutions = thermometerResolutionsFor(state);
+    bool applied = bus.setResolution(MASH_TUN_THERMOMETER_PROBE, resolutions.mashTun);
+    applied = bus.setResolution(BOTTOM_THERMOMETER_PROBE, resolutions.bottom) && applied;
+    applied = bus.setResolution(NEAR_TOP_THERMOMETER_PROBE, resolutions.nearTop) && applied;
+    applied = bus.setResolution(TOP_THERMOMETER_PROBE, resolutions.top) && applied;
+    return applied;
+  }
 
 public:
-  ThermometerController(Thermometer &mashTunThermometer, Thermometer &bottomThermometer,
+  ThermometerController(ThermometerBus &bus, Thermometer &mashTunThermometer, Thermometer &bottomThermometer,
                         Thermometer &nearTopThermometer, Thermometer &topThermometer)
-    : mashTunThermometer(mashTunThermometer), bottomThermometer(bottomThermometer),
-      nearTopThermometer(nearTopThermometer), topThermometer(topThermometer) {}
+    : bus(bus), mashTunThermometer(mashTunThermometer), bottomThermometer(bottomThermometer),
+      nearTopThermometer(nearTopThermometer), topThermometer(topThermometer),
+      thermometers{&mashTunThermometer, &bottomThermometer, &nearTopThermometer, &topThermometer} {}
 
-  // Update temperatures for all thermometers
+  /**
+   * Advances the two-phase conversion pipeline of all thermometers without blocking.
+   *
+   * Phase one reads the scratchpad of each probe as soon as that probe's conversion has finished, so probes at a
+   * low resolution are read early. Once every probe has finished, the resolution policy of the current phase is
+   * applied if the phase has changed, and phase two starts the next conversion on all probes with one broadcast
+   * command, so the bus is always converting while the rest of the loop runs.
+   */
   void updateAllTemperatures() {
-    mashTunThermometer.updateTemperature();
-    bottomThermometer.updateTemperature();
-    nearTopThermometer.updateTemperature();
-    topThermometer.updateTemperature();
+    for (Thermometer *thermometer : thermometers) {
+      thermometer->collectTemperature();
+    }
+    if (!bus.isConversionPending()) {
+      DistillationState state = DistillationStateManager::getInstance().getState();
+      if (!policyApplied || state != appliedState) {
+        policyApplied = applyResolutionPolicy(state);
+        appliedState = state;
+      }
+      bus.requestConversion();
+    }
   }
 
   // Get temperature readings
@@ -29,6 +118,33 @@ public:
   float getBottomTemperature() { return bottomThermometer.getTemperature(); }
   float getNearTopTemperature() { return nearTopThermometer.getTemperature(); }
   float getTopTemperature() { return topThermometer.getTemperature(); }
+
+  /**
+   * Returns the latest unfiltered reading of one thermometer.
+   * @param channel The thermometer's channel.
+   * @return The last reading in degrees Celsius.
+   */
+  [[nodiscard]] float getLastTemperature(ThermometerChannel channel) const {
+    return thermometers[channel]->getLastTemperature(); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  }
+
+  /**
+   * Returns the number of valid readings one thermometer has stored.
+   * @param channel The thermometer's channel.
+   * @return The reading count.
+   */
+  [[nodiscard]] unsigned long getReadingCount(ThermometerChannel channel) const {
+    return thermometers[channel]->getReadingCount(); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  }
+
+  /**
+   * Returns when the newest reading of one thermometer was acquired.
+   * @param channel The thermometer's channel.
+   * @return The acquisition time in milliseconds.
+   */
+  [[nodiscard]] unsigned long getReadingTime(ThermometerChannel channel) const {
+    return thermometers[channel]->getReadingTime(); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  }
 };
 
 #endif // THERMOMETER_CONTROLLER_H
@@ -1,25 +1,33 @@
 #ifndef VALVE_CONTROLLER_H
 #define VALVE_CONTROLLER_H
 
+#include "constants.h"
+#include "control_loop_interfaces.h"
 #include "distillation_state_manager.h"
 #include "relay.h"
+#include "time_proportioned_output.h"
 #ifndef UNIT_TEST
 #include <Arduino.h>
 #endif
 
 /**
  * Class for managing valves.
+ *
+ * The main valve can also run as a slow PWM: it opens for a share of every MAIN_VALVE_PWM_WINDOW_MS window, so a
+ * partial flow comes as regular pulses rather than as the valve snapping between open and closed whenever the flow
+ * crosses its target.
  */
-class ValveController {
+class ValveController : public IMainValve {
 private:
-  Relay coolantValve;        /**< Relay for controlling the coolant valve. */
-  Relay mainValve;           /**< Relay for controlling the main valve. */
-  Relay earlyForeshotsValve; /**< Relay for controlling the early foreshots valve. */
-  Relay lateForeshotsValve;  /**< Relay for controlling the late foreshots valve. */
-  Relay headsValve;          /**< Relay for controlling the heads valve. */
-  Relay heartsValve;         /**< Relay for controlling the hearts valve. */
-  Relay earlyTailsValve;     /**< Relay for controlling the early tails valve. */
-  Relay lateTailsValve;      /**< Relay for controlling the late tails valve. */
+  Relay coolantValve;                  /**< Relay for controlling the coolant valve. */
+  Relay mainValve;                     /**< Relay for controlling the main valve. */
+  Relay earlyForeshotsValve;           /**< Relay for controlling the early foreshots valve. */
+  Relay lateForeshotsValve;            /**< Relay for controlling the late foreshots valve. */
+  Relay headsValve;                    /**< Relay for controlling the heads valve. */
+  Relay heartsValve;                   /**< Relay for controlling the hearts valve. */
+  Relay earlyTailsValve;               /**< Relay for controlling the early tails valve. */
+  Relay lateTailsValve;                /**< Relay for controlling the late tails valve. */
+  TimeProportionedOutput mainValvePwm; /**< Slow PWM for the main valve. */
 
 public:
   /**
@@ -37,7 +45,8 @@ public:
                   Relay headsValve, Relay heartsValve, Relay earlyTailsValve, Relay lateTailsValve)
     : coolantValve(coolantValve), mainValve(mainValve), earlyForeshotsValve(earlyForeshotsValve),
       lateForeshotsValve(lateForeshotsValve), headsValve(headsValve), heartsValve(heartsValve),
-      earlyTailsValve(earlyTailsValve), lateTailsValve(lateTailsValve) {}
+      earlyTailsValve(earlyTailsValve), lateTailsValve(lateTailsValve),
+      mainValvePwm(MAIN_VALVE_PWM_WINDOW_MS, MAIN_VALVE_MIN_DWELL_MS) {}
 
   /**
    * Opens the distillate valve for the provided state and ensures all others are closed.
@@ -61,14 +70,25 @@ public:
   void closeCoolantValve();
 
   /**
-   * Opens the main valve.
+   * Opens the main valve, and keeps it open.
    */
   void openMainValve();
 
   /**
-   * Closes the main valve.
+   * Closes the main valve at once, and keeps it closed.
    */
-  void closeMainValve();
+  void closeMainValve() override;
+
+  /**
+   * Sets the share of each PWM window the main valve is open, from the next window on.
+   * @param duty The duty cycle, 0 to 1.
+   */
+  void setMainValveDuty(double duty) override;
+
+  /**
+   * Opens or closes the main valve as its duty cycle asks. Call it every MAIN_VALVE_SERVICE_INTERVAL_MS.
+   */
+  void serviceMainValve();
 };
 
 #endif // VALVE_CONTROLLER_H
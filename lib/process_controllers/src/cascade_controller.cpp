@@ -0,0 +1,34 @@
+#include "../include/cascade_controller.h"
+
+// More heater power lowers the duty the flow loop needs, so the PID acts in reverse
+CascadeController::CascadeController(IFlowLoop &flowController, IHeaterPower &heaterController)
+  : flowController(flowController), heaterController(heaterController),
+    setpoint(1.0 / (1.0 + CASCADE_CAPACITY_MARGIN)),
+    pid(&input, &output, &setpoint, CASCADE_PID_KP, CASCADE_PID_KI, CASCADE_PID_KD, REVERSE) {
+  pid.SetOutputLimits(CASCADE_MIN_POWER, HEATER_POWER_LEVEL_MAX);
+  pid.SetSampleTime(CASCADE_PID_SAMPLE_TIME_MS);
+}
+
+void CascadeController::enable() {
+  if (pid.GetMode() == AUTOMATIC) {
+    return;
+  }
+  input = flowController.getValveDuty();
+  output = heaterController.getPower();
+  pid.SetMode(AUTOMATIC);
+}
+
+void CascadeController::disable() { pid.SetMode(MANUAL); }
+
+void CascadeController::update() {
+  // The power is held while the flow loop autotunes, since the relay's duty says nothing about the column
+  if (pid.GetMode() != AUTOMATIC || flowController.getAutotuneState() == AUTOTUNE_RUNNING) {
+    return;
+  }
+  input = flowController.getValveDuty();
+  if (pid.Compute()) {
+    heaterController.setBurstFirePower(static_cast<int>(output + 0.5));
+  }
+}
+
+bool CascadeController::isEnabled() const { return pid.GetMode() == AUTOMATIC; }
@@ -0,0 +1,112 @@
+#include "../include/column_observer.h"
+
+#include <algorithm>
+
+namespace {
+constexpr float MS_PER_SECOND = 1000.0F;
+constexpr float SECONDS_PER_MINUTE = 60.0F;
+} // namespace
+
+ColumnObserver::ColumnObserver(const ThermometerController &thermometerController,
+                               const HeaterController &heaterController)
+  : thermometerController(thermometerController), heaterController(heaterController) {}
+
+// The rate is modelled as a random walk, which adds OBSERVER_RATE_PROCESS_NOISE of uncertainty per second
+void ColumnObserver::predict(ChannelEstimate &channel, float dt) {
+  const float q = OBSERVER_RATE_PROCESS_NOISE;
+  channel.temperature += channel.rate * dt;
+
+  // P = F P F' + Q, with F = [1 dt; 0 1]
+  channel.varianceTemperature +=
+      dt * (2.0F * channel.covariance + dt * channel.varianceRate) + q * dt * dt * dt / 3.0F;
+  channel.covariance += dt * channel.varianceRate + q * dt * dt / 2.0F;
+  channel.varianceRate += q * dt;
+}
+
+void ColumnObserver::correct(ChannelEstimate &channel, float measurement) {
+  if (!channel.initialized) {
+    channel.temperature = measurement;
+    channel.rate = 0.0F;
+    channel.varianceTemperature = OBSERVER_MEASUREMENT_VARIANCE_C2;
+    channel.covariance = 0.0F;
+    channel.varianceRate = OBSERVER_INITIAL_RATE_VARIANCE;
+    channel.initialized = true;
+    return;
+  }
+
+  float innovation = measurement - channel.temperature;
+  float innovationVariance = channel.varianceTemperature + OBSERVER_MEASUREMENT_VARIANCE_C2;
+  float gainTemperature = channel.varianceTemperature / innovationVariance;
+  float gainRate = channel.covariance / innovationVariance;
+
+  channel.temperature += gainTemperature * innovation;
+  channel.rate += gainRate * innovation;
+
+  // P = (I - K H) P, with H = [1 0]
+  float covariance = channel.covariance;
+  channel.varianceRate -= gainRate * covariance;
+  channel.covariance = (1.0F - gainTemperature) * covariance;
+  channel.varianceTemperature *= (1.0F - gainTemperature);
+}
+
+// Heater power that neither warms the mash nor leaks through the walls goes into boiling off vapour
+void ColumnObserver::updateVapourRate(float dt) {
+  const ChannelEstimate &mash = channels[MASH_TUN_CHANNEL];
+  float sensibleHeat = mash.initialized ? MASH_HEAT_CAPACITY_J_PER_C * mash.rate : 0.0F;
+  float boilingPower = static_cast<float>(heaterController.getPower()) - sensibleHeat - BOILER_HEAT_LOSS_W;
+  float instantRate = std::max(0.0F, boilingPower) / VAPORIZATION_HEAT_J_PER_G * SECONDS_PER_MINUTE;
+
+  // First-order low-pass, so heater relay switching and rate noise do not show up as vapour surges
+  float alpha = dt / (VAPOUR_RATE_FILTER_TIME_CONSTANT_S + dt);
+  vapourRate += alpha * (instantRate - vapourRate);
+}
+
+void ColumnObserver::update() {
+  unsigned long now = millis();
+  float dt = started ? static_cast<float>(now - lastUpdateTime) / MS_PER_SECOND : 0.0F;
+  lastUpdateTime = now;
+  started = true;
+
+  for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+    auto channelId = static_cast<ThermometerChannel>(i);
+    ChannelEstimate &channel = channels[i]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    unsigned long readingCount = thermometerController.getReadingCount(channelId);
+    if (readingCount == channel.seenReadingCount) {
+      continue;
+    }
+    channel.seenReadingCount = readingCount;
+
+    // Predict to when the reading was acquired, not to now, so the correction compares like with like
+    unsigned long readingTime = thermometerController.getReadingTime(channelId);
+    float sinceEstimate = static_cast<float>(readingTime - channel.estimateTime) / MS_PER_SECOND;
+    if (channel.initialized && sinceEstimate > 0.0F) {
+      predict(channel, sinceEstimate);
+    }
+    correct(channel, thermometerController.getLastTemperature(channelId));
+    channel.estimateTime = readingTime;
+  }
+
+  if (dt > 0.0F) {
+    updateVapourRate(dt);
+  }
+}
+
+bool ColumnObserver::isInitialized(ThermometerChannel channel) const {
+  return channels[channel].initialized; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+}
+
+float ColumnObserver::getTemperature(ThermometerChannel channel) const {
+  const ChannelEstimate &estimate = channels[channel]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  float sinceEstimate = static_cast<float>(lastUpdateTime - estimate.estimateTime) / MS_PER_SECOND;
+  return estimate.temperature + estimate.rate * sinceEstimate;
+}
+
+RawTemperature ColumnObserver::getRawTemperature(ThermometerChannel channel) const {
+  return celsiusToRaw(getTemperature(channel));
+}
+
+float ColumnObserver::getTemperatureRate(ThermometerChannel channel) const {
+  return channels[channel].rate * SECONDS_PER_MINUTE; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+}
+
+float ColumnObserver::getVapourRate() const { return vapourRate; }
@@ -1,20 +1,104 @@
 #include "../include/heater_controller.h"
 
+#ifndef UNIT_TEST
+#include "Arduino.h"
+#else
+// Burst fire and the energy count are timed with millis(); the mock implementation lives in the test files
+#include "mock_arduino.h"
+#endif
+
+namespace {
+constexpr double MS_PER_SECOND = 1000.0;
+} // namespace
+
 /**
  * Constructor for the HeaterController class.
  * @param relay1 Relay object for the first heater.
  * @param relay2 Relay object for the second heater.
  * @param relay3 Relay object for the third heater.
  */
-HeaterController::HeaterController(Relay &relay1, Relay &relay2, Relay &relay3) : heaters{&relay1, &relay2, &relay3} {}
+HeaterController::HeaterController(Relay &relay1, Relay &relay2, Relay &relay3)
+  : heaters{&relay1, &relay2, &relay3}, burst(HEATER_BURST_WINDOW_MS, HEATER_MIN_DWELL_MS) {}
 
 /**
- * Sets the power level of the heaters.
+ * Sets the power level of the heaters, as a sum of stages, and leaves burst-fire mode.
  * @param power The power level to set (0-6000).
  */
 void HeaterController::setPower(int power) {
   this->power = power;
-  int remainingPower = power;
+  burstFire = false;
+  applyStages(power);
+}
+
+/**
+ * Sets the average power level of the heaters in burst-fire mode. update() then modulates the stages.
+ * A new power is taken up at the next window, so calling this every control cycle does not disturb the bursts.
+ * @param power The power level to set, clamped to 0 to HEATER_POWER_LEVEL_MAX.
+ */
+void HeaterController::setBurstFirePower(int power) {
+  if (power < 0) {
+    power = 0;
+  } else if (power > HEATER_POWER_LEVEL_MAX) {
+    power = HEATER_POWER_LEVEL_MAX;
+  }
+  if (!burstFire) {
+    burstFire = true;
+    windowPending = true;
+    burst.reset();
+  }
+  this->power = power;
+
+  // At full power the lower sum is one stage step short, with the upper sum on for the whole window
+  pendingBase = power / HEATER_POWER_LEVEL_1 * HEATER_POWER_LEVEL_1;
+  if (pendingBase > HEATER_POWER_LEVEL_MAX - HEATER_POWER_LEVEL_1) {
+    pendingBase = HEATER_POWER_LEVEL_MAX - HEATER_POWER_LEVEL_1;
+  }
+  burst.setDuty(static_cast<double>(power - pendingBase) / HEATER_POWER_LEVEL_1);
+}
+
+/**
+ * Modulates the stages in burst-fire mode. Call it about once a second, well within HEATER_MIN_DWELL_MS.
+ * The lower sum changes only when a window starts, together with the share the window takes up.
+ */
+void HeaterController::update() {
+  if (!burstFire) {
+    return;
+  }
+  unsigned long previousWindow = burst.getWindowStart();
+  bool upper = burst.update(millis());
+  if (windowPending || burst.getWindowStart() != previousWindow) {
+    burstBase = pendingBase;
+    windowPending = false;
+  }
+  applyStages(upper ? burstBase + HEATER_POWER_LEVEL_1 : burstBase);
+}
+
+/**
+ * Returns the current power level of the heaters.
+ * @return The current power level (0-6000), the average one in burst-fire mode.
+ */
+int HeaterController::getPower() const { return power; }
+
+/**
+ * Returns the power of the stages that are on right now.
+ * @return The applied power in watts.
+ */
+int HeaterController::getAppliedPower() const { return appliedPower; }
+
+/**
+ * Returns the energy the stages have delivered since startup.
+ * @return The delivered energy in joules.
+ */
+double HeaterController::getDeliveredEnergy() const {
+  return deliveredEnergy + appliedPower * static_cast<double>(millis() - lastChange) / MS_PER_SECOND;
+}
+
+/**
+ * Switches the heaters to the stages that add up to a power, and books the energy of the previous stages.
+ * @param stagePower The power; the largest sum of stages not above it is applied.
+ */
+void HeaterController::applyStages(int stagePower) {
+  int remainingPower = stagePower;
 
   // Determine the state of each heater
   std::array<bool, 3> heaterStates = {false, false, false};
@@ -26,6 +110,11 @@ void HeaterController::setPower(int power) {
     }
   }
 
+  unsigned long now = millis();
+  deliveredEnergy += appliedPower * static_cast<double>(now - lastChange) / MS_PER_SECOND;
+  lastChange = now;
+  appliedPower = stagePower - remainingPower;
+
   // Update the state of each heater
   for (int i = 0; i < 3; i++) {
     if (heaterStates[i]) {
@@ -35,9 +124,3 @@ void HeaterController::setPower(int power) {
     }
   }
 }
-
-/**
- * Returns the current power level of the heaters.
- * @return The current power level (0-6000).
- */
-int HeaterController::getPower() const { return power; }
\ No newline at end of file
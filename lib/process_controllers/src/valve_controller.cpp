@@ -55,11 +55,37 @@ void ValveController::openCoolantValve() { coolantValve.turnOn(); }
 void ValveController::closeCoolantValve() { coolantValve.turnOff(); }
 
 /**
- * Opens the main valve.
+ * Opens the main valve, and keeps it open.
  */
-void ValveController::openMainValve() { mainValve.turnOn(); }
+void ValveController::openMainValve() {
+  mainValvePwm.setDuty(1.0);
+  mainValvePwm.reset();
+  mainValve.turnOn();
+}
+
+/**
+ * Closes the main valve at once, and keeps it closed.
+ * The PWM is reset rather than left to finish its pulse, so a stop never waits for the dwell.
+ */
+void ValveController::closeMainValve() {
+  mainValvePwm.setDuty(0.0);
+  mainValvePwm.reset();
+  mainValve.turnOff();
+}
 
 /**
- * Closes the main valve.
+ * Sets the share of each PWM window the main valve is open, from the next window on.
+ * @param duty The duty cycle, 0 to 1.
  */
-void ValveController::closeMainValve() { mainValve.turnOff(); }
\ No newline at end of file
+void ValveController::setMainValveDuty(double duty) { mainValvePwm.setDuty(duty); }
+
+/**
+ * Opens or closes the main valve as its duty cycle asks. Call it every MAIN_VALVE_SERVICE_INTERVAL_MS.
+ */
+void ValveController::serviceMainValve() {
+  if (mainValvePwm.update(millis())) {
+    mainValve.turnOn();
+  } else {
+    mainValve.turnOff();
+  }
+}
@@ -3,34 +3,164 @@
 
 #include <cstdint>
 
-#ifdef UNIT_TEST
-// Mock PID class for unit tests
-class PID {
-public:
-  PID(double *input, double *output, double *setpoint, double kp, double ki, double kd, int controllerDirection) {}
-  void SetMode(int mode) {}
-  static bool Compute() { return true; }
-};
-
-// Constants
+// Controller modes and directions, as in the Arduino PID library this class replaces
 constexpr int AUTOMATIC = 1;
 constexpr int MANUAL = 0;
 constexpr int DIRECT = 0;
 constexpr int REVERSE = 1;
-#else
-// This would be the real PID class for production
+
+/**
+ * Discrete PID controller with the interface of the Arduino PID library.
+ *
+ * The controller runs at a fixed sample interval: Compute() does nothing until a full interval has passed since the
+ * last computation, and the gains are folded into per-sample factors, so the integral and derivative terms do not
+ * depend on how often Compute() is called. On top of that it adds:
+ * - integral clamping to the output limits, and back-calculation anti-windup that bleeds the integral by the amount
+ *   the output was saturated, so the controller leaves a limit as soon as the error changes sign;
+ * - derivative on measurement, so setpoint steps cause no derivative kick, through a first-order low-pass filter
+ *   that keeps sensor noise from reaching the output;
+ * - bumpless transfer from MANUAL to AUTOMATIC, starting the integral from the output already applied.
+ *
+ * All state lives in the object; nothing is allocated.
+ */
 class PID {
+private:
+  double *input;              /**< Process value the controller reads. */
+  double *output;             /**< Control output the controller writes. */
+  double *setpoint;           /**< Target the controller drives the input to. */
+  double dispKp;              /**< Proportional gain as set, per unit of error. */
+  double dispKi;              /**< Integral gain as set, per unit of error and second. */
+  double dispKd;              /**< Derivative gain as set, in seconds. */
+  double kp{0};               /**< Proportional factor, signed by the direction. */
+  double ki{0};               /**< Integral factor per sample, signed by the direction. */
+  double kd{0};               /**< Derivative factor per sample, signed by the direction. */
+  double outMin;              /**< Lower output limit. */
+  double outMax;              /**< Upper output limit. */
+  double integral{0};         /**< Integral term, kept within the output limits. */
+  double lastInput{0};        /**< Input at the previous computation. */
+  double filteredDelta{0};    /**< Low-pass filtered input change per sample. */
+  double filterTime{0};       /**< Derivative filter time constant in seconds; 0 derives it from the gains. */
+  double trackingTime{0};     /**< Anti-windup tracking time constant in seconds; 0 derives it from the gains. */
+  double filterFactor{1};     /**< Share of each new input change taken into filteredDelta. */
+  double trackingFactor{0};   /**< Share of the saturation excess removed from the integral per sample. */
+  unsigned long sampleTimeMs; /**< Interval between computations. */
+  unsigned long lastTime;     /**< Time of the previous computation. */
+  int direction;              /**< DIRECT or REVERSE. */
+  bool inAuto{false};         /**< Whether the controller writes the output. */
+
+  /**
+   * Recomputes the per-sample factors from the gains, the direction and the sample time.
+   */
+  void updateFactors();
+
+  /**
+   * Restricts a value to the output limits.
+   * @param value The value.
+   * @return The value, clamped to [outMin, outMax].
+   */
+  [[nodiscard]] double clamp(double value) const;
+
+  /**
+   * Prepares a bumpless start: the integral takes over the current output and the derivative starts from rest.
+   */
+  void initialize();
+
 public:
-  PID(double *input, double *output, double *setpoint, double kp, double ki, double kd, int controllerDirection) {}
-  void SetMode(int mode) {}
-  static bool Compute() { return true; }
-};
+  /**
+   * Constructor for the PID class. The controller starts in MANUAL, with outputs limited to 0-255 and a sample time
+   * of 100 ms, as in the Arduino PID library.
+   * @param input Process value the controller reads.
+   * @param output Control output the controller writes.
+   * @param setpoint Target the controller drives the input to.
+   * @param kp Proportional gain.
+   * @param ki Integral gain, per second.
+   * @param kd Derivative gain, in seconds.
+   * @param controllerDirection DIRECT if a larger output raises the input, REVERSE otherwise.
+   */
+  PID(double *input, double *output, double *setpoint, double kp, double ki, double kd, int controllerDirection);
 
-// Constants
-constexpr int AUTOMATIC = 1;
-constexpr int MANUAL = 0;
-constexpr int DIRECT = 0;
-constexpr int REVERSE = 1;
-#endif
+  /**
+   * Switches between MANUAL, where the output is left alone, and AUTOMATIC. Switching to AUTOMATIC is bumpless.
+   * @param mode AUTOMATIC or MANUAL.
+   */
+  void SetMode(int mode);
+
+  /**
+   * Computes a new output, once per sample interval.
+   * @return True if a new output was written, false if the controller is in MANUAL or the interval has not passed.
+   */
+  bool Compute();
+
+  /**
+   * Sets the output limits. The output and the integral are clamped to them at once.
+   * @param min Lower limit.
+   * @param max Upper limit; ignored, with min, unless greater than min.
+   */
+  void SetOutputLimits(double min, double max);
+
+  /**
+   * Sets the gains. Negative gains are ignored; use the direction to reverse the controller.
+   * @param kp Proportional gain.
+   * @param ki Integral gain, per second.
+   * @param kd Derivative gain, in seconds.
+   */
+  void SetTunings(double kp, double ki, double kd);
+
+  /**
+   * Sets whether a larger output raises the input (DIRECT) or lowers it (REVERSE).
+   * @param controllerDirection DIRECT or REVERSE.
+   */
+  void SetControllerDirection(int controllerDirection);
+
+  /**
+   * Sets the interval between computations, keeping the gains' meaning per second.
+   * @param newSampleTimeMs The interval in milliseconds; 0 is ignored.
+   */
+  void SetSampleTime(unsigned long newSampleTimeMs);
+
+  /**
+   * Sets the time constant of the low-pass filter on the derivative term.
+   * @param timeConstantSec The time constant in seconds; 0 uses a tenth of the derivative time Kd / Kp, or no filter
+   * for a controller without proportional gain.
+   */
+  void SetDerivativeFilter(double timeConstantSec);
+
+  /**
+   * Sets how fast the integral tracks the output limits while saturated.
+   * @param timeConstantSec The tracking time constant in seconds; 0 uses the square root of the integral and
+   * derivative times, or the integral time for a PI controller.
+   */
+  void SetTrackingTime(double timeConstantSec);
+
+  /**
+   * Returns the proportional gain as set.
+   * @return The proportional gain.
+   */
+  [[nodiscard]] double GetKp() const;
+
+  /**
+   * Returns the integral gain as set.
+   * @return The integral gain, per second.
+   */
+  [[nodiscard]] double GetKi() const;
+
+  /**
+   * Returns the derivative gain as set.
+   * @return The derivative gain, in seconds.
+   */
+  [[nodiscard]] double GetKd() const;
+
+  /**
+   * Returns the controller mode.
+   * @return AUTOMATIC or MANUAL.
+   */
+  [[nodiscard]] int GetMode() const;
+
+  /**
+   * Returns the controller direction.
+   * @return DIRECT or REVERSE.
+   */
+  [[nodiscard]] int GetDirection() const;
+};
 
 #endif // PID_V1_H
@@ -1,6 +1,11 @@
 #ifndef CONSTANTS_H
 #define CONSTANTS_H
 
+#include "fixed_point_temperature.h"
+
+#include <cstddef>
+#include <cstdint>
+
 // Include TaskManagerIO.h only if not included elsewhere
 #if !defined(UNIT_TEST) && !defined(NATIVE)
 // For production builds, TaskManagerIO.h is already included in hardware_interfaces.h
@@ -15,45 +20,29 @@
 #endif
 
 // Hardware platform constants
-#if defined(UNIT_TEST) || defined(NATIVE)
-// Constants that might be needed for unit testing or native builds
-// but are typically defined in Arduino hardware
-#ifndef CHIP_SELECT_PIN
-#define CHIP_SELECT_PIN 4
-#endif
-
-#define FILE_READ "r"
-#define FILE_WRITE "w"
-#define FILE_APPEND "a"
-
-// Define pinMode constants if not already defined
-#ifndef INPUT
-#define INPUT 0
-#endif
-
-#ifndef OUTPUT
-#define OUTPUT 1
-#endif
-
-#ifndef INPUT_PULLUP
-#define INPUT_PULLUP 2
-#endif
-
-// Define serial constants if not already defined
+#if defined(NATIVE) && !defined(UNIT_TEST)
+// Serial constants that native builds need but the mock Arduino core leaves out; that core defines the pin and file
+// modes, and unit tests get them all from mock_arduino.h instead
 #ifndef SERIAL_8N1
 #define SERIAL_8N1 0
 #endif
 
-#endif // defined(UNIT_TEST) || defined(NATIVE)
+#endif // defined(NATIVE) && !defined(UNIT_TEST)
 
 // Density constants
 const double ALCOHOL_DENSITY = 0.868; // Density of alcohol in g/ml.
 
-// Pin constants for thermometers
-const int MASH_TUN_THERMOMETER_PIN = 1;
-const int BOTTOM_THERMOMETER_PIN = 2;
-const int NEAR_TOP_THERMOMETER_PIN = 3;
-const int TOP_THERMOMETER_PIN = 4;
+// Pin constant for the shared 1-Wire thermometer bus
+const int THERMOMETER_BUS_PIN = 1;
+
+// Thermometer probe indices on the bus, once each is bound to its ROM code in PROBE_FILE_NAME
+const uint8_t MASH_TUN_THERMOMETER_PROBE = 0;
+const uint8_t BOTTOM_THERMOMETER_PROBE = 1;
+const uint8_t NEAR_TOP_THERMOMETER_PROBE = 2;
+const uint8_t TOP_THERMOMETER_PROBE = 3;
+const uint8_t THERMOMETER_PROBE_POSITIONS = 4; // Probes with a position on the still, and slots in the probe store
+const uint8_t MAX_THERMOMETER_PROBES = 8;      // Number of probe addresses cached by the bus driver
+const char *const PROBE_FILE_NAME = "PROBES.ROM"; // 8.3 name of the bound ROM codes; delete it to bind afresh
 
 // Pin constants for scales
 const int EARLY_FORESHOTS_SCALE_DATA_PIN = 5;
@@ -68,6 +57,7 @@ const int EARLY_TAILS_SCALE_DATA_PIN = 13;
 const int EARLY_TAILS_SCALE_CLOCK_PIN = 14;
 const int LATE_TAILS_SCALE_DATA_PIN = 15;
 const int LATE_TAILS_SCALE_CLOCK_PIN = 16;
+const int SCALE_BANK_CLOCK_PIN = EARLY_FORESHOTS_SCALE_CLOCK_PIN; // Shared clock when PARALLEL_SCALE_BANK is defined
 
 // Pin constants for heater relays
 const int HEATER_RELAY_1_PIN = 13;
@@ -90,9 +80,39 @@ const int LCD_ROWS = 4;
 const int LCD_PIN = 3;
 const int SD_CARD_CS_PIN = 4; // Typical CS pin for SD card on Arduino MKR WiFi 1010
 
-// Array size constants
-const int READINGS_ARRAY_SIZE = 5;
-const int READINGS_ARRAY_MIDDLE_INDEX = 2;
+// Median filter window sizes (samples, must be odd)
+const int THERMOMETER_MEDIAN_WINDOW = 5;
+const int SCALE_MEDIAN_WINDOW = 5; // Spikes are dropped before the median, so it only smooths noise
+
+// Scale acquisition
+const int SCALE_SAMPLE_QUEUE_SIZE = 16;         // Conversions buffered between ticks, must be a power of two
+const int SCALE_INTERRUPT_SLOTS = 6;            // Scales that can have a data-ready interrupt at the same time
+const int HX711_BANK_MAX_CHANNELS = 6;          // Scales that can share one clock line in a parallel bank
+const uint8_t SCALE_AVERAGING_DEPTH = 1;        // Conversions averaged per filtered reading, by default
+const uint8_t HEARTS_SCALE_AVERAGING_DEPTH = 4; // Hearts fill slowly, so a deeper average costs no useful latency
+const uint8_t SCALE_TARE_CONVERSIONS = 10;      // Conversions averaged when taring, at startup and reconnection
+const float SCALE_TARE_MAX_SPREAD = 2.0F;       // Widest spread, in grams, a deferred tare accepts
+
+// Outlier rejection on single scale conversions, ahead of averaging and the median
+const int SCALE_HAMPEL_WINDOW = 7;             // Conversions the spike test compares against, must be odd
+const float SCALE_HAMPEL_THRESHOLD = 3.0F;     // Spike distance from the window median, in standard deviations
+const float SCALE_HAMPEL_MIN_DEVIATION = 1.0F; // Grams from the median that always pass, for a flat signal
+
+// A scale outside the fraction being collected sleeps, and is woken this often for a drift and health check
+const unsigned long SCALE_IDLE_CHECK_INTERVAL_MS = 60000;
+
+// Scale calibration, restored from CALIBRATION_FILE_NAME on the SD card at boot
+const char *const CALIBRATION_FILE_NAME = "SCALES.CAL"; // 8.3 name, as the SD library requires
+const float SCALE_DEFAULT_CALIBRATION = 420.0F;         // Raw counts per gram until a calibration is stored
+const uint8_t SCALE_ZERO_CHECK_CONVERSIONS = 3;         // Conversions that confirm a stored zero at startup
+const uint8_t CALIBRATION_STORE_SLOTS = 6;              // Scales the calibration store has room for
+const float SCALE_ZERO_CHECK_TOLERANCE = 5.0F;          // Drift in grams from the stored zero that still passes
+const float SCALE_CALIBRATION_MIN_WEIGHT = 100.0F;      // Lightest known weight a calibration accepts, in grams
+const float SCALE_CALIBRATION_MAX_SPREAD = 1.0F;        // Widest spread of a settled calibration window, in grams
+const float SCALE_CALIBRATION_MIN_LOAD = 0.1F;          // Fraction of the known weight the old factor must measure
+
+// Trend estimator window size (samples, one per MEDIUM_LOOP_PERIOD_MS tick: 40 × 1 s = 40 s)
+const int THERMOMETER_TREND_WINDOW = 40;
 
 // Time constants
 // DEFAULT_TASK_RATE_MS is already defined in TaskManagerIO.h
@@ -100,12 +120,27 @@ const unsigned long ONE_MINUTE_MS = 60 * 1000;       // 1 minute
 const unsigned long FIVE_MINUTES_MS = 5 * 60 * 1000; // 5 minutes
 const unsigned long TEN_MINUTES_MS = 10 * 60 * 1000; // 10 minutes = 600000ms
 
+// Serial console
+const char TASK_STATISTICS_COMMAND = 't'; // Dumps every task's run time and start lateness histograms
+const char CALIBRATE_SCALE_COMMAND = 'c'; // "c<scale> <grams>" calibrates a scale against a known weight on it
+const int CONSOLE_LINE_LENGTH = 32;       // Longest console command line, with its terminator
+const int TASK_HISTOGRAM_LINE = 160;      // Room for the non-empty buckets of one histogram
+
 // Power constants
 const int HEATER_POWER_LEVEL_1 = 1000;
 const int HEATER_POWER_LEVEL_2 = 2000;
 const int HEATER_POWER_LEVEL_3 = 3000;
 const int HEATER_POWER_LEVEL_MAX = 6000;
 
+// Heater burst fire: the relay stages alternate between two adjacent sums of stages within each window
+const unsigned long HEATER_BURST_WINDOW_MS = 60000; // Each relay switches at most a few times a minute
+const unsigned long HEATER_MIN_DWELL_MS = 5000;     // Shortest burst; shorter ones are carried to later windows
+const double JOULES_PER_KWH = 3.6e6;
+
+// Built-in recipe, used unless RECIPE_FILE_NAME on the SD card holds a valid one; see recipe.h for the file format
+const char *const RECIPE_FILE_NAME = "RECIPE.TXT"; // 8.3 name, next to CALIBRATION_FILE_NAME
+const size_t RECIPE_MAX_FILE_SIZE = 1024;          // Read on the stack at boot; a full recipe with comments fits
+
 // Volume constants
 const float EARLY_FORESHOTS_VOLUME_ML = 200.0F;
 const float LATE_FORESHOTS_VOLUME_ML = 400.0F;
@@ -119,23 +154,88 @@ const float HIGH_FLOW_RATE_ML_PER_MIN = 33.0F;
 const float LOW_FLOW_RATE_ML_PER_MIN = 10.0F;
 
 // Temperature constants (all in Celsius)
-const float TEMPERATURE_STABILIZATION_THRESHOLD_C = 2.0F;
-const float SUDDEN_TEMPERATURE_INCREASE_THRESHOLD_C = 0.1F;
-const float MIN_TEMPERATURE_THRESHOLD_C = 40.0F; // Minimum temperature to proceed from heating phase
+constexpr float TEMPERATURE_STABILIZATION_THRESHOLD_C = 2.0F;
+const float HEARTS_END_TEMPERATURE_SLOPE_C_PER_MIN = 0.1F; // Sustained rise at the column top that ends hearts
+const float TEMPERATURE_TREND_CONFIDENCE_SIGMAS = 2.0F;    // Standard errors a slope must clear to count
+constexpr float MIN_TEMPERATURE_THRESHOLD_C = 40.0F; // Minimum temperature to proceed from heating phase
 const float TEMPERATURE_COMPARISON_TOLERANCE = 0.001F;
 
+// Temperature thresholds in raw DS18B20 steps (1/16 °C), converted at compile time
+constexpr RawTemperature TEMPERATURE_STABILIZATION_THRESHOLD_RAW = celsiusToRaw(TEMPERATURE_STABILIZATION_THRESHOLD_C);
+constexpr RawTemperature MIN_TEMPERATURE_THRESHOLD_RAW = celsiusToRaw(MIN_TEMPERATURE_THRESHOLD_C);
+
+// Column observer tuning
+const float OBSERVER_MEASUREMENT_VARIANCE_C2 = 0.01F;   // Variance of a single probe reading, noise and quantization
+const float OBSERVER_RATE_PROCESS_NOISE = 1.0e-4F;      // How fast the temperature rates may wander, (°C/s)² per s
+const float OBSERVER_INITIAL_RATE_VARIANCE = 0.01F;     // Uncertainty of the rate before the first readings, (°C/s)²
+const float MASH_HEAT_CAPACITY_J_PER_C = 100000.0F;     // Roughly 25 L of wash
+const float BOILER_HEAT_LOSS_W = 300.0F;                // Heat lost through the boiler walls at boiling
+const float VAPORIZATION_HEAT_J_PER_G = 2000.0F;        // Latent heat of the boiling wash
+const float VAPOUR_RATE_FILTER_TIME_CONSTANT_S = 30.0F; // Smoothing of the vapour rate estimate
+
 // Time conversion constants
 const float MS_TO_MINUTES = 60000.0F;
 
 // Scale operation timeouts (milliseconds)
-const unsigned long SCALE_CONNECTION_TIMEOUT_MS = 1000; // 1 second timeout for scale connection
-const unsigned long SCALE_READ_TIMEOUT_MS = 500;        // 0.5 second timeout for scale reading
+const unsigned long SCALE_CONNECTION_TIMEOUT_MS = 1000;    // 1 second timeout for scale connection
+const unsigned long SCALE_READ_TIMEOUT_MS = 500;           // 0.5 second timeout for scale reading
+const unsigned long SCALE_WAKE_SETTLE_MS = 400;            // HX711 output settling after power-up at 10 SPS
+const unsigned long SCALE_RECONNECT_MIN_DELAY_MS = 2000;   // First retry after a scale drops out
+const unsigned long SCALE_RECONNECT_MAX_DELAY_MS = 120000; // Retry delay cap; the delay doubles per failed attempt
+
+// Thermometer timing (milliseconds)
+const unsigned long DS18B20_CONVERSION_TIME_MS = 750; // Conversion time of a DS18B20 at 12-bit resolution
+const uint8_t DS18B20_MIN_RESOLUTION_BITS = 9;          // 0.5 °C steps, 94 ms conversion
+const uint8_t DS18B20_MAX_RESOLUTION_BITS = 12;         // 0.0625 °C steps, 750 ms conversion
+
+// Flow PID: the output is the duty cycle of the main valve
+const double FLOW_PID_OUTPUT_MIN = 0.0;             // Valve closed for the whole window
+const double FLOW_PID_OUTPUT_MAX = 1.0;             // Valve open for the whole window
+const unsigned long FLOW_PID_SAMPLE_TIME_MS = 1000; // One computation a second, however often the fast loop calls
+const double FLOW_PID_DERIVATIVE_FILTER_S = 3.0;    // A few samples, so the valve's ripple in the estimate stays out
+const double FLOW_PID_KP = 0.02;                    // Duty per ml/min of error, so 10 ml/min short opens a fifth more
+const double FLOW_PID_KI = 0.0004;                  // Duty per ml/min of error and second, a 50 s integral time
+const double FLOW_PID_KD = 0.04;                    // Duty per ml/min per second, a 2 s derivative time
+
+// Main valve slow PWM: the solenoid opens for a share of each window, and never for less than the dwell
+const unsigned long MAIN_VALVE_PWM_WINDOW_MS = 10000;     // 5% duty steps at the minimum dwell
+const unsigned long MAIN_VALVE_MIN_DWELL_MS = 500;        // Shortest open or closed time the solenoid is put through
+const unsigned long MAIN_VALVE_SERVICE_INTERVAL_MS = 100; // PWM update rate, well within the dwell
+
+// Flow rate estimator, the mean weight over one main valve PWM window against the one before, so every valve
+// pulse counts once and every reading's noise is averaged
+const unsigned long FLOW_RATE_WINDOW_MS = MAIN_VALVE_PWM_WINDOW_MS; // Span of each of the two averaged windows
+const int FLOW_RATE_SLOTS = 240;                                    // One reading each at up to 12 SPS and depth 1
+const unsigned long FLOW_RATE_SPAN_TOLERANCE_MS = 500;              // Shortfall of the two windows still used
+// Readings closer together than this share a slot, so the slots span both windows at any conversion rate
+const unsigned long FLOW_RATE_SLOT_MS = 2 * FLOW_RATE_WINDOW_MS / (FLOW_RATE_SLOTS - 1) + 1;
+
+// Flow PID autotune: a relay experiment on the main valve, run once per still while collecting early foreshots
+const char *const TUNING_FILE_NAME = "TUNING.PID";     // 8.3 name of the stored gains, next to CALIBRATION_FILE_NAME
+const double FLOW_AUTOTUNE_HYSTERESIS = 2.0;           // ml/min either side of the setpoint, above estimator noise
+const unsigned long FLOW_AUTOTUNE_TIMEOUT_MS = 600000; // Ten minutes for the flow to settle into a limit cycle
+
+// Cascade: the heater power keeps the main valve duty below full, so the column makes more distillate than is taken
+const double CASCADE_CAPACITY_MARGIN = 0.15;           // Distillate the column makes beyond the take-off, as a share
+const double CASCADE_PID_KP = 2000.0;                  // Watts per unit of duty error
+const double CASCADE_PID_KI = 20.0;                    // Watts per unit of duty error and second
+const double CASCADE_PID_KD = 0.0;                     // The duty is too noisy to differentiate
+const unsigned long CASCADE_PID_SAMPLE_TIME_MS = 5000; // Several inner loop samples per outer loop sample
+const int CASCADE_MIN_POWER = 1000;                    // Keeps the column boiling whatever the valve says
+
+// Rate groups: the fast loop drives the main valve and the flow loop, the medium loop the heater and the phases, and
+// the slow loop the operator I/O. The slower budgets stay below the fast period, so a slower loop hands the processor
+// back before the fast loop falls a period behind.
+const unsigned long FAST_LOOP_PERIOD_MS = MAIN_VALVE_SERVICE_INTERVAL_MS;    // The valve PWM sets the pace
+const unsigned long FAST_LOOP_BUDGET_US = 20000;                             // Valve, flow loop and scale polls
+const unsigned long MEDIUM_LOOP_PERIOD_MS = 1000;                            // A DS18B20 conversion, a flow PID sample
+const unsigned long MEDIUM_LOOP_BUDGET_US = 50000;                           // Heater, phases and thermometer bus
+const unsigned long SLOW_LOOP_PERIOD_MS = 2000;                              // Display refresh and console response
+const unsigned long SLOW_LOOP_BUDGET_US = 30000;                             // LCD rows, SD writes and reconnection
+const uint16_t HEALTH_CHECK_DIVIDER = FIVE_MINUTES_MS / SLOW_LOOP_PERIOD_MS; // Slow ticks between health checks
 
 // Test constants
 const float TEST_TOLERANCE = 0.1F;
-const int TEST_PID_KP = 2;
-const int TEST_PID_KI = 5;
-const int TEST_PID_KD = 1;
 const int TEST_RETURN_VALUE = 42;
 
 #endif // CONSTANTS_H
\ No newline at end of file
@@ -0,0 +1,213 @@
+#ifndef COOPERATIVE_SCHEDULER_H
+#define COOPERATIVE_SCHEDULER_H
+
+#include "log2_histogram.h"
+
+#include <cstdint>
+
+/**
+ * What a fixed-rate task does about runs it missed because the loop was late.
+ */
+enum OverrunPolicy : uint8_t {
+  SKIP_MISSED, /**< Run once, then resume on the task's own grid; for control loops, where stale runs are useless. */
+  CATCH_UP,    /**< Run once per missed period, back to back; for tasks that count or integrate time. */
+};
+
+/**
+ * What the scheduler has measured about one task since it was scheduled.
+ */
+struct TaskStatistics {
+  const char *name{nullptr};     /**< Name for reports; null until set. */
+  unsigned long runs{0};         /**< Runs made. */
+  unsigned long overruns{0};     /**< Periods dropped or run late. */
+  Log2Histogram runTimeUs;       /**< Time each run took, in microseconds; empty without a timer. */
+  Log2Histogram startLatenessMs; /**< How long after its deadline each run started. */
+};
+
+/**
+ * Cooperative fixed-rate scheduler.
+ *
+ * Tasks are plain functions that run to completion. Pending tasks sit in a binary min-heap ordered by deadline, so
+ * runLoop() finds the next due task in constant time and reschedules it in O(log n), whatever the number of tasks.
+ * Each deadline is the previous one plus the period rather than the time the task ran, so a task does not drift
+ * however late the loop runs it; what happens to missed periods is up to its OverrunPolicy.
+ *
+ * Time comes from an injectable clock, millis() on the board. A virtual clock that jumps straight to
+ * getNextDeadline() runs hours of schedule in moments on a desktop, with the same order of runs as on the board.
+ * Deadlines are compared by signed difference, so the 49-day wrap of millis() is harmless.
+ *
+ * Every run is measured into the task's TaskStatistics: how late it started, on the clock, and how long it took, on
+ * an optional microsecond timer, micros() on the board. Both go into log2 histograms, so a callback that blocks now
+ * and then shows up in the top buckets rather than vanishing into an average.
+ *
+ * Task slots are fixed at MAX_TASKS and nothing is allocated.
+ */
+class CooperativeScheduler {
+public:
+  /** Returns the current time in milliseconds. */
+  using Clock = unsigned long (*)();
+
+  /** Returns the current time in microseconds, for timing runs. */
+  using Timer = unsigned long (*)();
+
+  /** Work a task does on each run. */
+  using Callback = void (*)();
+
+  /** Task slots; enough for every periodic job of the firmware with room to spare. */
+  static const uint8_t MAX_TASKS = 16;
+
+  /** Returned instead of a task ID when every slot is taken. */
+  static const int INVALID_TASK = -1;
+
+private:
+  /**
+   * A scheduled task.
+   */
+  struct Task {
+    Callback callback{nullptr};        /**< The work to run; null for a free slot. */
+    unsigned long deadline{0};         /**< When the task is next due. */
+    unsigned long periodMs{0};         /**< Time between runs. */
+    TaskStatistics statistics;         /**< What has been measured about the task. */
+    uint16_t generation{0};            /**< Bumped each time the slot is reused, so stale IDs miss. */
+    OverrunPolicy policy{SKIP_MISSED}; /**< What to do about missed periods. */
+    uint8_t heapPosition{0};           /**< Where the task sits in the heap while pending. */
+    bool pending{false};               /**< Whether the task is in the heap. */
+  };
+
+  Clock clock;                  /**< The time source. */
+  Timer timer{nullptr};         /**< The run timer, or null to leave run times unmeasured. */
+  Task tasks[MAX_TASKS];        /**< Task slots. */
+  uint8_t heap[MAX_TASKS]{};    /**< Slots of the pending tasks, as a min-heap on their deadlines. */
+  uint8_t heapSize{0};          /**< Pending tasks. */
+  int runningSlot{-1};          /**< Slot of the task running now, or -1. */
+  bool runningCancelled{false}; /**< Whether the running task cancelled itself. */
+
+  /**
+   * Finds the slot of a task ID.
+   * @param taskId The task ID.
+   * @return The slot, or -1 if the ID names no live task.
+   */
+  [[nodiscard]] int slotOf(int taskId) const;
+
+  /**
+   * Tells whether one slot's deadline comes before another's.
+   * @param a The first slot.
+   * @param b The second slot.
+   * @return True if a is due first.
+   */
+  [[nodiscard]] bool isEarlier(uint8_t a, uint8_t b) const;
+
+  /**
+   * Adds a slot to the heap.
+   * @param slot The slot.
+   */
+  void push(uint8_t slot);
+
+  /**
+   * Removes a slot from anywhere in the heap.
+   * @param slot The slot; must be pending.
+   */
+  void remove(uint8_t slot);
+
+  /**
+   * Puts the slot at a heap position in its place, moving it up or down.
+   * @param position The heap position.
+   */
+  void restore(uint8_t position);
+
+  /**
+   * Places a slot at a heap position and records the position in the slot.
+   * @param position The heap position.
+   * @param slot The slot.
+   */
+  void place(uint8_t position, uint8_t slot);
+
+public:
+  /**
+   * Constructor for the CooperativeScheduler class.
+   * @param clock The time source; must not be null.
+   */
+  explicit CooperativeScheduler(Clock clock);
+
+  /**
+   * Replaces the time source, for instance with a virtual clock in simulation. Pending deadlines are kept, so the
+   * new clock should carry on from the old one's time.
+   * @param newClock The time source; must not be null.
+   */
+  void setClock(Clock newClock);
+
+  /**
+   * Sets the timer that measures how long each run takes.
+   * @param newTimer The timer, or null to stop measuring run times.
+   */
+  void setTimer(Timer newTimer);
+
+  /**
+   * Schedules a task to run every period, first after an initial delay.
+   * @param initialDelayMs Time from now to the first run.
+   * @param periodMs Time between runs; 0 is taken as 1.
+   * @param callback The work to run; must not be null.
+   * @param policy What to do about periods missed while the loop was late.
+   * @return The task ID, or INVALID_TASK if every slot is taken.
+   */
+  int schedule(unsigned long initialDelayMs, unsigned long periodMs, Callback callback,
+               OverrunPolicy policy = SKIP_MISSED);
+
+  /**
+   * Stops a task. A task may cancel itself while it runs. IDs of cancelled tasks are not reused until the slot has
+   * cycled through many tasks, so cancelling a stale ID does nothing.
+   * @param taskId The task to stop.
+   * @return True if the task was pending or running, false otherwise.
+   */
+  bool cancel(int taskId);
+
+  /**
+   * Runs every task whose deadline has passed, earliest first, and reschedules each by its policy.
+   * @return The number of runs made.
+   */
+  unsigned int runLoop();
+
+  /**
+   * Returns when the next task is due, so a caller can sleep or advance a virtual clock until then.
+   * @param deadline Receives the deadline, if there is a pending task.
+   * @return True if a task is pending, false otherwise.
+   */
+  bool getNextDeadline(unsigned long &deadline) const;
+
+  /**
+   * Returns the number of tasks scheduled and not cancelled.
+   * @return The task count.
+   */
+  [[nodiscard]] uint8_t getTaskCount() const;
+
+  /**
+   * Returns how many periods a task has had to drop or run late, under either policy.
+   * @param taskId The task.
+   * @return The overrun count, or 0 for an unknown task.
+   */
+  [[nodiscard]] unsigned long getOverrunCount(int taskId) const;
+
+  /**
+   * Names a task in its statistics.
+   * @param taskId The task.
+   * @param name The name; must outlive the task, so usually a string literal.
+   * @return True if the task was found, false otherwise.
+   */
+  bool setTaskName(int taskId, const char *name);
+
+  /**
+   * Returns the ID of the task in a slot, so reports can go through every task.
+   * @param slot The slot, below MAX_TASKS.
+   * @return The task ID, or INVALID_TASK if the slot is free.
+   */
+  [[nodiscard]] int getTaskIdAt(uint8_t slot) const;
+
+  /**
+   * Returns what has been measured about a task.
+   * @param taskId The task.
+   * @return The statistics, or null for an unknown task.
+   */
+  [[nodiscard]] const TaskStatistics *getStatistics(int taskId) const;
+};
+
+#endif // COOPERATIVE_SCHEDULER_H
@@ -0,0 +1,90 @@
+#ifndef DISTILLATION_STATE_ENGINE_H
+#define DISTILLATION_STATE_ENGINE_H
+
+#include "distillation_state_manager.h"
+
+#include <cstddef>
+
+/**
+ * One row of a phase table: what a distillation phase does, and when and where it ends.
+ * Every member but the state and the successor may be null.
+ */
+struct DistillationPhase {
+  DistillationState state; /**< The phase this row describes; rows are indexed by it. */
+  void (*enter)();         /**< Runs once, when the phase begins: relays, valves and set points. */
+  void (*control)();       /**< Runs on every tick while the phase lasts: the control loops. */
+  bool (*isComplete)();    /**< Checked on every tick before the controls; true ends the phase. */
+  void (*exit)();          /**< Runs once, when the phase ends, before the successor is entered. */
+  DistillationState next;  /**< The phase that follows. */
+};
+
+/**
+ * Runs the distillation as a table of phases from a single scheduled task.
+ *
+ * The table holds one row per DistillationState, in enum order, so the current phase is found by indexing rather
+ * than searching and a transition costs the same whichever phase it leaves. Entry and exit actions run exactly once
+ * per transition, so the outputs they set are written once rather than on every tick. The state manager follows
+ * every transition, which also restarts its elapsed time for the phases it times.
+ *
+ * The engine keeps only the current phase; the table, usually a constexpr array of free functions, is not copied.
+ */
+class DistillationStateEngine {
+private:
+  const DistillationPhase *phases;     /**< The phase table, indexed by DistillationState. */
+  std::size_t phaseCount;              /**< Rows in the phase table. */
+  DistillationState currentPhase{OFF}; /**< The phase in progress. */
+  unsigned long transitionCount{0};    /**< Transitions made since the engine was built. */
+
+  /**
+   * Makes a phase current, tells the state manager, and runs the phase's entry action.
+   * @param phase The phase to enter.
+   */
+  void enter(DistillationState phase);
+
+public:
+  /**
+   * Constructor for the DistillationStateEngine class. The engine starts in OFF and does nothing until started.
+   * @param phases The phase table, one row per DistillationState in enum order; it must outlive the engine.
+   * @param phaseCount Rows in the phase table. Phases past the end are treated as having no actions.
+   */
+  DistillationStateEngine(const DistillationPhase *phases, std::size_t phaseCount);
+
+  /**
+   * Checks that a phase table holds its rows in DistillationState order, so a constexpr table can be checked with
+   * static_assert where it is defined.
+   * @param phases The phase table.
+   * @param phaseCount Rows in the phase table.
+   * @param row The first row to check.
+   * @return True if every row from the given one on describes the phase with its index.
+   */
+  static constexpr bool isIndexedByState(const DistillationPhase *phases, std::size_t phaseCount, std::size_t row = 0) {
+    return row == phaseCount || (phases[row].state == row && isIndexedByState(phases, phaseCount, row + 1));
+  }
+
+  /**
+   * Enters a phase regardless of the current one, running its entry action but not the current phase's exit.
+   * @param phase The phase to start in.
+   */
+  void start(DistillationState phase);
+
+  /**
+   * Runs one tick: ends the current phase and enters its successor if its exit predicate holds, or otherwise runs
+   * its per-tick controls.
+   * @return True if the tick made a transition, false otherwise.
+   */
+  bool update();
+
+  /**
+   * Returns the phase in progress.
+   * @return The current phase.
+   */
+  [[nodiscard]] DistillationState getPhase() const;
+
+  /**
+   * Returns how many transitions the engine has made, starts included.
+   * @return The transition count.
+   */
+  [[nodiscard]] unsigned long getTransitionCount() const;
+};
+
+#endif // DISTILLATION_STATE_ENGINE_H
@@ -0,0 +1,40 @@
+#ifndef FIXED_POINT_TEMPERATURE_H
+#define FIXED_POINT_TEMPERATURE_H
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * Temperature in the DS18B20's native register format: a signed count of 1/16 °C steps.
+ *
+ * The thermometer pipeline keeps temperatures in this format from the scratchpad read to the threshold
+ * comparisons, so the control loop never touches soft-float on a board without an FPU. Conversion to
+ * degrees Celsius only happens where a value is shown or logged.
+ */
+using RawTemperature = int16_t;
+
+constexpr int16_t RAW_TEMPERATURE_STEPS_PER_C = 16; /**< Number of raw steps in one degree Celsius. */
+
+/** Marks a probe that could not be read. Lies far below the DS18B20's −55 °C range. */
+constexpr RawTemperature DISCONNECTED_RAW_TEMPERATURE = std::numeric_limits<RawTemperature>::min();
+
+/**
+ * Converts degrees Celsius to raw steps, rounding to the nearest step.
+ * Meant for thresholds, which are converted once at compile time.
+ * @param celsius The temperature in degrees Celsius.
+ * @return The temperature in 1/16 °C steps.
+ */
+constexpr RawTemperature celsiusToRaw(float celsius) {
+  return static_cast<RawTemperature>(celsius * RAW_TEMPERATURE_STEPS_PER_C + (celsius >= 0.0F ? 0.5F : -0.5F));
+}
+
+/**
+ * Converts raw steps to degrees Celsius, for display and logging.
+ * @param raw The temperature in 1/16 °C steps.
+ * @return The temperature in degrees Celsius.
+ */
+constexpr float rawToCelsius(RawTemperature raw) {
+  return static_cast<float>(raw) / static_cast<float>(RAW_TEMPERATURE_STEPS_PER_C);
+}
+
+#endif // FIXED_POINT_TEMPERATURE_H
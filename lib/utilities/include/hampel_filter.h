@@ -0,0 +1,97 @@
+#ifndef HAMPEL_FILTER_H
+#define HAMPEL_FILTER_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+/**
+ * Sliding-window Hampel outlier detector.
+ *
+ * A sample is an outlier when it lies further from the median of the last N samples than threshold times the scaled
+ * median absolute deviation (MAD) of that window. Unlike a median filter, accepted samples pass through unchanged
+ * and without delay; only the outliers are removed.
+ *
+ * Every sample enters the window, outlier or not, so a genuine step in the signal is accepted once it holds most of
+ * the window. While the window is filling up, every sample is accepted.
+ *
+ * @tparam N The window size; must be odd so the median is a single sample.
+ */
+template <std::size_t N> class HampelFilter {
+  static_assert(N % 2 == 1, "HampelFilter window size must be odd");
+
+private:
+  /** Scales the MAD of normally distributed samples to their standard deviation. */
+  static constexpr float MAD_TO_SIGMA = 1.4826F;
+
+  std::array<float, N> window{}; /**< Samples in arrival order, used as a ring buffer. */
+  std::size_t next{0};           /**< Index in window where the next sample is stored. */
+  std::size_t count{0};          /**< Number of samples in the window. */
+  float threshold;               /**< Outlier distance, in standard deviations. */
+  float minDeviation;            /**< Distance from the median that is never an outlier, for flat signals. */
+  unsigned long rejected{0};     /**< Outliers detected since construction. */
+
+  /**
+   * Returns the median of the first count values of an array, reordering them.
+   * @param values The values.
+   * @return The upper median.
+   */
+  float medianOf(std::array<float, N> &values) const {
+    auto middle = values.begin() + count / 2;
+    std::nth_element(values.begin(), middle, values.begin() + count);
+    return *middle;
+  }
+
+public:
+  /**
+   * Constructor for the HampelFilter class.
+   * @param threshold Outlier distance from the window median, in standard deviations estimated from the MAD.
+   * @param minDeviation Distance from the median that is always accepted, so a quantized or flat signal, whose MAD
+   * is zero, does not turn every small change into an outlier.
+   */
+  HampelFilter(float threshold, float minDeviation) : threshold(threshold), minDeviation(minDeviation) {}
+
+  /**
+   * Checks a sample against the current window, then adds it to the window.
+   * @param value The new sample.
+   * @return True if the sample is not an outlier, false if it should be dropped.
+   */
+  bool accept(float value) {
+    bool inlier = true;
+    if (count == N) {
+      std::array<float, N> values = window;
+      float median = medianOf(values);
+      for (float &sample : values) {
+        sample = std::fabs(sample - median);
+      }
+      float limit = threshold * MAD_TO_SIGMA * medianOf(values);
+      inlier = std::fabs(value - median) <= std::max(limit, minDeviation);
+    } else {
+      count++;
+    }
+
+    window[next] = value;
+    next = (next + 1) % N;
+    if (!inlier) {
+      rejected++;
+    }
+    return inlier;
+  }
+
+  /**
+   * Returns the number of outliers detected since construction. Clearing the window does not reset it.
+   * @return The outlier count.
+   */
+  [[nodiscard]] unsigned long getRejectedCount() const { return rejected; }
+
+  /**
+   * Removes every sample from the window, for when the signal is about to jump legitimately.
+   */
+  void clear() {
+    next = 0;
+    count = 0;
+  }
+};
+
+#endif // HAMPEL_FILTER_H
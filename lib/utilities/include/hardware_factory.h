@@ -3,6 +3,11 @@
 #include <hardware_interfaces.h>
 
 #if !defined(UNIT_TEST) && !defined(NATIVE)
+#ifdef PARALLEL_SCALE_BANK
+#include <constants.h>
+#include <parallel_hx711_bank.h>
+#endif
+
 /**
  * Factory class for creating hardware interface implementations.
  * This helps with dependency injection in production code while
@@ -28,6 +33,64 @@ public:
     return &sdInterface;
   }
 
+  /**
+   * Get the storage for the scale calibrations.
+   * @return Pointer to a BlockStorage implementation.
+   */
+  static IBlockStorage *getCalibrationStorage() {
+    static ArduinoBlockStorage calibrationStorage(CALIBRATION_FILE_NAME);
+    return &calibrationStorage;
+  }
+
+  /**
+   * Get the storage for the autotuned PID gains.
+   * @return Pointer to a BlockStorage implementation.
+   */
+  static IBlockStorage *getTuningStorage() {
+    static ArduinoBlockStorage tuningStorage(TUNING_FILE_NAME);
+    return &tuningStorage;
+  }
+
+  /**
+   * Get the storage for the ROM code of each thermometer probe's position.
+   * @return Pointer to a BlockStorage implementation.
+   */
+  static IBlockStorage *getProbeStorage() {
+    static ArduinoBlockStorage probeStorage(PROBE_FILE_NAME);
+    return &probeStorage;
+  }
+
+  /**
+   * Get the storage for the distillation recipe.
+   * @return Pointer to a RecipeStorage implementation.
+   */
+  static IRecipeStorage *getRecipeStorage() {
+    static ArduinoRecipeStorage recipeStorage(RECIPE_FILE_NAME);
+    return &recipeStorage;
+  }
+
+#ifdef PARALLEL_SCALE_BANK
+  /**
+   * Get the bank of HX711 modules that share SCALE_BANK_CLOCK_PIN.
+   * @return Reference to the scale bank.
+   */
+  static ParallelHX711Bank &getScaleBank() {
+    static ArduinoHX711BankPort port;
+    static ParallelHX711Bank bank(port, SCALE_BANK_CLOCK_PIN);
+    return bank;
+  }
+
+  /**
+   * Create a new Scale interface implementation on the shared-clock scale bank.
+   * @param dataPin The data pin for the HX711 module.
+   * @param clockPin Unused; every module is clocked by SCALE_BANK_CLOCK_PIN.
+   * @return Pointer to a newly created ScaleInterface implementation.
+   * @note The caller is responsible for deleting the returned pointer.
+   */
+  static IScaleInterface *createScaleInterface(int dataPin, int clockPin) {
+    return new HX711BankChannel(getScaleBank(), dataPin);
+  }
+#else
   /**
    * Create a new Scale interface implementation.
    * @param dataPin The data pin for the HX711 module.
@@ -38,6 +101,7 @@ public:
   static IScaleInterface *createScaleInterface(int dataPin, int clockPin) {
     return new HX711ScaleInterface(dataPin, clockPin);
   }
+#endif
 };
 #else
 /**
@@ -63,6 +127,42 @@ public:
     return &sdInterface;
   }
 
+  /**
+   * Get the storage for the scale calibrations.
+   * @return Pointer to a BlockStorage implementation.
+   */
+  static IBlockStorage *getCalibrationStorage() {
+    static ArduinoBlockStorage calibrationStorage(CALIBRATION_FILE_NAME);
+    return &calibrationStorage;
+  }
+
+  /**
+   * Get the storage for the autotuned PID gains.
+   * @return Pointer to a BlockStorage implementation.
+   */
+  static IBlockStorage *getTuningStorage() {
+    static ArduinoBlockStorage tuningStorage(TUNING_FILE_NAME);
+    return &tuningStorage;
+  }
+
+  /**
+   * Get the storage for the ROM code of each thermometer probe's position.
+   * @return Pointer to a BlockStorage implementation.
+   */
+  static IBlockStorage *getProbeStorage() {
+    static ArduinoBlockStorage probeStorage(PROBE_FILE_NAME);
+    return &probeStorage;
+  }
+
+  /**
+   * Get the storage for the distillation recipe.
+   * @return Pointer to a RecipeStorage implementation.
+   */
+  static IRecipeStorage *getRecipeStorage() {
+    static ArduinoRecipeStorage recipeStorage(RECIPE_FILE_NAME);
+    return &recipeStorage;
+  }
+
   /**
    * Create a new Scale interface implementation.
    * @param dataPin The data pin for the HX711 module.
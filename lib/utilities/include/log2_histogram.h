@@ -0,0 +1,103 @@
+#ifndef LOG2_HISTOGRAM_H
+#define LOG2_HISTOGRAM_H
+
+#include <cstdint>
+
+/**
+ * Histogram of non-negative durations in power-of-two buckets.
+ *
+ * Bucket 0 counts zeros and bucket b counts values from 2^(b-1) up to 2^b - 1, so the buckets span five orders of
+ * magnitude in a fixed array, at the same relative resolution throughout. The last bucket takes everything from
+ * 2^(BUCKETS-2) up, and the exact largest value is kept alongside. Adding a sample costs a few shifts and nothing
+ * is allocated, so it can sit on the scheduler's hot path.
+ */
+class Log2Histogram {
+public:
+  /** Buckets; in microseconds, the last one starts at 262 ms. */
+  static constexpr uint8_t BUCKETS = 20;
+
+private:
+  uint32_t counts[BUCKETS]{}; /**< Samples per bucket. */
+  unsigned long samples{0};   /**< Samples in all buckets. */
+  unsigned long maximum{0};   /**< Largest sample. */
+
+public:
+  /**
+   * Returns the bucket a value falls in.
+   * @param value The value.
+   * @return The bucket: 0 for zero, otherwise the bit width of the value, at most BUCKETS - 1.
+   */
+  static uint8_t bucketOf(unsigned long value) {
+    uint8_t bucket = 0;
+    while (value != 0 && bucket < BUCKETS - 1) {
+      value >>= 1;
+      bucket++;
+    }
+    return bucket;
+  }
+
+  /**
+   * Returns the smallest value a bucket counts.
+   * @param bucket The bucket.
+   * @return 0 for bucket 0, otherwise 2^(bucket-1).
+   */
+  static unsigned long bucketLowerBound(uint8_t bucket) { return bucket == 0 ? 0 : 1UL << (bucket - 1); }
+
+  /**
+   * Adds a sample.
+   * @param value The sample.
+   */
+  void add(unsigned long value) {
+    counts[bucketOf(value)]++;
+    samples++;
+    if (value > maximum) {
+      maximum = value;
+    }
+  }
+
+  /**
+   * Returns the samples in a bucket.
+   * @param bucket The bucket.
+   * @return The sample count, or 0 for a bucket past the last.
+   */
+  [[nodiscard]] uint32_t getCount(uint8_t bucket) const { return bucket < BUCKETS ? counts[bucket] : 0; }
+
+  /**
+   * Returns the samples in all buckets.
+   * @return The sample count.
+   */
+  [[nodiscard]] unsigned long getSampleCount() const { return samples; }
+
+  /**
+   * Returns the largest sample.
+   * @return The largest sample, or 0 if there is none.
+   */
+  [[nodiscard]] unsigned long getMax() const { return maximum; }
+
+  /**
+   * Returns a bound that at least a given share of the samples do not exceed: the top of the bucket holding that
+   * percentile, or the largest sample if that is lower.
+   * @param percent The share of samples, 1 to 100.
+   * @return The bound, or 0 if there are no samples.
+   */
+  [[nodiscard]] unsigned long getPercentileBound(uint8_t percent) const {
+    // The rank of the percentile sample, rounded up so the bound covers at least the share asked for
+    unsigned long rank = (static_cast<unsigned long long>(samples) * percent + 99U) / 100U;
+    unsigned long seen = 0;
+    for (uint8_t bucket = 0; bucket < BUCKETS - 1; bucket++) {
+      seen += counts[bucket];
+      if (seen >= rank) {
+        unsigned long top = bucketLowerBound(bucket + 1) - 1;
+        return top < maximum ? top : maximum;
+      }
+    }
+    return maximum;
+  }
+
+  /**
+   * Clears every bucket and the largest sample.
+   */
+  void reset() { *this = Log2Histogram(); }
+};
+
+#endif // LOG2_HISTOGRAM_H
@@ -22,6 +22,7 @@ public:
 
 private:
   static constexpr int MAX_LOG_LINE = 256;
+  static constexpr int MAX_LOG_PREFIX = 32; // Room for "[time][level] " ahead of a message
 
 // Chip select pin for SD card
 #ifndef CHIP_SELECT_PIN
@@ -0,0 +1,101 @@
+#ifndef MEDIAN_FILTER_H
+#define MEDIAN_FILTER_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+/**
+ * Sliding-window median filter.
+ *
+ * Keeps the last N samples twice: once in arrival order, so the oldest sample is known, and once in sorted order,
+ * so the median is a single array lookup. Each new sample is placed with a binary search instead of sorting the
+ * whole window, which keeps the cost of a query independent of the window size.
+ *
+ * Adding is O(log N) comparisons but O(N) moves: the samples between the evicted slot and the new one shift by one.
+ * A balanced tree or indexable skip list would make the moves O(log N) too, but for the five-sample windows used
+ * here that is at most four copies of a small value, cheaper than a tree's node storage and pointer chasing.
+ *
+ * @tparam T The sample type.
+ * @tparam N The window size; must be odd so the median is a single sample.
+ */
+template <typename T, std::size_t N> class MedianFilter {
+  static_assert(N % 2 == 1, "MedianFilter window size must be odd");
+
+private:
+  std::array<T, N> window{}; /**< Samples in arrival order, used as a ring buffer. */
+  std::array<T, N> sorted{}; /**< The same samples in ascending order. */
+  std::size_t next{0};       /**< Index in window where the next sample is stored. */
+  std::size_t count{0};      /**< Number of samples in the window. */
+
+public:
+  /**
+   * Adds a sample, evicting the oldest one once the window is full.
+   * @param value The new sample.
+   */
+  void add(T value) {
+    if (count == N) {
+      // Reuse the oldest sample's slot: only the samples between it and the new one's place have to move
+      auto evicted = std::lower_bound(sorted.begin(), sorted.end(), window[next]);
+      if (*evicted < value) {
+        auto position = std::upper_bound(evicted + 1, sorted.end(), value);
+        std::copy(evicted + 1, position, evicted);
+        *(position - 1) = value;
+      } else {
+        auto position = std::upper_bound(sorted.begin(), evicted, value);
+        std::copy_backward(position, evicted, evicted + 1);
+        *position = value;
+      }
+    } else {
+      // Open a gap at the insertion point and drop the new sample into it
+      auto position = std::upper_bound(sorted.begin(), sorted.begin() + count, value);
+      std::copy_backward(position, sorted.begin() + count, sorted.begin() + count + 1);
+      *position = value;
+      count++;
+    }
+
+    window[next] = value;
+    next = (next + 1) % N;
+  }
+
+  /**
+   * Returns the median of the samples in the window.
+   * While the window is still filling up, the upper median of the samples received so far is returned.
+   * @return The median sample, or a value-initialized T if no sample has been added.
+   */
+  [[nodiscard]] T median() const { return count == 0 ? T{} : sorted[count / 2]; }
+
+  /**
+   * Returns the most recently added sample.
+   * @return The last sample, or a value-initialized T if no sample has been added.
+   */
+  [[nodiscard]] T last() const { return count == 0 ? T{} : window[(next + N - 1) % N]; }
+
+  /**
+   * Returns the difference between the largest and the smallest sample in the window.
+   * @return The spread, or a value-initialized T if no sample has been added.
+   */
+  [[nodiscard]] T spread() const { return count == 0 ? T{} : sorted[count - 1] - sorted[0]; }
+
+  /**
+   * Returns the number of samples in the window.
+   * @return The sample count, at most N.
+   */
+  [[nodiscard]] std::size_t size() const { return count; }
+
+  /**
+   * Checks whether the window holds N samples.
+   * @return True if the window is full, false otherwise.
+   */
+  [[nodiscard]] bool isFull() const { return count == N; }
+
+  /**
+   * Removes every sample from the window.
+   */
+  void clear() {
+    next = 0;
+    count = 0;
+  }
+};
+
+#endif // MEDIAN_FILTER_H
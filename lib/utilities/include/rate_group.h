@@ -0,0 +1,127 @@
+#ifndef RATE_GROUP_H
+#define RATE_GROUP_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * One job of a rate group.
+ */
+struct RateGroupMember {
+  const char *name; /**< Name for reports. */
+  void (*run)();    /**< The work to run; must not be null. */
+  uint16_t divider; /**< Runs on every divider-th tick of the group; 0 and 1 both mean every tick. */
+};
+
+/**
+ * A set of jobs that share a rate, run in priority order from a single scheduled task, within a time budget.
+ *
+ * Members are listed highest priority first and run in that order on each tick. The first member due always runs;
+ * before each further member the group checks how long the tick has taken, and once the budget is spent the members
+ * still due are shed to the next tick, where they are still owed even if their divider does not come round. A
+ * member is never interrupted, so a tick can overrun its budget by at most one member's run.
+ *
+ * The groups are scheduled fastest first, so where their deadlines coincide the scheduler runs the faster group
+ * first, and each slower group's budget is kept below the fast period. A slow tick then holds the fast loop up by
+ * at most its budget plus the run of the member that crosses it, so slow members that do display or SD I/O should
+ * split long work, such as a report of many logged lines, over several ticks.
+ */
+class RateGroup {
+public:
+  /** Returns the current time in microseconds, for timing ticks. */
+  using Timer = unsigned long (*)();
+
+  /** Most members a group can hold. */
+  static const uint8_t MAX_MEMBERS = 8;
+
+private:
+  const char *name;                        /**< Name for reports. */
+  const RateGroupMember *members;          /**< The member table, highest priority first. */
+  std::size_t memberCount;                 /**< Members in the table, at most MAX_MEMBERS. */
+  unsigned long budgetUs;                  /**< Time a tick may take before further members are shed. */
+  Timer timer;                             /**< The tick timer. */
+  unsigned long ticks{0};                  /**< Ticks run. */
+  unsigned long overBudgetTicks{0};        /**< Ticks that shed members. */
+  unsigned long worstTickUs{0};            /**< Longest tick. */
+  uint8_t owed{0};                         /**< Members shed and still due, one bit each. */
+  unsigned long shed[MAX_MEMBERS]{};       /**< Times each member was shed. */
+  unsigned long worstRunUs[MAX_MEMBERS]{}; /**< Longest run of each member. */
+
+  /**
+   * Tells whether a member is due on the current tick.
+   * @param index The member.
+   * @return True if the member's divider comes round on this tick or it is owed from an earlier one.
+   */
+  [[nodiscard]] bool isDue(std::size_t index) const;
+
+public:
+  /**
+   * Constructor for the RateGroup class.
+   * @param name Name for reports; must outlive the group.
+   * @param members The member table, highest priority first; it must outlive the group.
+   * @param memberCount Members in the table; members past MAX_MEMBERS never run.
+   * @param budgetUs Time a tick may take before further members are shed.
+   * @param timer The tick timer; must not be null.
+   */
+  RateGroup(const char *name, const RateGroupMember *members, std::size_t memberCount, unsigned long budgetUs,
+            Timer timer);
+
+  /**
+   * Runs one tick: every member due, highest priority first, until the budget is spent.
+   * @return The number of members run.
+   */
+  unsigned int run();
+
+  /**
+   * Returns the group's name.
+   * @return The name.
+   */
+  [[nodiscard]] const char *getName() const;
+
+  /**
+   * Returns the members in the group.
+   * @return The member count.
+   */
+  [[nodiscard]] std::size_t getMemberCount() const;
+
+  /**
+   * Returns a member of the group.
+   * @param index The member, below getMemberCount().
+   * @return The member.
+   */
+  [[nodiscard]] const RateGroupMember &getMember(std::size_t index) const;
+
+  /**
+   * Returns how many ticks the group has run.
+   * @return The tick count.
+   */
+  [[nodiscard]] unsigned long getTickCount() const;
+
+  /**
+   * Returns how many ticks ran out of budget and shed members.
+   * @return The over-budget tick count.
+   */
+  [[nodiscard]] unsigned long getOverBudgetCount() const;
+
+  /**
+   * Returns the longest tick so far.
+   * @return The time in microseconds.
+   */
+  [[nodiscard]] unsigned long getWorstTickUs() const;
+
+  /**
+   * Returns how many times a member was shed to a later tick.
+   * @param index The member.
+   * @return The shed count, or 0 for an unknown member.
+   */
+  [[nodiscard]] unsigned long getShedCount(std::size_t index) const;
+
+  /**
+   * Returns the longest run of a member so far.
+   * @param index The member.
+   * @return The time in microseconds, or 0 for an unknown member.
+   */
+  [[nodiscard]] unsigned long getWorstRunUs(std::size_t index) const;
+};
+
+#endif // RATE_GROUP_H
@@ -0,0 +1,93 @@
+#ifndef RECIPE_H
+#define RECIPE_H
+
+#include "distillation_state_manager.h"
+#include "fixed_point_temperature.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * The settings of one distillation run: fraction volumes, flow rates, heater powers and the thresholds that end the
+ * phases. A plain value with no pointers, so it can be copied, and filled from a recipe file without allocating.
+ *
+ * The temperature thresholds are kept in raw 1/16 °C steps next to their Celsius values, so the control loop can
+ * compare them against probe readings without soft-float.
+ */
+struct Recipe {
+  float earlyForeshotsVolumeMl;                /**< Volume that ends early foreshots. */
+  float lateForeshotsVolumeMl;                 /**< Volume that ends late foreshots. */
+  float headsVolumeMl;                         /**< Volume that ends heads. */
+  float heartsVolumeMl;                        /**< Least volume of hearts, before a temperature rise can end them. */
+  float earlyTailsVolumeMl;                    /**< Volume that ends early tails. */
+  float lateTailsVolumeMl;                     /**< Volume that ends late tails. */
+  float lowFlowRateMlPerMin;                   /**< Take-off while the column is not stabilized. */
+  float highFlowRateMlPerMin;                  /**< Take-off once the column is stabilized. */
+  int heatUpPower;                             /**< Heater power while heating up the mash, in watts. */
+  int stabilizingPower;                        /**< Heater power while the column stabilizes, in watts. */
+  float heatUpEndTemperatureC;                 /**< Column top temperature that ends heating up. */
+  float stabilizationThresholdC;               /**< Bottom-to-top difference below which the column is stable. */
+  float heartsEndSlopeCPerMin;                 /**< Sustained near-top rise that ends hearts. */
+  int finalizeMinutes;                         /**< Time the coolant keeps running after the heater goes off. */
+  RawTemperature heatUpEndTemperatureRaw{0};   /**< heatUpEndTemperatureC in raw steps. */
+  RawTemperature stabilizationThresholdRaw{0}; /**< stabilizationThresholdC in raw steps. */
+
+  /**
+   * Returns the target volume of a fraction.
+   * @param fraction A collecting phase, EARLY_FORESHOTS to LATE_TAILS.
+   * @return The volume in ml, or 0 for a phase that collects nothing.
+   */
+  [[nodiscard]] float getFractionVolumeMl(DistillationState fraction) const;
+};
+
+/**
+ * Why a recipe file was rejected.
+ */
+enum RecipeError : uint8_t {
+  RECIPE_OK,            /**< The recipe was accepted. */
+  RECIPE_SYNTAX_ERROR,  /**< A line is not `key = number`, or a whole number has a fraction. */
+  RECIPE_UNKNOWN_KEY,   /**< A key names no setting. */
+  RECIPE_DUPLICATE_KEY, /**< A setting is given twice. */
+  RECIPE_OUT_OF_RANGE,  /**< A value lies outside the limits of its setting. */
+  RECIPE_OFF_STEP,      /**< A value falls between the steps its setting is applied in. */
+  RECIPE_INCONSISTENT,  /**< The values are each in range but contradict one another. */
+};
+
+/**
+ * Outcome of parsing a recipe file.
+ */
+struct RecipeParseResult {
+  RecipeError error; /**< RECIPE_OK, or why the file was rejected. */
+  uint16_t line;     /**< The line at fault, counting from 1; 0 for a fault of the file as a whole. */
+};
+
+/**
+ * Returns the recipe built into the firmware, from the defaults in constants.h.
+ * @return The default recipe.
+ */
+Recipe defaultRecipe();
+
+/**
+ * Parses a recipe file over a recipe.
+ *
+ * The file holds one `key = number` setting per line; blank lines and text after a `#` are ignored, and settings
+ * the file leaves out keep their value in the recipe. Numbers are plain decimals, without exponents. The text is
+ * read in place and need not be null-terminated, and nothing is allocated.
+ *
+ * Every value is checked against the limits of its setting, and the result as a whole against the others. The
+ * recipe is only changed if the whole file is accepted.
+ * @param text The file contents.
+ * @param length Bytes in the file.
+ * @param recipe The recipe to update; unchanged unless the result is RECIPE_OK.
+ * @return RECIPE_OK, or the first fault found and its line.
+ */
+RecipeParseResult parseRecipe(const char *text, std::size_t length, Recipe &recipe);
+
+/**
+ * Describes a recipe error for the log.
+ * @param error The error.
+ * @return A short description.
+ */
+const char *describeRecipeError(RecipeError error);
+
+#endif // RECIPE_H
@@ -0,0 +1,139 @@
+#ifndef RELAY_AUTOTUNER_H
+#define RELAY_AUTOTUNER_H
+
+#include <cstdint>
+
+/**
+ * PID gains, in the units PID::SetTunings() takes.
+ */
+struct PidTuning {
+  double kp; /**< Proportional gain. */
+  double ki; /**< Integral gain, per second. */
+  double kd; /**< Derivative gain, in seconds. */
+};
+
+/**
+ * Compares two sets of gains, so the tuning store can tell when they changed.
+ * @param a The first gains.
+ * @param b The second gains.
+ * @return True if all three gains are equal, false otherwise.
+ */
+inline bool operator==(const PidTuning &a, const PidTuning &b) { return a.kp == b.kp && a.ki == b.ki && a.kd == b.kd; }
+
+/**
+ * Progress of a relay experiment.
+ */
+enum AutotuneState {
+  AUTOTUNE_IDLE,    /**< No experiment has been started. */
+  AUTOTUNE_RUNNING, /**< The relay is driving the process into a limit cycle. */
+  AUTOTUNE_DONE,    /**< The ultimate gain and period were measured. */
+  AUTOTUNE_FAILED,  /**< The process did not settle into a steady oscillation in time. */
+};
+
+/**
+ * Ziegler–Nichols rules for turning the ultimate gain and period into PID gains.
+ */
+enum TuningRule {
+  TUNING_RULE_PI,  /**< Proportional-integral, for noisy measurements or on/off actuators. */
+  TUNING_RULE_PID, /**< Full PID, for smooth measurements. */
+};
+
+/**
+ * Åström–Hägglund relay autotuner.
+ *
+ * In place of the PID, a relay with hysteresis switches the output between bias + amplitude and bias - amplitude
+ * whenever the process value crosses the setpoint. Most processes then settle into a limit cycle whose period is
+ * the ultimate period Pu, and whose amplitude a gives the ultimate gain Ku = 4d / (π·√(a² − ε²)) for a relay of
+ * amplitude d and hysteresis ε. Cycles run from one switch high to the next, so the approach to the first switch is
+ * discarded as a transient; the experiment finishes once two consecutive cycles agree on period and amplitude within
+ * CYCLE_TOLERANCE.
+ *
+ * Every update takes the time the process value was acquired, so the autotuner runs the same on timestamped sensor
+ * readings in the controller and on simulated time in native tests. It keeps no more than a few numbers of state.
+ */
+class RelayAutotuner {
+private:
+  double setpoint{0};                 /**< Process value the relay switches around. */
+  double bias{0};                     /**< Output in the middle of the relay swing. */
+  double amplitude{0};                /**< Relay swing either side of the bias. */
+  double hysteresis{0};               /**< Distance from the setpoint the process value must cross to switch. */
+  unsigned long timeoutMs{0};         /**< Longest the experiment may run. */
+  unsigned long startTime{0};         /**< Time the experiment started. */
+  unsigned long cycleStart{0};        /**< Time the relay last switched high, which starts a cycle. */
+  double cycleMax{0};                 /**< Highest process value in the current cycle. */
+  double cycleMin{0};                 /**< Lowest process value in the current cycle. */
+  double lastPeriodMs{0};             /**< Period of the previous complete cycle. */
+  double lastAmplitude{0};            /**< Amplitude of the previous complete cycle. */
+  double ultimateGain{0};             /**< Measured ultimate gain. */
+  double ultimatePeriodMs{0};         /**< Measured ultimate period. */
+  uint8_t cycles{0};                  /**< Cycles started since the first switch high. */
+  bool outputHigh{false};             /**< Whether the relay is at bias + amplitude. */
+  AutotuneState state{AUTOTUNE_IDLE}; /**< Progress of the experiment. */
+
+  /**
+   * Closes the cycle that ends at a switch high, and finishes the experiment if it agrees with the previous one.
+   * @param processValue The process value at the switch, which opens the next cycle.
+   * @param timeMs The time of the switch.
+   */
+  void completeCycle(double processValue, unsigned long timeMs);
+
+public:
+  /** Cycles that may pass without two consecutive ones agreeing before the experiment fails. */
+  static const uint8_t MAX_CYCLES = 10;
+
+  /** Largest relative difference in period and amplitude between two cycles that still counts as agreement. */
+  static constexpr double CYCLE_TOLERANCE = 0.1;
+
+  /**
+   * Starts a relay experiment. The relay begins high and switches low on the first update if the process value is
+   * already above the setpoint.
+   * @param setpoint Process value the relay switches around.
+   * @param bias Output in the middle of the relay swing.
+   * @param amplitude Relay swing either side of the bias.
+   * @param hysteresis Distance from the setpoint the process value must cross to switch, above the noise.
+   * @param timeoutMs Longest the experiment may run before it fails.
+   * @param timeMs The time the experiment starts.
+   */
+  void start(double setpoint, double bias, double amplitude, double hysteresis, unsigned long timeoutMs,
+             unsigned long timeMs);
+
+  /**
+   * Feeds a process value to the relay.
+   * @param processValue The process value.
+   * @param timeMs The time the process value was acquired.
+   * @return The output to apply; the bias once the experiment has ended.
+   */
+  double update(double processValue, unsigned long timeMs);
+
+  /**
+   * Abandons a running experiment.
+   */
+  void cancel();
+
+  /**
+   * Returns the progress of the experiment.
+   * @return The autotune state.
+   */
+  [[nodiscard]] AutotuneState getState() const;
+
+  /**
+   * Returns the measured ultimate gain.
+   * @return Ku in output units per process value unit, or 0 until the experiment is done.
+   */
+  [[nodiscard]] double getUltimateGain() const;
+
+  /**
+   * Returns the measured ultimate period.
+   * @return Pu in milliseconds, or 0 until the experiment is done.
+   */
+  [[nodiscard]] double getUltimatePeriodMs() const;
+
+  /**
+   * Derives PID gains from the ultimate gain and period.
+   * @param rule The Ziegler–Nichols rule to apply.
+   * @return The gains, all zero until the experiment is done.
+   */
+  [[nodiscard]] PidTuning getTuning(TuningRule rule) const;
+};
+
+#endif // RELAY_AUTOTUNER_H
@@ -0,0 +1,82 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Lock-free single-producer, single-consumer ring buffer.
+ *
+ * Meant for handing samples from an interrupt handler to the main loop without disabling interrupts. The producer
+ * only writes the head index and the consumer only writes the tail index, so plain atomic loads and stores are
+ * enough; no read-modify-write instructions are needed, which a Cortex-M0+ does not have.
+ *
+ * When the queue is full, new items are dropped and counted, so the consumer keeps the oldest unread items and
+ * can tell that it fell behind.
+ *
+ * @tparam T The item type.
+ * @tparam N The capacity; must be a power of two so the free-running indices wrap cleanly.
+ */
+template <typename T, std::size_t N> class SpscQueue {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+private:
+  std::array<T, N> items{};              /**< Storage, indexed by the free-running indices modulo N. */
+  std::atomic<std::size_t> head{0};      /**< Number of items pushed so far; written only by the producer. */
+  std::atomic<std::size_t> tail{0};      /**< Number of items popped so far; written only by the consumer. */
+  std::atomic<unsigned long> dropped{0}; /**< Number of items dropped on a full queue; written only by the producer. */
+
+public:
+  /**
+   * Appends an item. Call from the producer only.
+   * @param item The item to append.
+   * @return True if the item was queued, false if the queue was full and the item was dropped.
+   */
+  bool push(const T &item) {
+    std::size_t currentHead = head.load(std::memory_order_relaxed);
+    if (currentHead - tail.load(std::memory_order_acquire) == N) {
+      dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    items[currentHead % N] = item;
+    head.store(currentHead + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Removes the oldest item. Call from the consumer only.
+   * @param item Receives the removed item.
+   * @return True if an item was removed, false if the queue was empty.
+   */
+  bool pop(T &item) {
+    std::size_t currentTail = tail.load(std::memory_order_relaxed);
+    if (currentTail == head.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = items[currentTail % N];
+    tail.store(currentTail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Returns the number of queued items. Exact only when called from the producer or the consumer.
+   * @return The number of items waiting to be popped.
+   */
+  [[nodiscard]] std::size_t size() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Returns the number of items dropped because the queue was full.
+   * @return The number of dropped items since construction.
+   */
+  [[nodiscard]] unsigned long getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+  /**
+   * Discards all queued items. Call from the consumer only, while the producer is stopped.
+   */
+  void clear() { tail.store(head.load(std::memory_order_acquire), std::memory_order_release); }
+};
+
+#endif // SPSC_QUEUE_H
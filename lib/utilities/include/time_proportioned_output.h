@@ -0,0 +1,82 @@
+#ifndef TIME_PROPORTIONED_OUTPUT_H
+#define TIME_PROPORTIONED_OUTPUT_H
+
+/**
+ * Slow PWM for an on/off actuator such as a solenoid valve.
+ *
+ * Time is divided into windows of fixed length, and the output is on for the first duty × window of each. The on time
+ * is fixed when a window starts, so a duty change takes effect in the next window rather than chopping the current
+ * pulse.
+ *
+ * No pulse or gap is shorter than the minimum dwell. On time that would make a pulse too short to open the actuator,
+ * or a gap too short to close it, is carried into the next window instead of being dropped, so the average duty
+ * still matches the request at small and large duties. The dwell is enforced again on every switch, so the output
+ * never chatters, whatever the duty or the update timing.
+ *
+ * Every update takes the current time, so the output runs the same on millis() and on simulated time in tests.
+ */
+class TimeProportionedOutput {
+private:
+  unsigned long windowMs;       /**< Length of one PWM window. */
+  unsigned long minDwellMs;     /**< Shortest time the output stays on or off. */
+  double duty{0};               /**< Requested share of each window with the output on, 0 to 1. */
+  double carryMs{0};            /**< On time owed to or by later windows, from pulses the dwell shortened or dropped. */
+  unsigned long windowStart{0}; /**< Time the current window started. */
+  unsigned long onTimeMs{0};    /**< On time in the current window. */
+  unsigned long lastSwitch{0};  /**< Time the output last changed. */
+  bool on{false};               /**< Whether the output is on. */
+  bool running{false};          /**< Whether a window is in progress. */
+
+  /**
+   * Opens a new window and fixes its on time from the duty and the carried on time.
+   * @param nowMs The time the window starts.
+   */
+  void startWindow(unsigned long nowMs);
+
+public:
+  /**
+   * Constructor for the TimeProportionedOutput class. The output starts off, with a duty of zero.
+   * @param windowMs Length of one PWM window; longer windows give a finer duty for a given dwell.
+   * @param minDwellMs Shortest time the output stays on or off; at most half the window.
+   */
+  TimeProportionedOutput(unsigned long windowMs, unsigned long minDwellMs);
+
+  /**
+   * Sets the share of each window with the output on, from the next window on.
+   * @param newDuty The duty, clamped to 0 to 1.
+   */
+  void setDuty(double newDuty);
+
+  /**
+   * Advances the output to the given time. Call it well within the minimum dwell, so pulses keep their length.
+   * @param nowMs The current time.
+   * @return True if the output should be on, false otherwise.
+   */
+  bool update(unsigned long nowMs);
+
+  /**
+   * Turns the output off at once, ignoring the dwell, and forgets the window and any carried on time. The next
+   * update starts a new window.
+   */
+  void reset();
+
+  /**
+   * Returns the requested duty.
+   * @return The duty, 0 to 1.
+   */
+  [[nodiscard]] double getDuty() const;
+
+  /**
+   * Returns whether the output is on.
+   * @return True if the output is on, false otherwise.
+   */
+  [[nodiscard]] bool isOn() const;
+
+  /**
+   * Returns the time the current window started, so a caller can tell when the duty was last taken up.
+   * @return The start of the current window.
+   */
+  [[nodiscard]] unsigned long getWindowStart() const;
+};
+
+#endif // TIME_PROPORTIONED_OUTPUT_H
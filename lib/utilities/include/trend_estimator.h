@@ -0,0 +1,172 @@
+#ifndef TREND_ESTIMATOR_H
+#define TREND_ESTIMATOR_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Streaming least-squares trend estimator over a sliding window of timestamped samples.
+ *
+ * The window's sums (t, y, t², t·y, y²) are updated in O(1) per sample: the new sample is added and the evicted
+ * one subtracted. Times and values are taken relative to an origin near the window, so the sums stay small.
+ * The origin moves to the oldest sample and the sums are rebuilt from the buffer once every N samples, which
+ * costs O(1) amortized.
+ *
+ * Integer samples are accumulated in 64-bit integers, so the sliding updates are exact and need no floating
+ * point; floats are only used when a slope or variance is queried. Floating-point samples are accumulated in
+ * floats, and the periodic rebuild keeps rounding errors from building up.
+ *
+ * @tparam T The sample type.
+ * @tparam N The window size in samples.
+ */
+template <typename T, std::size_t N> class TrendEstimator {
+  static_assert(N >= 3, "TrendEstimator needs at least three samples to estimate a residual variance");
+
+private:
+  using Sum = typename std::conditional<std::is_integral<T>::value, int64_t, float>::type;
+
+  static constexpr float MS_PER_MINUTE = 60000.0F;
+
+  std::array<unsigned long, N> times{}; /**< Sample times in milliseconds, used as a ring buffer. */
+  std::array<T, N> values{};            /**< Sample values, parallel to times. */
+  std::size_t next{0};                  /**< Index where the next sample is stored. */
+  std::size_t count{0};                 /**< Number of samples in the window. */
+  std::size_t sinceRebase{0};           /**< Samples added since the sums were last rebuilt. */
+  unsigned long originTime{0};          /**< Time origin of the sums in milliseconds. */
+  T originValue{};                      /**< Value origin of the sums. */
+  Sum sumT{};                           /**< Sum of sample times relative to the origin, in milliseconds. */
+  Sum sumY{};                           /**< Sum of sample values relative to the origin. */
+  Sum sumTT{};                          /**< Sum of squared relative times. */
+  Sum sumTY{};                          /**< Sum of relative time times relative value. */
+  Sum sumYY{};                          /**< Sum of squared relative values. */
+
+  void accumulate(unsigned long time, T value, Sum sign) {
+    auto t = static_cast<Sum>(static_cast<long>(time - originTime));
+    auto y = static_cast<Sum>(value - originValue);
+    sumT += sign * t;
+    sumY += sign * y;
+    sumTT += sign * t * t;
+    sumTY += sign * t * y;
+    sumYY += sign * y * y;
+  }
+
+  // Moves the origin to the oldest sample and rebuilds the sums from the buffer
+  void rebase() {
+    std::size_t oldest = (next + N - count) % N;
+    originTime = times[oldest];
+    originValue = values[oldest];
+    sumT = sumY = sumTT = sumTY = sumYY = Sum{};
+    for (std::size_t i = 0; i < count; i++) {
+      std::size_t slot = (oldest + i) % N;
+      accumulate(times[slot], values[slot], Sum{1});
+    }
+    sinceRebase = 0;
+  }
+
+  // Spread of the sample times around their mean, n·Σt² − (Σt)²
+  [[nodiscard]] float timeSpread() const {
+    auto n = static_cast<Sum>(count);
+    return static_cast<float>(n * sumTT - sumT * sumT);
+  }
+
+  // Covariance term of times and values, n·Σty − Σt·Σy
+  [[nodiscard]] float covariance() const {
+    auto n = static_cast<Sum>(count);
+    return static_cast<float>(n * sumTY - sumT * sumY);
+  }
+
+  // Spread of the values around their mean, n·Σy² − (Σy)²
+  [[nodiscard]] float valueSpread() const {
+    auto n = static_cast<Sum>(count);
+    return static_cast<float>(n * sumYY - sumY * sumY);
+  }
+
+public:
+  /**
+   * Adds a sample, evicting the oldest one once the window is full.
+   * @param timeMs The time the sample was taken, in milliseconds.
+   * @param value The sample value.
+   */
+  void add(unsigned long timeMs, T value) {
+    if (count == N) {
+      accumulate(times[next], values[next], Sum{-1});
+    } else {
+      count++;
+    }
+    times[next] = timeMs;
+    values[next] = value;
+    next = (next + 1) % N;
+
+    if (count == 1 || ++sinceRebase >= N) {
+      rebase();
+    } else {
+      accumulate(timeMs, value, Sum{1});
+    }
+  }
+
+  /**
+   * Returns the slope of the least-squares line through the window.
+   * @return The slope in value units per minute, or 0 if fewer than two distinct sample times are available.
+   */
+  [[nodiscard]] float slopePerMinute() const {
+    float spread = timeSpread();
+    if (count < 2 || spread <= 0.0F) {
+      return 0.0F;
+    }
+    return covariance() / spread * MS_PER_MINUTE;
+  }
+
+  /**
+   * Returns the variance of the samples around the least-squares line.
+   * @return The residual variance in squared value units, or 0 if fewer than three samples are available.
+   */
+  [[nodiscard]] float residualVariance() const {
+    if (count < 3) {
+      return 0.0F;
+    }
+    auto n = static_cast<float>(count);
+    float spread = timeSpread();
+    float explained = spread > 0.0F ? covariance() * covariance() / spread : 0.0F;
+    float residual = (valueSpread() - explained) / n;
+    return residual > 0.0F ? residual / (n - 2.0F) : 0.0F;
+  }
+
+  /**
+   * Returns the standard error of the slope, which tells how far the slope can be trusted given the noise.
+   * @return The standard error in value units per minute, or 0 if it cannot be estimated.
+   */
+  [[nodiscard]] float slopeStandardError() const {
+    float spread = timeSpread();
+    if (count < 3 || spread <= 0.0F) {
+      return 0.0F;
+    }
+    return std::sqrt(residualVariance() * static_cast<float>(count) / spread) * MS_PER_MINUTE;
+  }
+
+  /**
+   * Returns the number of samples in the window.
+   * @return The sample count, at most N.
+   */
+  [[nodiscard]] std::size_t size() const { return count; }
+
+  /**
+   * Checks whether the window holds N samples.
+   * @return True if the window is full, false otherwise.
+   */
+  [[nodiscard]] bool isFull() const { return count == N; }
+
+  /**
+   * Removes every sample from the window.
+   */
+  void clear() {
+    next = 0;
+    count = 0;
+    sinceRebase = 0;
+    sumT = sumY = sumTT = sumTY = sumYY = Sum{};
+  }
+};
+
+#endif // TREND_ESTIMATOR_H
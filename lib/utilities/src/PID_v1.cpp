@@ -0,0 +1,159 @@
+#include "../include/PID_v1.h"
+
+#include <cmath>
+
+#ifndef UNIT_TEST
+#include "Arduino.h"
+#else
+// The sample interval comes from millis(); the mock implementation lives in the test files
+#include "mock_arduino.h"
+#endif
+
+namespace {
+constexpr unsigned long DEFAULT_SAMPLE_TIME_MS = 100;
+constexpr double DEFAULT_OUTPUT_MIN = 0.0;
+constexpr double DEFAULT_OUTPUT_MAX = 255.0;
+constexpr double MS_PER_SECOND = 1000.0;
+constexpr double DERIVATIVE_FILTER_DIVISOR = 10.0;
+} // namespace
+
+PID::PID(double *input, double *output, double *setpoint, double kp, double ki, double kd, int controllerDirection)
+  : input(input), output(output), setpoint(setpoint), dispKp(0), dispKi(0), dispKd(0), outMin(DEFAULT_OUTPUT_MIN),
+    outMax(DEFAULT_OUTPUT_MAX), sampleTimeMs(DEFAULT_SAMPLE_TIME_MS), lastTime(millis() - DEFAULT_SAMPLE_TIME_MS),
+    direction(controllerDirection == REVERSE ? REVERSE : DIRECT) {
+  SetTunings(kp, ki, kd);
+}
+
+void PID::SetMode(int mode) {
+  bool newAuto = mode == AUTOMATIC;
+  if (newAuto && !inAuto) {
+    initialize();
+  }
+  inAuto = newAuto;
+}
+
+bool PID::Compute() {
+  if (!inAuto) {
+    return false;
+  }
+  unsigned long now = millis();
+  if (now - lastTime < sampleTimeMs) {
+    return false;
+  }
+  lastTime = now;
+
+  double measured = *input;
+  double error = *setpoint - measured;
+  // Differentiate the measurement rather than the error, so a setpoint step does not kick the output
+  filteredDelta += filterFactor * ((measured - lastInput) - filteredDelta);
+  lastInput = measured;
+
+  // The part of the output cut off by the limits is fed back into the integral, so a long saturation leaves no
+  // stored error to unwind
+  integral = clamp(integral + ki * error);
+  double unsaturated = kp * error + integral - kd * filteredDelta;
+  double saturated = clamp(unsaturated);
+  integral = clamp(integral + trackingFactor * (saturated - unsaturated));
+
+  *output = saturated;
+  return true;
+}
+
+void PID::SetOutputLimits(double min, double max) {
+  if (min >= max) {
+    return;
+  }
+  outMin = min;
+  outMax = max;
+  if (inAuto) {
+    *output = clamp(*output);
+    integral = clamp(integral);
+  }
+}
+
+void PID::SetTunings(double kp, double ki, double kd) {
+  if (kp < 0 || ki < 0 || kd < 0) {
+    return;
+  }
+  dispKp = kp;
+  dispKi = ki;
+  dispKd = kd;
+  updateFactors();
+}
+
+void PID::SetControllerDirection(int controllerDirection) {
+  direction = controllerDirection == REVERSE ? REVERSE : DIRECT;
+  updateFactors();
+}
+
+void PID::SetSampleTime(unsigned long newSampleTimeMs) {
+  if (newSampleTimeMs == 0) {
+    return;
+  }
+  sampleTimeMs = newSampleTimeMs;
+  updateFactors();
+}
+
+void PID::SetDerivativeFilter(double timeConstantSec) {
+  filterTime = timeConstantSec > 0 ? timeConstantSec : 0;
+  updateFactors();
+}
+
+void PID::SetTrackingTime(double timeConstantSec) {
+  trackingTime = timeConstantSec > 0 ? timeConstantSec : 0;
+  updateFactors();
+}
+
+double PID::GetKp() const { return dispKp; }
+
+double PID::GetKi() const { return dispKi; }
+
+double PID::GetKd() const { return dispKd; }
+
+int PID::GetMode() const { return inAuto ? AUTOMATIC : MANUAL; }
+
+int PID::GetDirection() const { return direction; }
+
+void PID::updateFactors() {
+  double sampleTimeSec = static_cast<double>(sampleTimeMs) / MS_PER_SECOND;
+  double sign = direction == REVERSE ? -1.0 : 1.0;
+  kp = sign * dispKp;
+  ki = sign * dispKi * sampleTimeSec;
+  kd = sign * dispKd / sampleTimeSec;
+
+  // Without a time constant of its own, the filter takes the textbook Td / N, so the derivative gain at high
+  // frequencies is capped at N times the proportional gain
+  double filter = filterTime;
+  if (filter <= 0 && dispKp > 0) {
+    filter = dispKd / (dispKp * DERIVATIVE_FILTER_DIVISOR);
+  }
+  filterFactor = sampleTimeSec / (filter + sampleTimeSec);
+
+  // Åström's rule of thumb: track with the geometric mean of the integral and derivative times
+  double tracking = trackingTime;
+  if (tracking <= 0 && dispKi > 0) {
+    double integralTime = dispKp / dispKi;
+    tracking = dispKd > 0 && dispKp > 0 ? std::sqrt(integralTime * dispKd / dispKp) : integralTime;
+  }
+  // Tracking faster than one sample would overshoot the limit, so the factor is capped at 1
+  trackingFactor = tracking > 0 ? sampleTimeSec / tracking : 0;
+  if (trackingFactor > 1.0) {
+    trackingFactor = 1.0;
+  }
+}
+
+double PID::clamp(double value) const {
+  if (value > outMax) {
+    return outMax;
+  }
+  if (value < outMin) {
+    return outMin;
+  }
+  return value;
+}
+
+void PID::initialize() {
+  integral = clamp(*output);
+  lastInput = *input;
+  filteredDelta = 0;
+}
@@ -0,0 +1,208 @@
+#include "../include/cooperative_scheduler.h"
+
+const uint8_t CooperativeScheduler::MAX_TASKS;
+const int CooperativeScheduler::INVALID_TASK;
+
+CooperativeScheduler::CooperativeScheduler(Clock clock) : clock(clock) {}
+
+void CooperativeScheduler::setClock(Clock newClock) { clock = newClock; }
+
+void CooperativeScheduler::setTimer(Timer newTimer) { timer = newTimer; }
+
+int CooperativeScheduler::schedule(unsigned long initialDelayMs, unsigned long periodMs, Callback callback,
+                                   OverrunPolicy policy) {
+  for (uint8_t slot = 0; slot < MAX_TASKS; slot++) {
+    Task &task = tasks[slot];
+    if (task.callback != nullptr) {
+      continue;
+    }
+    task.callback = callback;
+    task.deadline = clock() + initialDelayMs;
+    task.periodMs = periodMs > 0 ? periodMs : 1;
+    task.statistics = TaskStatistics();
+    task.policy = policy;
+    push(slot);
+    // The generation in the ID makes it go stale once the slot is reused
+    return static_cast<int>(task.generation) * MAX_TASKS + slot;
+  }
+  return INVALID_TASK;
+}
+
+bool CooperativeScheduler::cancel(int taskId) {
+  int slot = slotOf(taskId);
+  if (slot < 0) {
+    return false;
+  }
+  Task &task = tasks[slot];
+  if (task.pending) {
+    remove(static_cast<uint8_t>(slot));
+  }
+  // A task cancelling itself is not in the heap, so runLoop() must be told not to push it back
+  if (slot == runningSlot) {
+    runningCancelled = true;
+  }
+  task.callback = nullptr;
+  task.generation++;
+  return true;
+}
+
+unsigned int CooperativeScheduler::runLoop() {
+  // Read once, so a long task delays the others rather than letting the loop chase its own tail
+  unsigned long now = clock();
+  unsigned int runs = 0;
+  while (heapSize > 0) {
+    uint8_t slot = heap[0];
+    Task &task = tasks[slot];
+    if (static_cast<long>(now - task.deadline) < 0) {
+      break;
+    }
+    remove(slot);
+    runningSlot = slot;
+    runningCancelled = false;
+    TaskStatistics &statistics = task.statistics;
+    statistics.runs++;
+    // A fresh reading, so the delay a long task causes is charged to the tasks it held up
+    statistics.startLatenessMs.add(clock() - task.deadline);
+    if (timer != nullptr) {
+      unsigned long started = timer();
+      task.callback();
+      // A task that cancelled itself may have been replaced in its slot, and the new task starts with clean figures
+      if (!runningCancelled) {
+        statistics.runTimeUs.add(timer() - started);
+      }
+    } else {
+      task.callback();
+    }
+    runningSlot = -1;
+    runs++;
+    if (runningCancelled) {
+      continue;
+    }
+
+    task.deadline += task.periodMs;
+    long late = static_cast<long>(now - task.deadline);
+    if (late >= 0) {
+      if (task.policy == SKIP_MISSED) {
+        // Drop every period that has already passed, keeping the deadline on the task's grid
+        unsigned long missed = static_cast<unsigned long>(late) / task.periodMs + 1;
+        task.deadline += missed * task.periodMs;
+        statistics.overruns += missed;
+      } else {
+        statistics.overruns++;
+      }
+    }
+    push(slot);
+  }
+  return runs;
+}
+
+bool CooperativeScheduler::getNextDeadline(unsigned long &deadline) const {
+  if (heapSize == 0) {
+    return false;
+  }
+  deadline = tasks[heap[0]].deadline;
+  return true;
+}
+
+uint8_t CooperativeScheduler::getTaskCount() const {
+  uint8_t count = 0;
+  for (const Task &task : tasks) {
+    if (task.callback != nullptr) {
+      count++;
+    }
+  }
+  return count;
+}
+
+unsigned long CooperativeScheduler::getOverrunCount(int taskId) const {
+  int slot = slotOf(taskId);
+  return slot < 0 ? 0 : tasks[slot].statistics.overruns;
+}
+
+bool CooperativeScheduler::setTaskName(int taskId, const char *name) {
+  int slot = slotOf(taskId);
+  if (slot < 0) {
+    return false;
+  }
+  tasks[slot].statistics.name = name;
+  return true;
+}
+
+int CooperativeScheduler::getTaskIdAt(uint8_t slot) const {
+  if (slot >= MAX_TASKS || tasks[slot].callback == nullptr) {
+    return INVALID_TASK;
+  }
+  return static_cast<int>(tasks[slot].generation) * MAX_TASKS + slot;
+}
+
+const TaskStatistics *CooperativeScheduler::getStatistics(int taskId) const {
+  int slot = slotOf(taskId);
+  return slot < 0 ? nullptr : &tasks[slot].statistics;
+}
+
+int CooperativeScheduler::slotOf(int taskId) const {
+  if (taskId < 0) {
+    return -1;
+  }
+  int slot = taskId % MAX_TASKS;
+  const Task &task = tasks[slot];
+  if (task.callback == nullptr || task.generation != taskId / MAX_TASKS) {
+    return -1;
+  }
+  return slot;
+}
+
+bool CooperativeScheduler::isEarlier(uint8_t a, uint8_t b) const {
+  // Equal deadlines go by slot, so tasks due together always run in the same order
+  long difference = static_cast<long>(tasks[a].deadline - tasks[b].deadline);
+  return difference < 0 || (difference == 0 && a < b);
+}
+
+void CooperativeScheduler::push(uint8_t slot) {
+  tasks[slot].pending = true;
+  place(heapSize, slot);
+  heapSize++;
+  restore(static_cast<uint8_t>(heapSize - 1));
+}
+
+void CooperativeScheduler::remove(uint8_t slot) {
+  uint8_t position = tasks[slot].heapPosition;
+  tasks[slot].pending = false;
+  heapSize--;
+  if (position != heapSize) {
+    place(position, heap[heapSize]);
+    restore(position);
+  }
+}
+
+void CooperativeScheduler::restore(uint8_t position) {
+  uint8_t slot = heap[position];
+  while (position > 0) {
+    uint8_t parent = static_cast<uint8_t>((position - 1) / 2);
+    if (!isEarlier(slot, heap[parent])) {
+      break;
+    }
+    place(position, heap[parent]);
+    position = parent;
+  }
+  while (true) {
+    unsigned int child = 2U * position + 1U;
+    if (child >= heapSize) {
+      break;
+    }
+    if (child + 1U < heapSize && isEarlier(heap[child + 1U], heap[child])) {
+      child++;
+    }
+    if (!isEarlier(heap[child], slot)) {
+      break;
+    }
+    place(position, heap[child]);
+    position = static_cast<uint8_t>(child);
+  }
+  place(position, slot);
+}
+
+void CooperativeScheduler::place(uint8_t position, uint8_t slot) {
+  heap[position] = slot;
+  tasks[slot].heapPosition = position;
+}
@@ -0,0 +1,38 @@
+#include "../include/distillation_state_engine.h"
+
+DistillationStateEngine::DistillationStateEngine(const DistillationPhase *phases, std::size_t phaseCount)
+  : phases(phases), phaseCount(phaseCount) {}
+
+void DistillationStateEngine::start(DistillationState phase) { enter(phase); }
+
+bool DistillationStateEngine::update() {
+  if (currentPhase >= phaseCount) {
+    return false;
+  }
+  const DistillationPhase &phase = phases[currentPhase];
+  // The successor's exit predicate waits for the next tick, so one tick never runs more than one transition
+  if (phase.isComplete != nullptr && phase.isComplete()) {
+    if (phase.exit != nullptr) {
+      phase.exit();
+    }
+    enter(phase.next);
+    return true;
+  }
+  if (phase.control != nullptr) {
+    phase.control();
+  }
+  return false;
+}
+
+DistillationState DistillationStateEngine::getPhase() const { return currentPhase; }
+
+unsigned long DistillationStateEngine::getTransitionCount() const { return transitionCount; }
+
+void DistillationStateEngine::enter(DistillationState phase) {
+  currentPhase = phase;
+  transitionCount++;
+  DistillationStateManager::getInstance().setState(phase);
+  if (phase < phaseCount && phases[phase].enter != nullptr) {
+    phases[phase].enter();
+  }
+}
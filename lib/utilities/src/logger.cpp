@@ -30,7 +30,7 @@ const char *Logger::levelToString(LogLevel level) {
  * @param sdInterface Interface for SD card operations (nullptr to disable SD logging)
  */
 Logger::Logger(ISerialInterface *serialInterface, ISDInterface *sdInterface)
-  : serialInterface(serialInterface), sdInterface(sdInterface), sdEnabled(sdInterface != nullptr) {}
+  : sdEnabled(sdInterface != nullptr), serialInterface(serialInterface), sdInterface(sdInterface) {}
 
 /**
  * Initialize the logger
@@ -89,7 +89,7 @@ void Logger::log(LogLevel level, const char *format, ...) {
   va_end(args);
 
   // Format: [TIME][LEVEL] Message
-  char logLine[MAX_LOG_LINE];
+  char logLine[MAX_LOG_PREFIX + MAX_LOG_LINE];
   snprintf(logLine, sizeof(logLine), "[%lu][%s] %s", millis(), levelToString(level), message);
 
   // Output to Serial
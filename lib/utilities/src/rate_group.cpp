@@ -0,0 +1,69 @@
+#include "../include/rate_group.h"
+
+const uint8_t RateGroup::MAX_MEMBERS;
+
+RateGroup::RateGroup(const char *name, const RateGroupMember *members, std::size_t memberCount,
+                     unsigned long budgetUs, Timer timer)
+  : name(name), members(members), memberCount(memberCount < MAX_MEMBERS ? memberCount : MAX_MEMBERS),
+    budgetUs(budgetUs), timer(timer) {}
+
+unsigned int RateGroup::run() {
+  unsigned long started = timer();
+  unsigned int runs = 0;
+  bool overBudget = false;
+  for (std::size_t index = 0; index < memberCount; index++) {
+    if (!isDue(index)) {
+      continue;
+    }
+    uint8_t bit = static_cast<uint8_t>(1U << index);
+    // The first member due runs whatever the budget, so the group always makes progress
+    if (runs > 0 && timer() - started >= budgetUs) {
+      owed |= bit;
+      shed[index]++;
+      overBudget = true;
+      continue;
+    }
+    owed &= static_cast<uint8_t>(~bit);
+    unsigned long memberStarted = timer();
+    members[index].run();
+    unsigned long runUs = timer() - memberStarted;
+    if (runUs > worstRunUs[index]) {
+      worstRunUs[index] = runUs;
+    }
+    runs++;
+  }
+
+  unsigned long tickUs = timer() - started;
+  if (tickUs > worstTickUs) {
+    worstTickUs = tickUs;
+  }
+  if (overBudget) {
+    overBudgetTicks++;
+  }
+  ticks++;
+  return runs;
+}
+
+const char *RateGroup::getName() const { return name; }
+
+std::size_t RateGroup::getMemberCount() const { return memberCount; }
+
+const RateGroupMember &RateGroup::getMember(std::size_t index) const { return members[index]; }
+
+unsigned long RateGroup::getTickCount() const { return ticks; }
+
+unsigned long RateGroup::getOverBudgetCount() const { return overBudgetTicks; }
+
+unsigned long RateGroup::getWorstTickUs() const { return worstTickUs; }
+
+unsigned long RateGroup::getShedCount(std::size_t index) const { return index < memberCount ? shed[index] : 0; }
+
+unsigned long RateGroup::getWorstRunUs(std::size_t index) const {
+  return index < memberCount ? worstRunUs[index] : 0;
+}
+
+bool RateGroup::isDue(std::size_t index) const {
+  // Dividers count from the first tick, so a divider of n runs on ticks 0, n, 2n and so on
+  uint16_t divider = members[index].divider;
+  return (owed & (1U << index)) != 0 || divider <= 1 || ticks % divider == 0;
+}
@@ -0,0 +1,287 @@
+#include "../include/recipe.h"
+
+#include <constants.h>
+#include <cstring>
+
+namespace {
+// Limits a recipe value must lie within
+constexpr float MAX_FRACTION_VOLUME_ML = 20000.0F; // More than a 25 L wash can give
+constexpr float MIN_FLOW_RATE_ML_PER_MIN = 1.0F;
+constexpr float MAX_FLOW_RATE_ML_PER_MIN = 100.0F;
+constexpr float MIN_HEAT_UP_END_C = 20.0F;
+constexpr float MAX_HEAT_UP_END_C = 100.0F;
+constexpr float MIN_STABILIZATION_THRESHOLD_C = 0.1F;
+constexpr float MAX_STABILIZATION_THRESHOLD_C = 10.0F;
+constexpr float MIN_HEARTS_END_SLOPE_C_PER_MIN = 0.01F;
+constexpr float MAX_HEARTS_END_SLOPE_C_PER_MIN = 5.0F;
+constexpr float MAX_FINALIZE_MINUTES = 60.0F;
+constexpr int MAX_NUMBER_DIGITS = 9; // Enough for any limit, and too few to overflow an int
+
+/**
+ * A setting a recipe file may give: its key, the member it goes to, and its limits.
+ * Exactly one of the members is set; a whole-number setting rejects a value with a fraction.
+ */
+struct RecipeField {
+  const char *key;     /**< The key in the file. */
+  float Recipe::*real; /**< The member a decimal setting goes to, or null. */
+  int Recipe::*whole;  /**< The member a whole-number setting goes to, or null. */
+  float min;           /**< Lowest value accepted. */
+  float max;           /**< Highest value accepted. */
+  int step;            /**< Multiple a whole-number value must be, or 0 for any. */
+};
+
+const RecipeField FIELDS[] = {
+    {"early_foreshots_ml", &Recipe::earlyForeshotsVolumeMl, nullptr, 0.0F, MAX_FRACTION_VOLUME_ML, 0},
+    {"late_foreshots_ml", &Recipe::lateForeshotsVolumeMl, nullptr, 0.0F, MAX_FRACTION_VOLUME_ML, 0},
+    {"heads_ml", &Recipe::headsVolumeMl, nullptr, 0.0F, MAX_FRACTION_VOLUME_ML, 0},
+    {"hearts_ml", &Recipe::heartsVolumeMl, nullptr, 0.0F, MAX_FRACTION_VOLUME_ML, 0},
+    {"early_tails_ml", &Recipe::earlyTailsVolumeMl, nullptr, 0.0F, MAX_FRACTION_VOLUME_ML, 0},
+    {"late_tails_ml", &Recipe::lateTailsVolumeMl, nullptr, 0.0F, MAX_FRACTION_VOLUME_ML, 0},
+    {"low_flow_ml_per_min", &Recipe::lowFlowRateMlPerMin, nullptr, MIN_FLOW_RATE_ML_PER_MIN, MAX_FLOW_RATE_ML_PER_MIN,
+     0},
+    {"high_flow_ml_per_min", &Recipe::highFlowRateMlPerMin, nullptr, MIN_FLOW_RATE_ML_PER_MIN,
+     MAX_FLOW_RATE_ML_PER_MIN, 0},
+    // Heating up switches whole stages, so a power between two stage sums would quietly run at the lower one
+    {"heat_up_power_w", nullptr, &Recipe::heatUpPower, HEATER_POWER_LEVEL_1, HEATER_POWER_LEVEL_MAX,
+     HEATER_POWER_LEVEL_1},
+    {"stabilizing_power_w", nullptr, &Recipe::stabilizingPower, HEATER_POWER_LEVEL_1, HEATER_POWER_LEVEL_MAX, 0},
+    {"heat_up_end_c", &Recipe::heatUpEndTemperatureC, nullptr, MIN_HEAT_UP_END_C, MAX_HEAT_UP_END_C, 0},
+    {"stabilization_threshold_c", &Recipe::stabilizationThresholdC, nullptr, MIN_STABILIZATION_THRESHOLD_C,
+     MAX_STABILIZATION_THRESHOLD_C, 0},
+    {"hearts_end_slope_c_per_min", &Recipe::heartsEndSlopeCPerMin, nullptr, MIN_HEARTS_END_SLOPE_C_PER_MIN,
+     MAX_HEARTS_END_SLOPE_C_PER_MIN, 0},
+    {"finalize_min", nullptr, &Recipe::finalizeMinutes, 0.0F, MAX_FINALIZE_MINUTES, 0},
+};
+constexpr std::size_t FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+static_assert(FIELD_COUNT <= 32, "Seen settings are tracked in a 32-bit mask");
+
+bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool isKeyChar(char c) { return (c >= 'a' && c <= 'z') || isDigit(c) || c == '_'; }
+
+/**
+ * Moves a cursor past blanks.
+ * @param cursor The cursor.
+ * @param end The end of the line.
+ */
+void skipBlanks(const char *&cursor, const char *end) {
+  while (cursor < end && isBlank(*cursor)) {
+    cursor++;
+  }
+}
+
+/**
+ * Reads a plain decimal number: an optional sign, digits, and for a decimal setting an optional fraction.
+ * @param cursor The cursor, moved past the number.
+ * @param end The end of the line.
+ * @param allowFraction Whether a fraction is accepted.
+ * @param value Receives the number.
+ * @return True if a number was read, false otherwise.
+ */
+bool readNumber(const char *&cursor, const char *end, bool allowFraction, float &value) {
+  bool negative = false;
+  if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+    negative = *cursor == '-';
+    cursor++;
+  }
+  float number = 0.0F;
+  int digits = 0;
+  while (cursor < end && isDigit(*cursor)) {
+    number = number * 10.0F + static_cast<float>(*cursor - '0');
+    cursor++;
+    digits++;
+  }
+  if (allowFraction && cursor < end && *cursor == '.') {
+    cursor++;
+    float scale = 0.1F;
+    while (cursor < end && isDigit(*cursor)) {
+      number += scale * static_cast<float>(*cursor - '0');
+      scale *= 0.1F;
+      cursor++;
+      digits++;
+    }
+  }
+  if (digits == 0 || digits > MAX_NUMBER_DIGITS) {
+    return false;
+  }
+  value = negative ? -number : number;
+  return true;
+}
+
+/**
+ * Finds the setting a key names.
+ * @param key The key, not null-terminated.
+ * @param length Characters in the key.
+ * @return The index of the setting in FIELDS, or FIELD_COUNT if there is none.
+ */
+std::size_t findField(const char *key, std::size_t length) {
+  for (std::size_t i = 0; i < FIELD_COUNT; i++) {
+    if (std::strlen(FIELDS[i].key) == length && std::strncmp(FIELDS[i].key, key, length) == 0) {
+      return i;
+    }
+  }
+  return FIELD_COUNT;
+}
+
+/**
+ * Parses one line of a recipe file into a recipe.
+ * @param cursor The start of the line.
+ * @param end The end of the line, before the newline.
+ * @param recipe The recipe to update.
+ * @param seen Bit i set if setting i was given on an earlier line; updated.
+ * @return RECIPE_OK, or why the line was rejected.
+ */
+RecipeError parseLine(const char *cursor, const char *end, Recipe &recipe, uint32_t &seen) {
+  skipBlanks(cursor, end);
+  if (cursor == end || *cursor == '#') {
+    return RECIPE_OK;
+  }
+
+  const char *key = cursor;
+  while (cursor < end && isKeyChar(*cursor)) {
+    cursor++;
+  }
+  std::size_t keyLength = static_cast<std::size_t>(cursor - key);
+  skipBlanks(cursor, end);
+  if (keyLength == 0 || cursor == end || *cursor != '=') {
+    return RECIPE_SYNTAX_ERROR;
+  }
+  cursor++;
+  skipBlanks(cursor, end);
+
+  std::size_t index = findField(key, keyLength);
+  if (index == FIELD_COUNT) {
+    return RECIPE_UNKNOWN_KEY;
+  }
+  const RecipeField &field = FIELDS[index];
+  float value = 0.0F;
+  if (!readNumber(cursor, end, field.real != nullptr, value)) {
+    return RECIPE_SYNTAX_ERROR;
+  }
+  skipBlanks(cursor, end);
+  if (cursor != end && *cursor != '#') {
+    return RECIPE_SYNTAX_ERROR;
+  }
+
+  uint32_t bit = static_cast<uint32_t>(1) << index;
+  if ((seen & bit) != 0) {
+    return RECIPE_DUPLICATE_KEY;
+  }
+  seen |= bit;
+  if (value < field.min || value > field.max) {
+    return RECIPE_OUT_OF_RANGE;
+  }
+  if (field.real != nullptr) {
+    recipe.*field.real = value;
+    return RECIPE_OK;
+  }
+  int whole = static_cast<int>(value);
+  if (field.step != 0 && whole % field.step != 0) {
+    return RECIPE_OFF_STEP;
+  }
+  recipe.*field.whole = whole;
+  return RECIPE_OK;
+}
+
+/**
+ * Fills in the raw copies of a recipe's temperature thresholds.
+ * @param recipe The recipe.
+ */
+void convertThresholds(Recipe &recipe) {
+  recipe.heatUpEndTemperatureRaw = celsiusToRaw(recipe.heatUpEndTemperatureC);
+  recipe.stabilizationThresholdRaw = celsiusToRaw(recipe.stabilizationThresholdC);
+}
+} // namespace
+
+float Recipe::getFractionVolumeMl(DistillationState fraction) const {
+  switch (fraction) {
+  case EARLY_FORESHOTS:
+    return earlyForeshotsVolumeMl;
+  case LATE_FORESHOTS:
+    return lateForeshotsVolumeMl;
+  case HEADS:
+    return headsVolumeMl;
+  case HEARTS:
+    return heartsVolumeMl;
+  case EARLY_TAILS:
+    return earlyTailsVolumeMl;
+  case LATE_TAILS:
+    return lateTailsVolumeMl;
+  default:
+    return 0.0F;
+  }
+}
+
+Recipe defaultRecipe() {
+  Recipe recipe{};
+  recipe.earlyForeshotsVolumeMl = EARLY_FORESHOTS_VOLUME_ML;
+  recipe.lateForeshotsVolumeMl = LATE_FORESHOTS_VOLUME_ML;
+  recipe.headsVolumeMl = HEADS_VOLUME_ML;
+  recipe.heartsVolumeMl = HEARTS_VOLUME_ML;
+  recipe.earlyTailsVolumeMl = EARLY_TAILS_VOLUME_ML;
+  recipe.lateTailsVolumeMl = LATE_TAILS_VOLUME_ML;
+  recipe.lowFlowRateMlPerMin = LOW_FLOW_RATE_ML_PER_MIN;
+  recipe.highFlowRateMlPerMin = HIGH_FLOW_RATE_ML_PER_MIN;
+  recipe.heatUpPower = HEATER_POWER_LEVEL_MAX;
+  recipe.stabilizingPower = HEATER_POWER_LEVEL_2;
+  recipe.heatUpEndTemperatureC = MIN_TEMPERATURE_THRESHOLD_C;
+  recipe.stabilizationThresholdC = TEMPERATURE_STABILIZATION_THRESHOLD_C;
+  recipe.heartsEndSlopeCPerMin = HEARTS_END_TEMPERATURE_SLOPE_C_PER_MIN;
+  recipe.finalizeMinutes = static_cast<int>(TEN_MINUTES_MS / ONE_MINUTE_MS);
+  convertThresholds(recipe);
+  return recipe;
+}
+
+// The file is parsed into a copy, so a fault on any line or across settings leaves the recipe untouched
+RecipeParseResult parseRecipe(const char *text, std::size_t length, Recipe &recipe) {
+  Recipe parsed = recipe;
+  uint32_t seen = 0;
+  uint16_t line = 0;
+  const char *end = text + length;
+  const char *lineStart = text;
+  while (lineStart < end) {
+    line++;
+    std::size_t remaining = static_cast<std::size_t>(end - lineStart);
+    const char *lineEnd = static_cast<const char *>(std::memchr(lineStart, '\n', remaining));
+    if (lineEnd == nullptr) {
+      lineEnd = end;
+    }
+    RecipeError error = parseLine(lineStart, lineEnd, parsed, seen);
+    if (error != RECIPE_OK) {
+      return {error, line};
+    }
+    lineStart = lineEnd + 1;
+  }
+
+  // Stabilizing must not outheat the heat-up, and the stabilized flow must be the higher one
+  if (parsed.lowFlowRateMlPerMin > parsed.highFlowRateMlPerMin || parsed.stabilizingPower > parsed.heatUpPower) {
+    return {RECIPE_INCONSISTENT, 0};
+  }
+
+  convertThresholds(parsed);
+  recipe = parsed;
+  return {RECIPE_OK, 0};
+}
+
+const char *describeRecipeError(RecipeError error) {
+  switch (error) {
+  case RECIPE_OK:
+    return "ok";
+  case RECIPE_SYNTAX_ERROR:
+    return "not a key = number line";
+  case RECIPE_UNKNOWN_KEY:
+    return "unknown setting";
+  case RECIPE_DUPLICATE_KEY:
+    return "setting given twice";
+  case RECIPE_OUT_OF_RANGE:
+    return "value out of range";
+  case RECIPE_OFF_STEP:
+    return "value between steps";
+  case RECIPE_INCONSISTENT:
+    return "settings contradict each other";
+  default:
+    return "unknown error";
+  }
+}
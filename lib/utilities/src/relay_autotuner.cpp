@@ -0,0 +1,123 @@
+#include "../include/relay_autotuner.h"
+
+#include <cmath>
+
+namespace {
+constexpr double PI = 3.14159265358979;
+constexpr double MS_PER_SECOND = 1000.0;
+
+// Ziegler–Nichols ultimate-cycle rules
+constexpr double PI_KP_PER_KU = 0.45;
+constexpr double PI_TI_PER_PU = 1.0 / 1.2;
+constexpr double PID_KP_PER_KU = 0.6;
+constexpr double PID_TI_PER_PU = 0.5;
+constexpr double PID_TD_PER_PU = 0.125;
+
+// Checks whether two cycle measurements agree within the tolerance, relative to the larger one
+bool agrees(double a, double b, double tolerance) {
+  double larger = std::fabs(a) > std::fabs(b) ? std::fabs(a) : std::fabs(b);
+  return std::fabs(a - b) <= tolerance * larger;
+}
+} // namespace
+
+const uint8_t RelayAutotuner::MAX_CYCLES;
+constexpr double RelayAutotuner::CYCLE_TOLERANCE;
+
+void RelayAutotuner::start(double setpoint, double bias, double amplitude, double hysteresis, unsigned long timeoutMs,
+                           unsigned long timeMs) {
+  this->setpoint = setpoint;
+  this->bias = bias;
+  this->amplitude = std::fabs(amplitude);
+  this->hysteresis = std::fabs(hysteresis);
+  this->timeoutMs = timeoutMs;
+  startTime = timeMs;
+  cycles = 0;
+  lastPeriodMs = 0;
+  lastAmplitude = 0;
+  ultimateGain = 0;
+  ultimatePeriodMs = 0;
+  // Start high; a process value already above the setpoint switches the relay low on the first update
+  outputHigh = true;
+  state = AUTOTUNE_RUNNING;
+}
+
+double RelayAutotuner::update(double processValue, unsigned long timeMs) {
+  if (state != AUTOTUNE_RUNNING) {
+    return bias;
+  }
+  if (timeMs - startTime > timeoutMs) {
+    state = AUTOTUNE_FAILED;
+    return bias;
+  }
+
+  if (cycles > 0) {
+    cycleMax = processValue > cycleMax ? processValue : cycleMax;
+    cycleMin = processValue < cycleMin ? processValue : cycleMin;
+  }
+  if (outputHigh && processValue > setpoint + hysteresis) {
+    outputHigh = false;
+  } else if (!outputHigh && processValue < setpoint - hysteresis) {
+    outputHigh = true;
+    completeCycle(processValue, timeMs);
+  }
+
+  if (state != AUTOTUNE_RUNNING) {
+    return bias;
+  }
+  return outputHigh ? bias + amplitude : bias - amplitude;
+}
+
+void RelayAutotuner::completeCycle(double processValue, unsigned long timeMs) {
+  if (cycles > 0) {
+    auto periodMs = static_cast<double>(timeMs - cycleStart);
+    double cycleAmplitude = (cycleMax - cycleMin) / 2.0;
+    if (cycles > 1 && agrees(periodMs, lastPeriodMs, CYCLE_TOLERANCE) &&
+        agrees(cycleAmplitude, lastAmplitude, CYCLE_TOLERANCE)) {
+      double meanAmplitude = (cycleAmplitude + lastAmplitude) / 2.0;
+      // A swing inside the hysteresis band says more about the noise than about the process
+      if (meanAmplitude <= hysteresis) {
+        state = AUTOTUNE_FAILED;
+        return;
+      }
+      ultimateGain = 4.0 * amplitude / (PI * std::sqrt(meanAmplitude * meanAmplitude - hysteresis * hysteresis));
+      ultimatePeriodMs = (periodMs + lastPeriodMs) / 2.0;
+      state = AUTOTUNE_DONE;
+      return;
+    }
+    if (cycles >= MAX_CYCLES) {
+      state = AUTOTUNE_FAILED;
+      return;
+    }
+    lastPeriodMs = periodMs;
+    lastAmplitude = cycleAmplitude;
+  }
+  cycles++;
+  cycleStart = timeMs;
+  cycleMax = processValue;
+  cycleMin = processValue;
+}
+
+void RelayAutotuner::cancel() {
+  if (state == AUTOTUNE_RUNNING) {
+    state = AUTOTUNE_IDLE;
+  }
+}
+
+AutotuneState RelayAutotuner::getState() const { return state; }
+
+double RelayAutotuner::getUltimateGain() const { return ultimateGain; }
+
+double RelayAutotuner::getUltimatePeriodMs() const { return ultimatePeriodMs; }
+
+PidTuning RelayAutotuner::getTuning(TuningRule rule) const {
+  if (state != AUTOTUNE_DONE) {
+    return {0.0, 0.0, 0.0};
+  }
+  double periodSec = ultimatePeriodMs / MS_PER_SECOND;
+  if (rule == TUNING_RULE_PI) {
+    double kp = PI_KP_PER_KU * ultimateGain;
+    return {kp, kp / (PI_TI_PER_PU * periodSec), 0.0};
+  }
+  double kp = PID_KP_PER_KU * ultimateGain;
+  return {kp, kp / (PID_TI_PER_PU * periodSec), kp * PID_TD_PER_PU * periodSec};
+}
@@ -0,0 +1,63 @@
+#include "../include/time_proportioned_output.h"
+
+// A dwell over half the window would leave no room for both an on and an off phase
+TimeProportionedOutput::TimeProportionedOutput(unsigned long windowMs, unsigned long minDwellMs)
+  : windowMs(windowMs), minDwellMs(minDwellMs < windowMs / 2 ? minDwellMs : windowMs / 2) {}
+
+void TimeProportionedOutput::setDuty(double newDuty) {
+  if (newDuty < 0) {
+    newDuty = 0;
+  } else if (newDuty > 1) {
+    newDuty = 1;
+  }
+  duty = newDuty;
+}
+
+bool TimeProportionedOutput::update(unsigned long nowMs) {
+  // A late update that skips whole windows starts afresh rather than replaying them
+  if (!running || nowMs - windowStart >= 2 * windowMs) {
+    startWindow(nowMs);
+  } else if (nowMs - windowStart >= windowMs) {
+    startWindow(windowStart + windowMs);
+  }
+
+  bool wanted = nowMs - windowStart < onTimeMs;
+  if (wanted != on && nowMs - lastSwitch >= minDwellMs) {
+    on = wanted;
+    lastSwitch = nowMs;
+  }
+  return on;
+}
+
+void TimeProportionedOutput::reset() {
+  on = false;
+  running = false;
+  carryMs = 0;
+}
+
+double TimeProportionedOutput::getDuty() const { return duty; }
+
+bool TimeProportionedOutput::isOn() const { return on; }
+
+unsigned long TimeProportionedOutput::getWindowStart() const { return windowStart; }
+
+void TimeProportionedOutput::startWindow(unsigned long nowMs) {
+  if (!running) {
+    // Let the first window switch at once; the output has been off for as long as anyone knows
+    lastSwitch = nowMs - minDwellMs;
+    running = true;
+  }
+  windowStart = nowMs;
+
+  auto window = static_cast<double>(windowMs);
+  double wantedMs = duty * window + carryMs;
+  double grantedMs = wantedMs;
+  if (wantedMs < static_cast<double>(minDwellMs)) {
+    grantedMs = 0;
+  } else if (window - wantedMs < static_cast<double>(minDwellMs)) {
+    grantedMs = window;
+  }
+  // Pulses and gaps shorter than the dwell are carried, so a low duty becomes a pulse every few windows
+  carryMs = wantedMs - grantedMs;
+  onTimeMs = static_cast<unsigned long>(grantedMs + 0.5);
+}
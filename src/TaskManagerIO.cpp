@@ -1,4 +1,18 @@
 #include "../include/TaskManagerIO.h"
 
+#ifndef UNIT_TEST
+#include <Arduino.h>
+
+TaskManager::TaskManager() : CooperativeScheduler(millis) { setTimer(micros); }
+
+taskid_t TaskManager::scheduleFixedRate(uint32_t rate, void (*callback)()) {
+  return taskManager.schedule(rate, rate, callback);
+}
+
+taskid_t TaskManager::scheduleFixedRate(uint32_t initialDelay, uint32_t rate, void (*callback)()) {
+  return taskManager.schedule(initialDelay, rate, callback);
+}
+#endif // UNIT_TEST
+
 // Define the global taskManager instance
 TaskManager taskManager; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
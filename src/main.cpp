@@ -1,9 +1,8 @@
-#if defined(NATIVE) || defined(UNIT_TEST)
-// For native build and unit tests, use our mock implementation
+#ifndef UNIT_TEST
+#ifdef NATIVE
+// The native build runs the firmware on our mock implementation, against the still simulated in main_native.cpp
 #include <MockArduino.h>
 #include <TaskManagerIO.h>
-// Include headers needed for tests and native builds
-#include <hardware_interfaces.h>
 #else
 // The real Arduino.h will be included by the build system
 // Explicitly skip including our Arduino.h in include/ directory
@@ -13,15 +12,22 @@
 #include <SD.h>  // SD must come after SPI
 #include <SPI.h> // SPI must come before SD
 #include <TaskManagerIO.h>
+#endif
 
 // Now include our hardware interfaces after all Arduino libs are included
 // Include library headers from the library structure
+#include <calibration_store.h>
 #include <lcd.h>
+#include <probe_store.h>
 #include <relay.h>
 #include <scale.h>
 #include <thermometer.h>
+#include <thermometer_bus.h>
+#include <tuning_store.h>
 
 // Process controllers
+#include <cascade_controller.h>
+#include <column_observer.h>
 #include <display_controller.h>
 #include <flow_controller.h>
 #include <heater_controller.h>
@@ -32,9 +38,16 @@
 // Utilities
 #include <PID_v1.h>
 #include <constants.h>
+#include <distillation_state_engine.h>
 #include <distillation_state_manager.h>
 #include <hardware_factory.h>
+#include <log2_histogram.h>
 #include <logger.h>
+#include <rate_group.h>
+#include <recipe.h>
+
+#include <cstdio>
+#include <cstdlib>
 
 // Create hardware interfaces
 ISerialInterface *serialInterface = HardwareFactory::getSerialInterface();
@@ -43,15 +56,24 @@ ISDInterface *sdInterface = HardwareFactory::getSDInterface();
 // Create the logger with interfaces
 Logger logger(serialInterface, sdInterface);
 
-// Task IDs for system health and reconnection
-taskid_t reconnectScalesTaskId;
-taskid_t systemHealthCheckTaskId;
+// Scale calibrations kept on the SD card across power cycles
+CalibrationStore calibrationStore(*HardwareFactory::getCalibrationStorage());
+
+// Autotuned PID gains, measured once per still and kept on the same card
+TuningStore tuningStore(*HardwareFactory::getTuningStorage());
+
+// ROM code of the probe at each position on the still, bound on the first boot and checked on every later one
+ProbeStore probeStore(*HardwareFactory::getProbeStorage());
 
-// Creating objects for thermometers
-Thermometer mashTunThermometer(MASH_TUN_THERMOMETER_PIN);
-Thermometer bottomThermometer(BOTTOM_THERMOMETER_PIN);
-Thermometer nearTopThermometer(NEAR_TOP_THERMOMETER_PIN);
-Thermometer topThermometer(TOP_THERMOMETER_PIN);
+// Fraction volumes, flow rates, powers and thresholds of this run; replaced from the SD card at boot if it has a recipe
+Recipe recipe = defaultRecipe();
+
+// Creating the shared thermometer bus and one object per probe
+ThermometerBus thermometerBus(THERMOMETER_BUS_PIN, &logger);
+Thermometer mashTunThermometer(thermometerBus, MASH_TUN_THERMOMETER_PROBE);
+Thermometer bottomThermometer(thermometerBus, BOTTOM_THERMOMETER_PROBE);
+Thermometer nearTopThermometer(thermometerBus, NEAR_TOP_THERMOMETER_PROBE);
+Thermometer topThermometer(thermometerBus, TOP_THERMOMETER_PROBE);
 
 // Creating objects for scales with logger
 Scale earlyForeshotsScale(HardwareFactory::createScaleInterface(EARLY_FORESHOTS_SCALE_DATA_PIN,
@@ -89,29 +111,23 @@ Lcd lcd(LCD_COLUMNS, LCD_ROWS, LCD_PIN);
 
 // Creating controllers with logger
 HeaterController heaterController(heaterRelay1, heaterRelay2, heaterRelay3);
-ValveController valveController(valveRelay1, valveRelay2, valveRelay3, valveRelay4, valveRelay5, valveRelay6,
-                                valveRelay7, valveRelay8);
-ThermometerController thermometerController(mashTunThermometer, bottomThermometer, nearTopThermometer, topThermometer);
+// The controller takes the coolant and main valves first, then the distillate valves in DistillationState order
+ValveController valveController(valveRelay7, valveRelay8, valveRelay1, valveRelay2, valveRelay3, valveRelay4,
+                                valveRelay5, valveRelay6);
+ThermometerController thermometerController(thermometerBus, mashTunThermometer, bottomThermometer, nearTopThermometer,
+                                            topThermometer);
 ScaleController scaleController(earlyForeshotsScale, lateForeshotsScale, headsScale, heartsScale, earlyTailsScale,
                                 lateTailsScale, &logger);
 FlowController flowController(&valveController, &scaleController);
+CascadeController cascadeController(flowController, heaterController);
+ColumnObserver columnObserver(thermometerController, heaterController);
 DisplayController displayController(lcd, thermometerController, scaleController, flowController);
 
-// Declare task identifiers for distillation process
-taskid_t heatUpMashTaskId;
-taskid_t waitForTemperatureStabilizationTaskId;
-taskid_t collectEarlyForeshotsTaskId;
-taskid_t collectLateForeshotsTaskId;
-taskid_t collectHeadsTaskId;
-taskid_t collectHeartsTaskId;
-taskid_t collectEarlyTailsTaskId;
-taskid_t collectLateTailsTaskId;
-taskid_t finalizeDistillationTaskId;
-
 // Update all thermometers
 void updateAllThermometers() {
   logger.debug("Updating all thermometers");
   thermometerController.updateAllTemperatures();
+  columnObserver.update();
 }
 
 // Update all scales with error handling
@@ -138,192 +154,469 @@ bool hasReachedVolume(float distillateVolume) {
 
 // Check if the temperature difference between bottom and top is small enough
 bool isTemperatureStabilized() {
-  float bottomTemp = bottomThermometer.getTemperature();
-  float topTemp = topThermometer.getTemperature();
-  float diff = bottomTemp - topTemp;
-
-  logger.debug("Temperature difference between bottom (%.2f°C) and top (%.2f°C): %.2f°C", bottomTemp, topTemp, diff);
-
-  return diff < TEMPERATURE_STABILIZATION_THRESHOLD_C;
-}
+  // Prefer the observer's lag-free estimates once both channels have readings. The observer filters in float, but
+  // its estimates are rounded to raw steps here, so the threshold test stays in integer arithmetic either way.
+  RawTemperature bottomTemp = 0;
+  RawTemperature topTemp = 0;
+  if (columnObserver.isInitialized(BOTTOM_CHANNEL) && columnObserver.isInitialized(TOP_CHANNEL)) {
+    bottomTemp = columnObserver.getRawTemperature(BOTTOM_CHANNEL);
+    topTemp = columnObserver.getRawTemperature(TOP_CHANNEL);
+  } else {
+    bottomTemp = bottomThermometer.getRawTemperature();
+    topTemp = topThermometer.getRawTemperature();
+  }
+  int diff = bottomTemp - topTemp;
 
-// Finalize the distillation process
-void finalizeDistillation() {
-  DistillationStateManager::getInstance().setState(FINALIZING);
-  static unsigned long startTime = 0;
-  if (startTime == 0) {
-    logger.info("Starting finalization phase");
-    heaterController.setPower(0);
-    startTime = millis();
-  } else if (millis() - startTime >= TEN_MINUTES_MS) {
-    logger.info("Finalization complete - shutting down");
-    valveController.closeCoolantValve();
-    valveController.closeAllDistillateValves();
-    flowController.setAndControlFlowRate(0.0);
-    startTime = 0;
-    DistillationStateManager::getInstance().setState(OFF);
-    taskManager.cancelTask(finalizeDistillationTaskId);
-    logger.info("System shutdown complete");
+  // Only pay for the float conversion when the message will actually be logged
+  if (logger.isLevelEnabled(Logger::DEBUG_LEVEL)) {
+    logger.debug("Temperature difference between bottom (%.2f°C) and top (%.2f°C): %.2f°C", rawToCelsius(bottomTemp),
+                 rawToCelsius(topTemp), rawToCelsius(static_cast<RawTemperature>(diff)));
   }
+
+  return diff < recipe.stabilizationThresholdRaw;
 }
 
-// Try to reconnect any disconnected scales periodically
-void tryReconnectScales() {
-  int reconnected = scaleController.tryReconnectScales();
+// Move any disconnected scales one step closer to being back online
+void serviceScaleConnections() {
+  int reconnected = scaleController.serviceConnections();
   if (reconnected > 0) {
     logger.info("Successfully reconnected %d scales", reconnected);
+
+    // A scale that had to tare on its first connection has a new zero; keep it for the next boot. Reconnects keep
+    // the zero they had, so a vessel filled in the meantime is never stored as empty
+    scaleController.recordCalibrations(calibrationStore);
+    if (!calibrationStore.save()) {
+      logger.warning("Failed to save scale calibrations");
+    }
   }
 }
 
-// Monitor system health and log stats
-void checkSystemHealth() {
-  // Log current state
+constexpr std::size_t RATE_GROUP_COUNT = 3; // The fast, medium and slow loops
+void logRateGroup(std::size_t index);       // Defined with the rate groups below
+
+// Log the distillation state and the condition of the scales
+void logProcessHealth() {
   DistillationState currentState = DistillationStateManager::getInstance().getState();
   logger.info("System health check - Current state: %d, Connected scales: %d/6", static_cast<int>(currentState),
               scaleController.getConnectedScaleCount());
+  logger.info("Scale spikes dropped since startup: %lu", scaleController.getRejectedSampleCount());
+  int zeroMismatches = scaleController.getZeroMismatchCount();
+  if (zeroMismatches > 0) {
+    logger.warning("Scales off their zero since reconnecting: %d", zeroMismatches);
+  }
+}
 
-  // Log temperatures
+// Log the temperatures, the observer's view of the column, the heater and the flow
+void logColumnHealth() {
   logger.info("Temperatures - Mash: %.2f°C, Bottom: %.2f°C, Near Top: %.2f°C, Top: %.2f°C",
               thermometerController.getMashTunTemperature(), thermometerController.getBottomTemperature(),
               thermometerController.getNearTopTemperature(), thermometerController.getTopTemperature());
 
-  // Log current flow rate if applicable
+  logger.info("Column estimates - Near top rate: %.2f°C/min, Top rate: %.2f°C/min, Vapour: %.1f g/min",
+              columnObserver.getTemperatureRate(NEAR_TOP_CHANNEL), columnObserver.getTemperatureRate(TOP_CHANNEL),
+              columnObserver.getVapourRate());
+
+  // The heater power asked for against the energy the stages actually delivered
+  logger.info("Heater - Power: %d W, Delivered: %.1f kWh", heaterController.getPower(),
+              heaterController.getDeliveredEnergy() / JOULES_PER_KWH);
+
+  DistillationState currentState = DistillationStateManager::getInstance().getState();
   if (currentState >= EARLY_FORESHOTS && currentState <= LATE_TAILS) {
     logger.info("Flow rate: %.2f mL/min", flowController.getFlowRate());
   }
 }
 
-// Collect late tails phase
-void collectLateTails() {
-  DistillationStateManager::getInstance().setState(LATE_TAILS);
-  heaterController.setPower(HEATER_POWER_LEVEL_2);
-  valveController.openCoolantValve();
-  valveController.openDistillateValve(LATE_TAILS);
+// Log how long the task in a slot takes and how late it starts; a blocking sensor read shows up in the maxima
+bool logTaskHealth(uint8_t slot) {
+  const TaskStatistics *statistics = taskManager.getStatistics(taskManager.getTaskIdAt(slot));
+  if (statistics == nullptr) {
+    return false;
+  }
+  logger.info("Task %s - Runs: %lu, Overruns: %lu, Run time p99: %lu us, max %lu us, Late start p99: %lu ms, "
+              "max %lu ms",
+              statistics->name != nullptr ? statistics->name : "?", statistics->runs, statistics->overruns,
+              statistics->runTimeUs.getPercentileBound(99), statistics->runTimeUs.getMax(),
+              statistics->startLatenessMs.getPercentileBound(99), statistics->startLatenessMs.getMax());
+  return true;
+}
 
-  if (!hasReachedVolume(LATE_TAILS_VOLUME_ML)) {
-    if (isTemperatureStabilized()) {
-      flowController.setAndControlFlowRate(HIGH_FLOW_RATE_ML_PER_MIN); // Higher flow if stabilized
-    } else {
-      flowController.setAndControlFlowRate(LOW_FLOW_RATE_ML_PER_MIN); // Lower flow if not stabilized
+// Parts of the health report: the process, the column, each task slot, then each rate group
+constexpr int HEALTH_REPORT_FIRST_TASK = 2;
+constexpr int HEALTH_REPORT_FIRST_GROUP = HEALTH_REPORT_FIRST_TASK + CooperativeScheduler::MAX_TASKS;
+constexpr int HEALTH_REPORT_PARTS = HEALTH_REPORT_FIRST_GROUP + static_cast<int>(RATE_GROUP_COUNT);
+
+// Next part of the health report to log, or HEALTH_REPORT_PARTS between reports
+int healthReportPart = HEALTH_REPORT_PARTS;
+
+// Start a health report, which continueHealthReport() logs over the following slow ticks
+void startHealthReport() { healthReportPart = 0; }
+
+// Log the next part of the health report. Every line is flushed to the SD card, and the budget is only checked
+// between members, so a whole report in one tick would hold the fast loop up for as long as the card takes
+void continueHealthReport() {
+  while (healthReportPart < HEALTH_REPORT_PARTS) {
+    int part = healthReportPart++;
+    if (part == 0) {
+      logProcessHealth();
+      return;
+    }
+    if (part == 1) {
+      logColumnHealth();
+      return;
+    }
+    if (part >= HEALTH_REPORT_FIRST_GROUP) {
+      logRateGroup(static_cast<std::size_t>(part - HEALTH_REPORT_FIRST_GROUP));
+      return;
+    }
+    // An empty task slot has nothing to log, so it does not take a tick of its own
+    if (logTaskHealth(static_cast<uint8_t>(part - HEALTH_REPORT_FIRST_TASK))) {
+      return;
     }
-  } else {
-    taskManager.cancelTask(collectLateTailsTaskId);
-    finalizeDistillationTaskId = TaskManager::scheduleFixedRate(DEFAULT_TASK_RATE_MS, finalizeDistillation);
   }
 }
 
-// Collect early tails phase
-void collectEarlyTails() {
-  DistillationStateManager::getInstance().setState(EARLY_TAILS);
-  heaterController.setPower(HEATER_POWER_LEVEL_2);
-  valveController.openCoolantValve();
-  valveController.openDistillateValve(EARLY_TAILS);
-
-  if (!hasReachedVolume(EARLY_TAILS_VOLUME_ML)) {
-    if (isTemperatureStabilized()) {
-      flowController.setAndControlFlowRate(HIGH_FLOW_RATE_ML_PER_MIN); // Higher flow if stabilized
-    } else {
-      flowController.setAndControlFlowRate(LOW_FLOW_RATE_ML_PER_MIN); // Lower flow if not stabilized
+// Log the non-empty buckets of one task histogram, each as the bucket's lowest value and its count
+void logTaskHistogram(const char *taskName, const char *label, const Log2Histogram &histogram) {
+  char line[TASK_HISTOGRAM_LINE];
+  int length = 0;
+  line[0] = '\0';
+  for (uint8_t bucket = 0; bucket < Log2Histogram::BUCKETS; bucket++) {
+    uint32_t count = histogram.getCount(bucket);
+    if (count == 0) {
+      continue;
     }
-  } else {
-    taskManager.cancelTask(collectEarlyTailsTaskId);
-    collectLateTailsTaskId = TaskManager::scheduleFixedRate(DEFAULT_TASK_RATE_MS, collectLateTails);
+    int written = snprintf(line + length, sizeof(line) - length, " %lu+:%lu", Log2Histogram::bucketLowerBound(bucket),
+                           static_cast<unsigned long>(count));
+    if (written < 0 || length + written >= static_cast<int>(sizeof(line))) {
+      break; // The line is full; the buckets left out are in the health check's maxima
+    }
+    length += written;
   }
+  logger.info("Task %s %s:%s", taskName, label, line);
 }
 
-// Collect hearts phase
-void collectHearts() {
-  DistillationStateManager::getInstance().setState(HEARTS);
-  heaterController.setPower(HEATER_POWER_LEVEL_2);
-  valveController.openCoolantValve();
-  valveController.openDistillateValve(HEARTS);
-
-  if (!hasReachedVolume(HEARTS_VOLUME_ML) ||
-      !nearTopThermometer.isSuddenTemperatureIncrease(SUDDEN_TEMPERATURE_INCREASE_THRESHOLD_C)) {
-    if (isTemperatureStabilized()) {
-      flowController.setAndControlFlowRate(HIGH_FLOW_RATE_ML_PER_MIN); // Higher flow if stabilized
-    } else {
-      flowController.setAndControlFlowRate(LOW_FLOW_RATE_ML_PER_MIN); // Lower flow if not stabilized
+// Task slot whose histograms the console dumps next, or MAX_TASKS when no dump is in progress
+uint8_t taskDumpSlot = CooperativeScheduler::MAX_TASKS;
+
+// Dump the next task's histograms, one task per slow tick for the same reason as continueHealthReport()
+void continueTaskStatisticsDump() {
+  while (taskDumpSlot < CooperativeScheduler::MAX_TASKS) {
+    const TaskStatistics *statistics = taskManager.getStatistics(taskManager.getTaskIdAt(taskDumpSlot++));
+    if (statistics == nullptr) {
+      continue;
     }
-  } else {
-    taskManager.cancelTask(collectHeartsTaskId);
-    collectEarlyTailsTaskId = TaskManager::scheduleFixedRate(DEFAULT_TASK_RATE_MS, collectEarlyTails);
+    const char *name = statistics->name != nullptr ? statistics->name : "?";
+    logger.info("Task %s - Runs: %lu, Overruns: %lu", name, statistics->runs, statistics->overruns);
+    logTaskHistogram(name, "run time us", statistics->runTimeUs);
+    logTaskHistogram(name, "late start ms", statistics->startLatenessMs);
+    return;
   }
 }
 
-// Collect heads phase
-void collectHeads() {
-  DistillationStateManager::getInstance().setState(HEADS);
-  heaterController.setPower(HEATER_POWER_LEVEL_2);
-  valveController.openCoolantValve();
-  valveController.openDistillateValve(HEADS);
+// Scale being calibrated from the console, or -1
+int calibratingScale = -1;
+
+// Start calibrating a scale against the known weight on it, from the arguments "<scale> <grams>"
+void startScaleCalibration(const char *arguments) {
+  char *end = nullptr;
+  long index = strtol(arguments, &end, 10);
+  const char *weightStart = end;
+  float grams = strtof(weightStart, &end);
+  if (end == weightStart || index < 0 || index >= SCALE_COUNT ||
+      !scaleController.startCalibration(static_cast<uint8_t>(index), grams)) {
+    logger.warning("Calibrate with %c<scale 0-%d> <grams>, at least %.0f g on an online scale", CALIBRATE_SCALE_COMMAND,
+                   SCALE_COUNT - 1, SCALE_CALIBRATION_MIN_WEIGHT);
+    return;
+  }
+  calibratingScale = static_cast<int>(index);
+  logger.info("Calibrating scale %d against %.1f g", calibratingScale, grams);
+}
 
-  if (!hasReachedVolume(HEADS_VOLUME_ML)) {
-    if (isTemperatureStabilized()) {
-      flowController.setAndControlFlowRate(HIGH_FLOW_RATE_ML_PER_MIN); // Higher flow if stabilized
-    } else {
-      flowController.setAndControlFlowRate(LOW_FLOW_RATE_ML_PER_MIN); // Lower flow if not stabilized
-    }
+// Keep a finished calibration for the next boot
+void finishScaleCalibration() {
+  if (calibratingScale < 0 || scaleController.isCalibrating(static_cast<uint8_t>(calibratingScale))) {
+    return;
+  }
+  if (!scaleController.isConnected(static_cast<uint8_t>(calibratingScale))) {
+    logger.warning("Scale %d went offline before its calibration finished", calibratingScale);
   } else {
-    taskManager.cancelTask(collectHeadsTaskId);
-    collectHeartsTaskId = TaskManager::scheduleFixedRate(DEFAULT_TASK_RATE_MS, collectHearts);
+    scaleController.recordCalibrations(calibrationStore);
+    if (!calibrationStore.save()) {
+      logger.warning("Failed to save scale calibrations");
+    }
   }
+  calibratingScale = -1;
 }
 
-// Collect late foreshots phase
-void collectLateForeshots() {
-  DistillationStateManager::getInstance().setState(LATE_FORESHOTS);
-  heaterController.setPower(HEATER_POWER_LEVEL_2);
-  valveController.openCoolantValve();
-  valveController.openDistillateValve(LATE_FORESHOTS);
+// Run one line typed on the serial console: a command character, then its arguments
+void runConsoleCommand(const char *line) {
+  switch (line[0]) {
+  case TASK_STATISTICS_COMMAND:
+    taskDumpSlot = 0;
+    break;
+  case CALIBRATE_SCALE_COMMAND:
+    startScaleCalibration(line + 1);
+    break;
+  default:
+    logger.warning("Unknown console command: %s", line);
+    break;
+  }
+}
 
-  if (!hasReachedVolume(LATE_FORESHOTS_VOLUME_ML)) {
-    if (isTemperatureStabilized()) {
-      flowController.setAndControlFlowRate(HIGH_FLOW_RATE_ML_PER_MIN); // Higher flow if stabilized
-    } else {
-      flowController.setAndControlFlowRate(LOW_FLOW_RATE_ML_PER_MIN); // Lower flow if not stabilized
+// Answer commands typed on the serial console, one line at a time, however the characters arrive
+void serviceSerialCommands() {
+  static char line[CONSOLE_LINE_LENGTH];
+  static int length = 0;
+  while (serialInterface->available()) {
+    int character = serialInterface->read();
+    if (character == '\n' || character == '\r') {
+      if (length > 0) {
+        line[length] = '\0';
+        runConsoleCommand(line);
+      }
+      length = 0;
+    } else if (length < CONSOLE_LINE_LENGTH - 1) {
+      line[length++] = static_cast<char>(character);
+    }
+  }
+  continueTaskStatisticsDump();
+  finishScaleCalibration();
+}
+
+// Measure the flow loop gains on a still that has none stored; the steady low flow of early foreshots suits the relay.
+// A failed autotune leaves the default gains in place until the next run.
+void tuneFlowLoop() {
+  PidTuning stored{};
+  if (tuningStore.get(FLOW_TUNING_LOOP, stored)) {
+    return;
+  }
+  AutotuneState state = flowController.getAutotuneState();
+  if (state == AUTOTUNE_IDLE) {
+    if (flowController.startAutotune()) {
+      logger.info("Autotuning the flow loop");
+    }
+  } else if (state == AUTOTUNE_DONE) {
+    PidTuning tuning = flowController.getAutotunedTuning();
+    logger.info("Flow loop tuned - Kp: %.3f, Ki: %.4f", tuning.kp, tuning.ki);
+    tuningStore.set(FLOW_TUNING_LOOP, tuning);
+    if (!tuningStore.save()) {
+      logger.warning("Failed to save flow loop gains");
     }
-  } else {
-    taskManager.cancelTask(collectLateForeshotsTaskId);
-    collectHeadsTaskId = TaskManager::scheduleFixedRate(DEFAULT_TASK_RATE_MS, collectHeads);
   }
 }
 
-// Collect early foreshots phase
-void collectEarlyForeshots() {
-  DistillationStateManager::getInstance().setState(EARLY_FORESHOTS);
-  heaterController.setPower(HEATER_POWER_LEVEL_2);
+// Heat up mash phase: the recipe's heat-up power until the vapour reaches the top of the column
+void enterHeatUp() { heaterController.setPower(recipe.heatUpPower); }
+
+bool isMashHeated() { return topThermometer.getRawTemperature() >= recipe.heatUpEndTemperatureRaw; }
+
+// Wait for temperature stabilization phase
+void enterStabilizing() { heaterController.setBurstFirePower(recipe.stabilizingPower); }
+
+// Collecting phases: the cascade loop takes over the heater, and the coolant and the phase's own valve open
+void enterCollecting() {
+  cascadeController.enable();
   valveController.openCoolantValve();
-  valveController.openDistillateValve(EARLY_FORESHOTS);
-  flowController.setAndControlFlowRate(LOW_FLOW_RATE_ML_PER_MIN);
+  valveController.openDistillateValve(DistillationStateManager::getInstance().getState());
+}
+
+// Set the flow loop, higher once the column has stabilized and lower while it has not; the fast loop runs it
+void controlCollecting() {
+  flowController.setFlowRate(isTemperatureStabilized() ? recipe.highFlowRateMlPerMin : recipe.lowFlowRateMlPerMin);
+}
+
+// Early foreshots always run at the low flow, which also suits the flow loop autotune
+void controlEarlyForeshots() {
+  flowController.setFlowRate(recipe.lowFlowRateMlPerMin);
+  tuneFlowLoop();
+}
+
+// A fraction is in once its scale holds the recipe's volume for it
+bool isFractionCollected() {
+  return hasReachedVolume(recipe.getFractionVolumeMl(DistillationStateManager::getInstance().getState()));
+}
+
+// Early foreshots also wait for the column to stabilize, so the late foreshots start on a settled column
+bool isEarlyForeshotsCollected() { return isFractionCollected() && isTemperatureStabilized(); }
+
+void exitEarlyForeshots() { flowController.cancelAutotune(); }
+
+// Hearts end once their volume is in and the near-top temperature starts climbing towards the tails
+bool isHeartsCollected() {
+  return isFractionCollected() && nearTopThermometer.isTemperatureRising(recipe.heartsEndSlopeCPerMin);
+}
+
+// Finalize phase: the heater goes off, and the coolant keeps running for a while to condense what is left
+void enterFinalizing() {
+  logger.info("Starting finalization phase");
+  cascadeController.disable();
+  heaterController.setPower(0);
+}
+
+bool isFinalized() {
+  return DistillationStateManager::getInstance().getElapsedTime() >=
+         static_cast<unsigned long>(recipe.finalizeMinutes) * ONE_MINUTE_MS;
+}
+
+void exitFinalizing() { logger.info("Finalization complete - shutting down"); }
 
-  if (hasReachedVolume(EARLY_FORESHOTS_VOLUME_ML) && isTemperatureStabilized()) {
-    taskManager.cancelTask(collectEarlyForeshotsTaskId);
-    collectLateForeshotsTaskId = TaskManager::scheduleFixedRate(DEFAULT_TASK_RATE_MS, collectLateForeshots);
+// Shut everything down at the end of a run
+void enterOff() {
+  valveController.closeCoolantValve();
+  valveController.closeAllDistillateValves();
+  flowController.setAndControlFlowRate(0.0);
+  logger.info("System shutdown complete");
+}
+
+// The distillation process, one row per DistillationState in enum order: entry action, per-tick controls, exit
+// predicate, exit action and successor
+constexpr DistillationPhase DISTILLATION_PHASES[] = {
+    {OFF, enterOff, nullptr, nullptr, nullptr, OFF},
+    {HEAT_UP, enterHeatUp, nullptr, isMashHeated, nullptr, STABILIZING},
+    {STABILIZING, enterStabilizing, nullptr, isTemperatureStabilized, nullptr, EARLY_FORESHOTS},
+    {EARLY_FORESHOTS, enterCollecting, controlEarlyForeshots, isEarlyForeshotsCollected, exitEarlyForeshots,
+     LATE_FORESHOTS},
+    {LATE_FORESHOTS, enterCollecting, controlCollecting, isFractionCollected, nullptr, HEADS},
+    {HEADS, enterCollecting, controlCollecting, isFractionCollected, nullptr, HEARTS},
+    {HEARTS, enterCollecting, controlCollecting, isHeartsCollected, nullptr, EARLY_TAILS},
+    {EARLY_TAILS, enterCollecting, controlCollecting, isFractionCollected, nullptr, LATE_TAILS},
+    {LATE_TAILS, enterCollecting, controlCollecting, isFractionCollected, nullptr, FINALIZING},
+    {FINALIZING, enterFinalizing, nullptr, isFinalized, exitFinalizing, OFF},
+};
+constexpr std::size_t DISTILLATION_PHASE_COUNT = sizeof(DISTILLATION_PHASES) / sizeof(DISTILLATION_PHASES[0]);
+static_assert(DISTILLATION_PHASE_COUNT == FINALIZING + 1, "Every distillation state needs a phase");
+static_assert(DistillationStateEngine::isIndexedByState(DISTILLATION_PHASES, DISTILLATION_PHASE_COUNT),
+              "Distillation phases must be listed in DistillationState order");
+
+DistillationStateEngine distillationStateEngine(DISTILLATION_PHASES, DISTILLATION_PHASE_COUNT);
+
+// Pulse the main valve at the duty the flow loop asks for; the pulses are far shorter than the flow loop's period
+void serviceMainValve() { valveController.serviceMainValve(); }
+
+// Run the flow loop at the rate the phases set; the PID computes once per FLOW_PID_SAMPLE_TIME_MS, and an autotune
+// acts on each new reading as it arrives
+void controlFlow() { flowController.controlFlowRate(); }
+
+// Set the heater power from the flow loop's valve duty while collecting, and modulate the heater stages in burst-fire
+// mode; a burst lasts at least HEATER_MIN_DWELL_MS
+void updateHeater() {
+  cascadeController.update();
+  heaterController.update();
+}
+
+void updatePhases() { distillationStateEngine.update(); }
+
+void updateDisplay() { displayController.displayDistillationInfo(); }
+
+// The rate groups, each highest priority first. Outputs come before inputs, so a tick that runs out of budget sheds
+// a reading, which the next tick takes, rather than an actuation. The phases are the exception: they decide on the
+// temperatures, so the thermometers are collected first and each decision uses the conversion finished this tick.
+constexpr RateGroupMember FAST_LOOP_MEMBERS[] = {
+    {"valve", serviceMainValve, 1},
+    {"flow", controlFlow, 1},
+    {"scales", updateAllScales, 1},
+};
+constexpr RateGroupMember MEDIUM_LOOP_MEMBERS[] = {
+    {"heater", updateHeater, 1},
+    {"thermometers", updateAllThermometers, 1},
+    {"phases", updatePhases, 1},
+};
+constexpr RateGroupMember SLOW_LOOP_MEMBERS[] = {
+    {"reconnect", serviceScaleConnections, 1},
+    {"display", updateDisplay, 1},
+    {"console", serviceSerialCommands, 1},
+    {"health", startHealthReport, HEALTH_CHECK_DIVIDER},
+    {"health report", continueHealthReport, 1},
+};
+
+RateGroup fastLoop("fast", FAST_LOOP_MEMBERS, sizeof(FAST_LOOP_MEMBERS) / sizeof(FAST_LOOP_MEMBERS[0]),
+                   FAST_LOOP_BUDGET_US, micros);
+RateGroup mediumLoop("medium", MEDIUM_LOOP_MEMBERS, sizeof(MEDIUM_LOOP_MEMBERS) / sizeof(MEDIUM_LOOP_MEMBERS[0]),
+                     MEDIUM_LOOP_BUDGET_US, micros);
+RateGroup slowLoop("slow", SLOW_LOOP_MEMBERS, sizeof(SLOW_LOOP_MEMBERS) / sizeof(SLOW_LOOP_MEMBERS[0]),
+                   SLOW_LOOP_BUDGET_US, micros);
+
+const RateGroup *const RATE_GROUPS[] = {&fastLoop, &mediumLoop, &slowLoop};
+static_assert(sizeof(RATE_GROUPS) / sizeof(RATE_GROUPS[0]) == RATE_GROUP_COUNT, "RATE_GROUP_COUNT is out of date");
+
+// Log how often a rate group ran out of budget, and the longest run of each of its members
+void logRateGroup(std::size_t index) {
+  const RateGroup &group = *RATE_GROUPS[index];
+  logger.info("Rate group %s - Ticks: %lu, Over budget: %lu, Worst tick: %lu us", group.getName(),
+              group.getTickCount(), group.getOverBudgetCount(), group.getWorstTickUs());
+  for (std::size_t i = 0; i < group.getMemberCount(); i++) {
+    logger.info("Rate group %s member %s - Worst run: %lu us, Shed: %lu", group.getName(), group.getMember(i).name,
+                group.getWorstRunUs(i), group.getShedCount(i));
   }
 }
 
-// Wait for temperature stabilization phase
-void waitForTemperatureStabilization() {
-  DistillationStateManager::getInstance().setState(STABILIZING);
-  heaterController.setPower(HEATER_POWER_LEVEL_2);
+// Replace the built-in recipe with the one on the SD card, if the card has one and it passes validation. The file is
+// read into a stack buffer that is gone once setup ends; parsing allocates nothing.
+void loadRecipe() {
+  char text[RECIPE_MAX_FILE_SIZE];
+  size_t length = HardwareFactory::getRecipeStorage()->read(text, sizeof(text));
+  if (length == 0) {
+    logger.info("No recipe on the SD card - using the built-in recipe");
+    return;
+  }
+  if (length == sizeof(text)) {
+    logger.warning("Recipe file is over %d bytes - using the built-in recipe", static_cast<int>(sizeof(text) - 1));
+    return;
+  }
+  RecipeParseResult result = parseRecipe(text, length, recipe);
+  if (result.error != RECIPE_OK) {
+    logger.warning("Recipe rejected at line %d: %s - using the built-in recipe", result.line,
+                   describeRecipeError(result.error));
+    return;
+  }
+  logger.info("Recipe loaded - Hearts: %.0f mL at %.1f mL/min", recipe.heartsVolumeMl, recipe.highFlowRateMlPerMin);
+}
 
-  if (isTemperatureStabilized()) {
-    taskManager.cancelTask(waitForTemperatureStabilizationTaskId);
-    collectEarlyForeshotsTaskId = TaskManager::scheduleFixedRate(DEFAULT_TASK_RATE_MS, collectEarlyForeshots);
+// Names of the probe positions, for the log
+const char *const PROBE_POSITION_NAMES[THERMOMETER_PROBE_POSITIONS] = {"mash tun", "bottom", "near top", "top"};
+
+// Formats a ROM code as hex for the log
+void formatProbeAddress(const ProbeAddress &address, char (&text)[2 * ONE_WIRE_ADDRESS_SIZE + 1]) {
+  for (uint8_t i = 0; i < ONE_WIRE_ADDRESS_SIZE; i++) {
+    snprintf(&text[2 * i], 3, "%02X", address.bytes[i]);
   }
 }
 
-// Heat up mash phase
-void heatUpMash() {
-  float temperature = topThermometer.getTemperature();
-  if (temperature < MIN_TEMPERATURE_THRESHOLD_C) {
-    heaterController.setPower(HEATER_POWER_LEVEL_MAX);
-  } else {
-    taskManager.cancelTask(heatUpMashTaskId);
-    waitForTemperatureStabilizationTaskId =
-        TaskManager::scheduleFixedRate(DEFAULT_TASK_RATE_MS, waitForTemperatureStabilization);
+// Move each probe to the index of its position on the still, by the ROM code stored for the position. The first boot
+// has no codes yet, so it binds the probes in ROM search order and stores their codes; from then on a replaced or
+// added probe is caught rather than silently given another's position. Returns false if a probe is missing.
+bool bindThermometerProbes() {
+  char text[2 * ONE_WIRE_ADDRESS_SIZE + 1];
+  if (!probeStore.load()) {
+    if (thermometerBus.getProbeCount() < THERMOMETER_PROBE_POSITIONS) {
+      logger.error("No stored thermometer probes, and too few on the bus to bind all %d positions",
+                   THERMOMETER_PROBE_POSITIONS);
+      return false;
+    }
+    for (uint8_t position = 0; position < THERMOMETER_PROBE_POSITIONS; position++) {
+      ProbeAddress address = thermometerBus.getAddress(position);
+      probeStore.set(position, address);
+      formatProbeAddress(address, text);
+      logger.warning("Bound thermometer probe %s to the %s position", text, PROBE_POSITION_NAMES[position]);
+    }
+    logger.warning("Check the probe positions above; delete %s to bind them again", PROBE_FILE_NAME);
+    if (!probeStore.save()) {
+      logger.warning("Failed to save the thermometer probe positions");
+    }
+    return true;
+  }
+
+  bool bound = true;
+  for (uint8_t position = 0; position < THERMOMETER_PROBE_POSITIONS; position++) {
+    ProbeAddress address{};
+    if (!probeStore.get(position, address) || !thermometerBus.bindProbe(position, address)) {
+      formatProbeAddress(address, text);
+      logger.error("Thermometer probe %s for the %s position is missing from the bus", text,
+                   PROBE_POSITION_NAMES[position]);
+      bound = false;
+    }
   }
+  return bound;
 }
 
 // Setup the process and schedule tasks
@@ -332,30 +625,58 @@ void setup() {
   logger.begin(Logger::INFO);
   logger.info("Distiller system starting up...");
 
-  // Schedule sensor update tasks
-  logger.info("Setting up sensor update tasks");
-  TaskManager::scheduleFixedRate(DEFAULT_TASK_RATE_MS, [] {
-    updateAllThermometers();
-    updateAllScales();
-  });
-
-  // Schedule health monitoring and reconnection tasks
-  logger.info("Setting up system health monitoring");
-  systemHealthCheckTaskId = TaskManager::scheduleFixedRate(FIVE_MINUTES_MS, checkSystemHealth);
-  reconnectScalesTaskId = TaskManager::scheduleFixedRate(ONE_MINUTE_MS, tryReconnectScales);
-
-  // Log connected scale count
-  int connectedScales = scaleController.getConnectedScaleCount();
-  logger.info("%d of 6 scales connected", connectedScales);
-
-  // If we don't have all scales connected, log a warning
-  if (connectedScales < 6) {
-    logger.warning("Not all scales are connected - system will operate with limited functionality");
+  // Enumerate the thermometer probes once; every later read goes straight to a cached address
+  uint8_t probeCount = thermometerBus.begin();
+  logger.info("%d thermometer probes found on the bus", probeCount);
+  bool probesBound = bindThermometerProbes();
+
+  // Restore the stored calibrations now that the logger has brought up the SD card, before any scale comes online
+  if (calibrationStore.load()) {
+    logger.info("Restored calibrations for %d scales", scaleController.restoreCalibrations(calibrationStore));
+  } else {
+    logger.warning("No stored scale calibrations - scales will tare with the default calibration factor");
+  }
+  PidTuning flowTuning{};
+  if (tuningStore.load() && tuningStore.get(FLOW_TUNING_LOOP, flowTuning)) {
+    flowController.applyTuning(flowTuning);
+    logger.info("Restored flow loop gains");
+  } else {
+    logger.warning("No stored flow loop gains - the flow loop will autotune during early foreshots");
   }
 
-  // Start the distillation process
-  logger.info("Starting distillation process in HEAT_UP phase");
-  heatUpMashTaskId = TaskManager::scheduleFixedRate(DEFAULT_TASK_RATE_MS, heatUpMash);
+  loadRecipe();
+
+  // Each conversion is a reading by default; hearts can afford a deeper average
+  heartsScale.setAveragingDepth(HEARTS_SCALE_AVERAGING_DEPTH);
+
+  // The display shows the run from the slow loop; only changed rows are written
+#ifndef NATIVE
+  Wire.begin();
+#endif
+  lcd.init();
+
+  // Run the rate groups, fastest first, so the fast loop goes first wherever their deadlines coincide
+  logger.info("Setting up the rate groups");
+  taskManager.setTaskName(TaskManager::scheduleFixedRate(FAST_LOOP_PERIOD_MS, [] { fastLoop.run(); }),
+                          fastLoop.getName());
+  taskManager.setTaskName(TaskManager::scheduleFixedRate(MEDIUM_LOOP_PERIOD_MS, [] { mediumLoop.run(); }),
+                          mediumLoop.getName());
+  taskManager.setTaskName(TaskManager::scheduleFixedRate(SLOW_LOOP_PERIOD_MS, [] { slowLoop.run(); }),
+                          slowLoop.getName());
+
+  // Scales come online from the reconnection member once their conversions settle; the health check reports them.
+  // Type TASK_STATISTICS_COMMAND on the console for the scheduler's histograms, and CALIBRATE_SCALE_COMMAND with a
+  // known weight on a scale to calibrate it.
+  logger.info("Scales will come online as their readings settle");
+
+  // Start the distillation process; the medium loop runs the phases. A probe in the wrong position would end the
+  // phases on the wrong temperature, so without every probe bound the still is left off
+  if (!probesBound) {
+    logger.error("Thermometer probes do not match their positions - distillation not started");
+  } else {
+    logger.info("Starting distillation process in HEAT_UP phase");
+    distillationStateEngine.start(HEAT_UP);
+  }
 
   logger.info("Setup complete");
 }
@@ -1,12 +1,156 @@
-#ifdef NATIVE
+#if defined(NATIVE) && !defined(UNIT_TEST)
+#include <MockArduino.h>
+#include <MockSensors.h>
+#include <TaskManagerIO.h>
+#include <constants.h>
+#include <distillation_state_manager.h>
+#include <thermometer_bus.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 
-// Simple main function for the native environment
-int main(int argc, char *argv[]) {
-  std::cout << "Distiller: Native build environment test" << std::endl;
-  std::cout << "This build is used primarily for testing" << std::endl;
+// The firmware, from main.cpp, with its phases, controllers and rate groups
+void setup();
+void loop();
+
+namespace {
+constexpr unsigned long SIMULATED_RUN_MS = 8UL * 60UL * 60UL * 1000UL; // Well beyond a whole distillation
+constexpr double MS_PER_SECOND = 1000.0;
+
+// The still around the firmware: a mash heated by the heater relays, a column whose probes follow the vapour from it,
+// and a vessel on a scale under each distillate valve. It is just detailed enough to take every phase to its end.
+constexpr double AMBIENT_C = 20.0;                      // Around the still, and every probe at the start
+constexpr double MASH_HEAT_CAPACITY_J_PER_C = 100000.0; // About 25 L of mash
+constexpr double MASH_HEAT_LOSS_W_PER_C = 10.0;         // Through the walls of the boiler, above ambient
+constexpr double MASH_BOILING_C = 92.0;                 // A wash of around 10% alcohol
+constexpr double DISTILLATE_J_PER_ML = 868.0;           // Heat that boils off a mL of distillate
+constexpr double AZEOTROPE_C = 78.2;                    // Column top while there is alcohol to distill
+constexpr double BOTTOM_ABOVE_TOP_C = 1.0;              // Spread of a settled column, well within the threshold
+constexpr double NEAR_TOP_ABOVE_TOP_C = 0.2;            // Just below the top, so a little warmer
+constexpr double TAILS_RISE_C = 20.0;                   // Climb of the column top as the alcohol runs out...
+constexpr double ALCOHOL_CHARGE_ML = 7000.0;            // ...once this much distillate is taken off
+constexpr int TAILS_RISE_EXPONENT = 6;                  // Keeps the top flat until late in the hearts
+constexpr double BOTTOM_LAG_S = 60.0;                   // Time constants of the probes following the vapour
+constexpr double NEAR_TOP_LAG_S = 240.0;                // The higher probes follow more slowly, so the column
+constexpr double TOP_LAG_S = 300.0;                     // takes a while to stabilize
+
+// Heater stages, each on its relay
+constexpr int HEATER_PINS[] = {HEATER_RELAY_1_PIN, HEATER_RELAY_2_PIN, HEATER_RELAY_3_PIN};
+constexpr int HEATER_WATTS[] = {HEATER_POWER_LEVEL_1, HEATER_POWER_LEVEL_2, HEATER_POWER_LEVEL_3};
+
+// Each vessel fills while its valve and the main valve are open
+struct Vessel {
+  int valvePin;
+  int scaleDataPin;
+};
+constexpr Vessel VESSELS[] = {
+    {EARLY_FORESHOTS_VALVE_PIN, EARLY_FORESHOTS_SCALE_DATA_PIN},
+    {LATE_FORESHOTS_VALVE_PIN, LATE_FORESHOTS_SCALE_DATA_PIN},
+    {HEADS_VALVE_PIN, HEADS_SCALE_DATA_PIN},
+    {HEARTS_VALVE_PIN, HEARTS_SCALE_DATA_PIN},
+    {EARLY_TAILS_VALVE_PIN, EARLY_TAILS_SCALE_DATA_PIN},
+    {LATE_TAILS_VALVE_PIN, LATE_TAILS_SCALE_DATA_PIN},
+};
+constexpr std::size_t VESSEL_COUNT = sizeof(VESSELS) / sizeof(VESSELS[0]);
+
+double mashC = AMBIENT_C;
+double probeC[THERMOMETER_PROBE_POSITIONS] = {AMBIENT_C, AMBIENT_C, AMBIENT_C, AMBIENT_C};
+double vesselMl[VESSEL_COUNT] = {};
+double collectedMl = 0.0;
+
+// Move a probe towards a temperature, as a first-order lag
+void follow(uint8_t probe, double targetC, double lagS, double seconds) {
+  probeC[probe] += (targetC - probeC[probe]) * (1.0 - std::exp(-seconds / lagS));
+}
+
+// Run the still for a span of time, with the relays and valves as the firmware last set them
+void advanceStill(double seconds) {
+  double heaterW = 0.0;
+  for (std::size_t i = 0; i < sizeof(HEATER_PINS) / sizeof(HEATER_PINS[0]); i++) {
+    heaterW += digitalRead(HEATER_PINS[i]) == HIGH ? HEATER_WATTS[i] : 0;
+  }
+  double netW = heaterW - MASH_HEAT_LOSS_W_PER_C * (mashC - AMBIENT_C);
+
+  // Below the boil the heat warms the mash; at the boil it makes vapour, and the column condenses it all
+  double distilledMl = 0.0;
+  mashC += netW * seconds / MASH_HEAT_CAPACITY_J_PER_C;
+  if (mashC >= MASH_BOILING_C) {
+    distilledMl = (mashC - MASH_BOILING_C) * MASH_HEAT_CAPACITY_J_PER_C / DISTILLATE_J_PER_ML;
+    mashC = MASH_BOILING_C;
+  }
+
+  // The main valve takes the condensate off, into whichever vessel is open; otherwise it runs back as reflux
+  if (digitalRead(MAIN_VALVE_PIN) == HIGH) {
+    for (std::size_t i = 0; i < VESSEL_COUNT; i++) {
+      if (digitalRead(VESSELS[i].valvePin) == HIGH) {
+        vesselMl[i] += distilledMl;
+        collectedMl += distilledMl;
+        break;
+      }
+    }
+  }
+
+  // Vapour only reaches the column at the boil, and the top climbs towards the mash as the alcohol runs out
+  bool boiling = mashC >= MASH_BOILING_C;
+  double topC = std::min(AZEOTROPE_C + TAILS_RISE_C * std::pow(collectedMl / ALCOHOL_CHARGE_ML, TAILS_RISE_EXPONENT),
+                         MASH_BOILING_C);
+  follow(MASH_TUN_THERMOMETER_PROBE, mashC, BOTTOM_LAG_S, seconds);
+  follow(BOTTOM_THERMOMETER_PROBE, boiling ? std::min(topC + BOTTOM_ABOVE_TOP_C, MASH_BOILING_C) : AMBIENT_C,
+         BOTTOM_LAG_S, seconds);
+  follow(NEAR_TOP_THERMOMETER_PROBE, boiling ? std::min(topC + NEAR_TOP_ABOVE_TOP_C, MASH_BOILING_C) : AMBIENT_C,
+         NEAR_TOP_LAG_S, seconds);
+  follow(TOP_THERMOMETER_PROBE, boiling ? topC : AMBIENT_C, TOP_LAG_S, seconds);
+}
+
+// Hand the still's state to the mock sensors: probes in 12-bit steps, scales in raw counts at the default calibration
+void updateSensors() {
+  for (uint8_t probe = 0; probe < THERMOMETER_PROBE_POSITIONS; probe++) {
+    MockSensors::probeTemperatures[probe] = celsiusToRaw(static_cast<float>(probeC[probe])) * DALLAS_RAW_PER_STEP;
+  }
+  for (std::size_t i = 0; i < VESSEL_COUNT; i++) {
+    MockSensors::loadCellCounts[VESSELS[i].scaleDataPin] =
+        std::lround(vesselMl[i] * ALCOHOL_DENSITY * SCALE_DEFAULT_CALIBRATION);
+  }
+}
+} // namespace
+
+// Runs the firmware against the simulated still on a virtual clock, as fast as the host allows, and checks that the
+// distillation goes through every phase and shuts down
+int main() {
+  std::cout << "Distiller: Native simulation" << std::endl;
+
+  // The scheduler runs on the mock core's clock, which only moves to each deadline
+  updateSensors();
+  setup();
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  DistillationState state = DistillationStateManager::getInstance().getState();
+  DistillationState furthest = state;
+  unsigned long deadline = 0;
+  while (state != OFF && taskManager.getNextDeadline(deadline) && deadline <= SIMULATED_RUN_MS) {
+    advanceStill(static_cast<double>(deadline - millis()) / MS_PER_SECOND);
+    updateSensors();
+    setMillis(deadline);
+    loop();
+
+    DistillationState next = DistillationStateManager::getInstance().getState();
+    if (next != state) {
+      std::cout << "Simulator: state " << static_cast<int>(state) << " -> " << static_cast<int>(next) << " at "
+                << deadline / ONE_MINUTE_MS << " min, " << collectedMl << " mL collected" << std::endl;
+      furthest = std::max(furthest, next);
+      state = next;
+    }
+  }
+  long long wallMs =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
 
-  // A "successful" run
-  return 0;
+  std::cout << "Simulated " << millis() / MS_PER_SECOND << " s in " << wallMs << " ms";
+  for (std::size_t i = 0; i < VESSEL_COUNT; i++) {
+    std::cout << (i == 0 ? ": vessels " : ", ") << vesselMl[i];
+  }
+  std::cout << " mL" << std::endl;
+  return state == OFF && furthest == FINALIZING ? 0 : 1;
 }
-#endif // NATIVE
\ No newline at end of file
+#endif // defined(NATIVE) && !defined(UNIT_TEST)
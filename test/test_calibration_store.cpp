@@ -0,0 +1,97 @@
+#include "test_mocks.h"
+
+#include <calibration_store.h>
+#include <constants.h>
+#include <gtest/gtest.h>
+
+/**
+ * @brief Test case for CalibrationsSurviveAPowerCycle.
+ *
+ * Given a store with calibrations for two scales, saved to the storage.
+ * When a new store loads the storage, as after a power cycle.
+ * Then both calibrations should come back unchanged, and the other slots should stay empty.
+ */
+TEST(CalibrationStoreTest, CalibrationsSurviveAPowerCycle) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  MemoryBlockStorage storage;
+  CalibrationStore before(storage);
+  before.set(0, {-81234, 419.5F});
+  before.set(3, {1200, -402.25F});
+  ASSERT_TRUE(before.save());
+
+  // Act
+  CalibrationStore after(storage);
+  bool loaded = after.load();
+
+  // Assert
+  EXPECT_TRUE(loaded);
+  ScaleCalibration calibration{};
+  ASSERT_TRUE(after.get(0, calibration));
+  EXPECT_EQ(-81234, calibration.offset);
+  EXPECT_FLOAT_EQ(419.5F, calibration.scale);
+  ASSERT_TRUE(after.get(3, calibration));
+  EXPECT_EQ(1200, calibration.offset);
+  EXPECT_FLOAT_EQ(-402.25F, calibration.scale);
+  EXPECT_FALSE(after.get(1, calibration));
+  EXPECT_FALSE(after.get(CALIBRATION_STORE_SLOTS, calibration));
+}
+
+/**
+ * @brief Test case for CorruptBlockIsRejected.
+ *
+ * Given a saved block with one byte flipped, and an empty storage.
+ * When a store loads each of them.
+ * Then both loads should fail and leave every slot empty.
+ */
+TEST(CalibrationStoreTest, CorruptBlockIsRejected) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  MemoryBlockStorage storage;
+  CalibrationStore writer(storage);
+  writer.set(2, {500, 420.0F});
+  ASSERT_TRUE(writer.save());
+  storage.block[storage.block.size() / 2] ^= 0x01;
+  MemoryBlockStorage emptyStorage;
+
+  // Act
+  CalibrationStore corrupt(storage);
+  bool corruptLoaded = corrupt.load();
+  CalibrationStore empty(emptyStorage);
+  bool emptyLoaded = empty.load();
+
+  // Assert
+  ScaleCalibration calibration{};
+  EXPECT_FALSE(corruptLoaded);
+  EXPECT_FALSE(corrupt.get(2, calibration));
+  EXPECT_FALSE(emptyLoaded);
+  EXPECT_FALSE(empty.get(2, calibration));
+}
+
+/**
+ * @brief Test case for UnchangedCalibrationIsNotRewritten.
+ *
+ * Given a store whose calibrations were just loaded.
+ * When the same calibration is stored again and the store is saved, and then a changed one.
+ * Then only the changed calibration should cause a write.
+ */
+TEST(CalibrationStoreTest, UnchangedCalibrationIsNotRewritten) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  MemoryBlockStorage storage;
+  CalibrationStore writer(storage);
+  writer.set(1, {700, 415.0F});
+  ASSERT_TRUE(writer.save());
+  CalibrationStore store(storage);
+  ASSERT_TRUE(store.load());
+  int writesAfterLoad = storage.writes;
+
+  // Act
+  store.set(1, {700, 415.0F});
+  store.save();
+  int writesForSame = storage.writes - writesAfterLoad;
+  store.set(1, {720, 415.0F});
+  store.save();
+  int writesForChange = storage.writes - writesAfterLoad - writesForSame;
+
+  // Assert
+  EXPECT_EQ(0, writesForSame);
+  EXPECT_EQ(1, writesForChange);
+}
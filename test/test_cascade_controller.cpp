@@ -0,0 +1,155 @@
+#include "test_constants.h"
+
+#include <algorithm>
+#include <cascade_controller.h>
+#include <constants.h>
+#include <control_loop_interfaces.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+// Include the mock Arduino functions
+#include "mock_arduino.h"
+
+// Mock flow loop, standing in for FlowController
+class MockFlowLoop : public IFlowLoop {
+public:
+  MOCK_METHOD(double, getValveDuty, (), (const, override));
+  MOCK_METHOD(AutotuneState, getAutotuneState, (), (const, override));
+};
+
+// Mock heater, standing in for HeaterController
+class MockHeaterPower : public IHeaterPower {
+public:
+  MOCK_METHOD(int, getPower, (), (const, override));
+  MOCK_METHOD(void, setBurstFirePower, (int), (override));
+};
+
+class CascadeControllerTest
+  : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  ::testing::NiceMock<MockFlowLoop> flowController;
+  ::testing::NiceMock<MockHeaterPower> heaterController;
+  CascadeController cascade{flowController, heaterController};
+  int power{heater::POWER_LEVEL_2};
+  double duty{0};
+
+  void SetUp() override {
+    ArduinoMock::setMillis(0);
+    ON_CALL(flowController, getAutotuneState()).WillByDefault(::testing::Return(AUTOTUNE_IDLE));
+    ON_CALL(flowController, getValveDuty()).WillByDefault([this] { return duty; });
+    ON_CALL(heaterController, getPower()).WillByDefault([this] { return power; });
+    ON_CALL(heaterController, setBurstFirePower(::testing::_)).WillByDefault([this](int newPower) {
+      power = newPower;
+    });
+  }
+
+  // Runs the cascade once a second against a column whose distillate rate grows with the power above its losses,
+  // and a flow loop whose valve duty is the requested share of that rate
+  void runColumn(unsigned long seconds) {
+    for (unsigned long i = 0; i < seconds; i++) {
+      duty = std::min(1.0, REQUESTED_FLOW_RATE / distillateRate(power));
+      ArduinoMock::advanceMillis(1000);
+      cascade.update();
+    }
+  }
+
+  static double distillateRate(int heaterPower) {
+    return std::max(0.0, static_cast<double>(heaterPower - COLUMN_LOSS_W) * ML_PER_MIN_PER_W);
+  }
+
+  static constexpr double REQUESTED_FLOW_RATE = 33.0;
+  static constexpr int COLUMN_LOSS_W = 800;
+  static constexpr double ML_PER_MIN_PER_W = 0.02;
+};
+
+/**
+ * @brief Test case for ColumnSettlesOnCapacityMargin.
+ *
+ * Given a cascade enabled at 2000 W on a column that makes too little distillate for the requested flow.
+ * When it runs for half an hour.
+ * Then the heater power should rise until the column makes the requested flow plus the capacity margin.
+ */
+TEST_F(CascadeControllerTest, ColumnSettlesOnCapacityMargin) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  ASSERT_LT(distillateRate(power), REQUESTED_FLOW_RATE);
+  cascade.enable();
+
+  // Act
+  runColumn(30 * 60);
+
+  // Assert
+  EXPECT_NEAR(REQUESTED_FLOW_RATE * (1.0 + CASCADE_CAPACITY_MARGIN), distillateRate(power),
+              REQUESTED_FLOW_RATE * 0.01);
+  EXPECT_NEAR(1.0 / (1.0 + CASCADE_CAPACITY_MARGIN), duty, 0.01);
+}
+
+/**
+ * @brief Test case for LowersPowerWhenValveHasHeadroom.
+ *
+ * Given a cascade enabled at full power, with the valve open only a third of the time.
+ * When it runs for a few minutes.
+ * Then the heater power should drop.
+ */
+TEST_F(CascadeControllerTest, LowersPowerWhenValveHasHeadroom) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  power = heater::POWER_LEVEL_MAX;
+  cascade.enable();
+
+  // Act
+  runColumn(5 * 60);
+
+  // Assert
+  EXPECT_LT(power, heater::POWER_LEVEL_MAX);
+  EXPECT_GE(power, CASCADE_MIN_POWER);
+}
+
+/**
+ * @brief Test case for HoldsPowerWhileFlowLoopAutotunes.
+ *
+ * Given an enabled cascade whose flow loop is running an autotune with the valve fully open.
+ * When it updates for a minute.
+ * Then the heater power should not be touched.
+ */
+TEST_F(CascadeControllerTest, HoldsPowerWhileFlowLoopAutotunes) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  cascade.enable();
+  duty = 1.0;
+  ON_CALL(flowController, getAutotuneState()).WillByDefault(::testing::Return(AUTOTUNE_RUNNING));
+  EXPECT_CALL(heaterController, setBurstFirePower(::testing::_)).Times(0);
+
+  // Act
+  for (int i = 0; i < 60; i++) {
+    ArduinoMock::advanceMillis(1000);
+    cascade.update();
+  }
+
+  // Assert
+  EXPECT_EQ(heater::POWER_LEVEL_2, power);
+}
+
+/**
+ * @brief Test case for EnableIsBumpless.
+ *
+ * Given a disabled cascade with the heater at 2000 W and the valve duty on target.
+ * When it is enabled and updates, and then is disabled.
+ * Then the first power it sets should be the power it found, and it should set none once disabled.
+ */
+TEST_F(CascadeControllerTest, EnableIsBumpless) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  duty = 1.0 / (1.0 + CASCADE_CAPACITY_MARGIN);
+  EXPECT_CALL(heaterController, setBurstFirePower(heater::POWER_LEVEL_2)).Times(1);
+
+  // Act
+  cascade.update();
+  cascade.enable();
+  bool enabled = cascade.isEnabled();
+  ArduinoMock::advanceMillis(CASCADE_PID_SAMPLE_TIME_MS);
+  cascade.update();
+  cascade.disable();
+  ArduinoMock::advanceMillis(CASCADE_PID_SAMPLE_TIME_MS);
+  cascade.update();
+
+  // Assert
+  EXPECT_TRUE(enabled);
+  EXPECT_FALSE(cascade.isEnabled());
+}
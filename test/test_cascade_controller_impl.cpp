@@ -0,0 +1,4 @@
+#include "../lib/process_controllers/include/cascade_controller.h"
+#include "../lib/process_controllers/src/cascade_controller.cpp"
+
+// This file ensures the CascadeController implementation is available for tests
@@ -0,0 +1,229 @@
+#include "test_constants.h"
+
+#include <array>
+#include <cmath>
+#include <constants.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+
+// Define UNIT_TEST if not already defined
+#ifndef UNIT_TEST
+#define UNIT_TEST
+#endif
+
+// Include the mock Arduino functions
+#include "mock_arduino.h"
+
+#include <column_observer.h>
+#include <distillation_state_manager.h>
+#include <heater_controller.h>
+#include <relay.h>
+#include <thermometer.h>
+#include <thermometer_bus.h>
+#include <thermometer_controller.h>
+
+namespace {
+constexpr uint8_t PROBE_COUNT = 4;
+constexpr unsigned long TICK_MS = 250;
+constexpr float MS_PER_SECOND = 1000.0F;
+constexpr float BOILING_MASH_C = 95.0F;
+constexpr float COLUMN_START_C = 78.0F;
+constexpr float RAMP_C_PER_MIN = 6.0F;
+} // namespace
+
+class ColumnObserverTest : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  std::shared_ptr<MockOneWire> oneWire;
+  std::shared_ptr<MockDallasTemperature> sensors;
+  std::unique_ptr<ThermometerBus> bus;
+  std::array<std::unique_ptr<Thermometer>, PROBE_COUNT> thermometers;
+  std::unique_ptr<ThermometerController> thermometerController;
+  std::array<std::unique_ptr<Relay>, 3> relays;
+  std::unique_ptr<HeaterController> heaterController;
+  std::unique_ptr<ColumnObserver> observer;
+  std::array<float, PROBE_COUNT> probeTemperatures{};
+
+  void SetUp() override {
+    setMillis(0);
+    EXPECT_CALL(ArduinoMockFixture::mockPinMode(), Call(::testing::_, ::testing::_)).Times(::testing::AnyNumber());
+    EXPECT_CALL(ArduinoMockFixture::mockDigitalWrite(), Call(::testing::_, ::testing::_))
+        .Times(::testing::AnyNumber());
+    DistillationStateManager::getInstance().setState(HEARTS);
+
+    oneWire = std::make_shared<::testing::NiceMock<MockOneWire>>();
+    ON_CALL(*oneWire, reset()).WillByDefault(::testing::Return(1));
+    sensors = std::make_shared<::testing::NiceMock<MockDallasTemperature>>();
+    ON_CALL(*sensors, getDeviceCount()).WillByDefault(::testing::Return(PROBE_COUNT));
+    ON_CALL(*sensors, getAddress(::testing::_, ::testing::_))
+        .WillByDefault(::testing::Invoke([](uint8_t *address, uint8_t index) {
+          std::fill(address, address + ONE_WIRE_ADDRESS_SIZE, 0);
+          address[0] = index;
+          return true;
+        }));
+    ON_CALL(*sensors, getTemp(::testing::_)).WillByDefault(::testing::Invoke([this](const uint8_t *address) {
+      return temperature::toDallasRaw(probeTemperatures[address[0]]);
+    }));
+    bus = std::make_unique<ThermometerBus>(oneWire, sensors);
+    bus->begin();
+
+    for (uint8_t probe = 0; probe < PROBE_COUNT; probe++) {
+      thermometers[probe] = std::make_unique<Thermometer>(*bus, probe);
+    }
+    thermometerController =
+        std::make_unique<ThermometerController>(*bus, *thermometers[MASH_TUN_THERMOMETER_PROBE],
+                                                *thermometers[BOTTOM_THERMOMETER_PROBE],
+                                                *thermometers[NEAR_TOP_THERMOMETER_PROBE],
+                                                *thermometers[TOP_THERMOMETER_PROBE]);
+
+    relays = {std::make_unique<Relay>(HEATER_RELAY_1_PIN), std::make_unique<Relay>(HEATER_RELAY_2_PIN),
+              std::make_unique<Relay>(HEATER_RELAY_3_PIN)};
+    heaterController = std::make_unique<HeaterController>(*relays[0], *relays[1], *relays[2]);
+    observer = std::make_unique<ColumnObserver>(*thermometerController, *heaterController);
+  }
+
+  void TearDown() override { ArduinoMockFixture::reset(); }
+
+  // Runs one control tick: thermometers first, then the observer
+  void tick() {
+    thermometerController->updateAllTemperatures();
+    observer->update();
+    advanceMillis(TICK_MS);
+  }
+};
+
+/**
+ * @brief Test case for TracksRampWithLessLagThanMedian.
+ *
+ * Given the near-top probe warming at 6 °C/min.
+ * When the observer has run for two minutes.
+ * Then its rate estimate should match the ramp, and its temperature estimate should lag the true temperature
+ * less than the probe's median does.
+ */
+TEST_F(ColumnObserverTest, TracksRampWithLessLagThanMedian) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr int TICKS = 480; // Two minutes
+
+  // Act
+  for (int i = 0; i < TICKS; i++) {
+    float minutes = static_cast<float>(millis()) / MS_TO_MINUTES;
+    probeTemperatures.fill(COLUMN_START_C);
+    probeTemperatures[NEAR_TOP_THERMOMETER_PROBE] = COLUMN_START_C + (RAMP_C_PER_MIN * minutes);
+    tick();
+  }
+
+  // Assert
+  float truth = probeTemperatures[NEAR_TOP_THERMOMETER_PROBE];
+  float observerLag = std::fabs(truth - observer->getTemperature(NEAR_TOP_CHANNEL));
+  float medianLag = std::fabs(truth - thermometerController->getNearTopTemperature());
+  EXPECT_TRUE(observer->isInitialized(NEAR_TOP_CHANNEL));
+  EXPECT_NEAR(RAMP_C_PER_MIN, observer->getTemperatureRate(NEAR_TOP_CHANNEL), RAMP_C_PER_MIN / 10);
+  EXPECT_NEAR(0.0F, observer->getTemperatureRate(TOP_CHANNEL), RAMP_C_PER_MIN / 10);
+  EXPECT_LT(observerLag, medianLag);
+}
+
+/**
+ * @brief Test case for VapourRateFollowsEnergyBalance.
+ *
+ * Given a mash held at boiling temperature with the heaters at 3000 W.
+ * When the observer has run for several filter time constants.
+ * Then the vapour rate should settle where the heater power, less the boiler's heat loss, boils off vapour.
+ */
+TEST_F(ColumnObserverTest, VapourRateFollowsEnergyBalance) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr int TICKS = 2400; // Ten minutes, twenty filter time constants
+  heaterController->setPower(HEATER_POWER_LEVEL_3);
+  probeTemperatures.fill(COLUMN_START_C);
+  probeTemperatures[MASH_TUN_THERMOMETER_PROBE] = BOILING_MASH_C;
+  const float expected = (static_cast<float>(HEATER_POWER_LEVEL_3) - BOILER_HEAT_LOSS_W) /
+                         VAPORIZATION_HEAT_J_PER_G * (MS_TO_MINUTES / MS_PER_SECOND);
+
+  // Act
+  for (int i = 0; i < TICKS; i++) {
+    tick();
+  }
+
+  // Assert
+  EXPECT_NEAR(expected, observer->getVapourRate(), expected / 20);
+}
+
+/**
+ * @brief Test case for NoVapourWhileMashIsHeating.
+ *
+ * Given a mash warming at the rate that all heater power, less losses, can sustain.
+ * When the observer has run for several minutes.
+ * Then the vapour rate should stay near zero, because the power is going into heating the mash.
+ */
+TEST_F(ColumnObserverTest, NoVapourWhileMashIsHeating) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr int TICKS = 1200; // Five minutes
+  constexpr float MASH_START_C = 40.0F;
+  heaterController->setPower(HEATER_POWER_LEVEL_3);
+  const float heatingRateCPerSecond =
+      (static_cast<float>(HEATER_POWER_LEVEL_3) - BOILER_HEAT_LOSS_W) / MASH_HEAT_CAPACITY_J_PER_C;
+
+  // Act
+  for (int i = 0; i < TICKS; i++) {
+    float seconds = static_cast<float>(millis()) / MS_PER_SECOND;
+    probeTemperatures.fill(temperature::BASE);
+    probeTemperatures[MASH_TUN_THERMOMETER_PROBE] = MASH_START_C + (heatingRateCPerSecond * seconds);
+    tick();
+  }
+
+  // Assert
+  EXPECT_NEAR(0.0F, observer->getVapourRate(), 10.0F);
+}
+
+/**
+ * @brief Test case for RawEstimateMatchesSteadyProbe.
+ *
+ * Given every probe steady at the column's starting temperature.
+ * When the observer has run for a minute.
+ * Then the raw estimate should be the probe's temperature in raw steps, for integer comparisons against thresholds.
+ */
+TEST_F(ColumnObserverTest, RawEstimateMatchesSteadyProbe) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr int TICKS = 240; // One minute
+  probeTemperatures.fill(COLUMN_START_C);
+
+  // Act
+  for (int i = 0; i < TICKS; i++) {
+    tick();
+  }
+
+  // Assert
+  EXPECT_EQ(celsiusToRaw(COLUMN_START_C), observer->getRawTemperature(TOP_CHANNEL));
+  EXPECT_EQ(celsiusToRaw(COLUMN_START_C), observer->getRawTemperature(BOTTOM_CHANNEL));
+}
+
+/**
+ * @brief Test case for ReadingIsFoldedInAtItsAcquisitionTime.
+ *
+ * Given the near-top probe warming at 6 °C/min, with each reading collected a whole medium tick after its
+ * conversion started.
+ * When the observer has run for two minutes.
+ * Then its temperature estimate should match the true temperature at the last update, not lag it by a tick.
+ */
+TEST_F(ColumnObserverTest, ReadingIsFoldedInAtItsAcquisitionTime) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr int TICKS = 120; // Two minutes
+  const float TICK_C = RAMP_C_PER_MIN * static_cast<float>(MEDIUM_LOOP_PERIOD_MS) / MS_TO_MINUTES;
+  float updateTime = 0.0F;
+
+  // Act
+  for (int i = 0; i < TICKS; i++) {
+    // The probe converted at the start of the previous tick, so that is the temperature it reports now
+    unsigned long conversionTime = millis() < MEDIUM_LOOP_PERIOD_MS ? 0 : millis() - MEDIUM_LOOP_PERIOD_MS;
+    float conversionMinutes = static_cast<float>(conversionTime) / MS_TO_MINUTES;
+    probeTemperatures.fill(COLUMN_START_C);
+    probeTemperatures[NEAR_TOP_THERMOMETER_PROBE] = COLUMN_START_C + (RAMP_C_PER_MIN * conversionMinutes);
+    thermometerController->updateAllTemperatures();
+    observer->update();
+    updateTime = static_cast<float>(millis());
+    advanceMillis(MEDIUM_LOOP_PERIOD_MS);
+  }
+
+  // Assert
+  float truth = COLUMN_START_C + (RAMP_C_PER_MIN * updateTime / MS_TO_MINUTES);
+  EXPECT_NEAR(truth, observer->getTemperature(NEAR_TOP_CHANNEL), TICK_C / 4);
+}
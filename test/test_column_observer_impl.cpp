@@ -0,0 +1,4 @@
+#include "../lib/process_controllers/include/column_observer.h"
+#include "../lib/process_controllers/src/column_observer.cpp"
+
+// This file ensures the ColumnObserver implementation is available for tests
@@ -2,6 +2,8 @@
 #define TEST_CONSTANTS_H
 
 #include <constants.h>
+#include <cstdint>
+#include <fixed_point_temperature.h>
 
 // Flow rate constants for tests
 namespace flow {
@@ -15,20 +17,6 @@ namespace test_time {
 inline constexpr unsigned long ONE_MINUTE_MS = 60000;
 }
 
-// Weight constants for tests
-namespace weight {
-inline constexpr double ZERO_WEIGHT = 0.0;
-inline const double EXPECTED_WEIGHT_10ML = 10.0 * ALCOHOL_DENSITY;
-inline const double EXPECTED_WEIGHT_20ML = 20.0 * ALCOHOL_DENSITY;
-} // namespace weight
-
-// PID output constants for tests
-namespace pid {
-inline constexpr double POSITIVE_OUTPUT = 1.0;
-inline constexpr double NEGATIVE_OUTPUT = -1.0;
-inline constexpr double WITHIN_TOLERANCE_OUTPUT = 0.05;
-} // namespace pid
-
 // Heater power constants for tests
 namespace heater {
 inline constexpr int POWER_LEVEL_1 = 1000;
@@ -45,6 +33,9 @@ inline constexpr float SMALL_INCREMENT = 0.1F;
 inline constexpr float MEDIUM_INCREMENT = 1.0F;
 inline constexpr float LARGE_INCREMENT = 2.0F;
 inline constexpr float SUDDEN_INCREASE = 5.0F;
+
+// DallasTemperature::getTemp() reports 1/128 °C, eight times finer than the DS18B20 register
+inline constexpr int32_t toDallasRaw(float celsius) { return static_cast<int32_t>(celsiusToRaw(celsius)) * 8; }
 } // namespace temperature
 
 #endif // TEST_CONSTANTS_H
@@ -0,0 +1,245 @@
+#include <cooperative_scheduler.h>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+constexpr unsigned long FAST_PERIOD_MS = 300;
+constexpr unsigned long SLOW_PERIOD_MS = 500;
+constexpr unsigned long PERIOD_MS = 100;
+constexpr unsigned long LATE_LOOP_MS = 350; // Three and a half periods, so the first deadline is two periods late
+
+// Virtual time for the scheduler under test, and a record of the runs it made
+unsigned long virtualNow = 0;
+unsigned long virtualClock() { return virtualNow; }
+unsigned long virtualMicros = 0;
+unsigned long virtualTimer() { return virtualMicros; }
+std::string runOrder;
+int runCount = 0;
+
+void runFast() { runOrder += 'F'; }
+void runSlow() { runOrder += 'S'; }
+void count() { runCount++; }
+} // namespace
+
+class CooperativeSchedulerTest
+  : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  CooperativeScheduler scheduler{virtualClock};
+
+  void SetUp() override {
+    virtualNow = 0;
+    virtualMicros = 0;
+    runOrder.clear();
+    runCount = 0;
+  }
+
+  // Moves the virtual clock from deadline to deadline, running the loop at each, up to a given time
+  void runUntil(unsigned long endMs) {
+    unsigned long deadline = 0;
+    while (scheduler.getNextDeadline(deadline) && deadline <= endMs) {
+      virtualNow = deadline;
+      scheduler.runLoop();
+    }
+    virtualNow = endMs;
+  }
+};
+
+/**
+ * @brief Test case for TasksRunInDeadlineOrder.
+ *
+ * Given two tasks with different periods on a virtual clock.
+ * When the clock is moved from deadline to deadline for several of their periods.
+ * Then each should run once per period, in deadline order, with the earlier-scheduled task first on a tie.
+ */
+TEST_F(CooperativeSchedulerTest, TasksRunInDeadlineOrder) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  scheduler.schedule(FAST_PERIOD_MS, FAST_PERIOD_MS, runFast);
+  scheduler.schedule(SLOW_PERIOD_MS, SLOW_PERIOD_MS, runSlow);
+
+  // Act
+  runUntil(3 * SLOW_PERIOD_MS);
+
+  // Assert
+  EXPECT_EQ("FSFFSFFS", runOrder); // 300, 500, 600, 900, 1000, 1200, 1500 (F, then S)
+}
+
+/**
+ * @brief Test case for SkipMissedResumesOnGrid.
+ *
+ * Given a task that skips missed periods.
+ * When the loop first runs several periods after its deadline.
+ * Then it should run once, count the periods it dropped, and be due next on its original grid.
+ */
+TEST_F(CooperativeSchedulerTest, SkipMissedResumesOnGrid) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  int task = scheduler.schedule(PERIOD_MS, PERIOD_MS, count, SKIP_MISSED);
+  virtualNow = LATE_LOOP_MS;
+
+  // Act
+  unsigned int runs = scheduler.runLoop();
+  unsigned long next = 0;
+  scheduler.getNextDeadline(next);
+
+  // Assert
+  EXPECT_EQ(1U, runs);
+  EXPECT_EQ(2UL, scheduler.getOverrunCount(task));
+  EXPECT_EQ(4 * PERIOD_MS, next);
+}
+
+/**
+ * @brief Test case for CatchUpRunsEveryMissedPeriod.
+ *
+ * Given a task that catches up on missed periods.
+ * When the loop first runs several periods after its deadline.
+ * Then it should run once for every period that has passed, and be due next on its original grid.
+ */
+TEST_F(CooperativeSchedulerTest, CatchUpRunsEveryMissedPeriod) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  int task = scheduler.schedule(PERIOD_MS, PERIOD_MS, count, CATCH_UP);
+  virtualNow = LATE_LOOP_MS;
+
+  // Act
+  unsigned int runs = scheduler.runLoop();
+  unsigned long next = 0;
+  scheduler.getNextDeadline(next);
+
+  // Assert
+  EXPECT_EQ(3U, runs);
+  EXPECT_EQ(3, runCount);
+  EXPECT_EQ(2UL, scheduler.getOverrunCount(task));
+  EXPECT_EQ(4 * PERIOD_MS, next);
+}
+
+namespace {
+CooperativeScheduler *selfCancellingScheduler = nullptr;
+int selfCancellingTask = CooperativeScheduler::INVALID_TASK;
+constexpr int SELF_CANCEL_AFTER_RUNS = 2;
+
+// Counts its runs and cancels itself after the second
+void countAndCancel() {
+  if (++runCount == SELF_CANCEL_AFTER_RUNS) {
+    selfCancellingScheduler->cancel(selfCancellingTask);
+  }
+}
+} // namespace
+
+/**
+ * @brief Test case for CancelledTasksStopAndTheirIdsGoStale.
+ *
+ * Given a task that cancels itself on its second run, and another task cancelled from outside.
+ * When the clock runs on and a new task takes a freed slot.
+ * Then neither cancelled task should run again, and cancelling the old IDs should not touch the new task.
+ */
+TEST_F(CooperativeSchedulerTest, CancelledTasksStopAndTheirIdsGoStale) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  selfCancellingScheduler = &scheduler;
+  selfCancellingTask = scheduler.schedule(PERIOD_MS, PERIOD_MS, countAndCancel);
+  int other = scheduler.schedule(PERIOD_MS, PERIOD_MS, runSlow);
+  ASSERT_TRUE(scheduler.cancel(other));
+
+  // Act
+  runUntil(10 * PERIOD_MS);
+  int replacement = scheduler.schedule(PERIOD_MS, PERIOD_MS, runFast);
+  bool staleSelfCancelled = scheduler.cancel(selfCancellingTask);
+  bool staleOtherCancelled = scheduler.cancel(other);
+  runUntil(virtualNow + PERIOD_MS);
+
+  // Assert
+  EXPECT_EQ(SELF_CANCEL_AFTER_RUNS, runCount);
+  EXPECT_NE(selfCancellingTask, replacement);
+  EXPECT_FALSE(staleSelfCancelled);
+  EXPECT_FALSE(staleOtherCancelled);
+  EXPECT_EQ("F", runOrder);
+  EXPECT_EQ(1, scheduler.getTaskCount());
+}
+
+/**
+ * @brief Test case for SlotsRunOut.
+ *
+ * Given a scheduler with every slot taken.
+ * When another task is scheduled.
+ * Then it should be refused.
+ */
+TEST_F(CooperativeSchedulerTest, SlotsRunOut) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  for (uint8_t i = 0; i < CooperativeScheduler::MAX_TASKS; i++) {
+    ASSERT_NE(CooperativeScheduler::INVALID_TASK, scheduler.schedule(PERIOD_MS, PERIOD_MS, count));
+  }
+
+  // Act
+  int refused = scheduler.schedule(PERIOD_MS, PERIOD_MS, count);
+
+  // Assert
+  EXPECT_EQ(CooperativeScheduler::INVALID_TASK, refused);
+  EXPECT_EQ(CooperativeScheduler::MAX_TASKS, scheduler.getTaskCount());
+}
+
+namespace {
+constexpr unsigned long BLOCKING_RUN_MS = 40; // A sensor read that holds up the loop
+
+// Stands in for a callback that blocks, moving both virtual clocks on by the time it takes
+void block() {
+  virtualNow += BLOCKING_RUN_MS;
+  virtualMicros += BLOCKING_RUN_MS * 1000UL;
+}
+} // namespace
+
+/**
+ * @brief Test case for BlockingRunIsTimedAndDelaysTheNextTask.
+ *
+ * Given a blocking task and a quick task due at the same time, on a scheduler with a run timer.
+ * When the loop runs them.
+ * Then the blocking run's time should be recorded, and the quick task should be recorded as starting that much late.
+ */
+TEST_F(CooperativeSchedulerTest, BlockingRunIsTimedAndDelaysTheNextTask) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  scheduler.setTimer(virtualTimer);
+  int blocking = scheduler.schedule(PERIOD_MS, PERIOD_MS, block);
+  int quick = scheduler.schedule(PERIOD_MS, PERIOD_MS, count);
+  virtualNow = PERIOD_MS;
+
+  // Act
+  scheduler.runLoop();
+
+  // Assert
+  const TaskStatistics *blockingStatistics = scheduler.getStatistics(blocking);
+  const TaskStatistics *quickStatistics = scheduler.getStatistics(quick);
+  ASSERT_NE(nullptr, blockingStatistics);
+  ASSERT_NE(nullptr, quickStatistics);
+  EXPECT_EQ(1UL, blockingStatistics->runs);
+  EXPECT_EQ(BLOCKING_RUN_MS * 1000UL, blockingStatistics->runTimeUs.getMax());
+  EXPECT_EQ(0UL, blockingStatistics->startLatenessMs.getMax());
+  EXPECT_EQ(0UL, quickStatistics->runTimeUs.getMax());
+  EXPECT_EQ(BLOCKING_RUN_MS, quickStatistics->startLatenessMs.getMax());
+}
+
+/**
+ * @brief Test case for StatisticsAreNamedAndFoundBySlot.
+ *
+ * Given a named task that has run, in a scheduler without a run timer.
+ * When the slots are gone through for statistics, and the task is then cancelled and its slot reused.
+ * Then its name and runs should be found with no run times, and the new task should start with clean statistics.
+ */
+TEST_F(CooperativeSchedulerTest, StatisticsAreNamedAndFoundBySlot) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  int task = scheduler.schedule(PERIOD_MS, PERIOD_MS, count);
+  ASSERT_TRUE(scheduler.setTaskName(task, "counter"));
+  runUntil(3 * PERIOD_MS);
+
+  // Act
+  const TaskStatistics *found = scheduler.getStatistics(scheduler.getTaskIdAt(0));
+  ASSERT_NE(nullptr, found);
+  TaskStatistics before = *found;
+  int freeSlot = scheduler.getTaskIdAt(1);
+  scheduler.cancel(task);
+  int replacement = scheduler.schedule(PERIOD_MS, PERIOD_MS, count);
+
+  // Assert
+  EXPECT_STREQ("counter", before.name);
+  EXPECT_EQ(3UL, before.runs);
+  EXPECT_EQ(0UL, before.runTimeUs.getSampleCount());
+  EXPECT_EQ(CooperativeScheduler::INVALID_TASK, freeSlot);
+  EXPECT_EQ(nullptr, scheduler.getStatistics(task));
+  EXPECT_EQ(nullptr, scheduler.getStatistics(replacement)->name);
+  EXPECT_EQ(0UL, scheduler.getStatistics(replacement)->runs);
+}
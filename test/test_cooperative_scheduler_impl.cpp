@@ -0,0 +1,4 @@
+#include "../lib/utilities/include/cooperative_scheduler.h"
+#include "../lib/utilities/src/cooperative_scheduler.cpp"
+
+// This file ensures the CooperativeScheduler implementation is available for tests
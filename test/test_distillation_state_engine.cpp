@@ -0,0 +1,175 @@
+#include <distillation_state_engine.h>
+#include <gtest/gtest.h>
+
+#include "mock_arduino.h"
+
+namespace {
+// Calls made into the test phase table, and whether the heat-up and stabilizing phases should end
+int heatUpEntries = 0;
+int heatUpControls = 0;
+int heatUpExits = 0;
+int stabilizingEntries = 0;
+int stabilizingControls = 0;
+bool heatUpDone = false;
+bool stabilizingDone = false;
+
+void enterHeatUp() { heatUpEntries++; }
+void controlHeatUp() { heatUpControls++; }
+bool isHeatUpDone() { return heatUpDone; }
+void exitHeatUp() { heatUpExits++; }
+void enterStabilizing() { stabilizingEntries++; }
+void controlStabilizing() { stabilizingControls++; }
+bool isStabilizingDone() { return stabilizingDone; }
+
+// Heat-up and stabilizing have actions; the other phases run straight through to FINALIZING, which ends in OFF
+bool always() { return true; }
+
+const DistillationPhase PHASES[] = {
+    {OFF, nullptr, nullptr, nullptr, nullptr, OFF},
+    {HEAT_UP, enterHeatUp, controlHeatUp, isHeatUpDone, exitHeatUp, STABILIZING},
+    {STABILIZING, enterStabilizing, controlStabilizing, isStabilizingDone, nullptr, EARLY_FORESHOTS},
+    {EARLY_FORESHOTS, nullptr, nullptr, always, nullptr, LATE_FORESHOTS},
+    {LATE_FORESHOTS, nullptr, nullptr, always, nullptr, HEADS},
+    {HEADS, nullptr, nullptr, always, nullptr, HEARTS},
+    {HEARTS, nullptr, nullptr, always, nullptr, EARLY_TAILS},
+    {EARLY_TAILS, nullptr, nullptr, always, nullptr, LATE_TAILS},
+    {LATE_TAILS, nullptr, nullptr, always, nullptr, FINALIZING},
+    {FINALIZING, nullptr, nullptr, always, nullptr, OFF},
+};
+constexpr std::size_t PHASE_COUNT = sizeof(PHASES) / sizeof(PHASES[0]);
+constexpr int TICKS = 5;
+} // namespace
+
+class DistillationStateEngineTest
+  : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  DistillationStateEngine engine{PHASES, PHASE_COUNT};
+
+  void SetUp() override {
+    setMillis(0);
+    DistillationStateManager::getInstance().setState(OFF);
+    heatUpEntries = heatUpControls = heatUpExits = 0;
+    stabilizingEntries = stabilizingControls = 0;
+    heatUpDone = stabilizingDone = false;
+  }
+};
+
+/**
+ * @brief Test case for EntryRunsOnceControlsRunEveryTick.
+ *
+ * Given a state engine started in a phase whose exit predicate does not hold.
+ * When it ticks several times.
+ * Then the entry action should have run once, on the start, and the controls on every tick.
+ */
+TEST_F(DistillationStateEngineTest, EntryRunsOnceControlsRunEveryTick) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  engine.start(HEAT_UP);
+
+  // Act
+  for (int i = 0; i < TICKS; i++) {
+    engine.update();
+  }
+
+  // Assert
+  EXPECT_EQ(1, heatUpEntries);
+  EXPECT_EQ(TICKS, heatUpControls);
+  EXPECT_EQ(0, heatUpExits);
+  EXPECT_EQ(HEAT_UP, engine.getPhase());
+  EXPECT_EQ(HEAT_UP, DistillationStateManager::getInstance().getState());
+}
+
+/**
+ * @brief Test case for TransitionRunsExitThenSuccessorEntry.
+ *
+ * Given a state engine in a phase whose exit predicate has just come to hold.
+ * When it ticks.
+ * Then it should run the phase's exit action and its successor's entry action, but neither phase's controls, and
+ * the state manager should follow.
+ */
+TEST_F(DistillationStateEngineTest, TransitionRunsExitThenSuccessorEntry) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  engine.start(HEAT_UP);
+  engine.update();
+  heatUpDone = true;
+
+  // Act
+  bool transitioned = engine.update();
+
+  // Assert
+  EXPECT_TRUE(transitioned);
+  EXPECT_EQ(1, heatUpControls);
+  EXPECT_EQ(1, heatUpExits);
+  EXPECT_EQ(1, stabilizingEntries);
+  EXPECT_EQ(0, stabilizingControls);
+  EXPECT_EQ(STABILIZING, engine.getPhase());
+  EXPECT_EQ(STABILIZING, DistillationStateManager::getInstance().getState());
+}
+
+/**
+ * @brief Test case for OneTransitionPerTick.
+ *
+ * Given a state engine whose phases from early foreshots on end as soon as they begin.
+ * When it ticks once per phase.
+ * Then it should step through the phases one per tick, in table order, and come to rest in OFF.
+ */
+TEST_F(DistillationStateEngineTest, OneTransitionPerTick) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  engine.start(EARLY_FORESHOTS);
+  const DistillationState expected[] = {LATE_FORESHOTS, HEADS, HEARTS, EARLY_TAILS, LATE_TAILS, FINALIZING, OFF};
+
+  // Act and Assert
+  for (DistillationState phase : expected) {
+    EXPECT_TRUE(engine.update());
+    EXPECT_EQ(phase, engine.getPhase());
+  }
+  EXPECT_FALSE(engine.update());
+  EXPECT_EQ(OFF, engine.getPhase());
+  EXPECT_EQ(8UL, engine.getTransitionCount());
+}
+
+/**
+ * @brief Test case for PhaseOutsideTableIsIdle.
+ *
+ * Given a state engine whose table stops before the phase it is started in.
+ * When it ticks.
+ * Then it should stay in that phase without calling into the table.
+ */
+TEST_F(DistillationStateEngineTest, PhaseOutsideTableIsIdle) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  DistillationStateEngine shortEngine(PHASES, STABILIZING);
+  shortEngine.start(STABILIZING);
+
+  // Act
+  bool transitioned = shortEngine.update();
+
+  // Assert
+  EXPECT_FALSE(transitioned);
+  EXPECT_EQ(STABILIZING, shortEngine.getPhase());
+  EXPECT_EQ(0, stabilizingEntries);
+  EXPECT_EQ(0, stabilizingControls);
+}
+
+/**
+ * @brief Test case for TableOrderIsChecked.
+ *
+ * Given a phase table in DistillationState order, and the same rows with two of them swapped.
+ * When each is checked.
+ * Then only the ordered table should pass.
+ */
+TEST_F(DistillationStateEngineTest, TableOrderIsChecked) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  DistillationPhase swapped[PHASE_COUNT];
+  for (std::size_t i = 0; i < PHASE_COUNT; i++) {
+    swapped[i] = PHASES[i];
+  }
+  swapped[HEADS] = PHASES[HEARTS];
+  swapped[HEARTS] = PHASES[HEADS];
+
+  // Act
+  bool orderedPasses = DistillationStateEngine::isIndexedByState(PHASES, PHASE_COUNT);
+  bool swappedPasses = DistillationStateEngine::isIndexedByState(swapped, PHASE_COUNT);
+
+  // Assert
+  EXPECT_TRUE(orderedPasses);
+  EXPECT_FALSE(swappedPasses);
+}
@@ -0,0 +1,4 @@
+#include "../lib/utilities/include/distillation_state_engine.h"
+#include "../lib/utilities/src/distillation_state_engine.cpp"
+
+// This file ensures the DistillationStateEngine implementation is available for tests
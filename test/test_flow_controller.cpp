@@ -1,176 +1,98 @@
 #include "test_constants.h"
 
+#include <algorithm>
+#include <array>
 #include <constants.h>
+#include <control_loop_interfaces.h>
+#include <distillation_state_manager.h>
+#include <flow_controller.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <memory>
 
-// Define UNIT_TEST if not already defined
-#ifndef UNIT_TEST
-#define UNIT_TEST
-#endif
-
-// Include the distillation_state_manager.h file to get the DistillationState enum
-#include <distillation_state_manager.h>
-
-// Conditional includes based on test vs. production environment
-#ifdef UNIT_TEST
-// Test environment - use mock classes and functions
-
 // Include the mock Arduino functions
 #include "mock_arduino.h"
 
-// Mock PID class
-// This mocks the PID class from the PID_v1 library
-class MockPID {
-public:
-  MOCK_METHOD(void, SetMode, (int), ());
-  MOCK_METHOD(bool, Compute, (), ());
-
-  // Pointers to the input, output, and setpoint variables
-  double *input;
-  double *output;
-  double *setpoint;
-
-  // Constructor to accept pointers to the variables
-  MockPID(double *input, double *output, double *setpoint, double kp, double ki, double kd, int controllerDirection)
-    : input(input), output(output), setpoint(setpoint) {}
-};
-
-// Define PID constants to match the PID_v1 library
-constexpr int AUTOMATIC = 1;
-constexpr int DIRECT = 0;
+using ::testing::_;
 
-// Mock ValveController
-// This mocks the ValveController class from src/valve_controller.h
-class MockValveController {
+// Mock main valve, standing in for ValveController
+class MockMainValve : public IMainValve {
 public:
-  MOCK_METHOD(void, openMainValve, (), ());
-  MOCK_METHOD(void, closeMainValve, (), ());
+  MOCK_METHOD(void, closeMainValve, (), (override));
+  MOCK_METHOD(void, setMainValveDuty, (double), (override));
 };
 
-// DistillationState enum is now included from distillation_state_manager.h
-
-// Mock ScaleController
-class MockScaleController {
+// Mock scale readings, standing in for ScaleController
+class MockScaleReadings : public IScaleReadings {
 public:
-  MOCK_METHOD(double, getWeight, (DistillationState), (const));
+  MOCK_METHOD(ScaleReading, getLastReading, (DistillationState), (const, override));
 };
 
-// Mock DistillationStateManager
-class MockDistillationStateManager {
-public:
-  MOCK_METHOD(DistillationState, getState, (), (const));
-
-  static MockDistillationStateManager &getInstance() {
-    static MockDistillationStateManager instance;
-    return instance;
-  }
-};
-
-// Testable FlowController
-// This is a testable version of the FlowController class from src/flow_controller.h
-// In a production environment, we would use conditional compilation in the original class
-class TestableFlowController {
-public: // Changed from private to public for testing
-  MockValveController *valveController;
-  MockScaleController *scaleController;
-  MockPID *pid; // Use a pointer to the mock PID
-  double flowRate{0};
-  unsigned long startTime{0};
-  double startVolume{0};
-
-private: // Keep other members private
-  [[nodiscard]] double getCurrentVolume() const {
-    return scaleController->getWeight(MockDistillationStateManager::getInstance().getState()) / ALCOHOL_DENSITY;
-  }
-
-public:
-  // Accept a pointer to the mock PID in the constructor
-  TestableFlowController(MockValveController *valveController, MockScaleController *scaleController, MockPID *pid)
-    : valveController(valveController), scaleController(scaleController), pid(pid) {
-    pid->SetMode(AUTOMATIC);
-    valveController->closeMainValve();
-  }
-
-  [[nodiscard]] double getFlowRate() const { return flowRate; }
-
-  void setAndControlFlowRate(double newFlowRate) {
-    const double epsilon = 0.001;
-
-    if (std::abs(newFlowRate - flowRate) > epsilon) {
-      flowRate = newFlowRate;
-      startVolume = getCurrentVolume();
-      startTime = millis();
-    }
-
-    if (flowRate == 0) {
-      valveController->closeMainValve();
-      return;
-    }
-
-    unsigned long currentMillis = millis();
-    double elapsedTimeInMinutes = static_cast<double>(currentMillis - startTime) / MS_TO_MINUTES;
-    double expectedVolume = flowRate * elapsedTimeInMinutes;
-    double currentVolume = getCurrentVolume();
-    *pid->input = expectedVolume - (currentVolume - startVolume); // Access input through pid pointer
-    pid->Compute();                                               // Use arrow operator
-
-    double tolerance = TEST_TOLERANCE;
-    if (*pid->output > tolerance) { // Access output through pid pointer
-      valveController->openMainValve();
-    } else if (*pid->output < -tolerance) { // Access output through pid pointer
-      valveController->closeMainValve();
-    }
-  }
-};
-
-#else
-// Production environment - would use real Arduino functions and libraries
-// This section is not used in the test but shows how conditional compilation would work
-#include "PID_v1.h"
-#include "constants.h"
-#include "distillation_state_manager.h"
-#include "scale_controller.h"
-#include "valve_controller.h"
-
-#include <Arduino.h>
-#endif
-
+// Drives the real FlowController, with its real PID, against a mocked main valve and scale
 class FlowControllerTest : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
 protected:
-  std::unique_ptr<MockValveController> valveController;
-  std::unique_ptr<MockScaleController> scaleController;
-  std::unique_ptr<MockPID> pid; // Use a unique_ptr for the mock PID
-  std::unique_ptr<TestableFlowController> flowController;
-  MockDistillationStateManager &stateManager = MockDistillationStateManager::getInstance();
+  ::testing::NiceMock<MockMainValve> valveController;
+  ::testing::NiceMock<MockScaleReadings> scaleController;
+  std::unique_ptr<FlowController> flowController;
+  DistillationStateManager &stateManager = DistillationStateManager::getInstance();
 
-  // Move input, output, and setpoint to the test fixture
-  double input{0}, output{0}, setpoint{0};
+  ScaleReading reading{0, 0.0F, 0};      // Newest reading of the scale under the outlet
+  DistillationState readingState{HEARTS}; // State whose scale the reading is from
+  double duty{0};                         // Last duty the main valve was given
+  double weight{0};                       // Weight in the vessel of runClosedLoop
 
   void SetUp() override {
     ArduinoMock::setMillis(0);
-    valveController = std::make_unique<MockValveController>();
-    scaleController = std::make_unique<MockScaleController>();
-
-    // Initialize input, output, and setpoint
-    input = 0;
-    output = 0;
-    setpoint = 0;
+    stateManager.setState(HEARTS);
+    ON_CALL(scaleController, getLastReading(_)).WillByDefault([this](DistillationState state) {
+      return state == readingState ? reading : ScaleReading{0, -1.0F, 0};
+    });
+    ON_CALL(valveController, setMainValveDuty(_)).WillByDefault([this](double newDuty) { duty = newDuty; });
+    ON_CALL(valveController, closeMainValve()).WillByDefault([this] { duty = 0; });
+    flowController = std::make_unique<FlowController>(&valveController, &scaleController);
+  }
 
-    // Create the mock PID object using pointers to the test fixture's members
-    pid = std::make_unique<MockPID>(&input, &output, &setpoint, TEST_PID_KP, TEST_PID_KI, TEST_PID_KD, DIRECT);
+  void TearDown() override { stateManager.setState(OFF); }
 
-    // Create the flow controller and pass the mock PID
-    flowController = std::make_unique<TestableFlowController>(valveController.get(), scaleController.get(), pid.get());
+  // A reading of a vessel filling at a steady rate since time zero
+  static ScaleReading steadyReading(unsigned long timeMs, double mlPerMinute, unsigned long sequence) {
+    double volume = mlPerMinute * static_cast<double>(timeMs) / MS_TO_MINUTES;
+    return {timeMs, static_cast<float>(volume * ALCOHOL_DENSITY), sequence};
+  }
 
-    // Initial closeMainValve call in constructor and SetMode call
-    EXPECT_CALL(*valveController, closeMainValve()).Times(1);
-    EXPECT_CALL(*pid, SetMode(AUTOMATIC)).Times(1);
+  // Runs one control step per reading, a hearts reading interval apart, on a vessel filling at a steady rate
+  void runSteadyFlow(double mlPerMinute, unsigned long firstSequence, unsigned long lastSequence) {
+    for (unsigned long i = firstSequence; i <= lastSequence; i++) {
+      ArduinoMock::setMillis(i * READING_INTERVAL_MS);
+      reading = steadyReading(i * READING_INTERVAL_MS, mlPerMinute, i);
+      flowController->setAndControlFlowRate(flow::DEFAULT_FLOW_RATE);
+    }
+  }
 
-    // Create the flow controller and pass the mock PID
-    flowController = std::make_unique<TestableFlowController>(valveController.get(), scaleController.get(), pid.get());
+  // Runs the loop on a fast-loop tick against a vessel that fills in proportion to the duty, with a reading every
+  // hearts reading interval, and returns the lowest and highest duty of the last half of the run
+  std::array<double, 2> runClosedLoop(unsigned long seconds) {
+    std::array<double, 2> dutyRange = {FLOW_PID_OUTPUT_MAX, FLOW_PID_OUTPUT_MIN};
+    unsigned long start = ArduinoMock::millis();
+    unsigned long end = start + seconds * 1000;
+    for (unsigned long now = start + FAST_LOOP_PERIOD_MS; now <= end; now += FAST_LOOP_PERIOD_MS) {
+      ArduinoMock::setMillis(now);
+      weight += duty * OPEN_FLOW_RATE * ALCOHOL_DENSITY * FAST_LOOP_PERIOD_MS / MS_TO_MINUTES;
+      if (now % READING_INTERVAL_MS == 0) {
+        reading = {now, static_cast<float>(weight), reading.sequence + 1};
+      }
+      flowController->controlFlowRate();
+      if (now - start >= (end - start) / 2) {
+        dutyRange[0] = std::min(dutyRange[0], duty);
+        dutyRange[1] = std::max(dutyRange[1], duty);
+      }
+    }
+    return dutyRange;
   }
+
+  static constexpr unsigned long READING_INTERVAL_MS = 400; // Four conversions averaged, as on the hearts scale
+  static constexpr unsigned long READY_READINGS = 2 * FLOW_RATE_WINDOW_MS / READING_INTERVAL_MS;
+  static constexpr double OPEN_FLOW_RATE = 2.0 * flow::DEFAULT_FLOW_RATE; // Flow with the valve open for whole windows
 };
 
 /**
@@ -178,22 +100,25 @@ protected:
  *
  * Given a new FlowController object is created.
  * When the flow rate is checked.
- * Then it should be zero.
+ * Then it should be zero, on the default gains.
  */
 TEST_F(FlowControllerTest, InitialFlowRateIsZero) { // NOLINT(cppcoreguidelines-owning-memory)
   EXPECT_EQ(flow::ZERO_FLOW_RATE, flowController->getFlowRate());
+  EXPECT_DOUBLE_EQ(FLOW_PID_KP, flowController->getTuning().kp);
+  EXPECT_DOUBLE_EQ(FLOW_PID_KI, flowController->getTuning().ki);
+  EXPECT_DOUBLE_EQ(FLOW_PID_KD, flowController->getTuning().kd);
 }
 
 /**
  * @brief Test case for SetFlowRateToZeroClosesMainValve.
  *
- * Given a FlowController object with a non-zero flow rate.
+ * Given a FlowController object.
  * When the flow rate is set to zero.
  * Then the main valve should be closed.
  */
 TEST_F(FlowControllerTest, SetFlowRateToZeroClosesMainValve) { // NOLINT(cppcoreguidelines-owning-memory)
   // Arrange
-  EXPECT_CALL(*valveController, closeMainValve()).Times(1);
+  EXPECT_CALL(valveController, closeMainValve()).Times(1);
 
   // Act
   flowController->setAndControlFlowRate(flow::ZERO_FLOW_RATE);
@@ -203,104 +128,185 @@ TEST_F(FlowControllerTest, SetFlowRateToZeroClosesMainValve) { // NOLINT(cppcore
 }
 
 /**
- * @brief Test case for SetFlowRateToPositiveValueOpensMainValveWhenBehindTarget.
+ * @brief Test case for OpensMainValveWhenFlowIsBelowTarget.
  *
- * Given a FlowController object with a zero flow rate and the current volume is behind the expected volume.
- * When the flow rate is set to a positive value.
- * Then the main valve should be opened.
+ * Given a FlowController object whose scale shows no flow.
+ * When a positive flow rate is set and the loop runs on two windows of readings.
+ * Then the measured rate should be zero, and the main valve should be given a duty above zero.
  */
-TEST_F(FlowControllerTest,
-       SetFlowRateToPositiveValueOpensMainValveWhenBehindTarget) { // NOLINT(cppcoreguidelines-owning-memory)
-  // Arrange
-  EXPECT_CALL(stateManager, getState()).WillRepeatedly(::testing::Return(HEARTS));
-
-  // Expect two calls to getWeight in setAndControlFlowRate
-  EXPECT_CALL(*scaleController, getWeight(HEARTS))
-      .Times(2)
-      .WillRepeatedly(::testing::Return(weight::ZERO_WEIGHT)); // Simulate no weight change
-
-  // Expect Compute to be called and set output to a positive value
-  EXPECT_CALL(*pid, Compute())
-      .WillOnce(::testing::DoAll(::testing::Assign(&output, pid::POSITIVE_OUTPUT),
-                                 ::testing::Return(true))); // Simulate PID output > tolerance
+TEST_F(FlowControllerTest, OpensMainValveWhenFlowIsBelowTarget) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Act
+  runSteadyFlow(flow::ZERO_FLOW_RATE, 1, READY_READINGS);
 
-  // Expect openMainValve to be called once
-  EXPECT_CALL(*valveController, openMainValve()).Times(1);
+  // Assert
+  EXPECT_EQ(flow::DEFAULT_FLOW_RATE, flowController->getFlowRate());
+  EXPECT_NEAR(0.0, flowController->getMeasuredFlowRate(), flow::FLOW_RATE_EPSILON);
+  EXPECT_GT(duty, FLOW_PID_OUTPUT_MIN);
+  EXPECT_DOUBLE_EQ(duty, flowController->getValveDuty());
+}
 
+/**
+ * @brief Test case for SmallErrorDoesNotSaturateDuty.
+ *
+ * Given a FlowController whose scale shows the vessel filling 1 ml/min short of the requested rate.
+ * When the loop runs on that for a minute.
+ * Then the default gains should open the valve part of the way, not for whole windows.
+ */
+TEST_F(FlowControllerTest, SmallErrorDoesNotSaturateDuty) { // NOLINT(cppcoreguidelines-owning-memory)
   // Act
-  flowController->setAndControlFlowRate(flow::DEFAULT_FLOW_RATE);
+  runSteadyFlow(flow::DEFAULT_FLOW_RATE - 1.0, 1, READY_READINGS + 60 * 1000 / READING_INTERVAL_MS);
 
   // Assert
-  EXPECT_EQ(flow::DEFAULT_FLOW_RATE, flowController->getFlowRate());
+  EXPECT_GT(duty, FLOW_PID_OUTPUT_MIN);
+  EXPECT_LT(duty, 0.1 * FLOW_PID_OUTPUT_MAX);
 }
 
 /**
  * @brief Test case for ClosesMainValveWhenAheadOfTarget.
  *
- * Given a FlowController object with a positive flow rate and the current volume is ahead of the expected volume.
- * When setAndControlFlowRate is called.
- * Then the main valve should be closed.
+ * Given a FlowController object whose scale shows the vessel filling at twice the requested rate.
+ * When the loop runs on two windows of readings.
+ * Then the measured rate should be that rate, and the main valve should be kept closed.
  */
 TEST_F(FlowControllerTest, ClosesMainValveWhenAheadOfTarget) { // NOLINT(cppcoreguidelines-owning-memory)
   // Arrange
-  EXPECT_CALL(stateManager, getState()).WillRepeatedly(::testing::Return(HEARTS));
+  constexpr double FAST_FLOW_RATE = 2.0 * flow::DEFAULT_FLOW_RATE;
 
-  // Expect calls to getWeight - now expecting 3 calls
-  EXPECT_CALL(*scaleController, getWeight(HEARTS))
-      .WillOnce(::testing::Return(weight::ZERO_WEIGHT))           // First call in initial setAndControlFlowRate
-      .WillOnce(::testing::Return(weight::EXPECTED_WEIGHT_20ML))  // Second call after advancing time
-      .WillOnce(::testing::Return(weight::EXPECTED_WEIGHT_20ML)); // Third call in the second setAndControlFlowRate
+  // Act
+  runSteadyFlow(FAST_FLOW_RATE, 1, READY_READINGS + 1);
 
-  // Set initial flow rate
-  flowController->setAndControlFlowRate(flow::DEFAULT_FLOW_RATE);
+  // Assert
+  EXPECT_NEAR(FAST_FLOW_RATE, flowController->getMeasuredFlowRate(), flow::FLOW_RATE_EPSILON);
+  EXPECT_DOUBLE_EQ(FLOW_PID_OUTPUT_MIN, duty);
+}
 
-  // Advance time by 1 minute
-  ArduinoMock::advanceMillis(test_time::ONE_MINUTE_MS);
+/**
+ * @brief Test case for SettlesOnPartialDuty.
+ *
+ * Given a FlowController on the default gains, over a vessel that fills at twice the requested rate with the valve
+ * open for whole windows and in proportion to the duty otherwise.
+ * When the loop runs for half an hour.
+ * Then the measured rate should settle on the requested rate, and the valve should pulse at about half duty rather
+ * than be opened or closed outright.
+ */
+TEST_F(FlowControllerTest, SettlesOnPartialDuty) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  flowController->setFlowRate(flow::DEFAULT_FLOW_RATE);
 
-  // Expect Compute to be called and set output to a negative value
-  EXPECT_CALL(*pid, Compute())
-      .WillOnce(::testing::DoAll(::testing::Assign(&output, pid::NEGATIVE_OUTPUT),
-                                 ::testing::Return(true))); // Simulate PID output < -tolerance
+  // Act
+  std::array<double, 2> dutyRange = runClosedLoop(30 * 60);
 
-  // Expect closeMainValve to be called once
-  EXPECT_CALL(*valveController, closeMainValve()).Times(1);
+  // Assert
+  EXPECT_NEAR(flow::DEFAULT_FLOW_RATE, flowController->getMeasuredFlowRate(), 0.05 * flow::DEFAULT_FLOW_RATE);
+  EXPECT_NEAR(flow::DEFAULT_FLOW_RATE / OPEN_FLOW_RATE, duty, 0.05);
+  EXPECT_GT(dutyRange[0], FLOW_PID_OUTPUT_MIN);
+  EXPECT_LT(dutyRange[1], FLOW_PID_OUTPUT_MAX);
+}
+
+/**
+ * @brief Test case for MeasuredRateUsesAcquisitionTimes.
+ *
+ * Given scale readings taken at a steady rate but reaching the control loop late, in bursts and repeatedly.
+ * When setAndControlFlowRate is called at irregular times.
+ * Then the measured rate should still be the true rate.
+ */
+TEST_F(FlowControllerTest, MeasuredRateUsesAcquisitionTimes) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  const std::array<unsigned long, 6> controlDelaysMs = {200, 1500, 0, 700, 2500, 100};
+  const std::array<unsigned long, 6> sequences = {1, 2, 2, 3, 4, 4};
+  runSteadyFlow(flow::DEFAULT_FLOW_RATE, 1, READY_READINGS);
 
   // Act
-  flowController->setAndControlFlowRate(flow::DEFAULT_FLOW_RATE);
+  for (std::size_t i = 0; i < sequences.size(); i++) {
+    ArduinoMock::advanceMillis(controlDelaysMs[i]);
+    unsigned long sequence = READY_READINGS + sequences[i];
+    reading = steadyReading(sequence * READING_INTERVAL_MS, flow::DEFAULT_FLOW_RATE, sequence);
+    flowController->setAndControlFlowRate(flow::DEFAULT_FLOW_RATE);
+  }
+
+  // Assert
+  EXPECT_NEAR(flow::DEFAULT_FLOW_RATE, flowController->getMeasuredFlowRate(), flow::FLOW_RATE_EPSILON);
 }
 
 /**
- * @brief Test case for MaintainsFlowRateWhenOnTarget.
+ * @brief Test case for HoldsDutyUntilEstimateIsReady.
  *
- * Given a FlowController object with a positive flow rate and the current volume is on target with the expected volume.
- * When setAndControlFlowRate is called.
- * Then no valve operations should occur.
+ * Given a FlowController pulsing the main valve at a partial duty.
+ * When the outlet moves to another scale and its readings span less than two PWM windows.
+ * Then the estimate should restart, and the valve should keep its duty until it is ready.
  */
-TEST_F(FlowControllerTest, MaintainsFlowRateWhenOnTarget) { // NOLINT(cppcoreguidelines-owning-memory)
+TEST_F(FlowControllerTest, HoldsDutyUntilEstimateIsReady) { // NOLINT(cppcoreguidelines-owning-memory)
   // Arrange
-  EXPECT_CALL(stateManager, getState()).WillRepeatedly(::testing::Return(HEARTS));
+  flowController->setFlowRate(flow::DEFAULT_FLOW_RATE);
+  runClosedLoop(5 * 60);
+  double heldDuty = duty;
+  ASSERT_GT(heldDuty, FLOW_PID_OUTPUT_MIN);
+  ASSERT_LT(heldDuty, FLOW_PID_OUTPUT_MAX);
+  unsigned long start = ArduinoMock::millis();
 
-  // Expect calls to getWeight - now expecting 3 calls
-  EXPECT_CALL(*scaleController, getWeight(HEARTS))
-      .WillOnce(::testing::Return(weight::ZERO_WEIGHT))           // First call in initial setAndControlFlowRate
-      .WillOnce(::testing::Return(weight::EXPECTED_WEIGHT_10ML))  // Second call after advancing time
-      .WillOnce(::testing::Return(weight::EXPECTED_WEIGHT_10ML)); // Third call in the second setAndControlFlowRate
+  // Act
+  stateManager.setState(EARLY_TAILS);
+  readingState = EARLY_TAILS;
+  for (unsigned long i = 1; i < READY_READINGS; i++) {
+    ArduinoMock::setMillis(start + i * READING_INTERVAL_MS);
+    reading = steadyReading(i * READING_INTERVAL_MS, flow::ZERO_FLOW_RATE, i);
+    flowController->controlFlowRate();
+  }
 
-  // Set initial flow rate
-  flowController->setAndControlFlowRate(flow::DEFAULT_FLOW_RATE);
+  // Assert
+  EXPECT_DOUBLE_EQ(heldDuty, duty);
+  EXPECT_DOUBLE_EQ(0.0, flowController->getMeasuredFlowRate());
+}
+
+/**
+ * @brief Test case for AutotuneRelayMeasuresValveLoop.
+ *
+ * Given a FlowController on target, whose vessel fills at twice the requested rate with the main valve open for whole
+ * windows and in proportion to the duty otherwise.
+ * When an autotune is started and the relay drives the valve.
+ * Then the flow should settle into a limit cycle, and the measured PI gains should replace the PID's.
+ */
+TEST_F(FlowControllerTest, AutotuneRelayMeasuresValveLoop) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  flowController->setFlowRate(flow::DEFAULT_FLOW_RATE);
+  runClosedLoop(5 * 60);
+  ASSERT_TRUE(flowController->startAutotune());
 
-  // Advance time by 1 minute
-  ArduinoMock::advanceMillis(test_time::ONE_MINUTE_MS);
+  // Act
+  for (unsigned long elapsed = 0;
+       flowController->getAutotuneState() == AUTOTUNE_RUNNING && elapsed < FLOW_AUTOTUNE_TIMEOUT_MS;
+       elapsed += 1000) {
+    runClosedLoop(1);
+  }
 
-  // Expect Compute to be called and set output to a value within tolerance
-  EXPECT_CALL(*pid, Compute())
-      .WillOnce(::testing::DoAll(::testing::Assign(&output, pid::WITHIN_TOLERANCE_OUTPUT),
-                                 ::testing::Return(true))); // Simulate PID output within tolerance
+  // Assert
+  ASSERT_EQ(AUTOTUNE_DONE, flowController->getAutotuneState());
+  PidTuning measured = flowController->getAutotunedTuning();
+  EXPECT_GT(measured.kp, 0.0);
+  EXPECT_GT(measured.ki, 0.0);
+  EXPECT_DOUBLE_EQ(measured.kp, flowController->getTuning().kp);
+  EXPECT_DOUBLE_EQ(measured.ki, flowController->getTuning().ki);
+  EXPECT_DOUBLE_EQ(0.0, flowController->getTuning().kd);
+}
 
-  // No valve operations expected since we're on target
-  EXPECT_CALL(*valveController, openMainValve()).Times(0);
-  EXPECT_CALL(*valveController, closeMainValve()).Times(0);
+/**
+ * @brief Test case for NewRateActsOnTheNextControlStep.
+ *
+ * Given a FlowController holding a steady flow.
+ * When the flow rate is set to zero, and a control step follows.
+ * Then the main valve should only close on the control step.
+ */
+TEST_F(FlowControllerTest, NewRateActsOnTheNextControlStep) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  runSteadyFlow(flow::DEFAULT_FLOW_RATE, 1, READY_READINGS);
 
   // Act
-  flowController->setAndControlFlowRate(flow::DEFAULT_FLOW_RATE);
+  EXPECT_CALL(valveController, closeMainValve()).Times(0);
+  flowController->setFlowRate(flow::ZERO_FLOW_RATE);
+  ::testing::Mock::VerifyAndClearExpectations(&valveController);
+  EXPECT_CALL(valveController, closeMainValve()).Times(1);
+  flowController->controlFlowRate();
+
+  // Assert
+  EXPECT_EQ(flow::ZERO_FLOW_RATE, flowController->getFlowRate());
 }
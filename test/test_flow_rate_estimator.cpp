@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <constants.h>
+#include <flow_rate_estimator.h>
+#include <gtest/gtest.h>
+
+namespace {
+constexpr unsigned long READING_INTERVAL_MS = 400;
+constexpr double FLOW_RATE_ML_PER_MIN = 33.0;
+constexpr double START_WEIGHT_G = 250.0;
+constexpr double RATE_TOLERANCE = 0.01;
+constexpr unsigned long CONVERSION_INTERVAL_MS = 100; // 10 SPS at depth 1
+
+// A reading of a vessel that held START_WEIGHT_G at time zero and fills at FLOW_RATE_ML_PER_MIN
+ScaleReading readingAt(unsigned long timeMs, unsigned long sequence) {
+  double volume = FLOW_RATE_ML_PER_MIN * static_cast<double>(timeMs) / MS_TO_MINUTES;
+  return {timeMs, static_cast<float>(START_WEIGHT_G + volume * ALCOHOL_DENSITY), sequence};
+}
+} // namespace
+
+/**
+ * @brief Test case for SteadyFlowIsMeasured.
+ *
+ * Given a flow rate estimator fed readings spanning more than its window from a vessel filling at a steady rate.
+ * When the flow rate is queried.
+ * Then it should be the filling rate in ml/min, whatever weight the vessel started at.
+ */
+TEST(FlowRateEstimatorTest, SteadyFlowIsMeasured) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  FlowRateEstimator estimator;
+
+  // Act
+  for (unsigned long i = 1; i <= 2 * FLOW_RATE_WINDOW_MS / READING_INTERVAL_MS; i++) {
+    estimator.add(readingAt(i * READING_INTERVAL_MS, i));
+  }
+
+  // Assert
+  EXPECT_TRUE(estimator.isReady());
+  EXPECT_NEAR(FLOW_RATE_ML_PER_MIN, estimator.getFlowRate(), RATE_TOLERANCE);
+}
+
+/**
+ * @brief Test case for NoRateUntilReadingsSpanBothWindows.
+ *
+ * Given a flow rate estimator whose readings span less than two windows, or that has none at all.
+ * When the flow rate is queried.
+ * Then it should not be ready and the rate should be zero, and a scale without readings should add nothing.
+ */
+TEST(FlowRateEstimatorTest, NoRateUntilReadingsSpanBothWindows) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  FlowRateEstimator estimator;
+  unsigned long lastShortTime = 2 * FLOW_RATE_WINDOW_MS - FLOW_RATE_SPAN_TOLERANCE_MS - 1;
+
+  // Act
+  bool addedEmpty = estimator.add({0, 0.0F, 0});
+  estimator.add(readingAt(0, 1));
+  estimator.add(readingAt(lastShortTime, 2));
+  bool readyShort = estimator.isReady();
+  double rateShort = estimator.getFlowRate();
+  estimator.add(readingAt(lastShortTime + 1, 3));
+
+  // Assert
+  EXPECT_FALSE(addedEmpty);
+  EXPECT_FALSE(readyShort);
+  EXPECT_DOUBLE_EQ(0.0, rateShort);
+  EXPECT_TRUE(estimator.isReady());
+}
+
+/**
+ * @brief Test case for FastScaleStillSpansBothWindows.
+ *
+ * Given a flow rate estimator fed a reading every 12.5 ms, as a scale at 80 SPS and depth 1 gives, more readings over
+ * two windows than it has slots.
+ * When the flow rate is queried.
+ * Then it should be ready and measure the filling rate.
+ */
+TEST(FlowRateEstimatorTest, FastScaleStillSpansBothWindows) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr double FAST_READING_INTERVAL_MS = 12.5;
+  constexpr auto READINGS = static_cast<unsigned long>(2 * FLOW_RATE_WINDOW_MS / FAST_READING_INTERVAL_MS);
+  static_assert(READINGS > FLOW_RATE_SLOTS, "The readings must outnumber the slots");
+  FlowRateEstimator estimator;
+
+  // Act
+  for (unsigned long i = 1; i <= READINGS; i++) {
+    estimator.add(readingAt(std::lround(static_cast<double>(i) * FAST_READING_INTERVAL_MS), i));
+  }
+
+  // Assert
+  EXPECT_TRUE(estimator.isReady());
+  EXPECT_NEAR(FLOW_RATE_ML_PER_MIN, estimator.getFlowRate(), RATE_TOLERANCE);
+}
+
+/**
+ * @brief Test case for RepeatedReadingIsAddedOnce.
+ *
+ * Given a flow rate estimator polled more often than the scale produces readings.
+ * When the same reading is offered again.
+ * Then it should be ignored, so the means are not weighted towards stale readings.
+ */
+TEST(FlowRateEstimatorTest, RepeatedReadingIsAddedOnce) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  FlowRateEstimator estimator;
+  ScaleReading first = readingAt(READING_INTERVAL_MS, 1);
+
+  // Act
+  bool addedFirst = estimator.add(first);
+  bool addedRepeat = estimator.add(first);
+  for (unsigned long i = 2; i <= 2 * FLOW_RATE_WINDOW_MS / READING_INTERVAL_MS; i++) {
+    estimator.add(readingAt(i * READING_INTERVAL_MS, i));
+    estimator.add(readingAt(i * READING_INTERVAL_MS, i));
+  }
+
+  // Assert
+  EXPECT_TRUE(addedFirst);
+  EXPECT_FALSE(addedRepeat);
+  EXPECT_TRUE(estimator.isReady());
+  EXPECT_NEAR(FLOW_RATE_ML_PER_MIN, estimator.getFlowRate(), RATE_TOLERANCE);
+}
+
+/**
+ * @brief Test case for ValvePulsesAverageOut.
+ *
+ * Given a flow rate estimator fed a reading per conversion from a vessel that only fills while the main valve is
+ * open, for a quarter of each PWM window.
+ * When the rate is read after every reading over several windows.
+ * Then it should not be ready for the first two windows, and should stay near the average flow rather than follow
+ * the valve open and shut once it is.
+ */
+TEST(FlowRateEstimatorTest, ValvePulsesAverageOut) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr unsigned long OPEN_MS = MAIN_VALVE_PWM_WINDOW_MS / 4;
+  constexpr double OPEN_RATE_ML_PER_MIN = 4.0 * FLOW_RATE_ML_PER_MIN;
+  constexpr int WINDOWS = 6;
+  constexpr double RIPPLE_TOLERANCE = 0.02 * FLOW_RATE_ML_PER_MIN;
+  FlowRateEstimator estimator;
+  double volume = 0.0;
+  double lowest = OPEN_RATE_ML_PER_MIN;
+  double highest = 0.0;
+  unsigned long firstReadyTime = 0;
+
+  // Act
+  unsigned long sequence = 0;
+  for (unsigned long time = CONVERSION_INTERVAL_MS; time <= WINDOWS * MAIN_VALVE_PWM_WINDOW_MS;
+       time += CONVERSION_INTERVAL_MS) {
+    if (time % MAIN_VALVE_PWM_WINDOW_MS < OPEN_MS) {
+      volume += OPEN_RATE_ML_PER_MIN * static_cast<double>(CONVERSION_INTERVAL_MS) / MS_TO_MINUTES;
+    }
+    estimator.add({time, static_cast<float>(START_WEIGHT_G + volume * ALCOHOL_DENSITY), ++sequence});
+    if (!estimator.isReady()) {
+      EXPECT_DOUBLE_EQ(0.0, estimator.getFlowRate());
+      continue;
+    }
+    firstReadyTime = firstReadyTime == 0 ? time : firstReadyTime;
+    lowest = std::min(lowest, estimator.getFlowRate());
+    highest = std::max(highest, estimator.getFlowRate());
+  }
+
+  // Assert
+  EXPECT_GE(firstReadyTime, 2 * FLOW_RATE_WINDOW_MS - FLOW_RATE_SPAN_TOLERANCE_MS);
+  EXPECT_NEAR(FLOW_RATE_ML_PER_MIN, lowest, RIPPLE_TOLERANCE);
+  EXPECT_NEAR(FLOW_RATE_ML_PER_MIN, highest, RIPPLE_TOLERANCE);
+}
+
+/**
+ * @brief Test case for ClearedEstimatorWaitsForBothWindows.
+ *
+ * Given a flow rate estimator that was ready, with the valve pulsing a quarter of each PWM window.
+ * When it is cleared, as on a move to another scale, and fed the next window and a half of readings.
+ * Then it should not report the valve's ripple as a rate while the readings span less than two windows.
+ */
+TEST(FlowRateEstimatorTest, ClearedEstimatorWaitsForBothWindows) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr unsigned long OPEN_MS = MAIN_VALVE_PWM_WINDOW_MS / 4;
+  constexpr double OPEN_RATE_ML_PER_MIN = 4.0 * FLOW_RATE_ML_PER_MIN;
+  constexpr unsigned long CLEAR_TIME_MS = 3 * FLOW_RATE_WINDOW_MS;
+  FlowRateEstimator estimator;
+  unsigned long sequence = 0;
+  for (unsigned long time = CONVERSION_INTERVAL_MS; time <= CLEAR_TIME_MS; time += CONVERSION_INTERVAL_MS) {
+    estimator.add({time, static_cast<float>(START_WEIGHT_G), ++sequence});
+  }
+  ASSERT_TRUE(estimator.isReady());
+  double volume = 0.0;
+  bool everReady = false;
+  double largestRate = 0.0;
+
+  // Act
+  estimator.clear();
+  for (unsigned long time = CLEAR_TIME_MS + CONVERSION_INTERVAL_MS; time <= CLEAR_TIME_MS + 3 * FLOW_RATE_WINDOW_MS / 2;
+       time += CONVERSION_INTERVAL_MS) {
+    if (time % MAIN_VALVE_PWM_WINDOW_MS < OPEN_MS) {
+      volume += OPEN_RATE_ML_PER_MIN * static_cast<double>(CONVERSION_INTERVAL_MS) / MS_TO_MINUTES;
+    }
+    estimator.add({time, static_cast<float>(START_WEIGHT_G + volume * ALCOHOL_DENSITY), ++sequence});
+    everReady = everReady || estimator.isReady();
+    largestRate = std::max(largestRate, estimator.getFlowRate());
+  }
+
+  // Assert
+  EXPECT_FALSE(everReady);
+  EXPECT_DOUBLE_EQ(0.0, largestRate);
+}
+
+/**
+ * @brief Test case for LowFlowNoiseIsAveraged.
+ *
+ * Given a flow rate estimator fed a reading per conversion from a vessel filling at the lowest flow rate, each
+ * reading off by up to half a gram of noise.
+ * When the rate is read after every reading once it is ready.
+ * Then it should stay within a few percent of the true rate, although one window adds little more weight than the
+ * noise on a single reading.
+ */
+TEST(FlowRateEstimatorTest, LowFlowNoiseIsAveraged) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr double NOISE_G = 0.5;
+  const double NOISE_TOLERANCE = 0.1 * LOW_FLOW_RATE_ML_PER_MIN;
+  FlowRateEstimator estimator;
+  uint32_t noiseState = 1;
+  double lowest = HIGH_FLOW_RATE_ML_PER_MIN;
+  double highest = 0.0;
+
+  // Act
+  unsigned long sequence = 0;
+  for (unsigned long time = CONVERSION_INTERVAL_MS; time <= 6 * FLOW_RATE_WINDOW_MS; time += CONVERSION_INTERVAL_MS) {
+    noiseState = noiseState * 1664525U + 1013904223U; // A fixed pseudo-random sequence, so the test is repeatable
+    double noise = NOISE_G * (2.0 * static_cast<double>(noiseState >> 8) / static_cast<double>(1U << 24) - 1.0);
+    double volume = LOW_FLOW_RATE_ML_PER_MIN * static_cast<double>(time) / MS_TO_MINUTES;
+    estimator.add({time, static_cast<float>(START_WEIGHT_G + volume * ALCOHOL_DENSITY + noise), ++sequence});
+    if (estimator.isReady()) {
+      lowest = std::min(lowest, estimator.getFlowRate());
+      highest = std::max(highest, estimator.getFlowRate());
+    }
+  }
+
+  // Assert
+  EXPECT_NEAR(LOW_FLOW_RATE_ML_PER_MIN, lowest, NOISE_TOLERANCE);
+  EXPECT_NEAR(LOW_FLOW_RATE_ML_PER_MIN, highest, NOISE_TOLERANCE);
+}
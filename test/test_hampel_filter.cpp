@@ -0,0 +1,83 @@
+#include <constants.h>
+#include <gtest/gtest.h>
+#include <hampel_filter.h>
+
+namespace {
+constexpr std::size_t WINDOW = 7;
+constexpr float THRESHOLD = 3.0F;
+constexpr float MIN_DEVIATION = 0.5F;
+
+// Fills the window with a noisy but steady signal around a level
+void fill(HampelFilter<WINDOW> &filter, float level) {
+  for (std::size_t i = 0; i < WINDOW; i++) {
+    filter.accept(level + (i % 2 == 0 ? 0.2F : -0.2F));
+  }
+}
+} // namespace
+
+/**
+ * @brief Test case for SpikeIsRejected.
+ *
+ * Given a window of steady samples.
+ * When a single sample far from them arrives, followed by a normal one.
+ * Then the spike should be rejected and counted, and the normal sample accepted.
+ */
+TEST(HampelFilterTest, SpikeIsRejected) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  HampelFilter<WINDOW> filter(THRESHOLD, MIN_DEVIATION);
+  fill(filter, 100.0F);
+
+  // Act
+  bool spikeAccepted = filter.accept(180.0F);
+  bool nextAccepted = filter.accept(100.1F);
+
+  // Assert
+  EXPECT_FALSE(spikeAccepted);
+  EXPECT_TRUE(nextAccepted);
+  EXPECT_EQ(1UL, filter.getRejectedCount());
+}
+
+/**
+ * @brief Test case for StepIsAcceptedOnceItPersists.
+ *
+ * Given a window of steady samples.
+ * When the signal steps to a new level and stays there.
+ * Then the first samples of the step should be rejected, and the step accepted once it holds most of the window.
+ */
+TEST(HampelFilterTest, StepIsAcceptedOnceItPersists) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  HampelFilter<WINDOW> filter(THRESHOLD, MIN_DEVIATION);
+  fill(filter, 100.0F);
+  int rejectedBeforeAccepted = 0;
+
+  // Act
+  while (!filter.accept(150.0F) && rejectedBeforeAccepted < static_cast<int>(WINDOW)) {
+    rejectedBeforeAccepted++;
+  }
+
+  // Assert
+  EXPECT_EQ(static_cast<int>(WINDOW / 2 + 1), rejectedBeforeAccepted);
+}
+
+/**
+ * @brief Test case for FlatSignalKeepsMinimumDeviation.
+ *
+ * Given a window of identical samples, whose MAD is zero.
+ * When samples arrive just inside and just outside the minimum deviation.
+ * Then the first should be accepted and the second rejected.
+ */
+TEST(HampelFilterTest, FlatSignalKeepsMinimumDeviation) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  HampelFilter<WINDOW> filter(THRESHOLD, MIN_DEVIATION);
+  for (std::size_t i = 0; i < WINDOW; i++) {
+    filter.accept(10.0F);
+  }
+
+  // Act
+  bool insideAccepted = filter.accept(10.0F + MIN_DEVIATION * 0.9F);
+  bool outsideAccepted = filter.accept(10.0F + MIN_DEVIATION * 2.0F);
+
+  // Assert
+  EXPECT_TRUE(insideAccepted);
+  EXPECT_FALSE(outsideAccepted);
+}
@@ -1,84 +1,87 @@
 #include "test_constants.h"
 
-#include <constants.h>
-
-// Define constants for array sizes
-namespace {
-constexpr size_t HEATER_COUNT = 3;
-}
-
 #include <array>
+#include <constants.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <heater_controller.h>
+#include <memory>
+#include <relay.h>
 
-// Define UNIT_TEST if not already defined
-#ifndef UNIT_TEST
-#define UNIT_TEST
-#endif
+// Include the mock Arduino functions
+#include "mock_arduino.h"
 
-// Forward declaration of the test class to ensure proper compilation
-class HeaterControllerTest;
+namespace {
+constexpr size_t HEATER_COUNT = 3;
+constexpr double MS_PER_SECOND = 1000.0;
+constexpr std::array<int, HEATER_COUNT> HEATER_PINS = {HEATER_RELAY_1_PIN, HEATER_RELAY_2_PIN, HEATER_RELAY_3_PIN};
+} // namespace
 
-// Conditional includes based on test vs. production environment
-#ifdef UNIT_TEST
-// Test environment - use mock classes
+using ::testing::_;
 
-// Mock Relay class
-// This mocks the Relay class from src/relay.h
-class MockRelay {
-public:
-  MOCK_METHOD(void, turnOn, (), ());
-  MOCK_METHOD(void, turnOff, (), ());
-};
+// Drives the real HeaterController through real Relays, following their pins on the mock digitalWrite
+class HeaterControllerTest
+  : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  std::unique_ptr<Relay> relay1;
+  std::unique_ptr<Relay> relay2;
+  std::unique_ptr<Relay> relay3;
+  std::unique_ptr<HeaterController> heaterController;
+
+  std::array<bool, HEATER_COUNT> relayOn{};
+  std::array<int, HEATER_COUNT> relaySwitches{};
+
+  void SetUp() override {
+    ArduinoMockFixture::reset();
+    ArduinoMock::setMillis(0);
+    EXPECT_CALL(ArduinoMockFixture::mockPinMode(), Call(_, _)).Times(::testing::AnyNumber());
+    EXPECT_CALL(ArduinoMockFixture::mockDigitalWrite(), Call(_, _))
+        .WillRepeatedly([this](int pin, int value) { recordWrite(pin, value); });
+    relay1 = std::make_unique<Relay>(HEATER_RELAY_1_PIN);
+    relay2 = std::make_unique<Relay>(HEATER_RELAY_2_PIN);
+    relay3 = std::make_unique<Relay>(HEATER_RELAY_3_PIN);
+    resetController();
+  }
 
-// Modified HeaterController for testing
-// This is a testable version of the HeaterController class from src/heater_controller.h
-// In a production environment, we would use conditional compilation in the original class
-class TestableHeaterController {
-private:
-  std::array<MockRelay *, HEATER_COUNT> heaters;
-  int power{0};
-
-public:
-  TestableHeaterController(MockRelay &relay1, MockRelay &relay2, MockRelay &relay3)
-    : heaters{&relay1, &relay2, &relay3} {}
-
-  void setPower(int power) {
-    this->power = power;
-    int remainingPower = power;
-
-    // Determine the state of each heater
-    std::array<bool, HEATER_COUNT> heaterStates = {false, false, false};
-    for (int i = 2; i >= 0; i--) {
-      int heaterPower = (i + 1) * HEATER_POWER_LEVEL_1;
-      if (remainingPower >= heaterPower) {
-        heaterStates[i] = true; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-        remainingPower -= heaterPower;
-      }
-    }
+  void TearDown() override { ArduinoMockFixture::reset(); }
+
+  // Starts over with a new controller on relays that are all off, at time zero
+  void resetController() {
+    relay1->turnOff();
+    relay2->turnOff();
+    relay3->turnOff();
+    ArduinoMock::setMillis(0);
+    heaterController = std::make_unique<HeaterController>(*relay1, *relay2, *relay3);
+    relayOn.fill(false);
+    relaySwitches.fill(0);
+  }
 
-    // Update the state of each heater
-    for (size_t i = 0; i < heaters.size(); i++) {
-      if (heaterStates[i]) {  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-        heaters[i]->turnOn(); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-      } else {
-        heaters[i]->turnOff(); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  // Follows the level of each heater pin, counting the times it actually changes
+  void recordWrite(int pin, int value) {
+    bool on = value == HIGH;
+    for (size_t i = 0; i < HEATER_COUNT; i++) {
+      if (HEATER_PINS.at(i) == pin && relayOn.at(i) != on) {
+        relayOn.at(i) = on;
+        relaySwitches.at(i)++;
       }
     }
   }
 
-  [[nodiscard]] int getPower() const { return power; }
-};
+  void expectRelays(bool heater1, bool heater2, bool heater3) const {
+    EXPECT_EQ(heater1, relayOn[0]);
+    EXPECT_EQ(heater2, relayOn[1]);
+    EXPECT_EQ(heater3, relayOn[2]);
+  }
 
-class HeaterControllerTest
-  : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
-protected:
-  MockRelay relay1;
-  MockRelay relay2;
-  MockRelay relay3;
-  std::unique_ptr<TestableHeaterController> heaterController;
+  // Runs burst fire for a number of windows, updating once a second
+  void runBurstFire(unsigned long windows) {
+    for (unsigned long t = 0; t < windows * HEATER_BURST_WINDOW_MS; t += BURST_UPDATE_INTERVAL_MS) {
+      heaterController->update();
+      ArduinoMock::advanceMillis(BURST_UPDATE_INTERVAL_MS);
+    }
+  }
 
-  void SetUp() override { heaterController = std::make_unique<TestableHeaterController>(relay1, relay2, relay3); }
+  static constexpr unsigned long BURST_UPDATE_INTERVAL_MS = 1000;
 };
 
 /**
@@ -95,20 +98,19 @@ TEST_F(HeaterControllerTest, InitialPowerIsZero) { // NOLINT(cppcoreguidelines-o
 /**
  * @brief Test case for SetPowerZeroTurnsOffAllHeaters.
  *
- * Given a HeaterController object.
+ * Given a HeaterController with all heaters on.
  * When the power is set to zero.
  * Then all heaters should be turned off.
  */
 TEST_F(HeaterControllerTest, SetPowerZeroTurnsOffAllHeaters) { // NOLINT(cppcoreguidelines-owning-memory)
   // Arrange
-  EXPECT_CALL(relay1, turnOff()).Times(1);
-  EXPECT_CALL(relay2, turnOff()).Times(1);
-  EXPECT_CALL(relay3, turnOff()).Times(1);
+  heaterController->setPower(heater::POWER_LEVEL_MAX);
 
   // Act
   heaterController->setPower(0);
 
   // Assert
+  expectRelays(false, false, false);
   EXPECT_EQ(0, heaterController->getPower());
 }
 
@@ -120,15 +122,11 @@ TEST_F(HeaterControllerTest, SetPowerZeroTurnsOffAllHeaters) { // NOLINT(cppcore
  * Then only heater 1 should be turned on.
  */
 TEST_F(HeaterControllerTest, SetPower1000TurnsOnHeater1Only) { // NOLINT(cppcoreguidelines-owning-memory)
-  // Arrange
-  EXPECT_CALL(relay1, turnOn()).Times(1);
-  EXPECT_CALL(relay2, turnOff()).Times(1);
-  EXPECT_CALL(relay3, turnOff()).Times(1);
-
   // Act
   heaterController->setPower(heater::POWER_LEVEL_1);
 
   // Assert
+  expectRelays(true, false, false);
   EXPECT_EQ(heater::POWER_LEVEL_1, heaterController->getPower());
 }
 
@@ -140,15 +138,11 @@ TEST_F(HeaterControllerTest, SetPower1000TurnsOnHeater1Only) { // NOLINT(cppcore
  * Then only heater 2 should be turned on.
  */
 TEST_F(HeaterControllerTest, SetPower2000TurnsOnHeater2Only) { // NOLINT(cppcoreguidelines-owning-memory)
-  // Arrange
-  EXPECT_CALL(relay1, turnOff()).Times(1);
-  EXPECT_CALL(relay2, turnOn()).Times(1);
-  EXPECT_CALL(relay3, turnOff()).Times(1);
-
   // Act
   heaterController->setPower(heater::POWER_LEVEL_2);
 
   // Assert
+  expectRelays(false, true, false);
   EXPECT_EQ(heater::POWER_LEVEL_2, heaterController->getPower());
 }
 
@@ -160,15 +154,11 @@ TEST_F(HeaterControllerTest, SetPower2000TurnsOnHeater2Only) { // NOLINT(cppcore
  * Then only heater 3 should be turned on.
  */
 TEST_F(HeaterControllerTest, SetPower3000TurnsOnHeater3Only) { // NOLINT(cppcoreguidelines-owning-memory)
-  // Arrange
-  EXPECT_CALL(relay1, turnOff()).Times(1);
-  EXPECT_CALL(relay2, turnOff()).Times(1);
-  EXPECT_CALL(relay3, turnOn()).Times(1);
-
   // Act
   heaterController->setPower(heater::POWER_LEVEL_3);
 
   // Assert
+  expectRelays(false, false, true);
   EXPECT_EQ(heater::POWER_LEVEL_3, heaterController->getPower());
 }
 
@@ -180,15 +170,11 @@ TEST_F(HeaterControllerTest, SetPower3000TurnsOnHeater3Only) { // NOLINT(cppcore
  * Then only heater 3 should be turned on (as it's the highest power heater).
  */
 TEST_F(HeaterControllerTest, SetPower3001TurnsOnHeater3Only) { // NOLINT(cppcoreguidelines-owning-memory)
-  // Arrange
-  EXPECT_CALL(relay1, turnOff()).Times(1);
-  EXPECT_CALL(relay2, turnOff()).Times(1);
-  EXPECT_CALL(relay3, turnOn()).Times(1);
-
   // Act
   heaterController->setPower(heater::POWER_LEVEL_OVER_MAX);
 
   // Assert
+  expectRelays(false, false, true);
   EXPECT_EQ(heater::POWER_LEVEL_OVER_MAX, heaterController->getPower());
 }
 
@@ -200,16 +186,101 @@ TEST_F(HeaterControllerTest, SetPower3001TurnsOnHeater3Only) { // NOLINT(cppcore
  * Then all heaters should be turned on.
  */
 TEST_F(HeaterControllerTest, SetPower6000TurnsOnAllHeaters) { // NOLINT(cppcoreguidelines-owning-memory)
-  // Arrange
-  EXPECT_CALL(relay1, turnOn()).Times(1);
-  EXPECT_CALL(relay2, turnOn()).Times(1);
-  EXPECT_CALL(relay3, turnOn()).Times(1);
-
   // Act
   heaterController->setPower(heater::POWER_LEVEL_MAX);
 
   // Assert
+  expectRelays(true, true, true);
   EXPECT_EQ(heater::POWER_LEVEL_MAX, heaterController->getPower());
 }
 
-#endif // UNIT_TEST
+/**
+ * @brief Test case for BurstFireDeliversRequestedEnergy.
+ *
+ * Given a HeaterController in burst-fire mode at powers between the stage sums.
+ * When it runs for ten windows.
+ * Then the delivered energy should be the requested power over that time, within one minimum dwell of one stage.
+ */
+TEST_F(HeaterControllerTest, BurstFireDeliversRequestedEnergy) { // NOLINT(cppcoreguidelines-owning-memory)
+  constexpr unsigned long WINDOWS = 10;
+  for (int power : {2500, 4020, 5990}) {
+    // Arrange
+    resetController();
+    heaterController->setBurstFirePower(power);
+
+    // Act
+    runBurstFire(WINDOWS);
+
+    // Assert
+    double seconds = static_cast<double>(WINDOWS * HEATER_BURST_WINDOW_MS) / MS_PER_SECOND;
+    double dwellEnergy = heater::POWER_LEVEL_1 * static_cast<double>(HEATER_MIN_DWELL_MS) / MS_PER_SECOND;
+    EXPECT_EQ(power, heaterController->getPower());
+    EXPECT_NEAR(power * seconds, heaterController->getDeliveredEnergy(), dwellEnergy) << "power " << power;
+  }
+}
+
+/**
+ * @brief Test case for BurstFireRespectsContactLife.
+ *
+ * Given a HeaterController in burst-fire mode at a power whose two stage sums share no relay.
+ * When it runs for ten windows.
+ * Then no relay should switch more than twice per window.
+ */
+TEST_F(HeaterControllerTest, BurstFireRespectsContactLife) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr unsigned long WINDOWS = 10;
+  heaterController->setBurstFirePower(2500); // Alternates between stage 2 and stage 3
+
+  // Act
+  runBurstFire(WINDOWS);
+
+  // Assert
+  for (int switches : relaySwitches) {
+    EXPECT_LE(switches, static_cast<int>(2 * WINDOWS));
+  }
+  EXPECT_GT(relaySwitches[1], 0);
+  EXPECT_GT(relaySwitches[2], 0);
+}
+
+/**
+ * @brief Test case for BurstFireAtStageSumHoldsRelays.
+ *
+ * Given a HeaterController in burst-fire mode at a power that is a sum of stages.
+ * When it runs for several windows.
+ * Then the stages should switch once, to that sum, and stay there.
+ */
+TEST_F(HeaterControllerTest, BurstFireAtStageSumHoldsRelays) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  heaterController->setBurstFirePower(heater::POWER_LEVEL_2);
+
+  // Act
+  runBurstFire(3);
+
+  // Assert
+  EXPECT_EQ(heater::POWER_LEVEL_2, heaterController->getAppliedPower());
+  EXPECT_EQ(0, relaySwitches[0]);
+  EXPECT_EQ(1, relaySwitches[1]);
+  EXPECT_EQ(0, relaySwitches[2]);
+}
+
+/**
+ * @brief Test case for SetPowerLeavesBurstFire.
+ *
+ * Given a HeaterController in burst-fire mode.
+ * When a stage sum is set with setPower.
+ * Then that sum should be applied at once and stay applied through later updates.
+ */
+TEST_F(HeaterControllerTest, SetPowerLeavesBurstFire) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  heaterController->setBurstFirePower(2500);
+  runBurstFire(1);
+
+  // Act
+  heaterController->setPower(heater::POWER_LEVEL_1);
+  runBurstFire(1);
+
+  // Assert
+  EXPECT_EQ(heater::POWER_LEVEL_1, heaterController->getPower());
+  EXPECT_EQ(heater::POWER_LEVEL_1, heaterController->getAppliedPower());
+  expectRelays(true, false, false);
+}
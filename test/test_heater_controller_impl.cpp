@@ -0,0 +1,4 @@
+#include "../lib/process_controllers/include/heater_controller.h"
+#include "../lib/process_controllers/src/heater_controller.cpp"
+
+// This file ensures the HeaterController implementation is available for tests
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <log2_histogram.h>
+
+namespace {
+constexpr unsigned long FAST_RUN_US = 300;       // Bucket 9, 256 to 511
+constexpr unsigned long BLOCKED_RUN_US = 750000; // Past the start of the last bucket
+constexpr int FAST_RUNS = 99;
+} // namespace
+
+/**
+ * @brief Test case for BucketsArePowersOfTwo.
+ *
+ * Given the bucket boundaries of a log2 histogram.
+ * When values at and around powers of two are placed.
+ * Then zero should go to bucket 0, each value to the bucket of its bit width, and huge values to the last bucket.
+ */
+TEST(Log2HistogramTest, BucketsArePowersOfTwo) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange, Act & Assert
+  EXPECT_EQ(0, Log2Histogram::bucketOf(0));
+  EXPECT_EQ(1, Log2Histogram::bucketOf(1));
+  EXPECT_EQ(2, Log2Histogram::bucketOf(2));
+  EXPECT_EQ(2, Log2Histogram::bucketOf(3));
+  EXPECT_EQ(3, Log2Histogram::bucketOf(4));
+  EXPECT_EQ(10, Log2Histogram::bucketOf(1023));
+  EXPECT_EQ(11, Log2Histogram::bucketOf(1024));
+  EXPECT_EQ(Log2Histogram::BUCKETS - 1, Log2Histogram::bucketOf(0xFFFFFFFFUL));
+  EXPECT_EQ(0UL, Log2Histogram::bucketLowerBound(0));
+  EXPECT_EQ(1024UL, Log2Histogram::bucketLowerBound(11));
+}
+
+/**
+ * @brief Test case for OneBlockedRunShowsInTheTail.
+ *
+ * Given a histogram of 99 fast runs and one run blocked for most of a second.
+ * When the median, the 99th percentile and the largest sample are read.
+ * Then the percentiles should stay within the fast runs' bucket while the maximum keeps the blocked run exactly.
+ */
+TEST(Log2HistogramTest, OneBlockedRunShowsInTheTail) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  Log2Histogram histogram;
+  for (int i = 0; i < FAST_RUNS; i++) {
+    histogram.add(FAST_RUN_US);
+  }
+
+  // Act
+  histogram.add(BLOCKED_RUN_US);
+
+  // Assert
+  EXPECT_EQ(100UL, histogram.getSampleCount());
+  EXPECT_EQ(static_cast<uint32_t>(FAST_RUNS), histogram.getCount(Log2Histogram::bucketOf(FAST_RUN_US)));
+  EXPECT_EQ(1U, histogram.getCount(Log2Histogram::BUCKETS - 1));
+  EXPECT_EQ(511UL, histogram.getPercentileBound(50));
+  EXPECT_EQ(511UL, histogram.getPercentileBound(99));
+  EXPECT_EQ(BLOCKED_RUN_US, histogram.getPercentileBound(100));
+  EXPECT_EQ(BLOCKED_RUN_US, histogram.getMax());
+}
+
+/**
+ * @brief Test case for EmptyAndResetHistogramsReadZero.
+ *
+ * Given a histogram with samples in it.
+ * When it is reset.
+ * Then every bucket, the sample count, the percentiles and the maximum should read zero, as for a new histogram.
+ */
+TEST(Log2HistogramTest, EmptyAndResetHistogramsReadZero) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  Log2Histogram histogram;
+  histogram.add(FAST_RUN_US);
+  histogram.add(0);
+
+  // Act
+  histogram.reset();
+
+  // Assert
+  EXPECT_EQ(0UL, histogram.getSampleCount());
+  EXPECT_EQ(0U, histogram.getCount(0));
+  EXPECT_EQ(0U, histogram.getCount(Log2Histogram::bucketOf(FAST_RUN_US)));
+  EXPECT_EQ(0UL, histogram.getPercentileBound(99));
+  EXPECT_EQ(0UL, histogram.getMax());
+}
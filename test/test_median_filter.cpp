@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <array>
+#include <gtest/gtest.h>
+#include <median_filter.h>
+#include <vector>
+
+namespace {
+constexpr std::size_t WINDOW = 5;
+constexpr std::size_t WIDE_WINDOW = 31;
+constexpr int SAMPLE_COUNT = 500;
+
+// Reference median: copies and sorts the last `window` samples
+float bruteForceMedian(const std::vector<float> &samples, std::size_t window) {
+  std::vector<float> tail(samples.end() - static_cast<std::ptrdiff_t>(window), samples.end());
+  std::sort(tail.begin(), tail.end());
+  return tail[window / 2];
+}
+} // namespace
+
+/**
+ * @brief Test case for MedianOfFullWindow.
+ *
+ * Given a median filter with a window of 5 samples.
+ * When 5 unordered samples are added.
+ * Then the median should be the middle value and the last sample should be the most recent one.
+ */
+TEST(MedianFilterTest, MedianOfFullWindow) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  MedianFilter<float, WINDOW> filter;
+
+  // Act
+  for (float sample : {10.0F, 30.0F, 20.0F, 15.0F, 25.0F}) {
+    filter.add(sample);
+  }
+
+  // Assert
+  EXPECT_TRUE(filter.isFull());
+  EXPECT_FLOAT_EQ(20.0F, filter.median());
+  EXPECT_FLOAT_EQ(25.0F, filter.last());
+}
+
+/**
+ * @brief Test case for PartialWindowUsesReceivedSamplesOnly.
+ *
+ * Given an empty median filter.
+ * When fewer samples than the window size are added.
+ * Then the median should be taken over the received samples only, not over empty slots.
+ */
+TEST(MedianFilterTest, PartialWindowUsesReceivedSamplesOnly) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  MedianFilter<float, WINDOW> filter;
+  EXPECT_FLOAT_EQ(0.0F, filter.median());
+
+  // Act
+  filter.add(80.0F);
+  filter.add(82.0F);
+  filter.add(81.0F);
+
+  // Assert
+  EXPECT_FALSE(filter.isFull());
+  EXPECT_EQ(3U, filter.size());
+  EXPECT_FLOAT_EQ(81.0F, filter.median());
+}
+
+/**
+ * @brief Test case for SpreadCoversTheWindowOnly.
+ *
+ * Given a median filter that has seen a wide swing followed by a window of close samples.
+ * When its spread is read before and after the swing leaves the window.
+ * Then the spread should first include the swing and then cover only the close samples.
+ */
+TEST(MedianFilterTest, SpreadCoversTheWindowOnly) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  MedianFilter<float, WINDOW> filter;
+  EXPECT_FLOAT_EQ(0.0F, filter.spread());
+
+  // Act
+  filter.add(10.0F);
+  for (std::size_t i = 1; i < WINDOW; i++) {
+    filter.add(50.0F + static_cast<float>(i));
+  }
+  float spreadWithSwing = filter.spread();
+  filter.add(52.5F);
+
+  // Assert
+  EXPECT_FLOAT_EQ(44.0F, spreadWithSwing);
+  EXPECT_FLOAT_EQ(3.0F, filter.spread());
+}
+
+/**
+ * @brief Test case for SlidingWindowMatchesSortedCopy.
+ *
+ * Given a wide median filter fed a long sequence of noisy samples with many duplicates.
+ * When each sample is added.
+ * Then the median should always equal the median of a sorted copy of the last N samples.
+ */
+TEST(MedianFilterTest, SlidingWindowMatchesSortedCopy) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  MedianFilter<float, WIDE_WINDOW> filter;
+  std::vector<float> samples;
+  unsigned int seed = 12345U;
+
+  // Act & Assert
+  for (int i = 0; i < SAMPLE_COUNT; i++) {
+    seed = seed * 1103515245U + 12345U; // Deterministic LCG noise, quantized so values repeat
+    float sample = static_cast<float>(i / 10) + static_cast<float>((seed >> 16) % 8) * 0.25F;
+    samples.push_back(sample);
+    filter.add(sample);
+    if (samples.size() >= WIDE_WINDOW) {
+      ASSERT_FLOAT_EQ(bruteForceMedian(samples, WIDE_WINDOW), filter.median()) << "after sample " << i;
+    }
+  }
+}
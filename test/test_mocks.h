@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <hardware_interfaces.h>
@@ -48,6 +49,10 @@ public:
     return false; // No incoming data in mock
   }
 
+  int read() override {
+    return -1; // No incoming data in mock
+  }
+
   static void reset() {
     logs.clear();
     initialized = false;
@@ -95,6 +100,27 @@ public:
   }
 };
 
+// In-memory block storage for the stores built on BlockStore; keeps the block and counts the writes
+class MemoryBlockStorage : public IBlockStorage {
+public:
+  std::vector<uint8_t> block; // Stored bytes, empty until the first write
+  int writes = 0;             // Number of write() calls
+
+  bool read(uint8_t *data, size_t size) override {
+    if (block.size() != size) {
+      return false;
+    }
+    std::copy(block.begin(), block.end(), data);
+    return true;
+  }
+
+  bool write(const uint8_t *data, size_t size) override {
+    block.assign(data, data + size);
+    writes++;
+    return true;
+  }
+};
+
 // Helper function to check if a log message contains a substring
 inline bool containsSubstring(const std::vector<std::string> &logs, const std::string &substring) {
   for (const auto &log : logs) {
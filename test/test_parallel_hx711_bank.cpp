@@ -0,0 +1,216 @@
+#include "test_constants.h"
+
+#include <array>
+#include <constants.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+// Define UNIT_TEST if not already defined
+#ifndef UNIT_TEST
+#define UNIT_TEST
+#endif
+
+// Include the mock Arduino functions
+#include "mock_arduino.h"
+
+#include <hardware_interfaces.h>
+#include <parallel_hx711_bank.h>
+
+namespace {
+constexpr int CLOCK_PIN = 6;
+constexpr uint8_t DATA_BITS = 24;
+
+// Simulates HX711 modules on one clock line: each shifts its conversion out MSB first while its DOUT is low
+class FakeHX711BankPort : public IHX711BankPort {
+public:
+  std::array<long, HX711_BANK_MAX_CHANNELS> conversions{}; // Next value each module shifts out
+  uint8_t readyMask = 0;                                   // Modules holding DOUT low
+  int pulses = 0;                                          // Clock pulses since construction
+
+  void begin(int /*clockPin*/, const int * /*dataPins*/, uint8_t /*channelCount*/) override {}
+
+  uint8_t readDataPins() override { return static_cast<uint8_t>(~readyMask); }
+
+  uint8_t pulseClock() override {
+    int pulseInPass = pulses % ParallelHX711Bank::PULSES_PER_PASS;
+    if (pulseInPass == 0) {
+      shiftingMask = readyMask;
+    }
+    pulses++;
+
+    uint8_t levels = 0;
+    for (uint8_t i = 0; i < HX711_BANK_MAX_CHANNELS; i++) {
+      if (pulseInPass < DATA_BITS && (shiftingMask & (1U << i)) != 0) {
+        levels |= static_cast<uint8_t>(((conversions[i] >> (DATA_BITS - 1 - pulseInPass)) & 1) << i);
+      }
+    }
+    // The 25th pulse ends the read; the modules raise DOUT until their next conversion
+    if (pulseInPass == ParallelHX711Bank::PULSES_PER_PASS - 1) {
+      readyMask &= static_cast<uint8_t>(~shiftingMask);
+    }
+    return levels;
+  }
+
+  void setClock(bool /*high*/) override {}
+
+  // Finishes a conversion on every module in the mask
+  void convert(uint8_t mask) { readyMask |= mask; }
+
+private:
+  uint8_t shiftingMask = 0;
+};
+} // namespace
+
+class ParallelHX711BankTest : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  FakeHX711BankPort port;
+  std::unique_ptr<ParallelHX711Bank> bank;
+
+  void SetUp() override {
+    setMillis(0);
+    bank = std::make_unique<ParallelHX711Bank>(port, CLOCK_PIN);
+  }
+
+  void addChannels(int count) {
+    for (int i = 0; i < count; i++) {
+      bank->addChannel(i);
+    }
+    bank->begin();
+  }
+};
+
+/**
+ * @brief Test case for ReadsEveryChannelInOnePass.
+ *
+ * Given six modules with conversions waiting, including negative and full-scale values.
+ * When the bank is polled.
+ * Then one pass of 25 clock pulses should deliver each module's sign-extended conversion.
+ */
+TEST_F(ParallelHX711BankTest, ReadsEveryChannelInOnePass) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  addChannels(HX711_BANK_MAX_CHANNELS);
+  const std::array<long, HX711_BANK_MAX_CHANNELS> expected = {0, 1, -1, 0x7FFFFF, -0x800000, 123456};
+  for (uint8_t i = 0; i < HX711_BANK_MAX_CHANNELS; i++) {
+    port.conversions[i] = expected[i] & 0xFFFFFF;
+  }
+  port.convert(0x3F);
+
+  // Act
+  bool read = bank->poll();
+
+  // Assert
+  EXPECT_TRUE(read);
+  EXPECT_EQ(ParallelHX711Bank::PULSES_PER_PASS, port.pulses);
+  for (uint8_t i = 0; i < HX711_BANK_MAX_CHANNELS; i++) {
+    ASSERT_TRUE(bank->hasSample(i));
+    EXPECT_EQ(expected[i], bank->takeSample(i));
+    EXPECT_FALSE(bank->hasSample(i));
+  }
+  EXPECT_FALSE(bank->poll());
+}
+
+/**
+ * @brief Test case for PassCostDoesNotGrowWithChannels.
+ *
+ * Given banks of one to six channels.
+ * When each bank reads one conversion from every channel.
+ * Then every bank should need the same number of clock pulses.
+ */
+TEST_F(ParallelHX711BankTest, PassCostDoesNotGrowWithChannels) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  std::vector<int> pulsesPerBank;
+
+  // Act
+  for (int channels = 1; channels <= HX711_BANK_MAX_CHANNELS; channels++) {
+    FakeHX711BankPort bankPort;
+    ParallelHX711Bank channelBank(bankPort, CLOCK_PIN);
+    for (int i = 0; i < channels; i++) {
+      channelBank.addChannel(i);
+    }
+    channelBank.begin();
+    bankPort.convert(static_cast<uint8_t>((1U << channels) - 1U));
+    channelBank.poll();
+    pulsesPerBank.push_back(bankPort.pulses);
+  }
+
+  // Assert
+  for (int pulses : pulsesPerBank) {
+    EXPECT_EQ(ParallelHX711Bank::PULSES_PER_PASS, pulses);
+  }
+}
+
+/**
+ * @brief Test case for SilentChannelIsLeftOut.
+ *
+ * Given a bank where one module never finishes a conversion.
+ * When the other modules have waited longer than the read timeout.
+ * Then the bank should read them without the silent module, and take it back once it has data again.
+ */
+TEST_F(ParallelHX711BankTest, SilentChannelIsLeftOut) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  addChannels(HX711_BANK_MAX_CHANNELS);
+  constexpr uint8_t SILENT_CHANNEL = 3;
+  constexpr uint8_t OTHERS = 0x3F & ~(1U << SILENT_CHANNEL);
+  port.convert(OTHERS);
+
+  // Act
+  bool readBeforeTimeout = bank->poll();
+  advanceMillis(SCALE_READ_TIMEOUT_MS + 1);
+  bool readAfterTimeout = bank->poll();
+  uint8_t activeAfterTimeout = bank->getActiveMask();
+  port.convert(0x3F);
+  bool readAfterRecovery = bank->poll();
+
+  // Assert
+  EXPECT_FALSE(readBeforeTimeout);
+  EXPECT_TRUE(readAfterTimeout);
+  EXPECT_EQ(OTHERS, activeAfterTimeout);
+  EXPECT_TRUE(readAfterRecovery);
+  EXPECT_EQ(0x3F, bank->getActiveMask());
+  EXPECT_TRUE(bank->hasSample(SILENT_CHANNEL));
+}
+
+/**
+ * @brief Test case for ChannelsShareOnePassPerConversion.
+ *
+ * Given six bank channels used as scale interfaces, with one tared channel.
+ * When every channel is checked and read after a single conversion.
+ * Then the first check should read the whole bank, the others should find their conversions waiting, and the
+ * tared channel should report its weight in calibrated units.
+ */
+TEST_F(ParallelHX711BankTest, ChannelsShareOnePassPerConversion) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr float COUNTS_PER_GRAM = 50.0F;
+  constexpr long TARE_COUNTS = 1000;
+  std::vector<std::unique_ptr<HX711BankChannel>> channels;
+  for (int i = 0; i < HX711_BANK_MAX_CHANNELS; i++) {
+    channels.push_back(std::make_unique<HX711BankChannel>(*bank, i));
+    channels.back()->begin();
+  }
+  channels[0]->set_scale(COUNTS_PER_GRAM);
+  port.conversions.fill(TARE_COUNTS);
+  port.convert(0x3F);
+  channels[0]->tare(1);
+  for (auto &channel : channels) {
+    channel->read(); // Discard the tare conversion
+  }
+  port.conversions.fill(TARE_COUNTS + 5000);
+  port.convert(0x3F);
+
+  // Act
+  std::vector<long> raw;
+  for (auto &channel : channels) {
+    ASSERT_TRUE(channel->is_ready());
+    raw.push_back(channel->read());
+  }
+
+  // Assert
+  EXPECT_EQ(2UL, bank->getPassCount());
+  for (long value : raw) {
+    EXPECT_EQ(TARE_COUNTS + 5000, value);
+  }
+  EXPECT_FALSE(channels[0]->is_ready());
+  EXPECT_EQ(TARE_COUNTS, channels[0]->get_offset());
+  EXPECT_FLOAT_EQ(100.0F, static_cast<float>(raw[0] - channels[0]->get_offset()) / channels[0]->get_scale());
+}
@@ -0,0 +1,4 @@
+#include "../lib/hardware_abstractions/include/parallel_hx711_bank.h"
+#include "../lib/hardware_abstractions/src/parallel_hx711_bank.cpp"
+
+// This file ensures the ParallelHX711Bank implementation is available for tests
@@ -0,0 +1,262 @@
+#include <PID_v1.h>
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+
+// Define UNIT_TEST if not already defined
+#ifndef UNIT_TEST
+#define UNIT_TEST
+#endif
+
+// Include the mock Arduino functions
+#include "mock_arduino.h"
+
+namespace {
+constexpr unsigned long SAMPLE_TIME_MS = 100;
+constexpr double SAMPLE_TIME_S = 0.1;
+constexpr double PLANT_GAIN = 2.0;          // Plant output per unit of controller output, at steady state
+constexpr double PLANT_TIME_CONSTANT = 5.0; // Seconds
+constexpr double OUTPUT_MIN = 0.0;
+constexpr double OUTPUT_MAX = 100.0;
+constexpr double KP = 1.0;
+constexpr double KI = 0.2; // Integral time equal to the plant time constant
+constexpr double KD = 0.2;
+constexpr int ONE_MINUTE_SAMPLES = 600;
+} // namespace
+
+class PIDTest : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  double input{0}, output{0}, setpoint{0};
+  PID pid{&input, &output, &setpoint, KP, KI, KD, DIRECT};
+
+  void SetUp() override {
+    setMillis(0);
+    pid.SetSampleTime(SAMPLE_TIME_MS);
+    pid.SetOutputLimits(OUTPUT_MIN, OUTPUT_MAX);
+  }
+
+  // Lets one sample interval pass, computes, and advances a first-order lag plant driven by the output
+  void step() {
+    advanceMillis(SAMPLE_TIME_MS);
+    pid.Compute();
+    input += SAMPLE_TIME_S / PLANT_TIME_CONSTANT * (PLANT_GAIN * output - input);
+  }
+
+  // Runs the loop for a number of samples and returns the highest plant output seen
+  double run(int samples) {
+    double peak = input;
+    for (int i = 0; i < samples; i++) {
+      step();
+      peak = std::max(peak, input);
+    }
+    return peak;
+  }
+};
+
+/**
+ * @brief Test case for TracksSetpointOnFirstOrderPlant.
+ *
+ * Given a PID controller in AUTOMATIC driving a first-order lag plant from rest.
+ * When the loop runs for a minute after a setpoint step.
+ * Then the plant should settle on the setpoint with little overshoot.
+ */
+TEST_F(PIDTest, TracksSetpointOnFirstOrderPlant) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr double TARGET = 50.0;
+  pid.SetMode(AUTOMATIC);
+  setpoint = TARGET;
+
+  // Act
+  double peak = run(ONE_MINUTE_SAMPLES);
+
+  // Assert
+  EXPECT_NEAR(TARGET, input, 0.1);
+  EXPECT_LT(peak, TARGET * 1.05);
+}
+
+/**
+ * @brief Test case for ComputeWaitsForSampleInterval.
+ *
+ * Given a PID controller that has just computed.
+ * When Compute is called again before a full sample interval has passed.
+ * Then it should not compute until the interval is complete.
+ */
+TEST_F(PIDTest, ComputeWaitsForSampleInterval) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  pid.SetMode(AUTOMATIC);
+  setpoint = 10.0;
+  ASSERT_TRUE(pid.Compute());
+
+  // Act
+  advanceMillis(SAMPLE_TIME_MS - 1);
+  bool early = pid.Compute();
+  advanceMillis(1);
+  bool onTime = pid.Compute();
+
+  // Assert
+  EXPECT_FALSE(early);
+  EXPECT_TRUE(onTime);
+}
+
+/**
+ * @brief Test case for AntiWindupLeavesSaturationPromptly.
+ *
+ * Given a PID controller held at its upper output limit for a minute by an unreachable setpoint.
+ * When the setpoint drops to a reachable value.
+ * Then the output should leave the limit on the next sample and the plant should settle without a windup overshoot.
+ */
+TEST_F(PIDTest, AntiWindupLeavesSaturationPromptly) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr double UNREACHABLE = 500.0;
+  constexpr double TARGET = 150.0;
+  pid.SetMode(AUTOMATIC);
+  setpoint = UNREACHABLE;
+  run(ONE_MINUTE_SAMPLES);
+  ASSERT_DOUBLE_EQ(OUTPUT_MAX, output);
+
+  // Act
+  setpoint = TARGET;
+  step();
+  double firstOutput = output;
+  run(ONE_MINUTE_SAMPLES);
+
+  // Assert
+  EXPECT_LT(firstOutput, OUTPUT_MAX);
+  EXPECT_GE(output, OUTPUT_MIN);
+  EXPECT_NEAR(TARGET, input, 0.5);
+}
+
+/**
+ * @brief Test case for NoDerivativeKickOnSetpointStep.
+ *
+ * Given a PID controller with a derivative gain and a steady input.
+ * When the setpoint steps.
+ * Then the output should change by the proportional and integral terms only.
+ */
+TEST_F(PIDTest, NoDerivativeKickOnSetpointStep) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr double STEP = 10.0;
+  constexpr double INITIAL_OUTPUT = 20.0;
+  output = INITIAL_OUTPUT;
+  input = 30.0;
+  setpoint = input;
+  pid.SetMode(AUTOMATIC);
+
+  // Act
+  setpoint += STEP;
+  advanceMillis(SAMPLE_TIME_MS);
+  pid.Compute();
+
+  // Assert
+  EXPECT_NEAR(INITIAL_OUTPUT + (KP + KI * SAMPLE_TIME_S) * STEP, output, 1e-9);
+}
+
+/**
+ * @brief Test case for DerivativeFilterSmoothsNoise.
+ *
+ * Given two D-only controllers fed the same input toggling by one unit every sample, one with a derivative filter.
+ * When both compute over the same samples.
+ * Then the filtered controller's output should swing far less than the unfiltered one's.
+ */
+TEST_F(PIDTest, DerivativeFilterSmoothsNoise) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr double MIDDLE_OUTPUT = 50.0;
+  constexpr double FILTER_TIME_S = 1.0;
+  constexpr int SAMPLES = 50;
+  double filteredOutput = MIDDLE_OUTPUT;
+  PID filtered(&input, &filteredOutput, &setpoint, 0.0, 0.0, KD, DIRECT);
+  PID unfiltered(&input, &output, &setpoint, 0.0, 0.0, KD, DIRECT);
+  for (PID *controller : {&filtered, &unfiltered}) {
+    controller->SetSampleTime(SAMPLE_TIME_MS);
+    controller->SetOutputLimits(OUTPUT_MIN, OUTPUT_MAX);
+  }
+  filtered.SetDerivativeFilter(FILTER_TIME_S);
+  output = MIDDLE_OUTPUT;
+  filtered.SetMode(AUTOMATIC);
+  unfiltered.SetMode(AUTOMATIC);
+
+  // Act
+  double filteredSwing = 0.0;
+  double unfilteredSwing = 0.0;
+  for (int i = 0; i < SAMPLES; i++) {
+    input = i % 2 == 0 ? 1.0 : 0.0;
+    advanceMillis(SAMPLE_TIME_MS);
+    filtered.Compute();
+    unfiltered.Compute();
+    filteredSwing = std::max(filteredSwing, std::fabs(filteredOutput - MIDDLE_OUTPUT));
+    unfilteredSwing = std::max(unfilteredSwing, std::fabs(output - MIDDLE_OUTPUT));
+  }
+
+  // Assert
+  EXPECT_LT(filteredSwing, unfilteredSwing / 4.0);
+}
+
+/**
+ * @brief Test case for DefaultDerivativeFilterFollowsGains.
+ *
+ * Given a PD controller left with the default derivative filter, one filtered at Td / 10 by hand and one all but
+ * unfiltered.
+ * When all three compute over the same noisy input.
+ * Then the default should match the hand-set Td / 10 filter and differ from the unfiltered controller.
+ */
+TEST_F(PIDTest, DefaultDerivativeFilterFollowsGains) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr double MIDDLE_OUTPUT = 50.0;
+  constexpr double NEGLIGIBLE_FILTER_S = 1e-9;
+  constexpr int SAMPLES = 10;
+  double handSetOutput = MIDDLE_OUTPUT;
+  double unfilteredOutput = MIDDLE_OUTPUT;
+  output = MIDDLE_OUTPUT;
+  setpoint = 0.5;
+  PID byDefault(&input, &output, &setpoint, KP, 0.0, KD, DIRECT);
+  PID handSet(&input, &handSetOutput, &setpoint, KP, 0.0, KD, DIRECT);
+  PID unfiltered(&input, &unfilteredOutput, &setpoint, KP, 0.0, KD, DIRECT);
+  handSet.SetDerivativeFilter(KD / KP / 10.0);
+  unfiltered.SetDerivativeFilter(NEGLIGIBLE_FILTER_S);
+  for (PID *controller : {&byDefault, &handSet, &unfiltered}) {
+    controller->SetSampleTime(SAMPLE_TIME_MS);
+    controller->SetOutputLimits(-OUTPUT_MAX, OUTPUT_MAX);
+    controller->SetMode(AUTOMATIC);
+  }
+
+  // Act
+  double largestGap = 0.0;
+  for (int i = 0; i < SAMPLES; i++) {
+    input = i % 2 == 0 ? 1.0 : 0.0;
+    advanceMillis(SAMPLE_TIME_MS);
+    byDefault.Compute();
+    handSet.Compute();
+    unfiltered.Compute();
+    largestGap = std::max(largestGap, std::fabs(output - unfilteredOutput));
+    ASSERT_NEAR(handSetOutput, output, 1e-9);
+  }
+
+  // Assert
+  EXPECT_GT(largestGap, 0.1);
+}
+
+/**
+ * @brief Test case for BumplessTransferToAutomatic.
+ *
+ * Given a PID controller in MANUAL whose output was set by hand, with the input on the setpoint.
+ * When it is switched to AUTOMATIC and computes.
+ * Then the output should stay where it was set, rather than jump to what the integral held before.
+ */
+TEST_F(PIDTest, BumplessTransferToAutomatic) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr double MANUAL_OUTPUT = 42.0;
+  input = 25.0;
+  setpoint = input;
+  output = MANUAL_OUTPUT;
+  ASSERT_FALSE(pid.Compute());
+
+  // Act
+  pid.SetMode(AUTOMATIC);
+  advanceMillis(SAMPLE_TIME_MS);
+  bool computed = pid.Compute();
+
+  // Assert
+  EXPECT_TRUE(computed);
+  EXPECT_EQ(AUTOMATIC, pid.GetMode());
+  EXPECT_DOUBLE_EQ(MANUAL_OUTPUT, output);
+}
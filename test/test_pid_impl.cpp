@@ -0,0 +1,4 @@
+#include "../lib/utilities/include/PID_v1.h"
+#include "../lib/utilities/src/PID_v1.cpp"
+
+// This file ensures the PID implementation is available for tests
@@ -0,0 +1,37 @@
+#include "test_mocks.h"
+
+#include <constants.h>
+#include <gtest/gtest.h>
+#include <probe_store.h>
+
+/**
+ * @brief Test case for PositionsSurviveAPowerCycle.
+ *
+ * Given a store with the ROM codes of the mash tun and top probes, saved to the storage.
+ * When a new store loads the storage, as after a power cycle.
+ * Then both ROM codes should come back at their positions, and the other positions should have none.
+ */
+TEST(ProbeStoreTest, PositionsSurviveAPowerCycle) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  MemoryBlockStorage storage;
+  const ProbeAddress mashTun = {{0x28, 0xFF, 0x4C, 0x91, 0x61, 0x16, 0x04, 0x7A}};
+  const ProbeAddress top = {{0x28, 0xFF, 0x02, 0x3B, 0x62, 0x16, 0x03, 0xC1}};
+  ProbeStore before(storage);
+  before.set(MASH_TUN_THERMOMETER_PROBE, mashTun);
+  before.set(TOP_THERMOMETER_PROBE, top);
+  ASSERT_TRUE(before.save());
+
+  // Act
+  ProbeStore after(storage);
+  bool loaded = after.load();
+
+  // Assert
+  EXPECT_TRUE(loaded);
+  ProbeAddress address{};
+  ASSERT_TRUE(after.get(MASH_TUN_THERMOMETER_PROBE, address));
+  EXPECT_TRUE(address == mashTun);
+  ASSERT_TRUE(after.get(TOP_THERMOMETER_PROBE, address));
+  EXPECT_TRUE(address == top);
+  EXPECT_FALSE(after.get(BOTTOM_THERMOMETER_PROBE, address));
+  EXPECT_FALSE(after.get(THERMOMETER_PROBE_POSITIONS, address));
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <rate_group.h>
+#include <string>
+
+namespace {
+constexpr unsigned long BUDGET_US = 10000;
+constexpr unsigned long SLOW_RUN_US = 15000; // Spends the whole budget in one run
+constexpr uint16_t EVERY_THIRD_TICK = 3;
+
+// Virtual time for the group under test, and a record of the members it ran
+unsigned long virtualMicros = 0;
+unsigned long virtualTimer() { return virtualMicros; }
+std::string runOrder;
+unsigned long slowRunUs = 0;
+
+void runOutput() {
+  runOrder += 'O';
+  virtualMicros += slowRunUs;
+}
+void runControl() { runOrder += 'C'; }
+void runReport() { runOrder += 'R'; }
+
+// Highest priority first; the report runs on every third tick
+const RateGroupMember MEMBERS[] = {
+    {"output", runOutput, 1},
+    {"control", runControl, 0},
+    {"report", runReport, EVERY_THIRD_TICK},
+};
+constexpr std::size_t MEMBER_COUNT = sizeof(MEMBERS) / sizeof(MEMBERS[0]);
+} // namespace
+
+class RateGroupTest : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  RateGroup group{"test", MEMBERS, MEMBER_COUNT, BUDGET_US, virtualTimer};
+
+  void SetUp() override {
+    virtualMicros = 0;
+    runOrder.clear();
+    slowRunUs = 0;
+  }
+
+  // Runs a number of ticks, marking the end of each in the run order
+  void runTicks(int count) {
+    for (int i = 0; i < count; i++) {
+      group.run();
+      runOrder += '|';
+    }
+  }
+};
+
+/**
+ * @brief Test case for MembersRunInPriorityOrderAtTheirDividers.
+ *
+ * Given a group with two members due every tick and one due every third tick, all well within budget.
+ * When six ticks are run.
+ * Then every member should run in table order on the ticks it is due, and nothing should be shed.
+ */
+TEST_F(RateGroupTest, MembersRunInPriorityOrderAtTheirDividers) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Act
+  runTicks(6);
+
+  // Assert
+  EXPECT_EQ("OCR|OC|OC|OCR|OC|OC|", runOrder);
+  EXPECT_EQ(6UL, group.getTickCount());
+  EXPECT_EQ(0UL, group.getOverBudgetCount());
+}
+
+/**
+ * @brief Test case for SpentBudgetShedsLowerPriorityMembersToTheNextTick.
+ *
+ * Given a group whose top member spends the whole budget.
+ * When a tick is run on which every member is due, and then a tick with the top member quick again.
+ * Then the first tick should run only the top member, and the second should run the shed members, the every-third
+ * member included although its divider has not come round.
+ */
+TEST_F(RateGroupTest, SpentBudgetShedsLowerPriorityMembersToTheNextTick) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  slowRunUs = SLOW_RUN_US;
+
+  // Act
+  runTicks(1);
+  slowRunUs = 0;
+  runTicks(1);
+
+  // Assert
+  EXPECT_EQ("O|OCR|", runOrder);
+  EXPECT_EQ(1UL, group.getOverBudgetCount());
+  EXPECT_EQ(0UL, group.getShedCount(0));
+  EXPECT_EQ(1UL, group.getShedCount(1));
+  EXPECT_EQ(1UL, group.getShedCount(2));
+  EXPECT_EQ(SLOW_RUN_US, group.getWorstRunUs(0));
+  EXPECT_EQ(SLOW_RUN_US, group.getWorstTickUs());
+}
+
+/**
+ * @brief Test case for FirstDueMemberAlwaysRuns.
+ *
+ * Given a group with no budget at all.
+ * When ticks are run.
+ * Then each tick should still run its top member, so the group makes progress, and shed the rest.
+ */
+TEST_F(RateGroupTest, FirstDueMemberAlwaysRuns) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  RateGroup starved{"starved", MEMBERS, MEMBER_COUNT, 0, virtualTimer};
+
+  // Act
+  unsigned int runs = starved.run();
+
+  // Assert
+  EXPECT_EQ(1U, runs);
+  EXPECT_EQ("O", runOrder);
+  EXPECT_EQ(1UL, starved.getOverBudgetCount());
+  EXPECT_STREQ("control", starved.getMember(1).name);
+}
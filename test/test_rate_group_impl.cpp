@@ -0,0 +1,4 @@
+#include "../lib/utilities/include/rate_group.h"
+#include "../lib/utilities/src/rate_group.cpp"
+
+// This file ensures the RateGroup implementation is available for tests
@@ -0,0 +1,124 @@
+#include <constants.h>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <recipe.h>
+
+namespace {
+// Parses a null-terminated recipe over a recipe
+RecipeParseResult parse(const char *text, Recipe &recipe) { return parseRecipe(text, std::strlen(text), recipe); }
+} // namespace
+
+class RecipeTest : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  Recipe recipe = defaultRecipe();
+};
+
+/**
+ * @brief Test case for SettingsOverrideDefaults.
+ *
+ * Given the built-in recipe and a file with comments, blank lines and Windows line endings.
+ * When the file is parsed.
+ * Then the settings it gives should replace the built-in ones, the rest should keep their built-in values, and the
+ * raw thresholds should follow the Celsius ones.
+ */
+TEST_F(RecipeTest, SettingsOverrideDefaults) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  const char *text = "# Rye mash\r\n"
+                     "\r\n"
+                     "hearts_ml = 4200   # smaller wash\r\n"
+                     "high_flow_ml_per_min=28.5\r\n"
+                     "heat_up_power_w = 4000\r\n"
+                     "stabilizing_power_w = 2500\r\n"
+                     "heat_up_end_c = 45.5\r\n";
+
+  // Act
+  RecipeParseResult result = parse(text, recipe);
+
+  // Assert
+  EXPECT_EQ(RECIPE_OK, result.error);
+  EXPECT_FLOAT_EQ(4200.0F, recipe.getFractionVolumeMl(HEARTS));
+  EXPECT_FLOAT_EQ(28.5F, recipe.highFlowRateMlPerMin);
+  EXPECT_EQ(4000, recipe.heatUpPower);
+  EXPECT_EQ(2500, recipe.stabilizingPower); // Burst fire applies any power, so it need not be a stage sum
+  EXPECT_EQ(celsiusToRaw(45.5F), recipe.heatUpEndTemperatureRaw);
+  EXPECT_FLOAT_EQ(HEADS_VOLUME_ML, recipe.getFractionVolumeMl(HEADS));
+  EXPECT_FLOAT_EQ(LOW_FLOW_RATE_ML_PER_MIN, recipe.lowFlowRateMlPerMin);
+  EXPECT_EQ(TEMPERATURE_STABILIZATION_THRESHOLD_RAW, recipe.stabilizationThresholdRaw);
+}
+
+/**
+ * @brief Test case for FaultyLinesAreRejected.
+ *
+ * Given files that each have one faulty line after a valid one.
+ * When each file is parsed.
+ * Then it should be rejected with the fault and the line it is on, and the recipe left as it was.
+ */
+TEST_F(RecipeTest, FaultyLinesAreRejected) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  struct Case {
+    const char *text;
+    RecipeError error;
+  };
+  const Case cases[] = {
+      {"heads_ml = 800\nhearts_ml 4000\n", RECIPE_SYNTAX_ERROR},
+      {"heads_ml = 800\nhearts_ml = 4e3\n", RECIPE_SYNTAX_ERROR},
+      {"heads_ml = 800\nheat_up_power_w = 2500.5\n", RECIPE_SYNTAX_ERROR},
+      {"heads_ml = 800\nhearts_litres = 4\n", RECIPE_UNKNOWN_KEY},
+      {"heads_ml = 800\nheads_ml = 900\n", RECIPE_DUPLICATE_KEY},
+      {"heads_ml = 800\nlow_flow_ml_per_min = 0\n", RECIPE_OUT_OF_RANGE},
+      {"heads_ml = 800\nheat_up_power_w = 9000\n", RECIPE_OUT_OF_RANGE},
+      {"heads_ml = 800\nheat_up_power_w = 2500\n", RECIPE_OFF_STEP},
+  };
+  const Recipe original = recipe;
+
+  for (const Case &faulty : cases) {
+    // Act
+    RecipeParseResult result = parse(faulty.text, recipe);
+
+    // Assert
+    EXPECT_EQ(faulty.error, result.error) << faulty.text;
+    EXPECT_EQ(2, result.line) << faulty.text;
+    EXPECT_FLOAT_EQ(original.headsVolumeMl, recipe.headsVolumeMl) << faulty.text;
+  }
+}
+
+/**
+ * @brief Test case for ContradictorySettingsAreRejected.
+ *
+ * Given a file whose flow rates are each in range, but with the low rate above the high one.
+ * When the file is parsed.
+ * Then it should be rejected as inconsistent, and the recipe left as it was.
+ */
+TEST_F(RecipeTest, ContradictorySettingsAreRejected) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  const char *text = "low_flow_ml_per_min = 40\nhigh_flow_ml_per_min = 30\n";
+
+  // Act
+  RecipeParseResult result = parse(text, recipe);
+
+  // Assert
+  EXPECT_EQ(RECIPE_INCONSISTENT, result.error);
+  EXPECT_EQ(0, result.line);
+  EXPECT_FLOAT_EQ(LOW_FLOW_RATE_ML_PER_MIN, recipe.lowFlowRateMlPerMin);
+  EXPECT_FLOAT_EQ(HIGH_FLOW_RATE_ML_PER_MIN, recipe.highFlowRateMlPerMin);
+}
+
+/**
+ * @brief Test case for ParsingStopsAtLength.
+ *
+ * Given a buffer whose recipe is followed by bytes that are not part of the file, with no terminating null.
+ * When the file's length of the buffer is parsed.
+ * Then only the file should be read, including a last line with no newline.
+ */
+TEST_F(RecipeTest, ParsingStopsAtLength) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  const char buffer[] = {'f', 'i', 'n', 'a', 'l', 'i', 'z', 'e', '_', 'm', 'i', 'n', '=', '1', '5', '9', '!'};
+  const std::size_t fileLength = 15;
+
+  // Act
+  RecipeParseResult result = parseRecipe(buffer, fileLength, recipe);
+
+  // Assert
+  EXPECT_EQ(RECIPE_OK, result.error);
+  EXPECT_EQ(15, recipe.finalizeMinutes);
+}
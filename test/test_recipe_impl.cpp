@@ -0,0 +1,4 @@
+#include "../lib/utilities/include/recipe.h"
+#include "../lib/utilities/src/recipe.cpp"
+
+// This file ensures the recipe parser implementation is available for tests
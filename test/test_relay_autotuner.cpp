@@ -0,0 +1,128 @@
+#include <cmath>
+#include <deque>
+#include <gtest/gtest.h>
+#include <relay_autotuner.h>
+
+namespace {
+constexpr unsigned long STEP_MS = 10;
+constexpr double STEP_S = 0.01;
+constexpr double PLANT_GAIN = 1.0;  // Process value change per second per unit of output
+constexpr double DEAD_TIME_S = 2.0; // Delay between the output and its effect
+constexpr double RELAY_AMPLITUDE = 1.0;
+constexpr double HYSTERESIS = 0.1;
+constexpr double SETPOINT = 20.0;
+constexpr unsigned long TIMEOUT_MS = 120000;
+constexpr double PI = 3.14159265358979;
+} // namespace
+
+class RelayAutotunerTest : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  RelayAutotuner autotuner;
+  double processValue{SETPOINT};
+  std::deque<double> delayedOutputs;
+  unsigned long now{0};
+
+  void SetUp() override {
+    delayedOutputs.assign(static_cast<size_t>(DEAD_TIME_S / STEP_S), 0.0);
+    autotuner.start(SETPOINT, 0.0, RELAY_AMPLITUDE, HYSTERESIS, TIMEOUT_MS, now);
+  }
+
+  // Runs an integrating process with dead time under the relay until the experiment ends or the time runs out
+  void run(unsigned long durationMs, double gain = PLANT_GAIN) {
+    unsigned long end = now + durationMs;
+    while (now < end && autotuner.getState() == AUTOTUNE_RUNNING) {
+      now += STEP_MS;
+      delayedOutputs.push_back(autotuner.update(processValue, now));
+      processValue += gain * delayedOutputs.front() * STEP_S;
+      delayedOutputs.pop_front();
+    }
+  }
+};
+
+/**
+ * @brief Test case for MeasuresIntegratingProcessWithDeadTime.
+ *
+ * Given a relay experiment on an integrating process with dead time L, whose limit cycle is a triangle wave of
+ * amplitude a = ε + K·d·L and period 4L + 4ε / (K·d).
+ * When the experiment runs to completion.
+ * Then the ultimate period and gain should match the limit cycle, within a sample or two.
+ */
+TEST_F(RelayAutotunerTest, MeasuresIntegratingProcessWithDeadTime) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  double amplitude = HYSTERESIS + PLANT_GAIN * RELAY_AMPLITUDE * DEAD_TIME_S;
+  double expectedPeriodMs = (4 * DEAD_TIME_S + 4 * HYSTERESIS / (PLANT_GAIN * RELAY_AMPLITUDE)) * 1000.0;
+  double expectedGain = 4 * RELAY_AMPLITUDE / (PI * std::sqrt(amplitude * amplitude - HYSTERESIS * HYSTERESIS));
+
+  // Act
+  run(TIMEOUT_MS);
+
+  // Assert
+  ASSERT_EQ(AUTOTUNE_DONE, autotuner.getState());
+  EXPECT_NEAR(expectedPeriodMs, autotuner.getUltimatePeriodMs(), 2 * STEP_MS);
+  EXPECT_NEAR(expectedGain, autotuner.getUltimateGain(), expectedGain * 0.02);
+  EXPECT_LT(now, 5 * static_cast<unsigned long>(expectedPeriodMs));
+}
+
+/**
+ * @brief Test case for TuningFollowsZieglerNichols.
+ *
+ * Given a completed relay experiment.
+ * When PI and PID gains are requested.
+ * Then they should follow the Ziegler–Nichols ultimate-cycle rules, with the period in seconds.
+ */
+TEST_F(RelayAutotunerTest, TuningFollowsZieglerNichols) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  run(TIMEOUT_MS);
+  ASSERT_EQ(AUTOTUNE_DONE, autotuner.getState());
+  double ku = autotuner.getUltimateGain();
+  double pu = autotuner.getUltimatePeriodMs() / 1000.0;
+
+  // Act
+  PidTuning pi = autotuner.getTuning(TUNING_RULE_PI);
+  PidTuning pid = autotuner.getTuning(TUNING_RULE_PID);
+
+  // Assert
+  EXPECT_NEAR(0.45 * ku, pi.kp, 1e-9);
+  EXPECT_NEAR(0.54 * ku / pu, pi.ki, 1e-9);
+  EXPECT_DOUBLE_EQ(0.0, pi.kd);
+  EXPECT_NEAR(0.6 * ku, pid.kp, 1e-9);
+  EXPECT_NEAR(1.2 * ku / pu, pid.ki, 1e-9);
+  EXPECT_NEAR(0.075 * ku * pu, pid.kd, 1e-9);
+}
+
+/**
+ * @brief Test case for FailsWhenProcessDoesNotOscillate.
+ *
+ * Given a relay experiment on a process that does not respond to the output.
+ * When the timeout passes.
+ * Then the experiment should fail, return the bias, and offer no gains.
+ */
+TEST_F(RelayAutotunerTest, FailsWhenProcessDoesNotOscillate) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Act
+  run(TIMEOUT_MS + STEP_MS, 0.0);
+
+  // Assert
+  EXPECT_EQ(AUTOTUNE_FAILED, autotuner.getState());
+  EXPECT_DOUBLE_EQ(0.0, autotuner.update(processValue, now + STEP_MS));
+  EXPECT_DOUBLE_EQ(0.0, autotuner.getTuning(TUNING_RULE_PI).kp);
+}
+
+/**
+ * @brief Test case for CancelReturnsToIdle.
+ *
+ * Given a running relay experiment with the relay high.
+ * When it is cancelled.
+ * Then it should be idle and return the bias.
+ */
+TEST_F(RelayAutotunerTest, CancelReturnsToIdle) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  double relayOutput = autotuner.update(SETPOINT, STEP_MS);
+
+  // Act
+  autotuner.cancel();
+
+  // Assert
+  EXPECT_DOUBLE_EQ(RELAY_AMPLITUDE, relayOutput);
+  EXPECT_EQ(AUTOTUNE_IDLE, autotuner.getState());
+  EXPECT_DOUBLE_EQ(0.0, autotuner.update(SETPOINT, 2 * STEP_MS));
+}
@@ -0,0 +1,4 @@
+#include "../lib/utilities/include/relay_autotuner.h"
+#include "../lib/utilities/src/relay_autotuner.cpp"
+
+// This file ensures the relay autotuner implementation is available for tests
@@ -0,0 +1,217 @@
+#include "test_constants.h"
+
+#include <array>
+#include <constants.h>
+#include <gtest/gtest.h>
+#include <memory>
+
+// Define UNIT_TEST if not already defined
+#ifndef UNIT_TEST
+#define UNIT_TEST
+#endif
+
+// Include the mock Arduino functions
+#include "mock_arduino.h"
+
+#include <distillation_state_manager.h>
+#include <hardware_interfaces.h>
+#include <scale.h>
+#include <scale_controller.h>
+
+namespace {
+constexpr unsigned long TICK_MS = 100;
+constexpr uint8_t HEARTS_INDEX = 3;
+constexpr uint8_t HEADS_INDEX = 2;
+
+// Polled HX711 that always has a conversion waiting and counts how it is driven
+class SchedulerScaleInterface : public IScaleInterface {
+public:
+  int reads = 0;             // Conversions clocked out
+  int powerDowns = 0;        // power_down() calls
+  int powerUps = 0;          // power_up() calls
+  bool powerDownable = true; // What can_power_down() reports
+
+  void begin() override {}
+  bool is_ready() override { return true; }
+  void set_scale(float /*scaleValue*/) override {}
+  void tare(uint8_t /*times*/ = 1) override {}
+  float get_units(uint8_t /*times*/ = 1) override { return 0.0F; }
+  void power_down() override { powerDowns++; }
+  void power_up() override { powerUps++; }
+  bool can_power_down() override { return powerDownable; }
+
+  long read() override {
+    reads++;
+    return 0;
+  }
+};
+} // namespace
+
+class ScaleControllerTest
+  : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  std::array<SchedulerScaleInterface, SCALE_COUNT> interfaces;
+  std::array<std::unique_ptr<Scale>, SCALE_COUNT> scales;
+  std::unique_ptr<ScaleController> controller;
+
+  void SetUp() override {
+    setMillis(0);
+    for (uint8_t i = 0; i < SCALE_COUNT; i++) {
+      scales[i] = std::make_unique<Scale>(&interfaces[i], i, i + SCALE_COUNT);
+    }
+    controller = std::make_unique<ScaleController>(*scales[0], *scales[1], *scales[2], *scales[3], *scales[4],
+                                                   *scales[5]);
+    DistillationStateManager::getInstance().setState(HEARTS);
+
+    // Bring every scale online, then count from zero
+    for (int i = 0; i <= SCALE_TARE_CONVERSIONS; i++) {
+      controller->serviceConnections();
+    }
+    for (SchedulerScaleInterface &interface : interfaces) {
+      interface.reads = 0;
+    }
+  }
+
+  void TearDown() override { DistillationStateManager::getInstance().setState(OFF); }
+
+  void tick() {
+    controller->updateAllWeights();
+    advanceMillis(TICK_MS);
+  }
+};
+
+/**
+ * @brief Test case for ActiveScaleIsSampledEveryTick.
+ *
+ * Given six scales while the hearts are being collected.
+ * When the controller runs for several ticks.
+ * Then the hearts scale should be read on every tick, and every other scale should be read once and powered down.
+ */
+TEST_F(ScaleControllerTest, ActiveScaleIsSampledEveryTick) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr int TICKS = 5;
+
+  // Act
+  for (int i = 0; i < TICKS; i++) {
+    tick();
+  }
+
+  // Assert
+  EXPECT_EQ(TICKS, interfaces[HEARTS_INDEX].reads);
+  EXPECT_FALSE(scales[HEARTS_INDEX]->isSleeping());
+  EXPECT_EQ(0, interfaces[HEARTS_INDEX].powerDowns);
+  for (uint8_t i = 0; i < SCALE_COUNT; i++) {
+    if (i != HEARTS_INDEX) {
+      EXPECT_EQ(1, interfaces[i].reads);
+      EXPECT_EQ(1, interfaces[i].powerDowns);
+      EXPECT_TRUE(scales[i]->isSleeping());
+    }
+  }
+}
+
+/**
+ * @brief Test case for IdleScaleIsCheckedPeriodically.
+ *
+ * Given idle scales that have been powered down.
+ * When the idle check interval passes.
+ * Then each idle scale should be woken for one reading and powered down again until the next interval.
+ */
+TEST_F(ScaleControllerTest, IdleScaleIsCheckedPeriodically) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  tick();
+  ASSERT_TRUE(scales[HEADS_INDEX]->isSleeping());
+
+  // Act
+  advanceMillis(SCALE_IDLE_CHECK_INTERVAL_MS);
+  tick();
+  int readsAfterCheck = interfaces[HEADS_INDEX].reads;
+  tick();
+  tick();
+
+  // Assert
+  EXPECT_EQ(2, readsAfterCheck);
+  EXPECT_EQ(2, interfaces[HEADS_INDEX].reads);
+  EXPECT_EQ(1, interfaces[HEADS_INDEX].powerUps);
+  EXPECT_EQ(2, interfaces[HEADS_INDEX].powerDowns);
+  EXPECT_TRUE(scales[HEADS_INDEX]->isSleeping());
+}
+
+/**
+ * @brief Test case for ScaleWakesWhenItsFractionStarts.
+ *
+ * Given the heads scale asleep while the hearts are being collected.
+ * When the state moves back to heads.
+ * Then the heads scale should be woken on the next tick and read every tick, and the hearts scale should sleep.
+ */
+TEST_F(ScaleControllerTest, ScaleWakesWhenItsFractionStarts) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  tick();
+  ASSERT_TRUE(scales[HEADS_INDEX]->isSleeping());
+
+  // Act
+  DistillationStateManager::getInstance().setState(HEADS);
+  tick();
+  tick();
+
+  // Assert
+  EXPECT_FALSE(scales[HEADS_INDEX]->isSleeping());
+  EXPECT_EQ(3, interfaces[HEADS_INDEX].reads);
+  EXPECT_TRUE(scales[HEARTS_INDEX]->isSleeping());
+}
+
+/**
+ * @brief Test case for ScaleThatCannotPowerDownStaysAwake.
+ *
+ * Given scales whose interface cannot power down, like the channels of a parallel bank.
+ * When the controller runs for several ticks.
+ * Then no scale should be put to sleep or woken, and every scale should be read on every tick.
+ */
+TEST_F(ScaleControllerTest, ScaleThatCannotPowerDownStaysAwake) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr int TICKS = 3;
+  for (SchedulerScaleInterface &interface : interfaces) {
+    interface.powerDownable = false;
+  }
+
+  // Act
+  for (int i = 0; i < TICKS; i++) {
+    tick();
+  }
+
+  // Assert
+  for (uint8_t i = 0; i < SCALE_COUNT; i++) {
+    EXPECT_FALSE(scales[i]->isSleeping());
+    EXPECT_EQ(0, interfaces[i].powerDowns);
+    EXPECT_EQ(0, interfaces[i].powerUps);
+    EXPECT_EQ(TICKS, interfaces[i].reads);
+  }
+}
+
+/**
+ * @brief Test case for CalibratingScaleStaysAwake.
+ *
+ * Given the heads scale asleep while the hearts are being collected.
+ * When a calibration of the heads scale is started.
+ * Then the heads scale should be read on every tick until its median window is full, and then go back to sleep.
+ */
+TEST_F(ScaleControllerTest, CalibratingScaleStaysAwake) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  tick();
+  ASSERT_TRUE(scales[HEADS_INDEX]->isSleeping());
+  int readsBefore = interfaces[HEADS_INDEX].reads;
+
+  // Act
+  bool started = controller->startCalibration(HEADS_INDEX, SCALE_CALIBRATION_MIN_WEIGHT);
+  for (int i = 0; i < SCALE_MEDIAN_WINDOW; i++) {
+    tick();
+  }
+  bool calibrating = controller->isCalibrating(HEADS_INDEX);
+  tick();
+
+  // Assert
+  EXPECT_TRUE(started);
+  EXPECT_FALSE(calibrating);
+  // Once the window is full the scale is treated as idle again, which takes one more reading before it sleeps
+  EXPECT_EQ(SCALE_MEDIAN_WINDOW + 1, interfaces[HEADS_INDEX].reads - readsBefore);
+  EXPECT_TRUE(scales[HEADS_INDEX]->isSleeping());
+}
@@ -1,5 +1,6 @@
 #include "test_constants.h"
 
+#include <cmath>
 #include <constants.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -32,6 +33,14 @@ public:
   std::vector<float> readings;
   int dataPin = -1;
   int clockPin = -1;
+  bool interruptCapable = false;
+  void (*dataReadyHandler)() = nullptr;
+  int readCount = 0;
+  int readyConversionCount = 0;
+  int polledConversionCount = 0;
+  long offset = 0;
+
+  static constexpr float COUNTS_PER_UNIT = 100.0f;
 
   void begin() override { initialized = true; }
 
@@ -41,12 +50,12 @@ public:
     // Not used in our tests
   }
 
-  void tare(uint8_t times = 10) override {
+  void tare(uint8_t times = 1) override {
     tared = true;
     tareCount = times;
   }
 
-  float get_units(uint8_t /*times*/ = 10) override {
+  float get_units(uint8_t /*times*/ = 1) override {
     float value = weight;
     readings.push_back(value);
     return value;
@@ -60,6 +69,38 @@ public:
     // Not used in our tests
   }
 
+  long read() override {
+    readCount++;
+    readings.push_back(weight);
+    return std::lround(weight * COUNTS_PER_UNIT);
+  }
+
+  long readReadyConversion() override {
+    readyConversionCount++;
+    return read();
+  }
+
+  long readPolledConversion() override {
+    polledConversionCount++;
+    return read();
+  }
+
+  long get_offset() override { return offset; }
+
+  void set_offset(long value) override { offset = value; }
+
+  float get_scale() override { return COUNTS_PER_UNIT; }
+
+  bool attachDataReadyInterrupt(void (*handler)()) override {
+    if (!interruptCapable) {
+      return false;
+    }
+    dataReadyHandler = handler;
+    return true;
+  }
+
+  void detachDataReadyInterrupt() override { dataReadyHandler = nullptr; }
+
   void reset() {
     initialized = false;
     readyToRead = true;
@@ -67,6 +108,19 @@ public:
     tared = false;
     tareCount = 0;
     readings.clear();
+    interruptCapable = false;
+    dataReadyHandler = nullptr;
+    readCount = 0;
+    readyConversionCount = 0;
+    polledConversionCount = 0;
+    offset = 0;
+  }
+
+  // Helper to simulate the DOUT falling edge of a finished conversion
+  void fireDataReady() {
+    if (dataReadyHandler != nullptr) {
+      dataReadyHandler();
+    }
   }
 
   // Helper to simulate disconnection/connection
@@ -77,6 +131,16 @@ public:
   void setWeight(float newWeight) { weight = newWeight; }
 };
 
+// Scale interface that keeps the calibration factor it is given, for the calibration tests
+class CalibratedScaleInterface : public MockScaleInterface {
+public:
+  float calibration = 1.0f;
+
+  void set_scale(float scale) override { calibration = scale; }
+
+  float get_scale() override { return calibration; }
+};
+
 // Using MockSerialInterface from test_mocks.h
 
 // Helper function and MockSDInterface are defined in test_mocks.h
@@ -112,6 +176,14 @@ protected:
     scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
   }
 
+  // Steps the scale's connection until it is online, raising the data-ready edge for interrupt-driven scales
+  void bringOnline() {
+    for (int i = 0; i <= SCALE_TARE_CONVERSIONS && !scale->isConnected(); i++) {
+      scaleInterface->fireDataReady();
+      scale->serviceConnection();
+    }
+  }
+
   void TearDown() override {
     // Clean up will be handled by unique_ptr destructors
   }
@@ -127,14 +199,23 @@ protected:
 TEST_F(ScaleResilienceTest, ScaleConnectionSuccess) {
   // Scale interface ready to respond
   scaleInterface->simulateConnection();
+  scaleInterface->setWeight(2.0f);
 
   // Create a scale with our interfaces
   scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
 
+  // Construction does not wait for the HX711
+  EXPECT_FALSE(scale->isConnected());
+  EXPECT_EQ(0, scaleInterface->readCount);
+
+  // The scale comes online once its conversions have settled
+  bringOnline();
+
   // Verify scale status
   EXPECT_TRUE(scale->isConnected());
   EXPECT_TRUE(scaleInterface->initialized);
-  EXPECT_TRUE(scaleInterface->tared);
+  EXPECT_FALSE(scaleInterface->tared); // Tared in software, from the settled conversions
+  EXPECT_EQ(200, scaleInterface->offset);
 
   // Verify logs
   EXPECT_TRUE(containsSubstring(MockSerialInterface::logs, "Initializing scale on pins"));
@@ -147,7 +228,7 @@ TEST_F(ScaleResilienceTest, ScaleConnectionSuccess) {
  *
  * Given a Scale object with logger.
  * When the HX711 doesn't respond within the timeout.
- * Then the scale should fail initialization and be marked as disconnected.
+ * Then construction should not wait for it, and the connection attempt should time out and be retried later.
  */
 TEST_F(ScaleResilienceTest, ScaleConnectionTimeout) {
   // Scale interface not ready to respond
@@ -158,9 +239,11 @@ TEST_F(ScaleResilienceTest, ScaleConnectionTimeout) {
 
   // Time passes over the timeout
   advanceMillis(SCALE_CONNECTION_TIMEOUT_MS + 100);
+  scale->serviceConnection();
 
   // Verify scale status
   EXPECT_FALSE(scale->isConnected());
+  EXPECT_EQ(SCALE_BACKOFF, scale->getConnectionState());
   EXPECT_TRUE(scaleInterface->initialized);
   EXPECT_FALSE(scaleInterface->tared);
 
@@ -179,12 +262,13 @@ TEST_F(ScaleResilienceTest, ScaleConnectionTimeout) {
 TEST_F(ScaleResilienceTest, ScaleReadingSuccess) {
   const float testReading = 42.5f;
 
-  // HX711 ready to respond with test reading
+  // HX711 ready to respond
   scaleInterface->simulateConnection();
-  scaleInterface->setWeight(testReading);
 
-  // Create a scale with our interfaces
+  // Create a scale with our interfaces, tared empty
   scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  bringOnline();
+  scaleInterface->setWeight(testReading);
 
   // Update weight
   bool result = scale->updateWeight();
@@ -207,7 +291,7 @@ TEST_F(ScaleResilienceTest, ScaleReadingSuccess) {
  * @brief Test case for Scale reading timeout.
  *
  * Given a connected Scale object.
- * When the HX711 doesn't respond during weight update.
+ * When the HX711 doesn't respond during weight updates spanning the read timeout.
  * Then the update should fail and the scale marked as disconnected.
  */
 TEST_F(ScaleResilienceTest, ScaleReadingTimeout) {
@@ -216,6 +300,7 @@ TEST_F(ScaleResilienceTest, ScaleReadingTimeout) {
 
   // Create a scale with our interfaces
   scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  bringOnline();
 
   // Reset logger after setup
   MockSerialInterface::reset();
@@ -223,12 +308,15 @@ TEST_F(ScaleResilienceTest, ScaleReadingTimeout) {
   // Now make scale interface unresponsive
   scaleInterface->simulateDisconnection();
 
-  // Update weight
-  bool result = scale->updateWeight();
+  // A single empty update does not wait and is not yet a failure
+  EXPECT_TRUE(scale->updateWeight());
 
   // Time passes over the timeout
   advanceMillis(SCALE_READ_TIMEOUT_MS + 100);
 
+  // Update weight
+  bool result = scale->updateWeight();
+
   // Verify result
   EXPECT_FALSE(result);
   EXPECT_FALSE(scale->isConnected()); // Should be marked as disconnected
@@ -241,11 +329,11 @@ TEST_F(ScaleResilienceTest, ScaleReadingTimeout) {
  * @brief Test case for Scale reconnection success.
  *
  * Given a disconnected Scale object.
- * When tryReconnect is called and HX711 responds.
- * Then the reconnection should succeed.
+ * When the HX711 starts responding with steady conversions.
+ * Then the scale should come online once enough conversions agree, tared to their mean without a blocking tare.
  */
 TEST_F(ScaleResilienceTest, ScaleReconnectionSuccess) {
-  // Scale interface not ready at first (connection will timeout)
+  // Scale interface not ready at first
   scaleInterface->simulateDisconnection();
 
   // Create a scale with our interfaces
@@ -257,27 +345,40 @@ TEST_F(ScaleResilienceTest, ScaleReconnectionSuccess) {
   // Reset logger
   MockSerialInterface::reset();
 
-  // Now scale interface becomes responsive for reconnection
+  // Now scale interface becomes responsive, with an empty vessel on it
   scaleInterface->simulateConnection();
-
-  // Try to reconnect
-  bool reconnected = scale->tryReconnect();
+  scaleInterface->setWeight(1.5f);
+
+  // Step the connection until the tare has enough conversions
+  scale->serviceConnection();
+  EXPECT_EQ(SCALE_SETTLING, scale->getConnectionState());
+  int onlineCalls = 0;
+  for (int i = 0; i < SCALE_TARE_CONVERSIONS; i++) {
+    advanceMillis(100);
+    if (scale->serviceConnection()) {
+      onlineCalls++;
+    }
+  }
+  scale->updateWeight();
 
   // Verify reconnection
-  EXPECT_TRUE(reconnected);
+  EXPECT_EQ(1, onlineCalls);
   EXPECT_TRUE(scale->isConnected());
+  EXPECT_EQ(SCALE_ONLINE, scale->getConnectionState());
+  EXPECT_FALSE(scaleInterface->tared);
+  EXPECT_EQ(150, scaleInterface->offset);
+  EXPECT_FLOAT_EQ(0.0f, scale->getLastWeight());
 
   // Verify logs
-  EXPECT_TRUE(containsSubstring(MockSerialInterface::logs, "Attempting to reconnect scale"));
-  EXPECT_TRUE(containsSubstring(MockSerialInterface::logs, "Scale reconnected successfully"));
+  EXPECT_TRUE(containsSubstring(MockSerialInterface::logs, "Scale connected successfully"));
 }
 
 /**
  * @brief Test case for Scale reconnection failure.
  *
  * Given a disconnected Scale object.
- * When tryReconnect is called and HX711 doesn't respond.
- * Then the reconnection should fail.
+ * When the HX711 keeps not responding.
+ * Then each attempt should time out without waiting, and the delay before the next attempt should double.
  */
 TEST_F(ScaleResilienceTest, ScaleReconnectionFailure) {
   // Scale interface not ready (connection will timeout)
@@ -285,29 +386,156 @@ TEST_F(ScaleResilienceTest, ScaleReconnectionFailure) {
 
   // Create a scale with our interfaces
   scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
-
-  // Verify it's disconnected
-  EXPECT_FALSE(scale->isConnected());
+  advanceMillis(SCALE_CONNECTION_TIMEOUT_MS + 1);
+  scale->serviceConnection();
 
   // Reset logger
   MockSerialInterface::reset();
 
-  // Scale interface still not responsive
-  scaleInterface->simulateDisconnection();
+  // The first retry comes after the minimum delay
+  advanceMillis(SCALE_RECONNECT_MIN_DELAY_MS - 1);
+  scale->serviceConnection();
+  EXPECT_EQ(SCALE_BACKOFF, scale->getConnectionState());
+  advanceMillis(1);
+  scale->serviceConnection();
+  EXPECT_EQ(SCALE_PROBING, scale->getConnectionState());
+  EXPECT_TRUE(containsSubstring(MockSerialInterface::logs, "Attempting to reconnect scale"));
 
-  // Try to reconnect
-  bool reconnected = scale->tryReconnect();
-
-  // Time passes over the timeout
-  advanceMillis(SCALE_CONNECTION_TIMEOUT_MS + 100);
+  // It times out as well, so the next retry waits twice as long
+  advanceMillis(SCALE_CONNECTION_TIMEOUT_MS + 1);
+  scale->serviceConnection();
+  EXPECT_EQ(SCALE_BACKOFF, scale->getConnectionState());
+  advanceMillis(2 * SCALE_RECONNECT_MIN_DELAY_MS - 1);
+  scale->serviceConnection();
+  EXPECT_EQ(SCALE_BACKOFF, scale->getConnectionState());
+  advanceMillis(1);
+  scale->serviceConnection();
 
   // Verify reconnection failed
-  EXPECT_FALSE(reconnected);
+  EXPECT_EQ(SCALE_PROBING, scale->getConnectionState());
   EXPECT_FALSE(scale->isConnected());
 
   // Verify logs
-  EXPECT_TRUE(containsSubstring(MockSerialInterface::logs, "Attempting to reconnect scale"));
-  EXPECT_TRUE(containsSubstring(MockSerialInterface::logs, "Scale reconnection timeout"));
+  EXPECT_TRUE(containsSubstring(MockSerialInterface::logs, "Scale connection timeout"));
+}
+
+/**
+ * @brief Test case for settling before the tare.
+ *
+ * Given a Scale that starts responding while its load is still moving.
+ * When the conversions spread wider than the tare tolerance, and later hold steady.
+ * Then the scale should stay offline through the moving window and tare only on the steady one.
+ */
+TEST_F(ScaleResilienceTest, TareWaitsForSteadyConversions) {
+  // Arrange
+  scaleInterface->simulateDisconnection();
+  scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  scaleInterface->simulateConnection();
+  scale->serviceConnection();
+
+  // Act
+  for (int i = 0; i < SCALE_TARE_CONVERSIONS; i++) {
+    scaleInterface->setWeight(i % 2 == 0 ? 0.0f : 2.0f * SCALE_TARE_MAX_SPREAD);
+    scale->serviceConnection();
+  }
+  bool connectedWhileMoving = scale->isConnected();
+  scaleInterface->setWeight(3.0f);
+  for (int i = 0; i < SCALE_TARE_CONVERSIONS; i++) {
+    scale->serviceConnection();
+  }
+
+  // Assert
+  EXPECT_FALSE(connectedWhileMoving);
+  EXPECT_TRUE(scale->isConnected());
+  EXPECT_EQ(300, scaleInterface->offset);
+}
+
+/**
+ * @brief Test case for a stored zero that still holds.
+ *
+ * Given a Scale with a restored calibration, and an empty vessel that weighs what it did when the zero was stored.
+ * When the scale comes online.
+ * Then a few conversions should confirm the stored zero, and no tare should replace it.
+ */
+TEST_F(ScaleResilienceTest, StoredZeroSkipsTheTare) {
+  // Arrange
+  scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  scale->restoreCalibration({500, MockScaleInterface::COUNTS_PER_UNIT});
+  scaleInterface->setWeight(6.0f); // One gram of drift, within the tolerance
+
+  // Act
+  bringOnline();
+
+  // Assert
+  EXPECT_TRUE(scale->isConnected());
+  EXPECT_EQ(SCALE_ZERO_CHECK_CONVERSIONS, scaleInterface->readCount);
+  EXPECT_EQ(500, scaleInterface->offset);
+  EXPECT_FALSE(containsSubstring(MockSerialInterface::logs, "Scale tared"));
+}
+
+/**
+ * @brief Test case for a stored zero that no longer holds.
+ *
+ * Given a Scale with a restored calibration, and a vessel much heavier than when the zero was stored.
+ * When the scale comes online.
+ * Then the zero check should fail and a full tare should set a new offset.
+ */
+TEST_F(ScaleResilienceTest, DriftedZeroIsTared) {
+  // Arrange
+  scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  scale->restoreCalibration({500, MockScaleInterface::COUNTS_PER_UNIT});
+  scaleInterface->setWeight(5.0f + 2.0f * SCALE_ZERO_CHECK_TOLERANCE);
+
+  // Act
+  for (int i = 0; i <= SCALE_ZERO_CHECK_CONVERSIONS + SCALE_TARE_CONVERSIONS && !scale->isConnected(); i++) {
+    scale->serviceConnection();
+  }
+
+  // Assert
+  EXPECT_TRUE(scale->isConnected());
+  EXPECT_EQ(SCALE_ZERO_CHECK_CONVERSIONS + SCALE_TARE_CONVERSIONS, scaleInterface->readCount);
+  EXPECT_EQ(std::lround((5.0f + 2.0f * SCALE_ZERO_CHECK_TOLERANCE) * MockScaleInterface::COUNTS_PER_UNIT),
+            scaleInterface->offset);
+  EXPECT_TRUE(containsSubstring(MockSerialInterface::logs, "off its zero, taring"));
+  EXPECT_TRUE(containsSubstring(MockSerialInterface::logs, "Scale tared"));
+}
+
+/**
+ * @brief Test case for a reconnect with a partly filled vessel.
+ *
+ * Given a Scale that was tared empty and has since collected distillate.
+ * When it drops out and reconnects mid-run.
+ * Then it should keep its zero and flag the mismatch, instead of taring to the distillate.
+ */
+TEST_F(ScaleResilienceTest, ReconnectKeepsZeroOfFilledVessel) {
+  // Arrange
+  scaleInterface->setWeight(2.0f);
+  bringOnline();
+  ASSERT_TRUE(scale->isConnected());
+  scaleInterface->setWeight(250.0f);
+  scaleInterface->simulateDisconnection();
+  scale->updateWeight();
+  advanceMillis(SCALE_READ_TIMEOUT_MS + 100);
+  scale->updateWeight();
+  ASSERT_FALSE(scale->isConnected());
+  MockSerialInterface::reset();
+
+  // Act
+  scaleInterface->simulateConnection();
+  advanceMillis(SCALE_RECONNECT_MIN_DELAY_MS);
+  for (int i = 0; i <= SCALE_ZERO_CHECK_CONVERSIONS + 1 && !scale->isConnected(); i++) {
+    scale->serviceConnection();
+  }
+  scale->updateWeight();
+
+  // Assert
+  EXPECT_TRUE(scale->isConnected());
+  EXPECT_TRUE(scale->hasZeroMismatch());
+  EXPECT_EQ(200, scaleInterface->offset);
+  EXPECT_EQ(200, scale->getCalibration().offset);
+  EXPECT_FLOAT_EQ(248.0f, scale->getLastWeight());
+  EXPECT_TRUE(containsSubstring(MockSerialInterface::logs, "off its zero, keeping it"));
+  EXPECT_FALSE(containsSubstring(MockSerialInterface::logs, "Scale tared"));
 }
 
 /**
@@ -323,6 +551,7 @@ TEST_F(ScaleResilienceTest, MedianWeightCalculation) {
 
   // Create a scale with our interfaces
   scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  bringOnline();
 
   // Add a set of weight readings
   scaleInterface->setWeight(10.0f);
@@ -342,4 +571,395 @@ TEST_F(ScaleResilienceTest, MedianWeightCalculation) {
 
   // The median should be 20.0f
   EXPECT_FLOAT_EQ(20.0f, scale->getWeight());
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Test case for per-scale software averaging.
+ *
+ * Given a Scale set to average three conversions per reading.
+ * When six conversions arrive, one per update.
+ * Then the median filter should receive two readings, each the mean of its three conversions, and every update
+ * should take exactly one conversion.
+ */
+TEST_F(ScaleResilienceTest, AveragingDepthGroupsConversions) {
+  // Arrange
+  scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  bringOnline();
+  scale->setAveragingDepth(3);
+  int readsWhileConnecting = scaleInterface->readCount;
+
+  // Act
+  for (float weight : {10.0f, 20.0f, 30.0f, 40.0f, 50.0f, 60.0f}) {
+    scaleInterface->setWeight(weight);
+    scale->updateWeight();
+  }
+
+  // Assert
+  EXPECT_EQ(3, scale->getAveragingDepth());
+  EXPECT_EQ(6, scaleInterface->readCount - readsWhileConnecting);
+  EXPECT_FLOAT_EQ(50.0f, scale->getLastWeight());
+  EXPECT_FLOAT_EQ(50.0f, scale->getWeight()); // Upper median of {20, 50}
+}
+
+/**
+ * @brief Test case for reading timestamps.
+ *
+ * Given an interrupt-driven Scale averaging three conversions per reading.
+ * When the conversions arrive 100 ms apart and are only drained a second later.
+ * Then the reading should be stamped with the time of its middle conversion, not the time of the update.
+ */
+TEST_F(ScaleResilienceTest, ReadingIsStampedWithItsConversionTimes) {
+  // Arrange
+  scaleInterface->interruptCapable = true;
+  scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  bringOnline();
+  ASSERT_TRUE(scale->isInterruptDriven());
+  scale->setAveragingDepth(3);
+  unsigned long readingsBefore = scale->getReadingCount();
+  unsigned long middleConversionTime = millis() + 200;
+
+  // Act
+  for (float weight : {10.0f, 20.0f, 30.0f}) {
+    scaleInterface->setWeight(weight);
+    advanceMillis(100);
+    scaleInterface->fireDataReady();
+  }
+  advanceMillis(1000);
+  scale->updateWeight();
+  ScaleReading reading = scale->getLastReading();
+
+  // Assert
+  EXPECT_EQ(middleConversionTime, reading.timeMs);
+  EXPECT_FLOAT_EQ(20.0f, reading.weight);
+  EXPECT_EQ(readingsBefore + 1, reading.sequence);
+}
+
+/**
+ * @brief Test case for spike rejection.
+ *
+ * Given a connected Scale with a steady load.
+ * When a single conversion spikes, as a relay switching next to the load cell would cause.
+ * Then the spike should be dropped and counted, and never reach the filtered weight.
+ */
+TEST_F(ScaleResilienceTest, SpikeNeverReachesTheWeight) {
+  // Arrange
+  scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  bringOnline();
+  for (int i = 0; i < SCALE_HAMPEL_WINDOW; i++) {
+    scaleInterface->setWeight(i % 2 == 0 ? 250.0f : 250.5f);
+    scale->updateWeight();
+  }
+  unsigned long readingsBeforeSpike = scale->getReadingCount();
+
+  // Act
+  scaleInterface->setWeight(400.0f);
+  bool result = scale->updateWeight();
+
+  // Assert
+  EXPECT_TRUE(result);
+  EXPECT_EQ(1UL, scale->getRejectedCount());
+  EXPECT_EQ(readingsBeforeSpike, scale->getReadingCount());
+  EXPECT_FLOAT_EQ(250.0f, scale->getLastWeight());
+}
+
+/**
+ * @brief Test case for interrupt-driven acquisition.
+ *
+ * Given a connected Scale whose data pin can raise interrupts.
+ * When conversions arrive through the data-ready handler between updates.
+ * Then each should be clocked out without waiting, and updateWeight should drain them all into the median without
+ * reading the HX711 itself.
+ */
+TEST_F(ScaleResilienceTest, InterruptSamplesAreDrainedWithoutPolling) {
+  // Arrange
+  scaleInterface->interruptCapable = true;
+  scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  bringOnline();
+  ASSERT_TRUE(scale->isInterruptDriven());
+  int readsWhileConnecting = scaleInterface->readCount;
+  int readyConversionsWhileConnecting = scaleInterface->readyConversionCount;
+
+  // Act
+  for (float weight : {10.0f, 30.0f, 20.0f}) {
+    scaleInterface->setWeight(weight);
+    advanceMillis(100);
+    scaleInterface->fireDataReady();
+  }
+  int readsBeforeUpdate = scaleInterface->readCount - readsWhileConnecting;
+  int readyConversions = scaleInterface->readyConversionCount - readyConversionsWhileConnecting;
+  bool result = scale->updateWeight();
+
+  // Assert
+  EXPECT_TRUE(result);
+  EXPECT_EQ(3, readsBeforeUpdate);
+  EXPECT_EQ(readsBeforeUpdate, readyConversions);
+  EXPECT_EQ(readsBeforeUpdate, scaleInterface->readCount - readsWhileConnecting);
+  EXPECT_FLOAT_EQ(20.0f, scale->getWeight());
+  EXPECT_FLOAT_EQ(20.0f, scale->getLastWeight());
+}
+
+/**
+ * @brief Test case for polled acquisition.
+ *
+ * Given a connected Scale whose data pin cannot raise interrupts.
+ * When it settles and then takes conversions on its updates.
+ * Then every conversion should be clocked out through the polled read, which masks other scales' handlers, and
+ * never through the read meant for interrupt context.
+ */
+TEST_F(ScaleResilienceTest, PolledScaleReadsWithInterruptsMasked) {
+  // Arrange
+  scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  bringOnline();
+  ASSERT_FALSE(scale->isInterruptDriven());
+  int polledWhileConnecting = scaleInterface->polledConversionCount;
+
+  // Act
+  for (float weight : {10.0f, 30.0f, 20.0f}) {
+    scaleInterface->setWeight(weight);
+    advanceMillis(100);
+    scale->updateWeight();
+  }
+
+  // Assert
+  EXPECT_EQ(SCALE_TARE_CONVERSIONS, polledWhileConnecting);
+  EXPECT_EQ(3, scaleInterface->polledConversionCount - polledWhileConnecting);
+  EXPECT_EQ(0, scaleInterface->readyConversionCount);
+  EXPECT_EQ(scaleInterface->polledConversionCount, scaleInterface->readCount);
+  EXPECT_FLOAT_EQ(20.0f, scale->getWeight());
+}
+
+/**
+ * @brief Test case for logging the acquisition mode.
+ *
+ * Given a connected, polled Scale that has logged its acquisition mode.
+ * When it is put to sleep and woken again, as the idle checks do, and resumes its updates.
+ * Then the unchanged mode should not be logged again.
+ */
+TEST_F(ScaleResilienceTest, UnchangedAcquisitionModeIsLoggedOnce) {
+  // Arrange
+  scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  bringOnline();
+  scale->updateWeight();
+  ASSERT_TRUE(containsSubstring(MockSerialInterface::logs, "is polled"));
+  MockSerialInterface::reset();
+
+  // Act
+  for (int cycle = 0; cycle < 3; cycle++) {
+    scale->sleep();
+    scale->wake();
+    advanceMillis(100);
+    scale->updateWeight();
+  }
+
+  // Assert
+  EXPECT_FALSE(containsSubstring(MockSerialInterface::logs, "is polled"));
+}
+
+/**
+ * @brief Test case for an interrupt-driven scale going silent.
+ *
+ * Given a Scale reading by interrupt.
+ * When no data-ready edge arrives for longer than the read timeout.
+ * Then the scale should be marked as disconnected and its handler detached.
+ */
+TEST_F(ScaleResilienceTest, SilentInterruptScaleIsDetached) {
+  // Arrange
+  scaleInterface->interruptCapable = true;
+  scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  bringOnline();
+  scale->updateWeight();
+
+  // Act
+  advanceMillis(SCALE_READ_TIMEOUT_MS + 100);
+  bool result = scale->updateWeight();
+
+  // Assert
+  EXPECT_FALSE(result);
+  EXPECT_FALSE(scale->isConnected());
+  EXPECT_FALSE(scale->isInterruptDriven());
+  EXPECT_EQ(nullptr, scaleInterface->dataReadyHandler);
+}
+
+/**
+ * @brief Test case for the first conversion after a wake-up.
+ *
+ * Given a connected Scale that has been put to sleep.
+ * When it is woken and its first conversion only arrives about 450 ms later, once the HX711 has settled.
+ * Then every update should succeed and the conversion should become a new reading.
+ */
+TEST_F(ScaleResilienceTest, FirstConversionAfterWakeIsAwaited) {
+  // Arrange
+  constexpr unsigned long FIRST_CONVERSION_MS = 450;
+  constexpr unsigned long UPDATE_INTERVAL_MS = 150;
+  scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  bringOnline();
+  scale->sleep();
+  scaleInterface->setWeight(40.0f);
+  scaleInterface->simulateDisconnection();
+  unsigned long readingsBefore = scale->getReadingCount();
+  unsigned long wakeTime = millis();
+
+  // Act
+  scale->wake();
+  bool allUpdatesSucceeded = true;
+  for (unsigned long elapsed = 0; elapsed <= FIRST_CONVERSION_MS + UPDATE_INTERVAL_MS; elapsed += UPDATE_INTERVAL_MS) {
+    setMillis(wakeTime + elapsed);
+    if (elapsed >= FIRST_CONVERSION_MS) {
+      scaleInterface->simulateConnection();
+    }
+    allUpdatesSucceeded = scale->updateWeight() && allUpdatesSucceeded;
+  }
+
+  // Assert
+  EXPECT_TRUE(allUpdatesSucceeded);
+  EXPECT_TRUE(scale->isConnected());
+  EXPECT_LT(readingsBefore, scale->getReadingCount());
+  EXPECT_FLOAT_EQ(40.0f, scale->getLastWeight());
+}
+
+/**
+ * @brief Test case for a woken scale that never settles.
+ *
+ * Given a connected Scale that has been put to sleep.
+ * When it is woken and no conversion arrives.
+ * Then it should stay connected through the settling time and time out once the read timeout has passed after it.
+ */
+TEST_F(ScaleResilienceTest, WokenScaleTimesOutAfterSettling) {
+  // Arrange
+  scale = std::make_unique<Scale>(scaleInterface.get(), dataPin, clockPin, logger.get());
+  bringOnline();
+  scale->sleep();
+  scaleInterface->simulateDisconnection();
+
+  // Act
+  scale->wake();
+  scale->updateWeight();
+  advanceMillis(SCALE_WAKE_SETTLE_MS + SCALE_READ_TIMEOUT_MS);
+  bool settlingResult = scale->updateWeight();
+  bool connectedWhileSettling = scale->isConnected();
+  advanceMillis(100);
+  bool timedOutResult = scale->updateWeight();
+
+  // Assert
+  EXPECT_TRUE(settlingResult);
+  EXPECT_TRUE(connectedWhileSettling);
+  EXPECT_FALSE(timedOutResult);
+  EXPECT_FALSE(scale->isConnected());
+}
+
+/**
+ * @brief Test case for calibrating against a known weight.
+ *
+ * Given a connected Scale still on the default calibration factor, whose HX711 gives 100 counts per gram.
+ * When a 500 g weight is placed on it and a calibration against 500 g runs for a full median window.
+ * Then the calibration should end with a factor of 100 counts per gram, and the weight should read 500 g.
+ */
+TEST_F(ScaleResilienceTest, CalibrationSetsTheFactorFromAKnownWeight) {
+  // Arrange
+  constexpr float KNOWN_WEIGHT = 500.0f;
+  CalibratedScaleInterface calibratedInterface;
+  scale = std::make_unique<Scale>(&calibratedInterface, dataPin, clockPin, logger.get());
+  bringOnline();
+  ASSERT_TRUE(scale->isConnected());
+  calibratedInterface.setWeight(KNOWN_WEIGHT);
+
+  // Act
+  bool started = scale->startCalibration(KNOWN_WEIGHT);
+  for (int i = 0; i < SCALE_MEDIAN_WINDOW; i++) {
+    scale->updateWeight();
+  }
+  bool calibratingAfterWindow = scale->isCalibrating();
+  scale->updateWeight();
+
+  // Assert
+  EXPECT_TRUE(started);
+  EXPECT_FALSE(calibratingAfterWindow);
+  EXPECT_FLOAT_EQ(MockScaleInterface::COUNTS_PER_UNIT, scale->getCalibration().scale);
+  EXPECT_FLOAT_EQ(KNOWN_WEIGHT, scale->getWeight());
+}
+
+/**
+ * @brief Test case for calibrating against a load that is still moving.
+ *
+ * Given a connected Scale with a 500 g weight still swinging on it.
+ * When a calibration against 500 g fills its median window while the load moves, and the load then settles.
+ * Then the calibration should go on through the moving window and take its factor from the settled one only.
+ */
+TEST_F(ScaleResilienceTest, CalibrationWaitsForASettledLoad) {
+  // Arrange
+  constexpr float KNOWN_WEIGHT = 500.0f;
+  CalibratedScaleInterface calibratedInterface;
+  scale = std::make_unique<Scale>(&calibratedInterface, dataPin, clockPin, logger.get());
+  bringOnline();
+  ASSERT_TRUE(scale->isConnected());
+
+  // Act
+  bool started = scale->startCalibration(KNOWN_WEIGHT);
+  for (float weight : {300.0f, 650.0f, 420.0f, 560.0f, 470.0f}) {
+    calibratedInterface.setWeight(weight);
+    scale->updateWeight();
+  }
+  bool calibratingWhileMoving = scale->isCalibrating();
+  calibratedInterface.setWeight(KNOWN_WEIGHT);
+  for (int i = 0; i < SCALE_MEDIAN_WINDOW; i++) {
+    scale->updateWeight();
+  }
+
+  // Assert
+  EXPECT_TRUE(started);
+  EXPECT_TRUE(calibratingWhileMoving);
+  EXPECT_FALSE(scale->isCalibrating());
+  EXPECT_FLOAT_EQ(MockScaleInterface::COUNTS_PER_UNIT, calibratedInterface.calibration);
+}
+
+/**
+ * @brief Test case for calibrating without the known weight on the scale.
+ *
+ * Given a connected Scale with only 20 g on it.
+ * When a calibration against 500 g fills a settled median window.
+ * Then the calibration should end with an error and keep the default factor.
+ */
+TEST_F(ScaleResilienceTest, CalibrationRejectsTooLittleLoad) {
+  // Arrange
+  CalibratedScaleInterface calibratedInterface;
+  scale = std::make_unique<Scale>(&calibratedInterface, dataPin, clockPin, logger.get());
+  bringOnline();
+  ASSERT_TRUE(scale->isConnected());
+  calibratedInterface.setWeight(20.0f);
+
+  // Act
+  bool started = scale->startCalibration(500.0f);
+  for (int i = 0; i < SCALE_MEDIAN_WINDOW; i++) {
+    scale->updateWeight();
+  }
+
+  // Assert
+  EXPECT_TRUE(started);
+  EXPECT_FALSE(scale->isCalibrating());
+  EXPECT_FLOAT_EQ(SCALE_DEFAULT_CALIBRATION, scale->getCalibration().scale);
+  EXPECT_TRUE(containsSubstring(MockSerialInterface::logs, "too little load"));
+}
+
+/**
+ * @brief Test case for calibrations that cannot start.
+ *
+ * Given a Scale that is not yet connected, and then the same Scale online.
+ * When a calibration is started offline, and then online with a weight below SCALE_CALIBRATION_MIN_WEIGHT.
+ * Then neither calibration should start, and the calibration factor should stay at its default.
+ */
+TEST_F(ScaleResilienceTest, CalibrationNeedsAnOnlineScaleAndEnoughWeight) {
+  // Arrange
+  CalibratedScaleInterface calibratedInterface;
+  scale = std::make_unique<Scale>(&calibratedInterface, dataPin, clockPin, logger.get());
+
+  // Act
+  bool startedOffline = scale->startCalibration(SCALE_CALIBRATION_MIN_WEIGHT);
+  bringOnline();
+  bool startedLight = scale->startCalibration(SCALE_CALIBRATION_MIN_WEIGHT / 2);
+
+  // Assert
+  EXPECT_FALSE(startedOffline);
+  EXPECT_FALSE(startedLight);
+  EXPECT_FALSE(scale->isCalibrating());
+  EXPECT_FLOAT_EQ(SCALE_DEFAULT_CALIBRATION, scale->getCalibration().scale);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <spsc_queue.h>
+
+namespace {
+constexpr std::size_t CAPACITY = 4;
+} // namespace
+
+/**
+ * @brief Test case for ItemsComeOutInOrder.
+ *
+ * Given an empty queue.
+ * When three items are pushed and then popped.
+ * Then they should come out in the order they went in, and the queue should be empty afterwards.
+ */
+TEST(SpscQueueTest, ItemsComeOutInOrder) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  SpscQueue<int, CAPACITY> queue;
+  int item = 0;
+
+  // Act
+  queue.push(1);
+  queue.push(2);
+  queue.push(3);
+
+  // Assert
+  EXPECT_EQ(3U, queue.size());
+  ASSERT_TRUE(queue.pop(item));
+  EXPECT_EQ(1, item);
+  ASSERT_TRUE(queue.pop(item));
+  EXPECT_EQ(2, item);
+  ASSERT_TRUE(queue.pop(item));
+  EXPECT_EQ(3, item);
+  EXPECT_FALSE(queue.pop(item));
+  EXPECT_EQ(0U, queue.size());
+}
+
+/**
+ * @brief Test case for FullQueueDropsNewItems.
+ *
+ * Given a queue filled to capacity.
+ * When two more items are pushed.
+ * Then both should be rejected and counted, and the oldest items should be kept.
+ */
+TEST(SpscQueueTest, FullQueueDropsNewItems) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  SpscQueue<int, CAPACITY> queue;
+  for (int i = 0; i < static_cast<int>(CAPACITY); i++) {
+    queue.push(i);
+  }
+  int item = -1;
+
+  // Act
+  bool firstOverflow = queue.push(100);
+  bool secondOverflow = queue.push(101);
+
+  // Assert
+  EXPECT_FALSE(firstOverflow);
+  EXPECT_FALSE(secondOverflow);
+  EXPECT_EQ(2UL, queue.getDroppedCount());
+  ASSERT_TRUE(queue.pop(item));
+  EXPECT_EQ(0, item);
+}
+
+/**
+ * @brief Test case for IndicesWrapAroundTheBuffer.
+ *
+ * Given a queue that is pushed and popped many times its capacity.
+ * When items are interleaved so the indices wrap around the buffer repeatedly.
+ * Then every item should come out exactly once and in order.
+ */
+TEST(SpscQueueTest, IndicesWrapAroundTheBuffer) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr int ITEMS = 1000;
+  SpscQueue<int, CAPACITY> queue;
+  int expected = 0;
+  int item = 0;
+
+  // Act
+  for (int i = 0; i < ITEMS; i++) {
+    ASSERT_TRUE(queue.push(i));
+    if (i % 3 != 0) {
+      while (queue.pop(item)) {
+        ASSERT_EQ(expected, item);
+        expected++;
+      }
+    }
+  }
+  while (queue.pop(item)) {
+    ASSERT_EQ(expected, item);
+    expected++;
+  }
+
+  // Assert
+  EXPECT_EQ(ITEMS, expected);
+  EXPECT_EQ(0UL, queue.getDroppedCount());
+}
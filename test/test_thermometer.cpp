@@ -10,19 +10,41 @@
 #define UNIT_TEST
 #endif
 
-// Include the Thermometer class (now with conditional compilation)
+// Include the mock Arduino functions
+#include "mock_arduino.h"
+
+// Include the Thermometer class and the bus it reads from
 #include <thermometer.h>
+#include <thermometer_bus.h>
+
+namespace {
+constexpr float SLOW_RISE_C_PER_MIN = 0.3F;
+constexpr float NOISE_AMPLITUDE_C = 0.02F;
+} // namespace
 
 class ThermometerTest : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
 protected:
   std::shared_ptr<MockOneWire> oneWire;
   std::shared_ptr<MockDallasTemperature> sensors;
+  std::unique_ptr<ThermometerBus> bus;
   std::unique_ptr<Thermometer> thermometer;
 
   void SetUp() override {
+    setMillis(0);
     oneWire = std::make_shared<MockOneWire>();
-    sensors = std::make_shared<MockDallasTemperature>();
-    thermometer = std::make_unique<Thermometer>(oneWire, sensors);
+    sensors = std::make_shared<::testing::NiceMock<MockDallasTemperature>>();
+    ON_CALL(*sensors, getDeviceCount()).WillByDefault(::testing::Return(1));
+    ON_CALL(*sensors, getAddress(::testing::_, 0)).WillByDefault(::testing::Return(true));
+    bus = std::make_unique<ThermometerBus>(oneWire, sensors);
+    bus->begin();
+    thermometer = std::make_unique<Thermometer>(*bus, 0);
+  }
+
+  // Runs one full request/collect cycle of the conversion pipeline
+  void takeReading() {
+    bus->requestConversion();
+    advanceMillis(DS18B20_CONVERSION_TIME_MS);
+    thermometer->collectTemperature();
   }
 };
 
@@ -35,18 +57,19 @@ protected:
  */
 TEST_F(ThermometerTest, GetTemperatureReturnsMedian) { // NOLINT(cppcoreguidelines-owning-memory)
   // Arrange
-  EXPECT_CALL(*sensors, requestTemperatures()).Times(READINGS_ARRAY_SIZE);
+  EXPECT_CALL(*sensors, requestTemperatures()).Times(THERMOMETER_MEDIAN_WINDOW);
 
-  EXPECT_CALL(*sensors, getTempCByIndex(0))
-      .WillOnce(::testing::Return(temperature::BASE))
-      .WillOnce(::testing::Return(temperature::BASE + temperature::LARGE_INCREMENT))
-      .WillOnce(::testing::Return(temperature::BASE + temperature::MEDIUM_INCREMENT))
-      .WillOnce(::testing::Return(temperature::BASE + temperature::LARGE_INCREMENT + temperature::MEDIUM_INCREMENT))
-      .WillOnce(::testing::Return(temperature::BASE - temperature::MEDIUM_INCREMENT));
+  EXPECT_CALL(*sensors, getTemp(::testing::_))
+      .WillOnce(::testing::Return(temperature::toDallasRaw(temperature::BASE)))
+      .WillOnce(::testing::Return(temperature::toDallasRaw(temperature::BASE + temperature::LARGE_INCREMENT)))
+      .WillOnce(::testing::Return(temperature::toDallasRaw(temperature::BASE + temperature::MEDIUM_INCREMENT)))
+      .WillOnce(::testing::Return(
+          temperature::toDallasRaw(temperature::BASE + temperature::LARGE_INCREMENT + temperature::MEDIUM_INCREMENT)))
+      .WillOnce(::testing::Return(temperature::toDallasRaw(temperature::BASE - temperature::MEDIUM_INCREMENT)));
 
   // Act
-  for (int i = 0; i < READINGS_ARRAY_SIZE; i++) {
-    thermometer->updateTemperature();
+  for (int i = 0; i < THERMOMETER_MEDIAN_WINDOW; i++) {
+    takeReading();
   }
 
   // Assert
@@ -54,54 +77,58 @@ TEST_F(ThermometerTest, GetTemperatureReturnsMedian) { // NOLINT(cppcoreguidelin
 }
 
 /**
- * @brief Test case for DetectsSuddenTemperatureIncrease.
+ * @brief Test case for DetectsSlowSustainedRise.
  *
- * Given the thermometer has received 5 stable readings followed by 5 readings with a sudden increase.
- * When isSuddenTemperatureIncrease is called after the initial stable readings.
- * Then it should return false.
- * When isSuddenTemperatureIncrease is called after the sudden increase readings.
- * Then it should return true.
+ * Given the thermometer receives a full trend window of noisy readings rising at 0.3 °C/min.
+ * When isTemperatureRising is called before and after the window has filled.
+ * Then it should return false while the window is filling, and true once it is full, with the estimated slope
+ * close to the true rate of rise.
  */
-TEST_F(ThermometerTest, DetectsSuddenTemperatureIncrease) { // NOLINT(cppcoreguidelines-owning-memory)
+TEST_F(ThermometerTest, DetectsSlowSustainedRise) { // NOLINT(cppcoreguidelines-owning-memory)
   // Arrange
-  // Define a constant for the number of readings
-  constexpr int TOTAL_READINGS = 10;
-  EXPECT_CALL(*sensors, requestTemperatures()).Times(TOTAL_READINGS);
-
-  // First 5 readings
-  EXPECT_CALL(*sensors, getTempCByIndex(0))
-      .WillOnce(::testing::Return(temperature::BASE))
-      .WillOnce(::testing::Return(temperature::BASE + temperature::SMALL_INCREMENT))
-      .WillOnce(::testing::Return(temperature::BASE + (temperature::SMALL_INCREMENT * 2)))
-      .WillOnce(::testing::Return(temperature::BASE + temperature::SMALL_INCREMENT))
-      .WillOnce(::testing::Return(temperature::BASE))
-      // Next 5 readings with a sudden increase
-      .WillOnce(::testing::Return(temperature::BASE))
-      .WillOnce(::testing::Return(temperature::BASE + temperature::SMALL_INCREMENT))
-      .WillOnce(::testing::Return(temperature::BASE + temperature::SUDDEN_INCREASE)) // Sudden increase
-      .WillOnce(::testing::Return(temperature::BASE + temperature::SUDDEN_INCREASE + temperature::SMALL_INCREMENT))
-      .WillOnce(
-          ::testing::Return(temperature::BASE + temperature::SUDDEN_INCREASE + (temperature::SMALL_INCREMENT * 2)));
+  const float minutesPerReading = static_cast<float>(DS18B20_CONVERSION_TIME_MS) / MS_TO_MINUTES;
+  int reading = 0;
+  ON_CALL(*sensors, getTemp(::testing::_)).WillByDefault(::testing::Invoke([&](const uint8_t * /*address*/) {
+    float noise = (reading % 2 == 0) ? NOISE_AMPLITUDE_C : -NOISE_AMPLITUDE_C;
+    return temperature::toDallasRaw(temperature::BASE +
+                                    (SLOW_RISE_C_PER_MIN * minutesPerReading * static_cast<float>(reading++)) + noise);
+  }));
 
   // Act & Assert
-  // Fill the buffer with initial readings
-  for (int i = 0; i < READINGS_ARRAY_SIZE; i++) {
-    thermometer->updateTemperature();
+  for (int i = 0; i < THERMOMETER_TREND_WINDOW - 1; i++) {
+    takeReading();
   }
+  EXPECT_FALSE(thermometer->isTemperatureRising(HEARTS_END_TEMPERATURE_SLOPE_C_PER_MIN));
 
-  // Explicitly set lastMedian after filling the buffer
-  thermometer->setLastMedian(thermometer->getTemperature());
-
-  // No sudden increase yet (after filling the buffer)
-  EXPECT_FALSE(thermometer->isSuddenTemperatureIncrease(TEMPERATURE_STABILIZATION_THRESHOLD_C));
+  takeReading();
+  EXPECT_TRUE(thermometer->isTemperatureRising(HEARTS_END_TEMPERATURE_SLOPE_C_PER_MIN));
+  EXPECT_NEAR(SLOW_RISE_C_PER_MIN, thermometer->getTemperatureSlope(), SLOW_RISE_C_PER_MIN / 4);
+}
 
-  // Add readings with the sudden increase
-  for (int i = 0; i < READINGS_ARRAY_SIZE; i++) {
-    thermometer->updateTemperature();
+/**
+ * @brief Test case for SingleSpikeIsNotARise.
+ *
+ * Given the thermometer has a full trend window of flat readings.
+ * When one reading jumps by 5 °C.
+ * Then the jump should raise the residual noise and isTemperatureRising should still return false.
+ */
+TEST_F(ThermometerTest, SingleSpikeIsNotARise) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  ON_CALL(*sensors, getTemp(::testing::_))
+      .WillByDefault(::testing::Return(temperature::toDallasRaw(temperature::BASE)));
+  for (int i = 0; i < THERMOMETER_TREND_WINDOW - 1; i++) {
+    takeReading();
   }
+  float flatNoise = thermometer->getTemperatureNoise();
 
-  // Now we should detect the sudden increase
-  EXPECT_TRUE(thermometer->isSuddenTemperatureIncrease(TEMPERATURE_STABILIZATION_THRESHOLD_C));
+  // Act
+  ON_CALL(*sensors, getTemp(::testing::_))
+      .WillByDefault(::testing::Return(temperature::toDallasRaw(temperature::BASE + temperature::SUDDEN_INCREASE)));
+  takeReading();
+
+  // Assert
+  EXPECT_GT(thermometer->getTemperatureNoise(), flatNoise);
+  EXPECT_FALSE(thermometer->isTemperatureRising(HEARTS_END_TEMPERATURE_SLOPE_C_PER_MIN));
 }
 
 /**
@@ -117,16 +144,97 @@ TEST_F(ThermometerTest, GetLastTemperatureReturnsLastReading) { // NOLINT(cppcor
   constexpr int READING_COUNT = 3;
   EXPECT_CALL(*sensors, requestTemperatures()).Times(READING_COUNT);
 
-  EXPECT_CALL(*sensors, getTempCByIndex(0))
-      .WillOnce(::testing::Return(temperature::BASE))
-      .WillOnce(::testing::Return(temperature::BASE + temperature::MEDIUM_INCREMENT))
-      .WillOnce(::testing::Return(temperature::BASE + (temperature::MEDIUM_INCREMENT * 2)));
+  EXPECT_CALL(*sensors, getTemp(::testing::_))
+      .WillOnce(::testing::Return(temperature::toDallasRaw(temperature::BASE)))
+      .WillOnce(::testing::Return(temperature::toDallasRaw(temperature::BASE + temperature::MEDIUM_INCREMENT)))
+      .WillOnce(
+          ::testing::Return(temperature::toDallasRaw(temperature::BASE + (temperature::MEDIUM_INCREMENT * 2))));
 
   // Act
-  thermometer->updateTemperature();
-  thermometer->updateTemperature();
-  thermometer->updateTemperature();
+  takeReading();
+  takeReading();
+  takeReading();
 
   // Assert
   EXPECT_FLOAT_EQ(temperature::BASE + (temperature::MEDIUM_INCREMENT * 2), thermometer->getLastTemperature());
 }
+
+/**
+ * @brief Test case for CollectTemperatureWaitsForConversionTime.
+ *
+ * Given a conversion has been requested on the bus.
+ * When collectTemperature is called before the conversion time has passed.
+ * Then no scratchpad read should happen and no reading should be stored.
+ * When collectTemperature is called after the conversion time has passed.
+ * Then the scratchpad should be read exactly once for that conversion.
+ */
+TEST_F(ThermometerTest, CollectTemperatureWaitsForConversionTime) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  EXPECT_CALL(*sensors, requestTemperatures()).Times(1);
+  EXPECT_CALL(*sensors, getTemp(::testing::_))
+      .WillOnce(::testing::Return(temperature::toDallasRaw(temperature::BASE)));
+
+  // Act & Assert
+  bus->requestConversion();
+  EXPECT_TRUE(bus->isConversionPending());
+
+  advanceMillis(DS18B20_CONVERSION_TIME_MS - 1);
+  EXPECT_FALSE(bus->isConversionComplete());
+  EXPECT_FALSE(thermometer->collectTemperature());
+
+  advanceMillis(1);
+  EXPECT_TRUE(bus->isConversionComplete());
+  EXPECT_TRUE(thermometer->collectTemperature());
+  EXPECT_FLOAT_EQ(temperature::BASE, thermometer->getLastTemperature());
+
+  // A second collect of the same conversion must not touch the bus
+  EXPECT_FALSE(thermometer->collectTemperature());
+}
+
+/**
+ * @brief Test case for DisconnectedReadingIsDiscarded.
+ *
+ * Given a completed conversion whose scratchpad read fails.
+ * When collectTemperature is called.
+ * Then the failed read should not be stored as a reading.
+ */
+TEST_F(ThermometerTest, DisconnectedReadingIsDiscarded) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  EXPECT_CALL(*sensors, getTemp(::testing::_))
+      .WillOnce(::testing::Return(temperature::toDallasRaw(temperature::BASE)))
+      .WillOnce(::testing::Return(DEVICE_DISCONNECTED_RAW));
+  takeReading();
+
+  // Act
+  bus->requestConversion();
+  advanceMillis(DS18B20_CONVERSION_TIME_MS);
+  bool stored = thermometer->collectTemperature();
+
+  // Assert
+  EXPECT_FALSE(stored);
+  EXPECT_FLOAT_EQ(temperature::BASE, thermometer->getLastTemperature());
+}
+
+/**
+ * @brief Test case for ReadingIsStampedWithConversionStart.
+ *
+ * Given a conversion whose result is collected long after it finished.
+ * When collectTemperature is called.
+ * Then the reading should carry the time the conversion started, not the time it was collected.
+ */
+TEST_F(ThermometerTest, ReadingIsStampedWithConversionStart) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr unsigned long START_TIME_MS = 5000;
+  EXPECT_CALL(*sensors, getTemp(::testing::_))
+      .WillOnce(::testing::Return(temperature::toDallasRaw(temperature::BASE)));
+  setMillis(START_TIME_MS);
+  bus->requestConversion();
+
+  // Act
+  advanceMillis(3 * DS18B20_CONVERSION_TIME_MS);
+  bool stored = thermometer->collectTemperature();
+
+  // Assert
+  EXPECT_TRUE(stored);
+  EXPECT_EQ(START_TIME_MS, thermometer->getReadingTime());
+}
@@ -0,0 +1,237 @@
+#include "test_constants.h"
+
+#include <array>
+#include <constants.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+
+// Define UNIT_TEST if not already defined
+#ifndef UNIT_TEST
+#define UNIT_TEST
+#endif
+
+// Include the mock Arduino functions
+#include "mock_arduino.h"
+
+#include <thermometer_bus.h>
+
+namespace {
+constexpr uint8_t PROBE_COUNT = 4;
+constexpr int READ_CYCLES = 3;
+constexpr uint8_t NINE_BIT_CONFIGURATION = 0x1F; // R1 and R0 clear, as the DS18B20 datasheet lists it
+constexpr uint8_t COPY_SCRATCHPAD = 0x48;        // Copies the scratchpad to EEPROM
+} // namespace
+
+class ThermometerBusTest : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  std::shared_ptr<MockOneWire> oneWire;
+  std::shared_ptr<MockDallasTemperature> sensors;
+  std::unique_ptr<ThermometerBus> bus;
+
+  void SetUp() override {
+    setMillis(0);
+    oneWire = std::make_shared<::testing::NiceMock<MockOneWire>>();
+    ON_CALL(*oneWire, reset()).WillByDefault(::testing::Return(1));
+    sensors = std::make_shared<::testing::NiceMock<MockDallasTemperature>>();
+    bus = std::make_unique<ThermometerBus>(oneWire, sensors);
+
+    // Give every probe a distinct ROM code whose first byte is its index
+    ON_CALL(*sensors, getAddress(::testing::_, ::testing::_))
+        .WillByDefault(::testing::Invoke([](uint8_t *address, uint8_t index) {
+          std::fill(address, address + ONE_WIRE_ADDRESS_SIZE, 0);
+          address[0] = index;
+          return true;
+        }));
+    ON_CALL(*sensors, getResolution(::testing::_)).WillByDefault(::testing::Return(DS18B20_MAX_RESOLUTION_BITS));
+  }
+};
+
+/**
+ * @brief Test case for BeginCachesEveryProbeAddress.
+ *
+ * Given a bus with four probes.
+ * When begin is called.
+ * Then the ROM search should run once and every probe address should be read once.
+ */
+TEST_F(ThermometerBusTest, BeginCachesEveryProbeAddress) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  EXPECT_CALL(*sensors, setWaitForConversion(false)).Times(1);
+  EXPECT_CALL(*sensors, getDeviceCount()).WillOnce(::testing::Return(PROBE_COUNT));
+  EXPECT_CALL(*sensors, getAddress(::testing::_, ::testing::_)).Times(PROBE_COUNT);
+
+  // Act
+  uint8_t found = bus->begin();
+
+  // Assert
+  EXPECT_EQ(PROBE_COUNT, found);
+  EXPECT_EQ(PROBE_COUNT, bus->getProbeCount());
+}
+
+/**
+ * @brief Test case for ReadsUseCachedAddressesWithoutReenumerating.
+ *
+ * Given a bus that has been enumerated.
+ * When several conversion cycles are run and every probe is read.
+ * Then each cycle should issue exactly one broadcast convert, each read should address its own probe,
+ * and the bus should never be enumerated again.
+ */
+TEST_F(ThermometerBusTest, ReadsUseCachedAddressesWithoutReenumerating) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  EXPECT_CALL(*sensors, getDeviceCount()).Times(1).WillOnce(::testing::Return(PROBE_COUNT));
+  bus->begin();
+
+  EXPECT_CALL(*sensors, requestTemperatures()).Times(READ_CYCLES);
+  for (uint8_t probe = 0; probe < PROBE_COUNT; probe++) {
+    EXPECT_CALL(*sensors, getTemp(::testing::Truly([probe](const uint8_t *address) { return address[0] == probe; })))
+        .Times(READ_CYCLES)
+        .WillRepeatedly(::testing::Return(temperature::toDallasRaw(temperature::BASE + static_cast<float>(probe))));
+  }
+
+  // Act & Assert
+  for (int cycle = 0; cycle < READ_CYCLES; cycle++) {
+    bus->requestConversion();
+    advanceMillis(DS18B20_CONVERSION_TIME_MS);
+    for (uint8_t probe = 0; probe < PROBE_COUNT; probe++) {
+      EXPECT_EQ(celsiusToRaw(temperature::BASE + static_cast<float>(probe)), bus->readRawTemperature(probe));
+    }
+  }
+}
+
+/**
+ * @brief Test case for ReadingUnknownProbeReturnsDisconnected.
+ *
+ * Given a bus with four probes.
+ * When a probe index beyond the probe count is read.
+ * Then the bus should report the probe as disconnected without touching the wire.
+ */
+TEST_F(ThermometerBusTest, ReadingUnknownProbeReturnsDisconnected) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  ON_CALL(*sensors, getDeviceCount()).WillByDefault(::testing::Return(PROBE_COUNT));
+  bus->begin();
+  EXPECT_CALL(*sensors, getTemp(::testing::_)).Times(0);
+
+  // Act & Assert
+  EXPECT_EQ(DISCONNECTED_RAW_TEMPERATURE, bus->readRawTemperature(PROBE_COUNT));
+}
+
+/**
+ * @brief Test case for LowResolutionProbeCompletesEarly.
+ *
+ * Given a bus with four probes at 12-bit resolution.
+ * When one probe is set to 9 bits and a conversion is started.
+ * Then only that probe's configuration register should be written, with no copy to EEPROM, and the probe should
+ * be complete after its 94 ms conversion time while the cycle as a whole still waits for the 12-bit probes.
+ */
+TEST_F(ThermometerBusTest, LowResolutionProbeCompletesEarly) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  ON_CALL(*sensors, getDeviceCount()).WillByDefault(::testing::Return(PROBE_COUNT));
+  bus->begin();
+  EXPECT_CALL(*oneWire, select(::testing::Truly([](const uint8_t *address) { return address[0] == 0; }))).Times(1);
+  EXPECT_CALL(*oneWire, write(::testing::_)).Times(::testing::AnyNumber());
+  EXPECT_CALL(*oneWire, write(NINE_BIT_CONFIGURATION)).Times(1);
+  EXPECT_CALL(*oneWire, write(COPY_SCRATCHPAD)).Times(0);
+
+  // Act
+  EXPECT_TRUE(bus->setResolution(0, DS18B20_MIN_RESOLUTION_BITS));
+  bus->requestConversion();
+  advanceMillis(ds18b20ConversionTimeMs(DS18B20_MIN_RESOLUTION_BITS));
+
+  // Assert
+  EXPECT_EQ(94UL, bus->getConversionTimeMs(0));
+  EXPECT_TRUE(bus->isConversionComplete(0));
+  EXPECT_FALSE(bus->isConversionComplete(1));
+  EXPECT_FALSE(bus->isConversionComplete());
+  EXPECT_EQ(DS18B20_CONVERSION_TIME_MS, bus->getCycleTimeMs());
+}
+
+/**
+ * @brief Test case for ResolutionIsNotWrittenMidConversion.
+ *
+ * Given a bus with a conversion in progress.
+ * When a probe's resolution is changed, and then set again to the value it already has.
+ * Then the first change should be refused without touching the wire, and setting an unchanged resolution
+ * should succeed without a register write.
+ */
+TEST_F(ThermometerBusTest, ResolutionIsNotWrittenMidConversion) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  ON_CALL(*sensors, getDeviceCount()).WillByDefault(::testing::Return(PROBE_COUNT));
+  bus->begin();
+  bus->requestConversion();
+  EXPECT_CALL(*oneWire, write(::testing::_)).Times(0);
+
+  // Act & Assert
+  EXPECT_FALSE(bus->setResolution(0, DS18B20_MIN_RESOLUTION_BITS));
+  EXPECT_TRUE(bus->setResolution(0, DS18B20_MAX_RESOLUTION_BITS));
+  EXPECT_EQ(DS18B20_MAX_RESOLUTION_BITS, bus->getResolution(0));
+}
+
+/**
+ * @brief Test case for BoundProbesFollowTheirRomCodes.
+ *
+ * Given a bus whose ROM search lists the top probe first and the mash tun probe last, with the mash tun probe at
+ * 9 bits.
+ * When each position is bound to its probe's ROM code.
+ * Then each index should read its own probe, and the resolution should move with the probe.
+ */
+TEST_F(ThermometerBusTest, BoundProbesFollowTheirRomCodes) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  ON_CALL(*sensors, getDeviceCount()).WillByDefault(::testing::Return(PROBE_COUNT));
+  ON_CALL(*sensors, getResolution(::testing::Truly([](const uint8_t *address) { return address[0] == 3; })))
+      .WillByDefault(::testing::Return(DS18B20_MIN_RESOLUTION_BITS));
+  bus->begin();
+  const std::array<uint8_t, PROBE_COUNT> searchIndexOfPosition = {3, 1, 2, 0};
+  std::array<ProbeAddress, PROBE_COUNT> positionAddresses{};
+  for (uint8_t position = 0; position < PROBE_COUNT; position++) {
+    positionAddresses[position] = bus->getAddress(searchIndexOfPosition[position]);
+  }
+  ON_CALL(*sensors, getTemp(::testing::_)).WillByDefault(::testing::Invoke([](const uint8_t *address) {
+    return temperature::toDallasRaw(temperature::BASE + static_cast<float>(address[0]));
+  }));
+
+  // Act
+  bool bound = true;
+  for (uint8_t position = 0; position < PROBE_COUNT; position++) {
+    bound = bus->bindProbe(position, positionAddresses[position]) && bound;
+  }
+  bus->requestConversion();
+  advanceMillis(DS18B20_CONVERSION_TIME_MS);
+
+  // Assert
+  EXPECT_TRUE(bound);
+  for (uint8_t position = 0; position < PROBE_COUNT; position++) {
+    EXPECT_TRUE(bus->getAddress(position) == positionAddresses[position]);
+    EXPECT_EQ(celsiusToRaw(temperature::BASE + static_cast<float>(searchIndexOfPosition[position])),
+              bus->readRawTemperature(position));
+  }
+  EXPECT_EQ(DS18B20_MIN_RESOLUTION_BITS, bus->getResolution(MASH_TUN_THERMOMETER_PROBE));
+  EXPECT_EQ(DS18B20_MAX_RESOLUTION_BITS, bus->getResolution(TOP_THERMOMETER_PROBE));
+}
+
+/**
+ * @brief Test case for MissingProbeIsNotBound.
+ *
+ * Given a bus with four probes, one of them already bound to the first position.
+ * When a position is bound to a ROM code no probe on the bus has, or to the already bound probe's code.
+ * Then both binds should fail and leave the probes where they were.
+ */
+TEST_F(ThermometerBusTest, MissingProbeIsNotBound) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  ON_CALL(*sensors, getDeviceCount()).WillByDefault(::testing::Return(PROBE_COUNT));
+  bus->begin();
+  ProbeAddress replaced = bus->getAddress(1);
+  replaced.bytes[ONE_WIRE_ADDRESS_SIZE - 1] ^= 0xFF;
+  ProbeAddress first = bus->getAddress(0);
+  ASSERT_TRUE(bus->bindProbe(0, first));
+
+  // Act
+  bool boundReplaced = bus->bindProbe(1, replaced);
+  bool boundTwice = bus->bindProbe(2, first);
+
+  // Assert
+  EXPECT_FALSE(boundReplaced);
+  EXPECT_FALSE(boundTwice);
+  for (uint8_t probe = 0; probe < PROBE_COUNT; probe++) {
+    EXPECT_EQ(probe, bus->getAddress(probe).bytes[0]);
+  }
+}
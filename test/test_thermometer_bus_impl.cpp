@@ -0,0 +1,4 @@
+#include "../lib/hardware_abstractions/include/thermometer_bus.h"
+#include "../lib/hardware_abstractions/src/thermometer_bus.cpp"
+
+// This file ensures the ThermometerBus implementation is available for tests
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "test_constants.h"
+
+#include <constants.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+
+// Define UNIT_TEST if not already defined
+#ifndef UNIT_TEST
+#define UNIT_TEST
+#endif
+
+// Include the mock Arduino functions
+#include "mock_arduino.h"
+
+#include <distillation_state_manager.h>
+#include <thermometer.h>
+#include <thermometer_bus.h>
+#include <thermometer_controller.h>
+
+namespace {
+constexpr uint8_t PROBE_COUNT = 4;
+}
+
+class ThermometerControllerTest
+  : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  std::shared_ptr<MockOneWire> oneWire;
+  std::shared_ptr<MockDallasTemperature> sensors;
+  std::unique_ptr<ThermometerBus> bus;
+  std::unique_ptr<Thermometer> mashTun;
+  std::unique_ptr<Thermometer> bottom;
+  std::unique_ptr<Thermometer> nearTop;
+  std::unique_ptr<Thermometer> top;
+  std::unique_ptr<ThermometerController> controller;
+
+  void SetUp() override {
+    setMillis(0);
+    oneWire = std::make_shared<::testing::NiceMock<MockOneWire>>();
+    ON_CALL(*oneWire, reset()).WillByDefault(::testing::Return(1));
+    sensors = std::make_shared<::testing::NiceMock<MockDallasTemperature>>();
+    ON_CALL(*sensors, getDeviceCount()).WillByDefault(::testing::Return(PROBE_COUNT));
+    ON_CALL(*sensors, getAddress(::testing::_, ::testing::_))
+        .WillByDefault(::testing::Invoke([](uint8_t *address, uint8_t index) {
+          std::fill(address, address + ONE_WIRE_ADDRESS_SIZE, 0);
+          address[0] = index;
+          return true;
+        }));
+    ON_CALL(*sensors, getResolution(::testing::_)).WillByDefault(::testing::Return(DS18B20_MAX_RESOLUTION_BITS));
+    DistillationStateManager::getInstance().setState(OFF);
+    bus = std::make_unique<ThermometerBus>(oneWire, sensors);
+    bus->begin();
+
+    mashTun = std::make_unique<Thermometer>(*bus, MASH_TUN_THERMOMETER_PROBE);
+    bottom = std::make_unique<Thermometer>(*bus, BOTTOM_THERMOMETER_PROBE);
+    nearTop = std::make_unique<Thermometer>(*bus, NEAR_TOP_THERMOMETER_PROBE);
+    top = std::make_unique<Thermometer>(*bus, TOP_THERMOMETER_PROBE);
+    controller = std::make_unique<ThermometerController>(*bus, *mashTun, *bottom, *nearTop, *top);
+  }
+};
+
+/**
+ * @brief Test case for PipelineNeverWaitsForConversion.
+ *
+ * Given a controller with four probes on one bus.
+ * When updateAllTemperatures is called before and after the conversion time has passed.
+ * Then the first tick should start one conversion for all probes without reading, ticks during the conversion
+ * should not touch the bus, and the first tick after the conversion should read every probe once and start
+ * the next conversion.
+ */
+TEST_F(ThermometerControllerTest, PipelineNeverWaitsForConversion) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Tick 1: start the first conversion, nothing to read yet
+  EXPECT_CALL(*sensors, requestTemperatures()).Times(1);
+  EXPECT_CALL(*sensors, getTemp(::testing::_)).Times(0);
+  controller->updateAllTemperatures();
+  ::testing::Mock::VerifyAndClearExpectations(sensors.get());
+
+  // Tick 2: conversion still running, the bus stays untouched
+  advanceMillis(bus->getCycleTimeMs() / 2);
+  EXPECT_CALL(*sensors, requestTemperatures()).Times(0);
+  EXPECT_CALL(*sensors, getTemp(::testing::_)).Times(0);
+  controller->updateAllTemperatures();
+  ::testing::Mock::VerifyAndClearExpectations(sensors.get());
+
+  // Tick 3: conversion finished, read all probes and restart
+  advanceMillis(bus->getCycleTimeMs() - bus->getCycleTimeMs() / 2);
+  EXPECT_CALL(*sensors, getTemp(::testing::_))
+      .Times(PROBE_COUNT)
+      .WillRepeatedly(::testing::Return(temperature::toDallasRaw(temperature::BASE)));
+  EXPECT_CALL(*sensors, requestTemperatures()).Times(1);
+  controller->updateAllTemperatures();
+
+  EXPECT_FLOAT_EQ(temperature::BASE, top->getLastTemperature());
+  EXPECT_TRUE(bus->isConversionPending());
+}
+
+/**
+ * @brief Test case for ResolutionFollowsDistillationPhase.
+ *
+ * Given a controller whose probes start at 12-bit resolution.
+ * When the pipeline runs during heat-up and the phase then changes to hearts mid-conversion.
+ * Then heat-up should drop every probe to 9 bits, the hearts policy should only be written once the running
+ * conversion has finished, and only the probes whose resolution changes should be reprogrammed.
+ */
+TEST_F(ThermometerControllerTest, ResolutionFollowsDistillationPhase) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Heat-up: every probe drops to the fastest resolution before the first conversion
+  DistillationStateManager::getInstance().setState(HEAT_UP);
+  EXPECT_CALL(*oneWire, select(::testing::_)).Times(PROBE_COUNT);
+  controller->updateAllTemperatures();
+  ::testing::Mock::VerifyAndClearExpectations(oneWire.get());
+  EXPECT_EQ(ds18b20ConversionTimeMs(DS18B20_MIN_RESOLUTION_BITS), bus->getCycleTimeMs());
+
+  // Phase change mid-conversion: the configuration registers are left alone
+  DistillationStateManager::getInstance().setState(HEARTS);
+  EXPECT_CALL(*oneWire, select(::testing::_)).Times(0);
+  controller->updateAllTemperatures();
+  ::testing::Mock::VerifyAndClearExpectations(oneWire.get());
+
+  // Conversion finished: only the column probes are reprogrammed
+  advanceMillis(bus->getCycleTimeMs());
+  EXPECT_CALL(*oneWire, select(::testing::_)).Times(PROBE_COUNT - 1);
+  controller->updateAllTemperatures();
+  ::testing::Mock::VerifyAndClearExpectations(oneWire.get());
+
+  EXPECT_EQ(thermometerResolutionsFor(HEARTS).mashTun, bus->getResolution(MASH_TUN_THERMOMETER_PROBE));
+  EXPECT_EQ(thermometerResolutionsFor(HEARTS).bottom, bus->getResolution(BOTTOM_THERMOMETER_PROBE));
+  EXPECT_EQ(DS18B20_MAX_RESOLUTION_BITS, bus->getResolution(NEAR_TOP_THERMOMETER_PROBE));
+  EXPECT_EQ(DS18B20_CONVERSION_TIME_MS, bus->getCycleTimeMs());
+}
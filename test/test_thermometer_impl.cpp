@@ -0,0 +1,4 @@
+#include "../lib/hardware_abstractions/include/thermometer.h"
+#include "../lib/hardware_abstractions/src/thermometer.cpp"
+
+// This file ensures the Thermometer implementation is available for tests
\ No newline at end of file
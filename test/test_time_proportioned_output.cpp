@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <time_proportioned_output.h>
+
+namespace {
+constexpr unsigned long WINDOW_MS = 10000;
+constexpr unsigned long MIN_DWELL_MS = 500;
+constexpr unsigned long UPDATE_INTERVAL_MS = 100;
+} // namespace
+
+class TimeProportionedOutputTest
+  : public ::testing::Test { // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+protected:
+  TimeProportionedOutput output{WINDOW_MS, MIN_DWELL_MS};
+  unsigned long now{0};
+  unsigned long onTimeMs{0};
+  unsigned long shortestRunMs{WINDOW_MS};
+
+  // Updates the output every UPDATE_INTERVAL_MS for a number of windows, totalling the on time and timing each run
+  void run(unsigned long windows) {
+    unsigned long end = now + windows * WINDOW_MS;
+    bool previous = output.update(now);
+    unsigned long runStart = now;
+    while (now < end) {
+      now += UPDATE_INTERVAL_MS;
+      if (previous) {
+        onTimeMs += UPDATE_INTERVAL_MS;
+      }
+      bool current = output.update(now);
+      if (current != previous) {
+        shortestRunMs = std::min(shortestRunMs, now - runStart);
+        runStart = now;
+        previous = current;
+      }
+    }
+  }
+};
+
+/**
+ * @brief Test case for OnTimeFollowsDuty.
+ *
+ * Given an output with a duty of 30%.
+ * When it runs for ten windows.
+ * Then it should be on for 30% of the time.
+ */
+TEST_F(TimeProportionedOutputTest, OnTimeFollowsDuty) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr double DUTY = 0.3;
+  constexpr unsigned long WINDOWS = 10;
+  output.setDuty(DUTY);
+
+  // Act
+  run(WINDOWS);
+
+  // Assert
+  EXPECT_EQ(static_cast<unsigned long>(DUTY * WINDOWS * WINDOW_MS), onTimeMs);
+}
+
+/**
+ * @brief Test case for ShortPulsesAreCarriedNotDropped.
+ *
+ * Given outputs with duties whose pulses or gaps would be shorter than the minimum dwell.
+ * When each runs for fifty windows.
+ * Then no pulse or gap should be shorter than the dwell, and the average duty should still match within one dwell.
+ */
+TEST_F(TimeProportionedOutputTest, ShortPulsesAreCarriedNotDropped) { // NOLINT(cppcoreguidelines-owning-memory)
+  constexpr unsigned long WINDOWS = 50;
+  for (double duty : {0.02, 0.98}) {
+    // Arrange
+    output = TimeProportionedOutput(WINDOW_MS, MIN_DWELL_MS);
+    onTimeMs = 0;
+    shortestRunMs = WINDOW_MS;
+    output.setDuty(duty);
+
+    // Act
+    run(WINDOWS);
+
+    // Assert
+    EXPECT_GE(shortestRunMs, MIN_DWELL_MS) << "duty " << duty;
+    EXPECT_NEAR(duty * WINDOWS * WINDOW_MS, static_cast<double>(onTimeMs), MIN_DWELL_MS) << "duty " << duty;
+  }
+}
+
+/**
+ * @brief Test case for DutyChangeWaitsForNextWindow.
+ *
+ * Given an output part way through the on time of a window at 50% duty.
+ * When the duty drops to zero.
+ * Then the pulse should finish as planned, and the next window should stay off.
+ */
+TEST_F(TimeProportionedOutputTest, DutyChangeWaitsForNextWindow) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  output.setDuty(0.5);
+  ASSERT_TRUE(output.update(0));
+
+  // Act
+  output.setDuty(0.0);
+  bool onBeforeEnd = output.update(WINDOW_MS / 2 - UPDATE_INTERVAL_MS);
+  bool onAfterEnd = output.update(WINDOW_MS / 2);
+  bool onNextWindow = output.update(WINDOW_MS + UPDATE_INTERVAL_MS);
+
+  // Assert
+  EXPECT_TRUE(onBeforeEnd);
+  EXPECT_FALSE(onAfterEnd);
+  EXPECT_FALSE(onNextWindow);
+}
+
+/**
+ * @brief Test case for ResetTurnsOffAtOnce.
+ *
+ * Given an output that has just turned on.
+ * When it is reset.
+ * Then it should be off at once, in spite of the dwell.
+ */
+TEST_F(TimeProportionedOutputTest, ResetTurnsOffAtOnce) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  output.setDuty(1.0);
+  ASSERT_TRUE(output.update(0));
+
+  // Act
+  output.setDuty(0.0);
+  output.reset();
+
+  // Assert
+  EXPECT_FALSE(output.isOn());
+  EXPECT_FALSE(output.update(UPDATE_INTERVAL_MS));
+}
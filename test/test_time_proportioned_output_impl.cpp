@@ -0,0 +1,4 @@
+#include "../lib/utilities/include/time_proportioned_output.h"
+#include "../lib/utilities/src/time_proportioned_output.cpp"
+
+// This file ensures the TimeProportionedOutput implementation is available for tests
@@ -0,0 +1,141 @@
+#include <cmath>
+#include <gtest/gtest.h>
+#include <trend_estimator.h>
+#include <vector>
+
+namespace {
+constexpr std::size_t WINDOW = 40;
+constexpr unsigned long SAMPLE_INTERVAL_MS = 750;
+constexpr float MS_PER_MINUTE = 60000.0F;
+constexpr float START_TEMPERATURE_C = 78.0F;
+constexpr float RISE_C_PER_MIN = 0.5F;
+constexpr int LONG_RUN_SAMPLES = 20000;
+
+struct Sample {
+  unsigned long timeMs;
+  float value;
+};
+
+// Reference least-squares slope computed in double precision from scratch
+double batchSlopePerMinute(const std::vector<Sample> &samples) {
+  double meanT = 0.0;
+  double meanY = 0.0;
+  for (const Sample &sample : samples) {
+    meanT += static_cast<double>(sample.timeMs) / MS_PER_MINUTE;
+    meanY += sample.value;
+  }
+  meanT /= static_cast<double>(samples.size());
+  meanY /= static_cast<double>(samples.size());
+  double sumTY = 0.0;
+  double sumTT = 0.0;
+  for (const Sample &sample : samples) {
+    double t = (static_cast<double>(sample.timeMs) / MS_PER_MINUTE) - meanT;
+    sumTY += t * (sample.value - meanY);
+    sumTT += t * t;
+  }
+  return sumTY / sumTT;
+}
+} // namespace
+
+/**
+ * @brief Test case for SlopeOfLinearRise.
+ *
+ * Given a trend estimator fed noiseless samples rising at 0.5 °C/min.
+ * When the slope and residual variance are queried.
+ * Then the slope should be 0.5 °C/min and the residual variance should be zero.
+ */
+TEST(TrendEstimatorTest, SlopeOfLinearRise) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  TrendEstimator<float, WINDOW> trend;
+
+  // Act
+  for (unsigned long i = 0; i < WINDOW; i++) {
+    unsigned long time = i * SAMPLE_INTERVAL_MS;
+    trend.add(time, START_TEMPERATURE_C + (RISE_C_PER_MIN * static_cast<float>(time) / MS_PER_MINUTE));
+  }
+
+  // Assert
+  EXPECT_TRUE(trend.isFull());
+  EXPECT_NEAR(RISE_C_PER_MIN, trend.slopePerMinute(), 1e-3F);
+  EXPECT_NEAR(0.0F, trend.residualVariance(), 1e-5F);
+}
+
+/**
+ * @brief Test case for ResidualVarianceOfAlternatingNoise.
+ *
+ * Given a trend estimator fed flat samples alternating ±0.1 °C around a constant.
+ * When the residual variance is queried.
+ * Then the slope should be close to zero and the variance close to 0.01 °C².
+ */
+TEST(TrendEstimatorTest, ResidualVarianceOfAlternatingNoise) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr float NOISE_C = 0.1F;
+  TrendEstimator<float, WINDOW> trend;
+
+  // Act
+  for (unsigned long i = 0; i < WINDOW; i++) {
+    trend.add(i * SAMPLE_INTERVAL_MS, START_TEMPERATURE_C + ((i % 2 == 0) ? NOISE_C : -NOISE_C));
+  }
+
+  // Assert
+  EXPECT_NEAR(0.0F, trend.slopePerMinute(), 0.05F);
+  EXPECT_NEAR(NOISE_C * NOISE_C, trend.residualVariance(), 0.002F);
+  EXPECT_GT(trend.slopeStandardError(), 0.0F);
+}
+
+/**
+ * @brief Test case for SlidingUpdatesMatchBatchFitOverLongRuns.
+ *
+ * Given a trend estimator fed a long run of noisy samples whose slope changes partway through.
+ * When every sample is added with O(1) sliding updates.
+ * Then the slope should keep matching a double-precision batch fit over the same window, with no drift from
+ * accumulated rounding errors.
+ */
+TEST(TrendEstimatorTest, SlidingUpdatesMatchBatchFitOverLongRuns) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  TrendEstimator<float, WINDOW> trend;
+  std::vector<Sample> samples;
+  unsigned int seed = 42U;
+  const float riseStartMinutes = static_cast<float>(LONG_RUN_SAMPLES / 2 * SAMPLE_INTERVAL_MS) / MS_PER_MINUTE;
+
+  // Act
+  for (int i = 0; i < LONG_RUN_SAMPLES; i++) {
+    unsigned long time = static_cast<unsigned long>(i) * SAMPLE_INTERVAL_MS;
+    float minutes = static_cast<float>(time) / MS_PER_MINUTE;
+    seed = seed * 1103515245U + 12345U; // Deterministic LCG noise of up to ±0.05 °C
+    float noise = (static_cast<float>((seed >> 16) % 101) - 50.0F) / 1000.0F;
+    float rise = minutes < riseStartMinutes ? 0.0F : RISE_C_PER_MIN * (minutes - riseStartMinutes);
+    float value = START_TEMPERATURE_C + rise + noise;
+    trend.add(time, value);
+    samples.push_back({time, value});
+  }
+
+  // Assert
+  std::vector<Sample> window(samples.end() - WINDOW, samples.end());
+  EXPECT_NEAR(batchSlopePerMinute(window), trend.slopePerMinute(), 0.01);
+}
+
+/**
+ * @brief Test case for IntegerSamplesGiveExactSlidingSums.
+ *
+ * Given an integer trend estimator fed raw 1/16 °C steps rising at 8 steps per minute for many windows.
+ * When the slope and residual variance are queried.
+ * Then the slope should be exactly 8 steps per minute and the variance zero, since integer sums never drift.
+ */
+TEST(TrendEstimatorTest, IntegerSamplesGiveExactSlidingSums) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  constexpr int16_t START_RAW = 1248; // 78 °C
+  constexpr int STEPS_PER_MINUTE = 8;
+  constexpr unsigned long MS_PER_STEP = 60000 / STEPS_PER_MINUTE;
+  TrendEstimator<int16_t, WINDOW> trend;
+
+  // Act
+  for (unsigned long i = 0; i < WINDOW * 10; i++) {
+    unsigned long time = i * MS_PER_STEP;
+    trend.add(time, static_cast<int16_t>(START_RAW + static_cast<int16_t>(i)));
+  }
+
+  // Assert
+  EXPECT_FLOAT_EQ(static_cast<float>(STEPS_PER_MINUTE), trend.slopePerMinute());
+  EXPECT_FLOAT_EQ(0.0F, trend.residualVariance());
+}
@@ -0,0 +1,88 @@
+#include "test_mocks.h"
+
+#include <gtest/gtest.h>
+#include <tuning_store.h>
+
+/**
+ * @brief Test case for GainsSurviveAPowerCycle.
+ *
+ * Given a store with autotuned gains for the flow loop, saved to the storage.
+ * When a new store loads the storage, as after a power cycle.
+ * Then the flow gains should come back unchanged, and the heater loop should have none.
+ */
+TEST(TuningStoreTest, GainsSurviveAPowerCycle) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  MemoryBlockStorage storage;
+  TuningStore before(storage);
+  before.set(FLOW_TUNING_LOOP, {0.35, 0.021, 0.0});
+  ASSERT_TRUE(before.save());
+
+  // Act
+  TuningStore after(storage);
+  bool loaded = after.load();
+
+  // Assert
+  EXPECT_TRUE(loaded);
+  PidTuning tuning{};
+  ASSERT_TRUE(after.get(FLOW_TUNING_LOOP, tuning));
+  EXPECT_DOUBLE_EQ(0.35, tuning.kp);
+  EXPECT_DOUBLE_EQ(0.021, tuning.ki);
+  EXPECT_DOUBLE_EQ(0.0, tuning.kd);
+  EXPECT_FALSE(after.get(HEATER_TUNING_LOOP, tuning));
+  EXPECT_FALSE(after.get(TUNING_LOOP_COUNT, tuning));
+}
+
+/**
+ * @brief Test case for CorruptBlockIsRejected.
+ *
+ * Given a saved block with one byte flipped.
+ * When a store loads the corrupt block.
+ * Then the load should fail and leave every loop without gains.
+ */
+TEST(TuningStoreTest, CorruptBlockIsRejected) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  MemoryBlockStorage storage;
+  TuningStore writer(storage);
+  writer.set(HEATER_TUNING_LOOP, {2.0, 0.1, 5.0});
+  ASSERT_TRUE(writer.save());
+  storage.block[storage.block.size() / 2] ^= 0x01;
+
+  // Act
+  TuningStore corrupt(storage);
+  bool loaded = corrupt.load();
+
+  // Assert
+  PidTuning tuning{};
+  EXPECT_FALSE(loaded);
+  EXPECT_FALSE(corrupt.get(HEATER_TUNING_LOOP, tuning));
+}
+
+/**
+ * @brief Test case for UnchangedGainsAreNotRewritten.
+ *
+ * Given a store whose gains were just loaded.
+ * When the same gains are stored again and the store is saved, and then changed ones.
+ * Then only the changed gains should cause a write.
+ */
+TEST(TuningStoreTest, UnchangedGainsAreNotRewritten) { // NOLINT(cppcoreguidelines-owning-memory)
+  // Arrange
+  MemoryBlockStorage storage;
+  TuningStore writer(storage);
+  writer.set(FLOW_TUNING_LOOP, {0.35, 0.021, 0.0});
+  ASSERT_TRUE(writer.save());
+  TuningStore store(storage);
+  ASSERT_TRUE(store.load());
+  int writesAfterLoad = storage.writes;
+
+  // Act
+  store.set(FLOW_TUNING_LOOP, {0.35, 0.021, 0.0});
+  store.save();
+  int writesForSame = storage.writes - writesAfterLoad;
+  store.set(FLOW_TUNING_LOOP, {0.4, 0.021, 0.0});
+  store.save();
+  int writesForChange = storage.writes - writesAfterLoad - writesForSame;
+
+  // Assert
+  EXPECT_EQ(0, writesForSame);
+  EXPECT_EQ(1, writesForChange);
+}